@@ -0,0 +1,83 @@
+#include <iostream>
+#include <string>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include "backtest/backtest_runner.h"
+#include "backtest/market_history.h"
+
+// 回測工具: 以歷史數據回放正式策略
+//   ./backtest <data_dir> [--start YYYY-MM-DD] [--end YYYY-MM-DD] [--capital USDT]
+//              [--reconcile-minutes N] [--report report.json] [--verbose]
+// 策略參數讀取自 config/config.json
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "用法: " << program
+              << " <data_dir> [--start YYYY-MM-DD] [--end YYYY-MM-DD] [--capital USDT]"
+              << " [--reconcile-minutes N] [--report report.json] [--verbose]" << std::endl;
+}
+
+IClock::TimePoint parseDate(const std::string& text) {
+    std::tm tm = {};
+    std::istringstream ss(text);
+    ss >> std::get_time(&tm, "%Y-%m-%d");
+    if (ss.fail()) {
+        throw std::invalid_argument("日期格式錯誤: " + text);
+    }
+    return IClock::Clock::from_time_t(timegm(&tm));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        std::string dataDir = argv[1];
+        std::string reportPath;
+        BacktestOptions options;
+        for (int i = 2; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--verbose") {
+                options.quiet = false;
+            } else if (arg == "--start" && hasValue) {
+                options.start = parseDate(argv[++i]);
+            } else if (arg == "--end" && hasValue) {
+                options.end = parseDate(argv[++i]);
+            } else if (arg == "--capital" && hasValue) {
+                options.simulation.initialCapital = std::stod(argv[++i]);
+            } else if (arg == "--reconcile-minutes" && hasValue) {
+                options.reconcileInterval = std::chrono::minutes(std::stoi(argv[++i]));
+            } else if (arg == "--report" && hasValue) {
+                reportPath = argv[++i];
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+
+        auto history = MarketHistory::loadFromDirectory(dataDir);
+        BacktestRunner runner(history);
+
+        auto started = std::chrono::steady_clock::now();
+        BacktestReport report = runner.run(options);
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started);
+
+        report.print(std::cout);
+        std::cout << "耗時: " << std::fixed << std::setprecision(2) << elapsed.count() << " 秒" << std::endl;
+        if (!reportPath.empty() && !report.writeJson(reportPath)) {
+            std::cerr << "無法寫入報告: " << reportPath << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "錯誤: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include "bench_data.h"
+#include "exchange/bybit_api.h"
+#include "trading/trading_module.h"
+#include <cstdio>
+
+namespace benchdata {
+
+namespace {
+
+std::string number(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.8g", value);
+    return buffer;
+}
+
+std::string toText(const Json::Value& value) {
+    Json::FastWriter writer;
+    return writer.write(value);
+}
+
+} // namespace
+
+std::string symbolName(int index) {
+    // 形如 AAAUSDT, AABUSDT ...
+    std::string base(3, 'A');
+    for (int i = 2; i >= 0; i--) {
+        base[i] = static_cast<char>('A' + index % 26);
+        index /= 26;
+    }
+    return base + "USDT";
+}
+
+Json::Value orderBook(const std::string& symbol, double basePrice, int levels, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> quantity(1.0, 50.0);
+    const double tick = basePrice * 0.0001;
+
+    Json::Value root;
+    root["retCode"] = 0;
+    root["retMsg"] = "OK";
+    Json::Value& result = root["result"];
+    result["s"] = symbol;
+    result["a"] = Json::Value(Json::arrayValue);
+    result["b"] = Json::Value(Json::arrayValue);
+    for (int i = 0; i < levels; i++) {
+        Json::Value ask(Json::arrayValue);
+        ask.append(number(basePrice + tick * i));
+        ask.append(number(quantity(rng)));
+        result["a"].append(ask);
+        Json::Value bid(Json::arrayValue);
+        bid.append(number(basePrice - tick * (i + 1)));
+        bid.append(number(quantity(rng)));
+        result["b"].append(bid);
+    }
+    result["ts"] = Json::Int64(1700000000000);
+    return root;
+}
+
+std::string orderBookText(const std::string& symbol, double basePrice, int levels) {
+    return toText(orderBook(symbol, basePrice, levels));
+}
+
+std::string tickersText(int symbols) {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> price(0.01, 1000.0);
+    std::normal_distribution<double> rate(0.0001, 0.0003);
+
+    Json::Value root;
+    root["retCode"] = 0;
+    root["retMsg"] = "OK";
+    root["result"]["category"] = "linear";
+    Json::Value& list = root["result"]["list"];
+    list = Json::Value(Json::arrayValue);
+    for (int i = 0; i < symbols; i++) {
+        double last = price(rng);
+        Json::Value item;
+        item["symbol"] = symbolName(i);
+        item["lastPrice"] = number(last);
+        item["indexPrice"] = number(last * 0.9999);
+        item["markPrice"] = number(last * 1.0001);
+        item["prevPrice24h"] = number(last * 0.98);
+        item["price24hPcnt"] = "0.0204";
+        item["highPrice24h"] = number(last * 1.03);
+        item["lowPrice24h"] = number(last * 0.97);
+        item["openInterest"] = "1234567.8";
+        item["openInterestValue"] = "98765432.1";
+        item["turnover24h"] = "55555555.5";
+        item["volume24h"] = "4444444.4";
+        item["fundingRate"] = number(rate(rng));
+        item["nextFundingTime"] = "1700006400000";
+        item["bid1Price"] = number(last * 0.9998);
+        item["bid1Size"] = "120.5";
+        item["ask1Price"] = number(last * 1.0002);
+        item["ask1Size"] = "98.1";
+        list.append(item);
+    }
+    return toText(root);
+}
+
+std::string fundingHistoryText(const std::string& symbol, int periods) {
+    std::mt19937 rng(3);
+    std::normal_distribution<double> rate(0.0001, 0.0003);
+
+    Json::Value root;
+    root["retCode"] = 0;
+    root["retMsg"] = "OK";
+    root["result"]["category"] = "linear";
+    Json::Value& list = root["result"]["list"];
+    list = Json::Value(Json::arrayValue);
+    for (int i = 0; i < periods; i++) {
+        Json::Value item;
+        item["symbol"] = symbol;
+        item["fundingRate"] = number(rate(rng));
+        item["fundingRateTimestamp"] = std::to_string(1700000000000LL - i * 28800000LL);
+        list.append(item);
+    }
+    return toText(root);
+}
+
+std::vector<std::pair<std::string, std::vector<double>>> fundingHistories(int symbols, int periods) {
+    std::mt19937 rng(4);
+    std::normal_distribution<double> rate(0.0001, 0.0003);
+    std::vector<std::pair<std::string, std::vector<double>>> histories;
+    histories.reserve(symbols);
+    for (int i = 0; i < symbols; i++) {
+        std::vector<double> rates(periods);
+        for (double& r : rates) {
+            r = rate(rng);
+        }
+        histories.emplace_back(symbolName(i), std::move(rates));
+    }
+    return histories;
+}
+
+} // namespace benchdata
+
+double BenchmarkAccess::depthImpact(TradingModule& module, const Json::Value& orderbook, double size) {
+    return module.calculateDepthImpact(orderbook, size);
+}
+
+double BenchmarkAccess::rebalanceCost(TradingModule& module, const std::string& symbol, double size, bool isSpot,
+                                      const Json::Value& orderbook) {
+    return module.calculateRebalanceCost(symbol, size, isSpot, orderbook);
+}
+
+std::string BenchmarkAccess::signature(BybitAPI& api, const std::string& params, const std::string& timestamp) {
+    return api.generateSignature(params, timestamp);
+}
@@ -0,0 +1,41 @@
+#ifndef BENCH_DATA_H
+#define BENCH_DATA_H
+
+#include <json/json.h>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TradingModule;
+class BybitAPI;
+
+// 基準測試用的合成數據, 格式與 Bybit v5 回應一致. 固定種子, 各次運行結果可比較
+namespace benchdata {
+
+// 50 檔訂單簿: 以 basePrice 為最佳價, 每檔相隔 tick, 數量隨機
+Json::Value orderBook(const std::string& symbol, double basePrice, int levels = 50, unsigned seed = 1);
+std::string orderBookText(const std::string& symbol, double basePrice, int levels = 50);
+
+// /v5/market/tickers (linear) 回應, symbols 個交易對
+std::string tickersText(int symbols);
+
+// /v5/market/funding/history 回應, 每個交易對 periods 筆
+std::string fundingHistoryText(const std::string& symbol, int periods);
+
+// 評分輸入: symbols 個交易對, 每個 periods 筆費率 (最新在前)
+std::vector<std::pair<std::string, std::vector<double>>> fundingHistories(int symbols, int periods);
+
+std::string symbolName(int index);
+
+} // namespace benchdata
+
+// 訪問 TradingModule 及 BybitAPI 的內部熱路徑 (兩者皆宣告為 friend)
+struct BenchmarkAccess {
+    static double depthImpact(TradingModule& module, const Json::Value& orderbook, double size);
+    static double rebalanceCost(TradingModule& module, const std::string& symbol, double size, bool isSpot,
+                                const Json::Value& orderbook);
+    static std::string signature(BybitAPI& api, const std::string& params, const std::string& timestamp);
+};
+
+#endif // BENCH_DATA_H
@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+#include <json/json.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "logger.h"
+#include "storage/sqlite_storage.h"
+
+// 基準測試入口:
+//   ./bench [--baseline=FILE] [--threshold=0.10] [Google Benchmark 參數...]
+// 結果以 JSON 寫入 --benchmark_out (預設 bench_results.json).
+// 指定 --baseline 時與之前保存的結果比較, 任何項目的 CPU 時間慢於基準超過
+// threshold (比例) 即列為退步, 並以返回碼 1 結束
+
+namespace {
+
+double toNanoseconds(double value, const std::string& unit) {
+    if (unit == "us") return value * 1e3;
+    if (unit == "ms") return value * 1e6;
+    if (unit == "s") return value * 1e9;
+    return value;
+}
+
+// 名稱 -> CPU 時間 (ns). 有重複運行時取中位數, 否則取單次結果
+std::map<std::string, double> loadResults(const std::string& path) {
+    std::map<std::string, double> results;
+    std::ifstream in(path);
+    Json::Value root;
+    Json::Reader reader;
+    if (!in.is_open() || !reader.parse(in, root)) {
+        throw std::runtime_error("無法讀取基準測試結果: " + path);
+    }
+
+    std::map<std::string, double> medians;
+    for (const auto& run : root["benchmarks"]) {
+        double cpu = toNanoseconds(run["cpu_time"].asDouble(), run["time_unit"].asString());
+        if (run["run_type"].asString() == "aggregate") {
+            if (run["aggregate_name"].asString() == "median") {
+                medians[run["run_name"].asString()] = cpu;
+            }
+        } else if (run["error_occurred"].asBool() == false) {
+            results[run["name"].asString()] = cpu;
+        }
+    }
+    for (const auto& [name, cpu] : medians) {
+        results[name] = cpu;
+    }
+    return results;
+}
+
+int compareWithBaseline(const std::string& resultPath, const std::string& baselinePath, double threshold) {
+    auto current = loadResults(resultPath);
+    auto baseline = loadResults(baselinePath);
+
+    int regressions = 0;
+    std::printf("\n%-44s %14s %14s %9s\n", "基準比較", "基準 (ns)", "目前 (ns)", "變化");
+    for (const auto& [name, cpu] : current) {
+        auto it = baseline.find(name);
+        if (it == baseline.end() || it->second <= 0) {
+            std::printf("%-44s %14s %14.1f %9s\n", name.c_str(), "-", cpu, "新增");
+            continue;
+        }
+        double change = cpu / it->second - 1.0;
+        bool regressed = change > threshold;
+        regressions += regressed ? 1 : 0;
+        std::printf("%-44s %14.1f %14.1f %+8.1f%%%s\n", name.c_str(), it->second, cpu, change * 100,
+                    regressed ? "  <-- 退步" : "");
+    }
+    if (regressions > 0) {
+        std::printf("\n%d 項慢於基準超過 %.0f%%\n", regressions, threshold * 100);
+        return 1;
+    }
+    std::printf("\n沒有項目慢於基準超過 %.0f%%\n", threshold * 100);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string baselinePath;
+    std::string resultPath = "bench_results.json";
+    double threshold = 0.10;
+
+    // 取出本工具的參數, 其餘交給 Google Benchmark
+    std::vector<std::string> args{argv[0]};
+    bool hasOut = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--baseline=", 0) == 0) {
+            baselinePath = arg.substr(std::strlen("--baseline="));
+        } else if (arg.rfind("--threshold=", 0) == 0) {
+            threshold = std::stod(arg.substr(std::strlen("--threshold=")));
+        } else {
+            if (arg.rfind("--benchmark_out=", 0) == 0) {
+                hasOut = true;
+                resultPath = arg.substr(std::strlen("--benchmark_out="));
+            }
+            args.push_back(arg);
+        }
+    }
+    if (!hasOut) {
+        args.push_back("--benchmark_out=" + resultPath);
+    }
+    args.push_back("--benchmark_out_format=json");
+    resultPath = std::filesystem::absolute(resultPath).string();
+    if (!baselinePath.empty()) {
+        baselinePath = std::filesystem::absolute(baselinePath).string();
+    }
+
+    // 熱路徑中的調試日誌照常檢查級別, 但不輸出
+    LogBackend::getInstance().setLevel(LogLevel::Warning);
+    Config::getInstance();
+
+    // SQLiteStorage 固定打開當前目錄下的 trading.db, 在臨時目錄中先行打開
+    auto cwd = std::filesystem::current_path();
+    auto benchDir = std::filesystem::temp_directory_path() / "funding_rate_bench";
+    std::filesystem::remove_all(benchDir);
+    std::filesystem::create_directories(benchDir);
+    std::filesystem::current_path(benchDir);
+    SQLiteStorage::getInstance();
+    std::filesystem::current_path(cwd);
+
+    std::vector<char*> rawArgs;
+    for (auto& arg : args) {
+        rawArgs.push_back(arg.data());
+    }
+    int benchArgc = static_cast<int>(rawArgs.size());
+    benchmark::Initialize(&benchArgc, rawArgs.data());
+    if (benchmark::ReportUnrecognizedArguments(benchArgc, rawArgs.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    Logger::flush();
+
+    if (baselinePath.empty()) {
+        return 0;
+    }
+    try {
+        return compareWithBaseline(resultPath, baselinePath, threshold);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+}
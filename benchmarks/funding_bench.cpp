@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+#include "bench_data.h"
+#include "trading/funding_scorer.h"
+
+namespace {
+
+ScoringParams benchScoringParams() {
+    ScoringParams params;
+    params.periods = {3, 9, 21};
+    params.weights = {0.5, 0.3, 0.2};
+    params.topPairsCount = 5;
+    return params;
+}
+
+} // namespace
+
+// getTopFundingRates 的評分部分: 每個交易對按多個時間段加權平均後排序取前幾名
+static void BM_FundingScoreRank(benchmark::State& state) {
+    FundingScorer scorer(benchScoringParams());
+    auto histories = benchdata::fundingHistories(static_cast<int>(state.range(0)), 21);
+    for (auto _ : state) {
+        auto top = scorer.rank(histories);
+        benchmark::DoNotOptimize(top);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FundingScoreRank)->Arg(50)->Arg(300);
+
+static void BM_FundingScoreSingle(benchmark::State& state) {
+    FundingScorer scorer(benchScoringParams());
+    auto histories = benchdata::fundingHistories(1, 21);
+    double score = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scorer.score(histories[0].second, score));
+        benchmark::DoNotOptimize(score);
+    }
+}
+BENCHMARK(BM_FundingScoreSingle);
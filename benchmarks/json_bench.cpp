@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+#include "bench_data.h"
+
+namespace {
+
+// 與 BybitAPI::makeRequest 相同的解析方式
+void parseOrFail(benchmark::State& state, const std::string& text) {
+    for (auto _ : state) {
+        Json::Value root;
+        Json::Reader reader;
+        if (!reader.parse(text, root)) {
+            state.SkipWithError("JSON 解析失敗");
+            break;
+        }
+        benchmark::DoNotOptimize(root);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+} // namespace
+
+static void BM_ParseTickers(benchmark::State& state) {
+    parseOrFail(state, benchdata::tickersText(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_ParseTickers)->Arg(500);
+
+static void BM_ParseOrderBook(benchmark::State& state) {
+    parseOrFail(state, benchdata::orderBookText("BTCUSDT", 100.0, static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_ParseOrderBook)->Arg(50)->Arg(200);
+
+static void BM_ParseFundingHistory(benchmark::State& state) {
+    parseOrFail(state, benchdata::fundingHistoryText("BTCUSDT", static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_ParseFundingHistory)->Arg(200);
@@ -0,0 +1,28 @@
+#include <benchmark/benchmark.h>
+#include "bench_data.h"
+#include "storage/sqlite_storage.h"
+
+// 寫入只放入隊列, 由背景線程批次提交.
+// 數據庫由 bench_main 在臨時目錄中打開, 不會寫入正式的 trading.db
+static void BM_StoreTradeData(benchmark::State& state) {
+    SQLiteStorage& storage = SQLiteStorage::getInstance();
+    int i = 0;
+    for (auto _ : state) {
+        storage.storeTradeData(benchdata::symbolName(i++ % 500), 0.0001);
+    }
+    storage.flush();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StoreTradeData);
+
+// 每筆都等待提交, 相當於需要確認落盤的調用方
+static void BM_StoreTradeDataFlushed(benchmark::State& state) {
+    SQLiteStorage& storage = SQLiteStorage::getInstance();
+    int i = 0;
+    for (auto _ : state) {
+        storage.storeTradeData(benchdata::symbolName(i++ % 500), 0.0001);
+        storage.flush();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StoreTradeDataFlushed);
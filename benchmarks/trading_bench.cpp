@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+#include "bench_data.h"
+#include "../tests/mock_exchange.h"
+#include "exchange/bybit_api.h"
+#include "trading/trading_module.h"
+
+namespace {
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+TradingModule& benchTradingModule() {
+    static NiceMock<MockExchange> exchange;
+    static bool initialised = false;
+    if (!initialised) {
+        ON_CALL(exchange, getSpotFeeRate()).WillByDefault(Return(0.001));
+        ON_CALL(exchange, getContractFeeRate()).WillByDefault(Return(0.00055));
+        initialised = true;
+    }
+    return TradingModule::getInstance(exchange);
+}
+
+} // namespace
+
+// 訂單簿 50 檔, 參數為吃掉的檔數
+static void BM_CalculateDepthImpact(benchmark::State& state) {
+    TradingModule& module = benchTradingModule();
+    Json::Value book = benchdata::orderBook("BTCUSDT", 100.0, 50);
+    double size = 25.5 * state.range(0);   // 平均每檔約 25.5
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BenchmarkAccess::depthImpact(module, book, size));
+    }
+}
+BENCHMARK(BM_CalculateDepthImpact)->Arg(1)->Arg(10)->Arg(25);
+
+static void BM_CalculateRebalanceCost(benchmark::State& state) {
+    TradingModule& module = benchTradingModule();
+    Json::Value book = benchdata::orderBook("BTCUSDT", 100.0, 50);
+    double size = 25.5 * state.range(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BenchmarkAccess::rebalanceCost(module, "BTCUSDT", size, true, book));
+    }
+}
+BENCHMARK(BM_CalculateRebalanceCost)->Arg(1)->Arg(10)->Arg(25);
+
+// 下單請求的 HMAC-SHA256 簽名
+static void BM_GenerateSignature(benchmark::State& state) {
+    BybitAPI api(Config::getInstance().getAccounts().front());
+    std::string params = "{\"category\":\"linear\",\"orderType\":\"Market\",\"qty\":\"0.125\","
+                         "\"side\":\"Buy\",\"symbol\":\"BTCUSDT\"}";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BenchmarkAccess::signature(api, params, "1700000000000"));
+    }
+}
+BENCHMARK(BM_GenerateSignature);
@@ -5,7 +5,6 @@
 #include <algorithm>
 #include <thread>
 #include <chrono>
-#include <hiredis/hiredis.h>
 #include <json/json.h>
 #include <curl/curl.h>
 #include <sqlite3.h>
@@ -19,74 +18,116 @@
 #include "include/config.h"
 #include "exchange/bybit_api.h"
 #include "exchange/exchange_factory.h"
+#include "exchange/market_data_hub.h"
 #include "trading/trading_module.h"
 #include "storage/sqlite_storage.h"
+#include "scheduler/clock.h"
+#include "scheduler/settlement_calendar.h"
+#include "scheduler/task_scheduler.h"
+#include "scheduler/strategy_jobs.h"
+#include "metrics/alloc_tracker.h"
+#include "metrics/metrics_exporter.h"
+#include "metrics/trace.h"
 #include "logger.h"
 
-std::vector<std::string> splitString(const std::string& str, const std::string& delimiter) {
-    std::vector<std::string> tokens;
-    size_t prev = 0, pos = 0;
-    do {
-        pos = str.find(delimiter, prev);
-        if (pos == std::string::npos) pos = str.length();
-        std::string token = str.substr(prev, pos-prev);
-        if (!token.empty()) tokens.push_back(token);
-        prev = pos + delimiter.length();
-    } while (pos < str.length() && prev < str.length());
-    return tokens;
-}
+// 單一子帳戶的執行環境: 私有請求用自己的交易所實例, 行情經共用的 MarketDataHub
+struct AccountRuntime {
+    AccountConfig account;
+    std::unique_ptr<IExchange> exchange;
+    std::unique_ptr<AccountExchange> view;
+    std::unique_ptr<TradingModule> trader;
+    std::unique_ptr<TaskScheduler> scheduler;
+};
 
-bool isNearSettlement() {
-    auto now = std::chrono::system_clock::now();
-    auto utc_time = std::chrono::system_clock::to_time_t(now);
-    std::tm utc_tm = *std::gmtime(&utc_time);
-    
-    int current_minutes = utc_tm.tm_hour * 60 + utc_tm.tm_min;
-    auto settlement_times = Config::getInstance().getSettlementTimesUTC();
-    int pre_minutes = Config::getInstance().getPreSettlementMinutes();
-    
-    for (const auto& time_str : settlement_times) {
-        std::istringstream ss(time_str);
-        int hour, minute;
-        char delimiter;
-        ss >> hour >> delimiter >> minute;
-        
-        int settlement_minutes = hour * 60 + minute;
-        int diff = std::abs(current_minutes - settlement_minutes);
-        
-        // 考慮跨日情況
-        if (diff > 720) { // 12小時 = 720分鐘
-            diff = 1440 - diff; // 24小時 = 1440分鐘
-        }
-        
-        if (diff <= pre_minutes) {
-            return true;
-        }
+// 帳戶線程: 啟動對帳後由各自的排程器按結算時間表執行
+void runAccount(AccountRuntime& runtime, const StrategyJobOptions& options) {
+    Logger logger;
+    TradingModule& trader = *runtime.trader;
+
+    // 先載入重啟快照, 排名仍有效時啟動對帳不必重新下載資金費率歷史
+    trader.warmStart();
+
+    // 啟動時先執行一次完整對帳
+    try {
+        runReconcile(trader, options.displayPositions);
+    } catch (const std::exception& e) {
+        logger.error("啟動對帳失敗 " + runtime.account.name + ": " + std::string(e.what()));
     }
-    return false;
+    // 對帳後持倉簿已就緒, 風險監控以此為基準
+    trader.startRiskMonitor();
+    trader.startBasisTracker();
+    // 流水線啟動後排程工作只投遞請求, 由行情/策略/執行線程處理
+    trader.startPipeline();
+
+    runtime.scheduler->run();
 }
 
-// 调度器
+// 调度器: 按結算時間表在精確的截止時間喚醒, 取代固定間隔輪詢.
+// 多個子帳戶在同一進程內各自排程, 公共行情只請求一次
 void scheduleTask() {
     Logger logger;
-    while (true) {
-        try {
-            IExchange& exchange = ExchangeFactory::createExchange();
-            auto& trader = TradingModule::getInstance(exchange);
-            trader.displayPositions();
-            trader.executeHedgeStrategy(); 
-            trader.displayPositions();
-            logger.info("對沖策略執行完成");
-        } catch (const std::exception& e) {
-            std::cerr << "錯誤: " << e.what() << std::endl;
+    const std::vector<AccountConfig> accounts = Config::getInstance().getAccounts();
+    const SettlementCalendar calendar = SettlementCalendar::fromConfig();
+
+    // 公共行情不需要區分帳戶, 使用第一個帳戶的憑證
+    std::unique_ptr<IExchange> marketSource = ExchangeFactory::createExchange(accounts.front());
+    MarketDataHub marketData(*marketSource, MarketDataOptions::fromConfig());
+
+    StrategyJobOptions options;
+    options.reconcileInterval = std::chrono::minutes(Config::getInstance().getCheckIntervalMinutes());
+
+    std::vector<AccountRuntime> runtimes;
+    runtimes.reserve(accounts.size());
+    for (const auto& account : accounts) {
+        AccountRuntime& runtime = runtimes.emplace_back();
+        runtime.account = account;
+        runtime.exchange = ExchangeFactory::createExchange(account);
+        runtime.view = std::make_unique<AccountExchange>(*runtime.exchange, marketData);
+        runtime.trader = TradingModule::createForAccount(*runtime.view, SystemClock::getInstance(), account);
+        runtime.scheduler = std::make_unique<TaskScheduler>(SystemClock::getInstance());
+        // 資金費率歸檔只由第一個帳戶追加
+        StrategyJobOptions accountOptions = options;
+        if (runtimes.size() == 1) {
+            accountOptions.archivePath = Config::getInstance().getFundingArchivePath();
         }
-        std::this_thread::sleep_for(
-            std::chrono::minutes(Config::getInstance().getCheckIntervalMinutes())
-        );
+        registerStrategyJobs(*runtime.scheduler, *runtime.trader, calendar, accountOptions);
+    }
+
+    if (runtimes.size() == 1) {
+        runAccount(runtimes.front(), options);
+        return;
+    }
+    logger.info("啟動 " + std::to_string(runtimes.size()) + " 個子帳戶");
+    std::vector<std::thread> threads;
+    for (auto& runtime : runtimes) {
+        threads.emplace_back(runAccount, std::ref(runtime), std::cref(options));
+    }
+    for (auto& thread : threads) {
+        thread.join();
     }
 }
 
 int main() {
-    scheduleTask();
+    try {
+        LogBackend::getInstance().configure(LogOptions::fromConfig());
+        Config& config = Config::getInstance();
+        config.onReload([](const ConfigSnapshot&) {
+            LogBackend::getInstance().setLevel(LogOptions::fromConfig().level);
+        });
+        if (config.isHotReloadEnabled()) {
+            config.startWatching(std::chrono::seconds(std::max(config.getHotReloadIntervalSeconds(), 1)));
+        }
+        Tracer::getInstance().configure(TraceOptions::fromConfig());
+        AllocTracker::setEnabled(config.isAllocTrackingEnabled());
+        MetricsExporter metricsExporter(MetricsRegistry::getInstance(), MetricsExportOptions::fromConfig());
+        metricsExporter.start();
+        scheduleTask();
+    } catch (const std::exception& e) {
+        Logger::flush();
+        std::cerr << "錯誤: " << e.what() << std::endl;
+        return 1;
+    }
+    Config::getInstance().stopWatching();
+    Logger::flush();
     return 0;
 }
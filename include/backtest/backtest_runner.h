@@ -0,0 +1,60 @@
+#ifndef BACKTEST_RUNNER_H
+#define BACKTEST_RUNNER_H
+
+#include "backtest/market_history.h"
+#include "backtest/simulated_exchange.h"
+#include "scheduler/clock.h"
+#include "logger.h"
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BacktestOptions {
+    IClock::TimePoint start;   // 預設為歷史數據起點
+    IClock::TimePoint end;     // 預設為歷史數據終點
+    std::chrono::minutes reconcileInterval{60};
+    SimulationOptions simulation;
+    bool quiet = true;         // 回測期間抑制策略輸出
+};
+
+struct EquityPoint {
+    int64_t timestampMs;
+    double equity;
+};
+
+struct BacktestReport {
+    double initialEquity = 0.0;
+    double finalEquity = 0.0;
+    double pnl = 0.0;
+    double totalReturn = 0.0;
+    double maxDrawdown = 0.0;     // 相對高點的最大回撤比例
+    double fundingIncome = 0.0;
+    double fees = 0.0;
+    double turnover = 0.0;        // 成交名義價值
+    int orders = 0;
+    int rejectedOrders = 0;
+    int settlements = 0;
+    int64_t startMs = 0;
+    int64_t endMs = 0;
+    std::vector<EquityPoint> equityCurve;  // 每次結算後取樣
+
+    void print(std::ostream& out) const;
+    bool writeJson(const std::string& path) const;
+};
+
+// 以虛擬時鐘驅動正式的策略排程與 TradingModule, 對模擬交易所回放歷史數據。
+// 沒有實際等待, 數月的數據可在數秒內完成
+class BacktestRunner {
+public:
+    explicit BacktestRunner(std::shared_ptr<const MarketHistory> history);
+
+    BacktestReport run(const BacktestOptions& options);
+
+private:
+    std::shared_ptr<const MarketHistory> history;
+    Logger logger;
+};
+
+#endif // BACKTEST_RUNNER_H
@@ -0,0 +1,66 @@
+#ifndef MARKET_HISTORY_H
+#define MARKET_HISTORY_H
+
+#include "trading/order_book.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct FundingPoint {
+    int64_t timestampMs;
+    double rate;
+};
+
+struct TickerPoint {
+    int64_t timestampMs;
+    double spotPrice;
+    double contractPrice;
+};
+
+struct BookSnapshot {
+    int64_t timestampMs;
+    std::vector<BookLevel> bids;
+    std::vector<BookLevel> asks;
+};
+
+struct SymbolHistory {
+    std::vector<FundingPoint> funding;     // 按時間升序
+    std::vector<TickerPoint> tickers;
+    std::vector<BookSnapshot> spotBooks;
+    std::vector<BookSnapshot> contractBooks;
+};
+
+// 回測用的歷史市場數據。載入後只讀, 可在多個回測之間共享。
+//
+// 目錄格式 (時間戳為 UTC 毫秒, 首行可為表頭):
+//   funding/<SYMBOL>.csv        timestamp_ms,funding_rate
+//   tickers/<SYMBOL>.csv        timestamp_ms,spot_price,contract_price
+//   books/<SYMBOL>_spot.csv     timestamp_ms,bids,asks   (價格:數量;價格:數量 ...)
+//   books/<SYMBOL>_linear.csv   同上
+class MarketHistory {
+public:
+    static std::shared_ptr<const MarketHistory> loadFromDirectory(const std::string& directory);
+
+    // 建立數據後需調用 finalize() 排序
+    SymbolHistory& symbol(const std::string& name) { return data[name]; }
+    void finalize();
+
+    const SymbolHistory* find(const std::string& name) const;
+    std::vector<std::string> symbols() const;
+    int64_t firstTimestamp() const;
+    int64_t lastTimestamp() const;
+
+    // 以下查詢只返回 timestampMs 當下或之前的數據, 避免前視偏差
+    const TickerPoint* tickerAt(const std::string& name, int64_t timestampMs) const;
+    const FundingPoint* fundingAt(const std::string& name, int64_t timestampMs) const;
+    // 最新在前, 最多 limit 筆
+    std::vector<double> fundingBefore(const std::string& name, int64_t timestampMs, size_t limit) const;
+    const BookSnapshot* bookAt(const std::string& name, bool spot, int64_t timestampMs) const;
+
+private:
+    std::map<std::string, SymbolHistory> data;
+};
+
+#endif // MARKET_HISTORY_H
@@ -0,0 +1,139 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include "backtest/market_history.h"
+#include "scheduler/clock.h"
+#include "scheduler/settlement_calendar.h"
+#include "trading/funding_scorer.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+#include <json/json.h>
+
+// 一組待評估的策略參數
+struct SweepParams {
+    ScoringParams scoring;
+    PositionSizing sizing;
+
+    std::string describe() const;
+};
+
+struct SweepCosts {
+    double initialCapital = 10000.0;
+    double spotFeeRate = 0.001;
+    double contractFeeRate = 0.00055;
+    int leverage = 1;
+    // 與 RebalancePlanner 相同的最小調整門檻, 避免微小偏差造成換手
+    double minOrderValue = 5.0;
+    double minDeltaRatio = 0.003;
+};
+
+// 預先計算每個結算前決策時點的資金費率窗口與價格, 建立後只讀,
+// 由所有工作線程共用, 評估時不再查詢 MarketHistory
+class SweepDataset {
+public:
+    static std::shared_ptr<const SweepDataset> build(const MarketHistory& history,
+                                                     const SettlementCalendar& calendar,
+                                                     IClock::TimePoint start,
+                                                     IClock::TimePoint end,
+                                                     int maxLookback);
+
+    size_t stepCount() const { return decisionTimes.size(); }
+    size_t symbolCount() const { return symbolNames.size(); }
+    const std::vector<std::string>& symbols() const { return symbolNames; }
+    int64_t decisionTime(size_t step) const { return decisionTimes[step]; }
+
+    // 決策時點可見的資金費率, 最新在前
+    std::span<const double> fundingWindow(size_t step, size_t symbol) const;
+    double spotPrice(size_t step, size_t symbol) const { return spotPrices[index(step, symbol)]; }
+    double contractPrice(size_t step, size_t symbol) const { return contractPrices[index(step, symbol)]; }
+    // 緊接決策時點之後的結算所使用的費率
+    double settledRate(size_t step, size_t symbol) const { return settledRates[index(step, symbol)]; }
+
+private:
+    size_t index(size_t step, size_t symbol) const { return step * symbolNames.size() + symbol; }
+
+    int lookback = 0;
+    std::vector<std::string> symbolNames;
+    std::vector<int64_t> decisionTimes;
+    std::vector<double> windows;         // [step][symbol][lookback]
+    std::vector<int> windowSizes;        // [step][symbol]
+    std::vector<double> spotPrices;
+    std::vector<double> contractPrices;
+    std::vector<double> settledRates;
+};
+
+struct SweepResult {
+    size_t candidate = 0;          // 在候選列表中的位置
+    double finalEquity = 0.0;
+    double totalReturn = 0.0;
+    double maxDrawdown = 0.0;
+    double fundingIncome = 0.0;
+    double fees = 0.0;
+    double turnover = 0.0;
+    int trades = 0;
+    double objective = 0.0;        // 排名用: 報酬 - 回撤懲罰
+    bool paretoOptimal = false;    // 沒有其他組合同時有更高報酬及更低回撤
+};
+
+// 參數搜索空間. 每個維度可為數值陣列, 或 {"min", "max", "step"} 範圍
+// (網格搜索按 step 展開, 隨機搜索在 [min, max] 內均勻取樣)
+struct SweepSpace {
+    struct Dimension {
+        std::vector<double> values;
+        double min = 0.0;
+        double max = 0.0;
+        double step = 0.0;
+        bool isRange = false;
+
+        bool empty() const { return values.empty() && !isRange; }
+        std::vector<double> gridValues() const;
+    };
+
+    std::vector<std::vector<int>> periods;
+    std::vector<std::vector<double>> weights;
+    Dimension scalingFactor;
+    Dimension minScalingRate;
+    Dimension maxScalingRate;
+    Dimension topPairsCount;
+
+    static SweepSpace fromJson(const Json::Value& root);
+    static SweepSpace loadFromFile(const std::string& path);
+
+    // 未指定的維度沿用 base 的參數; 無效組合 (週期與權重長度不符、
+    // 最小縮放費率大於最大值) 會被略過
+    std::vector<SweepParams> grid(const SweepParams& base) const;
+    std::vector<SweepParams> random(const SweepParams& base, size_t count, uint32_t seed) const;
+};
+
+// 以所有 CPU 核心並行評估參數組合
+class ParameterSweep {
+public:
+    using ProgressCallback = std::function<void(size_t done, size_t total)>;
+
+    ParameterSweep(std::shared_ptr<const SweepDataset> dataset, SweepCosts costs);
+
+    // 在單一線程內評估一組參數, 不讀取全域配置, 可並行調用
+    SweepResult evaluate(const SweepParams& params) const;
+
+    // threads 為 0 時使用 hardware_concurrency; 結果按候選順序返回
+    std::vector<SweepResult> run(const std::vector<SweepParams>& candidates,
+                                 unsigned threads = 0,
+                                 ProgressCallback progress = nullptr) const;
+
+    // 計算排名目標及 Pareto 前沿, 並按目標值降序排列
+    static void rank(std::vector<SweepResult>& results, double drawdownPenalty);
+    static void writeCsv(std::ostream& out,
+                         const std::vector<SweepResult>& results,
+                         const std::vector<SweepParams>& candidates);
+
+private:
+    std::shared_ptr<const SweepDataset> dataset;
+    SweepCosts costs;
+};
+
+#endif // PARAMETER_SWEEP_H
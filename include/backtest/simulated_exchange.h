@@ -0,0 +1,109 @@
+#ifndef SIMULATED_EXCHANGE_H
+#define SIMULATED_EXCHANGE_H
+
+#include "backtest/market_history.h"
+#include "exchange/exchange_interface.h"
+#include "exchange/order_retry.h"
+#include "scheduler/clock.h"
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+struct SimulationOptions {
+    double initialCapital = 10000.0;    // 初始 USDT
+    double spotFeeRate = 0.001;
+    double contractFeeRate = 0.00055;
+    size_t fundingHistoryLimit = 21;    // getFundingHistory 返回的最大筆數
+    // 沒有錄製訂單簿時, 以行情價格合成訂單簿
+    int syntheticLevels = 50;
+    double syntheticLevelNotional = 5000.0;  // 每層深度 (USDT)
+    double syntheticTickRatio = 0.0001;      // 每層價格間距 (相對價格)
+    double maintenanceMarginRate = 0.005;
+};
+
+struct SimulationStats {
+    double fees = 0.0;
+    double turnover = 0.0;        // 成交名義價值
+    double fundingIncome = 0.0;
+    int orders = 0;
+    int rejectedOrders = 0;
+    int settlements = 0;
+};
+
+// 以歷史數據模擬的交易所: 行情按虛擬時鐘取當下或之前的數據, 市價單按
+// 錄製 (或合成) 的訂單簿成交, 並在結算時間按持倉結算資金費率
+class SimulatedExchange : public IExchange {
+public:
+    SimulatedExchange(std::shared_ptr<const MarketHistory> history,
+                      IClock& clock,
+                      const SimulationOptions& options = SimulationOptions());
+
+    std::vector<std::pair<std::string, double>> getFundingRates() override;
+    double getSpotPrice(const std::string& symbol) override;
+    double getTotalEquity() override;
+    Json::Value getPositions(const std::string& symbol = "") override;
+    std::vector<std::string> getInstruments(const std::string& category = "linear") override;
+    bool setLeverage(const std::string& symbol, int leverage) override;
+    Json::Value createOrder(const std::string& symbol,
+                            const std::string& side,
+                            double qty,
+                            const std::string& category = "linear",
+                            const std::string& orderType = "Market",
+                            const std::string& orderLinkId = "") override;
+    bool createSpotOrder(const std::string& symbol,
+                         const std::string& side,
+                         double qty,
+                         const std::string& orderLinkId = "") override;
+    Json::Value getOrderByLinkId(const std::string& category, const std::string& orderLinkId) override;
+    void closePosition(const std::string& symbol) override;
+    std::string getLastError() override;
+    Json::Value getSpotBalances() override;
+    double getSpotBalance(const std::string& symbol) override;
+    std::vector<std::pair<std::string, std::vector<double>>> getFundingHistory(
+        const std::vector<std::string>& symbols = {}) override;
+    // 回測的歷史已在內存中, 不寫入本地時間序列: 返回空, 評分使用 getFundingHistory
+    std::vector<FundingRecord> getFundingRecords(const std::vector<std::string>& symbols) override;
+    double getContractPrice(const std::string& symbol) override;
+    Json::Value getSpotOrderBook(const std::string& symbol) override;
+    Json::Value getContractOrderBook(const std::string& symbol) override;
+    std::optional<double> getCurrentFundingRate(const std::string& symbol) override;
+    double getSpotFeeRate() override;
+    double getContractFeeRate() override;
+    double getMarginRatio(const std::string& symbol) override;
+
+    // 在當前虛擬時間結算資金費率: 多頭支付、空頭收取 (費率為正時)
+    void settleFunding();
+    const SimulationStats& stats() const { return simulationStats; }
+    double cashBalance() const { return cash; }
+
+private:
+    struct PerpPosition {
+        double size = 0.0;        // 帶符號, 負數為空單
+        double entryPrice = 0.0;
+    };
+
+    int64_t nowMs() const;
+    std::vector<BookLevel> bookSide(const std::string& symbol, bool spot, bool buy) const;
+    Json::Value bookJson(const std::string& symbol, bool spot) const;
+    // 按訂單簿逐層成交, 返回成交均價; 深度不足時剩餘數量按最後一層價格成交
+    double fillPrice(const std::vector<BookLevel>& levels, double qty) const;
+    Json::Value reject(const std::string& message, int retCode = 10001);
+    // 與交易所相同, 拒絕已成交訂單用過的客戶端訂單號
+    bool duplicateOrderLinkId(const std::string& orderLinkId);
+    // 記錄帶客戶端訂單號的成交訂單, 供 getOrderByLinkId 查詢; 返回交易所訂單號
+    std::string recordOrder(const std::string& category, const std::string& symbol, const std::string& side,
+                            double qty, double price, const std::string& orderLinkId);
+
+    std::shared_ptr<const MarketHistory> history;
+    IClock& clock;
+    SimulationOptions options;
+    SimulationStats simulationStats;
+    double cash;
+    std::map<std::string, double> spotHoldings;
+    std::map<std::string, PerpPosition> perpPositions;
+    std::string lastError;
+    uint64_t nextOrderId = 1;
+    std::unordered_map<std::string, Json::Value> ordersByLinkId;
+};
+
+#endif // SIMULATED_EXCHANGE_H
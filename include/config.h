@@ -4,39 +4,175 @@
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <unordered_set>
+#include <filesystem>
+#include <cstdint>
 #include <json/json.h>
 
+// 配置快照: 載入時一次性編譯成強型別欄位, 之後不可修改.
+// 熱路徑透過 Config::snapshot() 取得 shared_ptr 後直接讀取欄位, 不走 Json 樹也不配置記憶體.
+struct ConfigSnapshot {
+    uint64_t version = 0;
+
+    // 交易所
+    std::string preferredExchange;
+    std::string bybitApiKey;
+    std::string bybitApiSecret;
+    std::string bybitBaseUrl;
+    int defaultLeverage = 0;
+    bool spotMarginTrading = false;
+
+    // 資金費率
+    bool reverseContractFundingRate = false;
+    bool useCoinMarketCap = false;
+    std::string cmcApiKey;
+    int cmcTopCount = 0;
+    std::string cmcSortBy;
+    std::vector<std::string> settlementTimesUTC;
+    int preSettlementMinutes = 0;
+    int postSettlementMinutes = 0;
+    std::vector<int> fundingPeriods;
+    std::vector<double> fundingWeights;
+    int fundingHistoryDays = 0;
+    int fundingHoldingDays = 0;
+    double minScalingRate = 0.0;
+    double maxScalingRate = 0.0;
+    bool positionScaling = false;
+    double scalingFactor = 0.0;
+
+    // 交易
+    int checkIntervalMinutes = 0;
+    int topPairsCount = 0;
+    std::vector<std::string> tradingPairs;
+    double minPositionValue = 0.0;
+    double maxPositionValue = 0.0;
+    std::vector<std::string> unsupportedSymbols;
+    std::unordered_set<std::string> unsupportedSet;
+
+    // 切片執行
+    bool slicedExecution = false;
+    double maxSliceImpact = 0.0;
+    int maxSlices = 0;
+    int sliceIntervalMs = 0;
+    std::string sliceTrigger;
+    int replenishTimeoutMs = 0;
+
+    // 只在啟動時讀取的區塊 (日誌, 指標, 追蹤) 保留原始 Json
+    Json::Value config;
+    Json::Value pairList;
+
+    bool isUnsupported(const std::string& symbol) const {
+        return unsupportedSet.count(symbol) > 0;
+    }
+
+    static std::shared_ptr<const ConfigSnapshot> build(const Json::Value& config,
+                                                       const Json::Value& pairList,
+                                                       uint64_t version);
+    // 以 overrides 逐層覆蓋原始配置後重新建立快照, 版本號不變
+    std::shared_ptr<const ConfigSnapshot> withOverrides(const Json::Value& overrides) const;
+};
+
+// 子帳戶: 各自的憑證及覆蓋配置, 行情數據由所有帳戶共用
+struct AccountConfig {
+    std::string name;       // 空字串表示單一帳戶模式 (使用 exchanges.bybit 的憑證)
+    std::string apiKey;
+    std::string apiSecret;
+    std::string baseUrl;
+    Json::Value overrides;  // 與 config.json 結構相同的局部配置, 例如 {"trading": {"max_position_value": 500}}
+};
+
 class Config {
+public:
+    using Snapshot = std::shared_ptr<const ConfigSnapshot>;
+    using ReloadListener = std::function<void(const ConfigSnapshot&)>;
+
 private:
     static std::unique_ptr<Config> instance;
     static std::mutex mutex_;
-    Json::Value config;
-    Json::Value pair_list;
-    
+    static std::once_flag initFlag;
+
+    // 以 std::atomic_load/atomic_store 發布, 讀取端不加鎖
+    Snapshot current;
+
+    std::mutex reloadMutex;   // 序列化 reload 及監聽器註冊
+    std::vector<ReloadListener> listeners;
+    std::filesystem::file_time_type configMtime{};
+    std::filesystem::file_time_type pairListMtime{};
+
+    std::thread watcher;
+    std::mutex watchMutex;
+    std::condition_variable watchCv;
+    bool watching = false;
+
     Config();
-    void loadConfigFiles();
     void loadFile(const std::string& filename, Json::Value& target);
+    bool filesChanged();
+    void notify(const std::vector<ReloadListener>& toNotify, const ConfigSnapshot& snap);
+    void watchLoop(std::chrono::milliseconds interval);
 
 public:
+    static constexpr const char* CONFIG_FILE = "config/config.json";
+    static constexpr const char* PAIR_LIST_FILE = "config/pair_list.json";
+
     static Config& getInstance();
-    
+    ~Config();
+
+    // 當前快照 (當前線程有 ConfigSnapshotScope 時為其指定的快照).
+    // 持有返回值期間內容不會改變, 重新載入只會替換指標
+    Snapshot snapshot() const;
+
+    // 以新快照取代當前快照並通知監聽器
+    void publish(Snapshot next);
+
+    // 重新讀取配置文件. 解析失敗時保留原快照並返回 false
+    bool reload();
+
+    // 重新載入成功後於發布線程上調用
+    void onReload(ReloadListener listener);
+
+    // 背景線程定期檢查文件修改時間, 有變更時重新載入
+    void startWatching(std::chrono::milliseconds interval);
+    void stopWatching();
+
+    // 熱重載相關配置
+    bool isHotReloadEnabled() const;
+    int getHotReloadIntervalSeconds() const;
+
     // 交易所相關配置
     std::string getPreferredExchange() const;
     bool isExchangeEnabled(const std::string& exchange) const;
     std::string getBybitApiKey() const;
     std::string getBybitApiSecret() const;
     std::string getBybitBaseUrl() const;
+    // 未配置 accounts 時返回單一預設帳戶
+    std::vector<AccountConfig> getAccounts() const;
     int getDefaultLeverage() const;
     bool isSpotMarginTradingEnabled() const;
-    
+
     // 資金費率相關配置
     bool getReverseContractFundingRate() const;
     bool getUseCoinMarketCap() const;
     std::string getCMCApiKey() const;
     int getCMCTopCount() const;
+    std::string getCMCBaseUrl() const;
+    bool hasCMCCacheConfig() const;
+    std::string getCMCCachePath() const;
+    int getCMCCacheTtlMinutes() const;
+    int getCMCRetryMinutes() const;
     std::string getCMCSortBy() const;
+    // 資金費率歸檔文件, 未設定時為空
+    std::string getFundingArchivePath() const;
+    bool hasWarmStateConfig() const;
+    std::string getWarmStatePath() const;
+    int getWarmStateMaxAgeMinutes() const;
     std::vector<std::string> getSettlementTimesUTC() const;
     int getPreSettlementMinutes() const;
+    int getPostSettlementMinutes() const;
     std::vector<int> getFundingPeriods() const;
     std::vector<double> getFundingWeights() const;
     int getFundingHistoryDays() const;
@@ -53,4 +189,109 @@ public:
     double getMinPositionValue() const;
     double getMaxPositionValue() const;
     std::vector<std::string> getUnsupportedSymbols() const;
-}; 
\ No newline at end of file
+
+    // 切片執行相關配置
+    bool isSlicedExecutionEnabled() const;
+    double getMaxSliceImpact() const;
+    int getMaxSlices() const;
+    int getSliceIntervalMs() const;
+    std::string getSliceTrigger() const;
+    int getReplenishTimeoutMs() const;
+
+    // 不支持交易對封鎖相關配置
+    bool hasSymbolBlockConfig() const;
+    int getSymbolBlockTtlHours() const;
+    int getSymbolBlockFlushIntervalMs() const;
+
+    // 保證金風險監控相關配置
+    bool hasRiskMonitorConfig() const;
+    bool isRiskMonitorEnabled() const;
+    int getRiskPollIntervalMs() const;
+    double getRiskMaintenanceMarginRate() const;
+    double getRiskWarnRatio() const;
+    double getRiskDeleverageRatio() const;
+    double getRiskDeleverageFraction() const;
+    int getRiskCooldownSeconds() const;
+    bool hasMarketDataConfig() const;
+    int getMarketTickerTtlMs() const;
+    int getMarketBookTtlMs() const;
+    int getMarketFundingTtlSeconds() const;
+    int getMarketInstrumentsTtlSeconds() const;
+    int getMarketDisplayMaxAgeSeconds() const;
+    bool hasBasisTrackerConfig() const;
+    bool isBasisGatingEnabled() const;
+    int getBasisPollIntervalMs() const;
+    int getBasisWindow() const;
+    int getBasisMaxSkewMs() const;
+    int getBasisMaxAgeMs() const;
+    int getBasisMinSamples() const;
+    double getBasisEwmaAlpha() const;
+    double getBasisEntryPercentile() const;
+    double getBasisExitPercentile() const;
+    int getBasisMaxExitDelaySeconds() const;
+
+    // 多線程運行時 (行情/策略/執行流水線) 相關配置
+    bool hasPipelineConfig() const;
+    bool isPipelineEnabled() const;
+    int getPipelineQueueCapacity() const;
+    bool isPipelineBusyPoll() const;
+    int getPipelineIdleWaitUs() const;
+    int getPipelineMarketDataCpu() const;  // 未設定時為 -1, 表示不綁定
+    int getPipelineStrategyCpu() const;
+    int getPipelineExecutionCpu() const;
+
+    // 請求超時及下單重試相關配置
+    bool hasOrderRetryConfig() const;
+    int getRequestTimeoutMs() const;
+    int getOrderTimeoutMs() const;
+    int getConnectTimeoutMs() const;
+    int getOrderMaxAttempts() const;
+
+    // 請求頻率額度相關配置
+    bool hasRateLimitConfig() const;
+    bool isRateLimitEnabled() const;
+    double getRateLimitPublicPerSecond() const;
+    double getRateLimitPrivatePerSecond() const;
+    double getRateLimitBurstSeconds() const;
+    double getRateLimitRiskReserve() const;
+    double getRateLimitMarketDataReserve() const;
+    double getRateLimitDisplayReserve() const;
+
+    // 日誌相關配置
+    bool hasLoggingConfig() const;
+    std::string getLogLevel() const;
+    bool isConsoleLogEnabled() const;
+    std::string getLogFile() const;
+    std::string getBinaryLogFile() const;
+    int getLogMaxFileSizeMB() const;
+    int getLogMaxFiles() const;
+    int getLogQueueSize() const;
+    std::string getLogOverflowPolicy() const;
+
+    // 指標輸出相關配置
+    bool hasMetricsConfig() const;
+    int getMetricsHttpPort() const;
+    std::string getMetricsBindAddress() const;
+    std::string getMetricsFile() const;
+    int getMetricsFileIntervalSeconds() const;
+    bool isAllocTrackingEnabled() const;
+
+    // 追蹤相關配置
+    bool hasTracingConfig() const;
+    bool isTracingEnabled() const;
+    std::string getTraceOutputDir() const;
+    int getTraceMaxEventsPerCycle() const;
+};
+
+// 在作用域內讓當前線程的 Config::snapshot() 及各個 getter 改讀指定快照, 可以嵌套.
+// 用於以子帳戶合併後的配置建立各模組的 Options::fromConfig()
+class ConfigSnapshotScope {
+public:
+    explicit ConfigSnapshotScope(Config::Snapshot snapshot);
+    ~ConfigSnapshotScope();
+    ConfigSnapshotScope(const ConfigSnapshotScope&) = delete;
+    ConfigSnapshotScope& operator=(const ConfigSnapshotScope&) = delete;
+
+private:
+    Config::Snapshot previous;
+};
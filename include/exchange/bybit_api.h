@@ -2,26 +2,40 @@
 #define BYBIT_API_H
 
 #include "exchange_interface.h"
-#include <mutex>
-#include <memory>
+#include "exchange/order_retry.h"
+#include "exchange/request_budget.h"
+#include "config.h"
+#include <chrono>
+#include <map>
+#include <string>
 
+// 每組憑證一個實例; 多帳戶時公共行情經 MarketDataHub 共用, 各實例只負責私有請求.
+// 每個請求發出前按優先級 (RequestPriorityScope, 未設定時按 endpoint) 取得請求額度
 class BybitAPI : public IExchange {
 private:
-    static std::mutex mutex_;
-    static std::unique_ptr<BybitAPI> instance;
     const std::string API_KEY;
     const std::string API_SECRET;
     const std::string BASE_URL;
     std::string lastError;
-    BybitAPI();
+    OrderRetryOptions retryOptions;
+    const RequestBudgetOptions budgetOptions;
+    // 私有請求按帳戶限頻; 公共行情按 IP 限頻, 額度在進程內共用
+    RequestBudget privateBudget;
 
     static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp);
     std::string generateSignature(const std::string& params, const std::string& timestamp);
+    // timeout 為 0 時使用一般請求超時
     Json::Value makeRequest(const std::string& endpoint, const std::string& method, 
-                          const std::map<std::string, std::string>& params = {});
+                          const std::map<std::string, std::string>& params = {},
+                          std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+    // 發送下單請求; 帶 orderLinkId 時以短超時發送, 狀態不明時按訂單號確認後重發
+    Json::Value submitOrder(const std::map<std::string, std::string>& params);
+
+    // 基準測試 (benchmarks/) 直接調用內部熱路徑
+    friend struct BenchmarkAccess;
 
 public:
-    static BybitAPI& getInstance();
+    explicit BybitAPI(const AccountConfig& account);
 
     // 實現 IExchange 介面
     std::vector<std::pair<std::string, double>> getFundingRates() override;
@@ -33,10 +47,12 @@ public:
                           const std::string& side, 
                           double qty,
                           const std::string& category = "linear",
-                          const std::string& orderType = "Market") override;
+                          const std::string& orderType = "Market",
+                          const std::string& orderLinkId = "") override;
     bool createSpotOrder(const std::string& symbol, 
                         const std::string& side, 
-                        double qty) override;
+                        double qty,
+                        const std::string& orderLinkId = "") override;
     void closePosition(const std::string& symbol) override;
     std::vector<std::string> getInstruments(const std::string& category = "linear") override;
     Json::Value getSpotBalances() override;
@@ -44,13 +60,17 @@ public:
     std::string getLastError() override;
     std::vector<std::pair<std::string, std::vector<double>>> getFundingHistory(
         const std::vector<std::string>& symbols = {}) override;
+    std::vector<FundingRecord> getFundingRecords(const std::vector<std::string>& symbols) override;
     double getContractPrice(const std::string& symbol) override;
     Json::Value getSpotOrderBook(const std::string& symbol) override;
     Json::Value getContractOrderBook(const std::string& symbol) override;
-    double getCurrentFundingRate(const std::string& symbol) override;
+    std::optional<double> getCurrentFundingRate(const std::string& symbol) override;
     double getSpotFeeRate() override;
     double getContractFeeRate() override;
     double getMarginRatio(const std::string& symbol) override;
+
+    // 按客戶端訂單號查詢訂單 (先查活動訂單, 再查歷史), 找不到或請求失敗時返回 null
+    Json::Value getOrderByLinkId(const std::string& category, const std::string& orderLinkId) override;
 };
 
 #endif // BYBIT_API_H
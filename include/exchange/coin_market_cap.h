@@ -0,0 +1,39 @@
+#ifndef COIN_MARKET_CAP_H
+#define COIN_MARKET_CAP_H
+
+#include "trading/universe_provider.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// CoinMarketCap listings 接口. baseUrl 可指向本地替身服務 (測試用)
+class CoinMarketCapSource : public IUniverseSource {
+public:
+    static constexpr const char* DEFAULT_BASE_URL = "https://pro-api.coinmarketcap.com";
+
+    CoinMarketCapSource(const std::string& baseUrl, const std::string& apiKey, long timeoutSeconds = 15);
+    ~CoinMarketCapSource() override;
+    CoinMarketCapSource(const CoinMarketCapSource&) = delete;
+    CoinMarketCapSource& operator=(const CoinMarketCapSource&) = delete;
+
+    static std::unique_ptr<CoinMarketCapSource> fromConfig();
+
+    bool fetch(int topCount, const std::string& sortBy,
+               std::vector<std::string>& symbols, std::string& error) override;
+
+    // 解析 listings 響應; status.error_code 非 0 (例如額度用完) 視為失敗
+    static bool parseListings(const std::string& body, int topCount,
+                              std::vector<std::string>& symbols, std::string& error);
+
+private:
+    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
+
+    std::string baseUrl;
+    std::string apiKey;
+    long timeoutSeconds;
+    std::mutex curlMutex;
+    void* curl = nullptr;   // 複用同一個 CURL 句柄以保留連線
+};
+
+#endif // COIN_MARKET_CAP_H
@@ -4,20 +4,22 @@
 #include "exchange_interface.h"
 #include "bybit_api.h"
 #include "config.h"
+#include <memory>
 #include <stdexcept>
 
 class ExchangeFactory {
 public:
-    static IExchange& createExchange() {
+    // 每個帳戶 (憑證) 建立一個實例
+    static std::unique_ptr<IExchange> createExchange(const AccountConfig& account) {
         const auto& config = Config::getInstance();
         std::string exchangeName = config.getPreferredExchange();
         
         if (exchangeName == "BYBIT" && config.isExchangeEnabled("bybit")) {
-            return BybitAPI::getInstance();
+            return std::make_unique<BybitAPI>(account);
         }
         // 之後可以添加其他交易所的支援
         // else if (exchangeName == "BINANCE" && config.isExchangeEnabled("binance")) {
-        //     return BinanceAPI::getInstance();
+        //     return std::make_unique<BinanceAPI>(account);
         // }
         
         throw std::runtime_error("不支援或未啟用的交易所: " + exchangeName);
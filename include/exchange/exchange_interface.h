@@ -1,10 +1,12 @@
 #ifndef EXCHANGE_INTERFACE_H
 #define EXCHANGE_INTERFACE_H
 
+#include "storage/funding_series.h"
 #include <string>
 #include <vector>
 #include <utility>
 #include <json/json.h>
+#include <optional>
 
 class IExchange {
 public:
@@ -17,16 +19,22 @@ public:
     virtual Json::Value getPositions(const std::string& symbol = "") = 0;
     virtual std::vector<std::string> getInstruments(const std::string& category = "linear") = 0;
 
-    // 交易操作
+    // 交易操作. orderLinkId 為客戶端訂單號, 非空時交易所拒絕重複的訂單號,
+    // 因此同一筆訂單可以用相同的訂單號安全重試
     virtual bool setLeverage(const std::string& symbol, int leverage) = 0;
     virtual Json::Value createOrder(const std::string& symbol, 
                                   const std::string& side, 
                                   double qty,
                                   const std::string& category = "linear",
-                                  const std::string& orderType = "Market") = 0;
+                                  const std::string& orderType = "Market",
+                                  const std::string& orderLinkId = "") = 0;
     virtual bool createSpotOrder(const std::string& symbol, 
                                const std::string& side, 
-                               double qty) = 0;
+                               double qty,
+                               const std::string& orderLinkId = "") = 0;
+    // 按客戶端訂單號查詢訂單 (symbol, side, qty, cumExecQty, avgPrice, orderStatus 等, 數值為字串);
+    // 查不到時返回 null
+    virtual Json::Value getOrderByLinkId(const std::string& category, const std::string& orderLinkId) = 0;
     virtual void closePosition(const std::string& symbol) = 0;
     virtual std::string getLastError() = 0;
 
@@ -35,10 +43,14 @@ public:
     virtual double getSpotBalance(const std::string& symbol) = 0;
     virtual std::vector<std::pair<std::string, std::vector<double>>> getFundingHistory(
         const std::vector<std::string>& symbols = {}) = 0;
+    // 帶結算時間的資金費率歷史 (每個幣種最新在前), 供寫入本地時間序列後評分.
+    // 不需要存檔的實現 (例如回測) 返回空, 調用方改用 getFundingHistory
+    virtual std::vector<FundingRecord> getFundingRecords(const std::vector<std::string>& symbols) = 0;
     virtual double getContractPrice(const std::string& symbol) = 0;
     virtual Json::Value getSpotOrderBook(const std::string& symbol) = 0;
     virtual Json::Value getContractOrderBook(const std::string& symbol) = 0;
-    virtual double getCurrentFundingRate(const std::string& symbol) = 0;
+    // 請求或解析失敗時返回空, 與 0 費率區分
+    virtual std::optional<double> getCurrentFundingRate(const std::string& symbol) = 0;
     virtual double getSpotFeeRate() = 0;
     virtual double getContractFeeRate() = 0;
     virtual double getMarginRatio(const std::string& symbol) = 0;
@@ -0,0 +1,199 @@
+#ifndef MARKET_DATA_HUB_H
+#define MARKET_DATA_HUB_H
+
+#include "exchange/exchange_interface.h"
+#include "exchange/request_budget.h"
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct MarketDataOptions {
+    std::chrono::milliseconds tickerTtl{1000};   // 最新價及當前資金費率
+    std::chrono::milliseconds bookTtl{250};      // 訂單簿
+    std::chrono::seconds fundingTtl{60};         // 資金費率列表及歷史
+    std::chrono::seconds instrumentsTtl{3600};   // 交易對列表
+    std::chrono::seconds displayMaxAge{30};      // 顯示/報表優先級的請求沿用此時間內的緩存, 不另發請求
+
+    static MarketDataOptions fromConfig();
+};
+
+// 帶有效期的緩存: 同一鍵同時只有一個請求在途, 其他調用方等待同一個結果.
+// 在途請求的優先級低於調用方時不合併 (例如下單不等顯示的請求取得額度), 調用方另發請求,
+// 之後到達的調用方改為等待這個更高優先級的請求.
+// accept 為 false 的結果 (請求失敗) 只交給在途的等待方, 不寫入緩存
+template <typename T>
+class TtlCache {
+public:
+    enum class Outcome { Hit, Shared, Fetched };
+
+    template <typename Fetch, typename Accept>
+    T get(const std::string& key, std::chrono::milliseconds ttl, Fetch&& fetch, Accept&& accept,
+          Outcome* outcome = nullptr) {
+        std::unique_lock<std::mutex> lock(mutex);
+        Slot& slot = slots[key];
+        if (slot.valid && std::chrono::steady_clock::now() - slot.fetchedAt < ttl) {
+            if (outcome) *outcome = Outcome::Hit;
+            return slot.value;
+        }
+        const RequestPriority priority = currentRequestPriority(RequestPriority::MarketData);
+        if (slot.inFlight && slot.pendingPriority <= priority) {
+            std::shared_future<T> pending = slot.pending;
+            lock.unlock();
+            if (outcome) *outcome = Outcome::Shared;
+            return pending.get();
+        }
+        std::promise<T> promise;
+        slot.pending = promise.get_future().share();
+        slot.pendingPriority = priority;
+        slot.inFlight = true;
+        const uint64_t generation = ++slot.generation;
+        lock.unlock();
+        if (outcome) *outcome = Outcome::Fetched;
+
+        T value;
+        try {
+            value = fetch();
+        } catch (...) {
+            lock.lock();
+            finish(slots[key], generation);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+        lock.lock();
+        Slot& done = slots[key];
+        finish(done, generation);
+        // 較晚發出的請求已先完成時, 不以較舊的結果覆蓋
+        if (accept(value) && generation > done.valueGeneration) {
+            done.value = value;
+            done.valueGeneration = generation;
+            done.fetchedAt = std::chrono::steady_clock::now();
+            done.valid = true;
+        }
+        promise.set_value(value);
+        return value;
+    }
+
+private:
+    struct Slot {
+        T value{};
+        std::chrono::steady_clock::time_point fetchedAt;
+        bool valid = false;
+        bool inFlight = false;
+        std::shared_future<T> pending;
+        RequestPriority pendingPriority = RequestPriority::Display;
+        uint64_t generation = 0;  // 被更高優先級的請求取代後, 舊請求完成時不清除在途狀態
+        uint64_t valueGeneration = 0;
+    };
+
+    static void finish(Slot& slot, uint64_t generation) {
+        if (slot.generation == generation) {
+            slot.inFlight = false;
+        }
+    }
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Slot> slots;
+};
+
+// 所有帳戶共用的行情層: 公共數據只經由一個交易所實例請求, 按類型設定有效期緩存
+// 並合併同時到達的相同請求, 子帳戶數量增加時不再放大公共請求
+class MarketDataHub {
+public:
+    MarketDataHub(IExchange& source, const MarketDataOptions& options);
+    MarketDataHub(const MarketDataHub&) = delete;
+    MarketDataHub& operator=(const MarketDataHub&) = delete;
+
+    std::vector<std::pair<std::string, double>> getFundingRates();
+    std::vector<std::pair<std::string, std::vector<double>>> getFundingHistory(
+        const std::vector<std::string>& symbols);
+    std::vector<FundingRecord> getFundingRecords(const std::vector<std::string>& symbols);
+    double getSpotPrice(const std::string& symbol);
+    double getContractPrice(const std::string& symbol);
+    std::optional<double> getCurrentFundingRate(const std::string& symbol);
+    Json::Value getSpotOrderBook(const std::string& symbol);
+    Json::Value getContractOrderBook(const std::string& symbol);
+    std::vector<std::string> getInstruments(const std::string& category);
+
+private:
+    // 顯示/報表優先級的請求放寬有效期, 合併到策略已取得的結果
+    std::chrono::milliseconds ttlFor(std::chrono::milliseconds ttl) const;
+
+    IExchange& source;
+    MarketDataOptions options;
+
+    TtlCache<double> prices;
+    TtlCache<std::optional<double>> currentFundingRates;
+    TtlCache<Json::Value> books;
+    TtlCache<std::vector<std::pair<std::string, double>>> fundingRates;
+    TtlCache<std::vector<std::pair<std::string, std::vector<double>>>> fundingHistory;
+    TtlCache<std::vector<FundingRecord>> fundingRecords;
+    TtlCache<std::vector<std::string>> instruments;
+};
+
+// 單一子帳戶的交易所視圖: 公共行情轉發到共用的 MarketDataHub, 私有請求 (下單, 持倉, 餘額, 手續費率)
+// 使用該帳戶自己的交易所實例
+class AccountExchange : public IExchange {
+public:
+    AccountExchange(IExchange& account, MarketDataHub& hub) : account(account), hub(hub) {}
+
+    std::vector<std::pair<std::string, double>> getFundingRates() override { return hub.getFundingRates(); }
+    double getSpotPrice(const std::string& symbol) override { return hub.getSpotPrice(symbol); }
+    double getTotalEquity() override { return account.getTotalEquity(); }
+    Json::Value getPositions(const std::string& symbol = "") override { return account.getPositions(symbol); }
+    std::vector<std::string> getInstruments(const std::string& category = "linear") override {
+        return hub.getInstruments(category);
+    }
+
+    bool setLeverage(const std::string& symbol, int leverage) override {
+        return account.setLeverage(symbol, leverage);
+    }
+    Json::Value createOrder(const std::string& symbol, const std::string& side, double qty,
+                            const std::string& category = "linear",
+                            const std::string& orderType = "Market",
+                            const std::string& orderLinkId = "") override {
+        return account.createOrder(symbol, side, qty, category, orderType, orderLinkId);
+    }
+    bool createSpotOrder(const std::string& symbol, const std::string& side, double qty,
+                         const std::string& orderLinkId = "") override {
+        return account.createSpotOrder(symbol, side, qty, orderLinkId);
+    }
+    Json::Value getOrderByLinkId(const std::string& category, const std::string& orderLinkId) override {
+        return account.getOrderByLinkId(category, orderLinkId);
+    }
+    void closePosition(const std::string& symbol) override { account.closePosition(symbol); }
+    std::string getLastError() override { return account.getLastError(); }
+
+    Json::Value getSpotBalances() override { return account.getSpotBalances(); }
+    double getSpotBalance(const std::string& symbol) override { return account.getSpotBalance(symbol); }
+    std::vector<std::pair<std::string, std::vector<double>>> getFundingHistory(
+        const std::vector<std::string>& symbols = {}) override {
+        return hub.getFundingHistory(symbols);
+    }
+    std::vector<FundingRecord> getFundingRecords(const std::vector<std::string>& symbols) override {
+        return hub.getFundingRecords(symbols);
+    }
+    double getContractPrice(const std::string& symbol) override { return hub.getContractPrice(symbol); }
+    Json::Value getSpotOrderBook(const std::string& symbol) override { return hub.getSpotOrderBook(symbol); }
+    Json::Value getContractOrderBook(const std::string& symbol) override {
+        return hub.getContractOrderBook(symbol);
+    }
+    std::optional<double> getCurrentFundingRate(const std::string& symbol) override {
+        return hub.getCurrentFundingRate(symbol);
+    }
+    double getSpotFeeRate() override { return account.getSpotFeeRate(); }
+    double getContractFeeRate() override { return account.getContractFeeRate(); }
+    double getMarginRatio(const std::string& symbol) override { return account.getMarginRatio(symbol); }
+
+private:
+    IExchange& account;
+    MarketDataHub& hub;
+};
+
+#endif // MARKET_DATA_HUB_H
@@ -0,0 +1,43 @@
+#ifndef ORDER_RETRY_H
+#define ORDER_RETRY_H
+
+#include <chrono>
+#include <functional>
+#include <json/json.h>
+#include <string>
+
+// Bybit: 同一客戶端訂單號的訂單已被接受
+constexpr int ORDER_LINK_ID_DUPLICATE = 110072;
+// 多次嘗試後仍無法確認訂單是否成立 (本地使用, 非交易所錯誤碼)
+constexpr int ORDER_STATUS_UNKNOWN = -1;
+// 按訂單號查到的訂單與本次下單的交易對, 方向或數量不符 (本地使用)
+constexpr int ORDER_LINK_ID_MISMATCH = -2;
+// 按訂單號查到的訂單已撤銷, 未成交或只部分成交 (本地使用), 響應附帶 cumExecQty
+constexpr int ORDER_NOT_FILLED = -3;
+
+struct OrderRetryOptions {
+    std::chrono::milliseconds requestTimeout{10000};  // 一般請求的總超時
+    std::chrono::milliseconds orderTimeout{800};      // 下單及按訂單號查詢的總超時
+    std::chrono::milliseconds connectTimeout{500};
+    int maxAttempts = 3;                               // 帶訂單號的下單最多發送次數
+
+    static OrderRetryOptions fromConfig();
+};
+
+// 本次下單的內容, 用於核對按訂單號查到的訂單確實是這一筆
+struct OrderIntent {
+    std::string symbol;
+    std::string side;
+    double qty = 0.0;
+};
+
+// 以客戶端訂單號保證冪等的下單: 響應丟失或超時時先按訂單號查詢, 訂單已存在即視為成功,
+// 不存在則立即以相同訂單號重發; 交易所返回訂單號重複時同樣以查詢結果為準.
+// send 返回下單響應 (請求失敗時為 null); lookup 返回訂單記錄 (找不到或查詢失敗時為 null).
+// 查到的訂單須與 intent 一致且未被撤銷, 成功響應附帶其 cumExecQty 及 avgPrice.
+// 成功或明確拒絕 (其他非零 retCode) 直接返回; 始終無法確認時返回 ORDER_STATUS_UNKNOWN
+Json::Value submitIdempotentOrder(const std::string& orderLinkId, const OrderIntent& intent, int maxAttempts,
+                                  const std::function<Json::Value()>& send,
+                                  const std::function<Json::Value()>& lookup);
+
+#endif // ORDER_RETRY_H
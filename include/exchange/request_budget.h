@@ -0,0 +1,89 @@
+#ifndef REQUEST_BUDGET_H
+#define REQUEST_BUDGET_H
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// 請求優先級, 數值越小越優先: 下單 > 風險 (持倉, 保證金, 餘額) > 行情 > 顯示/報表
+enum class RequestPriority { OrderEntry, Risk, MarketData, Display };
+constexpr size_t REQUEST_PRIORITY_COUNT = 4;
+
+const char* toString(RequestPriority priority);
+
+// 按 endpoint 推斷的默認優先級
+RequestPriority defaultRequestPriority(const std::string& endpoint);
+
+// 當前線程的請求優先級: 未設定 RequestPriorityScope 時返回 fallback
+RequestPriority currentRequestPriority(RequestPriority fallback);
+
+// 在作用域內覆蓋當前線程發出的所有請求的優先級, 可以嵌套
+class RequestPriorityScope {
+public:
+    explicit RequestPriorityScope(RequestPriority priority);
+    ~RequestPriorityScope();
+    RequestPriorityScope(const RequestPriorityScope&) = delete;
+    RequestPriorityScope& operator=(const RequestPriorityScope&) = delete;
+
+private:
+    int previous;
+};
+
+struct RequestBudgetOptions {
+    bool enabled = true;
+    double publicPerSecond = 100.0;   // 公共行情 (按 IP 計算, 進程內共用)
+    double privatePerSecond = 20.0;   // 私有請求 (按帳戶計算)
+    double burstSeconds = 1.0;        // 額度上限 = 每秒額度 * burstSeconds
+    // 各優先級動用額度時須保留的比例: 剩餘額度不足時該級別延後, 留給更高優先級. 下單不保留
+    double riskReserve = 0.1;
+    double marketDataReserve = 0.25;
+    double displayReserve = 0.5;
+
+    static RequestBudgetOptions fromConfig();
+};
+
+// 單一 endpoint 組的請求額度 (令牌桶): 按優先級分配, 低優先級的請求在額度
+// 低於其保留比例或有更高優先級請求等待時延後, 不會佔用更高優先級的額度
+class RequestBudget {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    RequestBudget(const std::string& group, double perSecond, const RequestBudgetOptions& options);
+    RequestBudget(const RequestBudget&) = delete;
+    RequestBudget& operator=(const RequestBudget&) = delete;
+
+    // 阻塞直到取得一個請求額度
+    void acquire(RequestPriority priority);
+    // 不阻塞: 取得額度時返回 0, 否則返回預計需要等待的時間
+    std::chrono::nanoseconds tryAcquire(RequestPriority priority, TimePoint now);
+    // 交易所返回超出頻率限制時清空額度, 之後的請求按補充速度放行
+    void exhaust(TimePoint now);
+    double available(TimePoint now);
+
+    struct Stats {
+        std::array<uint64_t, REQUEST_PRIORITY_COUNT> granted{};
+        std::array<uint64_t, REQUEST_PRIORITY_COUNT> deferred{};
+    };
+    Stats stats() const;
+
+private:
+    void refill(TimePoint now);
+    std::chrono::nanoseconds admit(RequestPriority priority, TimePoint now);
+
+    const std::string group;
+    const double perSecond;
+    const double capacity;
+    std::array<double, REQUEST_PRIORITY_COUNT> reserve{};
+
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    double tokens;
+    TimePoint refilledAt;
+    std::array<int, REQUEST_PRIORITY_COUNT> waiting{};
+    Stats counters;
+};
+
+#endif // REQUEST_BUDGET_H
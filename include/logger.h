@@ -1,27 +1,90 @@
 #pragma once
 
-#include <iostream>
 #include <string>
+#include "logging/log_backend.h"
 
+// 編譯期最低日誌級別 (0=DEBUG, 1=INFO, 2=WARNING, 3=ERROR), 低於此級別的
+// LOG_* 宏連同參數的構造都會被編譯器移除
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 0
+#endif
+
+// 日誌前端: 記錄放入非同步後端的佇列後立即返回, 不阻塞於終端或文件 I/O
 class Logger {
 public:
+    static constexpr bool compiledIn(LogLevel level) {
+        return static_cast<int>(level) >= LOG_COMPILE_LEVEL;
+    }
+
+    bool enabled(LogLevel level) const {
+        return compiledIn(level) && LogBackend::getInstance().enabled(level);
+    }
+
+    void write(LogLevel level, std::string message) {
+        LogBackend::getInstance().write(level, std::move(message));
+    }
+
     //debug
     void debug(const std::string& message) {
-        std::cout << "[DEBUG] " << message << std::endl;
+        if constexpr (compiledIn(LogLevel::Debug)) {
+            write(LogLevel::Debug, message);
+        }
     }
 
     //info
     void info(const std::string& message) {
-        std::cout << "[INFO] " << message << std::endl;
+        if constexpr (compiledIn(LogLevel::Info)) {
+            write(LogLevel::Info, message);
+        }
     }
     
     //error
     void error(const std::string& message) {
-        std::cerr << "[ERROR] " << message << std::endl;
+        write(LogLevel::Error, message);
     }
     
     //warning
     void warning(const std::string& message) {
-        std::cerr << "[WARNING] " << message << std::endl;
+        if constexpr (compiledIn(LogLevel::Warning)) {
+            write(LogLevel::Warning, message);
+        }
     }
-}; 
\ No newline at end of file
+
+    // 等待已提交的日誌寫出 (例如程序退出前)
+    static void flush() {
+        LogBackend::getInstance().flush();
+    }
+};
+
+// 熱路徑使用的宏: 級別未啟用時不會構造訊息字串
+#define LOG_AT(logger, level, message)                          \
+    do {                                                        \
+        if constexpr (Logger::compiledIn(level)) {              \
+            if ((logger).enabled(level)) {                      \
+                (logger).write(level, (message));               \
+            }                                                   \
+        }                                                       \
+    } while (0)
+
+#define LOG_DEBUG(logger, message) LOG_AT(logger, LogLevel::Debug, message)
+#define LOG_INFO(logger, message) LOG_AT(logger, LogLevel::Info, message)
+#define LOG_WARNING(logger, message) LOG_AT(logger, LogLevel::Warning, message)
+#define LOG_ERROR(logger, message) LOG_AT(logger, LogLevel::Error, message)
+
+// 延遲格式化的熱路徑日誌: 格式字串以 {} 表示參數, 每個調用點只在第一次執行時
+// 註冊格式 id; 之後每次只複製參數的原始位元組, 文字由背景線程或 log_decode 渲染.
+// 交易對等重複字串以 logSymbol() 轉成 id 記錄
+#define BINLOG(logger, level, format, ...)                                                  \
+    do {                                                                                    \
+        if constexpr (Logger::compiledIn(level)) {                                          \
+            if ((logger).enabled(level)) {                                                  \
+                static const uint32_t binlogFormatId_ =                                     \
+                    registerLogFormat(level, format, __FILE__, __LINE__);                   \
+                LogBackend::getInstance().writeBinary(level, binlogFormatId_ __VA_OPT__(,) __VA_ARGS__); \
+            }                                                                               \
+        }                                                                                   \
+    } while (0)
+
+#define BINLOG_DEBUG(logger, format, ...) BINLOG(logger, LogLevel::Debug, format __VA_OPT__(,) __VA_ARGS__)
+#define BINLOG_INFO(logger, format, ...) BINLOG(logger, LogLevel::Info, format __VA_OPT__(,) __VA_ARGS__)
+#define BINLOG_WARNING(logger, format, ...) BINLOG(logger, LogLevel::Warning, format __VA_OPT__(,) __VA_ARGS__)
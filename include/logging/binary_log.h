@@ -0,0 +1,185 @@
+#ifndef BINARY_LOG_H
+#define BINARY_LOG_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+enum class LogLevel : int;
+
+// 單筆二進位日誌記錄的參數區大小, 超出的參數會被截斷
+constexpr size_t LOG_PAYLOAD_BYTES = 104;
+
+// 參數類型標記
+enum class LogArgType : uint8_t {
+    Double = 1,
+    Int = 2,
+    UInt = 3,
+    Bool = 4,
+    String = 5,
+    Symbol = 6,
+    Truncated = 7   // 之後的參數因空間不足被捨棄
+};
+
+// 已註冊的交易對等常用字串, 以 id 記錄
+struct LogSymbol {
+    uint32_t id;
+};
+
+struct LogFormatInfo {
+    uint32_t id = 0;
+    int level = 0;
+    std::string format;     // 以 {} 表示參數位置
+    std::string location;   // file:line
+};
+
+// 格式與字串註冊表 (進程內全域, 線程安全). 每個調用點只在第一次執行時註冊
+uint32_t registerLogFormat(LogLevel level, const char* format, const char* file, int line);
+bool findLogFormat(uint32_t id, LogFormatInfo& info);
+uint32_t internLogSymbol(std::string_view name);
+std::string logSymbolName(uint32_t id);
+
+inline LogSymbol logSymbol(std::string_view name) {
+    return LogSymbol{internLogSymbol(name)};
+}
+
+// 整數以 LEB128 變長編碼存放, 有號數先做 zigzag 轉換
+inline uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+inline int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+size_t encodeVarint(uint64_t value, uint8_t* out);   // out 至少 10 位元組, 返回長度
+// 解碼失敗 (超出 size) 時返回 0
+size_t decodeVarint(const uint8_t* data, size_t size, uint64_t& value);
+
+// 將參數以原始位元組寫入固定大小緩衝區, 不做任何格式化
+class BinaryEncoder {
+public:
+    BinaryEncoder(uint8_t* buffer, size_t capacity) : buffer(buffer), capacity(capacity) {}
+
+    void put(double value) { putRaw(LogArgType::Double, &value, sizeof(value)); }
+    void put(float value) { put(static_cast<double>(value)); }
+    void put(bool value) {
+        uint8_t raw = value ? 1 : 0;
+        putRaw(LogArgType::Bool, &raw, 1);
+    }
+    void put(LogSymbol symbol) { putVarint(LogArgType::Symbol, symbol.id); }
+    void put(const char* text) { put(std::string_view(text)); }
+    void put(const std::string& text) { put(std::string_view(text)); }
+    void put(std::string_view text);
+
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>> put(T value) {
+        if constexpr (std::is_signed_v<T>) {
+            putVarint(LogArgType::Int, zigzagEncode(value));
+        } else {
+            putVarint(LogArgType::UInt, value);
+        }
+    }
+
+    size_t size() const { return used; }
+
+private:
+    void putRaw(LogArgType type, const void* data, size_t length);
+    void putVarint(LogArgType type, uint64_t value);
+    void markTruncated();
+
+    uint8_t* buffer;
+    size_t capacity;
+    size_t used = 0;
+    bool truncated = false;
+};
+
+// 依格式字串及參數區渲染文字
+std::string renderLogMessage(const std::string& format, const uint8_t* payload, size_t size);
+
+// 二進位日誌文件: 文件頭之後依序為格式定義、字串定義及事件記錄.
+// 每個文件自成一體 (輪替後重新寫入用到的定義), 浮點數以本機位元組序存放.
+// 事件記錄: 類型, 格式 id (變長), 級別, 與上一事件的時間差 (納秒, zigzag 變長), 參數區長度 (變長), 參數區.
+// 每次打開文件 (包括附加到既有文件) 後的第一筆事件前寫入會話記錄, 帶絕對時間戳作為之後時間差的基準
+constexpr char BINARY_LOG_MAGIC[8] = {'F', 'R', 'T', 'B', 'L', 'O', 'G', '1'};
+
+enum class BinaryRecordType : uint8_t {
+    FormatDefinition = 1,
+    SymbolDefinition = 2,
+    Event = 3,
+    Session = 4     // 絕對時間戳 (納秒, int64), 讀取時重設時間差的累計值
+};
+
+class BinaryLogWriter {
+public:
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file.is_open(); }
+    size_t bytesWritten() const { return fileBytes; }
+
+    // 返回寫入的位元組數
+    size_t writeEvent(uint32_t formatId, LogLevel level, std::chrono::system_clock::time_point time,
+                      const uint8_t* payload, size_t size);
+    void flush() { file.flush(); }
+
+private:
+    void ensureFormat(uint32_t formatId);
+    void ensureSymbols(const uint8_t* payload, size_t size);
+    void writeString(std::string_view text);
+    void writeVarint(uint64_t value);
+    template <typename T>
+    void writeValue(T value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        fileBytes += sizeof(value);
+    }
+
+    std::ofstream file;
+    size_t fileBytes = 0;
+    int64_t lastTimestampNs = 0;
+    bool sessionStarted = false;
+    std::unordered_set<uint32_t> writtenFormats;
+    std::unordered_set<uint32_t> writtenSymbols;
+};
+
+struct DecodedLogRecord {
+    int level = 0;
+    int64_t timestampNs = 0;
+    std::string message;
+    std::string location;
+};
+
+// 讀取二進位日誌文件並還原為文字, 用於離線解碼工具
+class BinaryLogReader {
+public:
+    explicit BinaryLogReader(std::istream& in);
+
+    bool valid() const { return headerValid; }
+    // 讀取下一筆事件; 文件結束或格式錯誤時返回 false
+    bool next(DecodedLogRecord& record);
+    bool corrupted() const { return corrupt; }
+
+private:
+    bool readString(std::string& text);
+    bool readVarint(uint64_t& value);
+    template <typename T>
+    bool readValue(T& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+    std::string render(const std::string& format, const std::vector<uint8_t>& payload) const;
+
+    std::istream& in;
+    bool headerValid = false;
+    bool corrupt = false;
+    int64_t lastTimestampNs = 0;
+    std::vector<LogFormatInfo> formats;     // 以 id 為索引
+    std::vector<std::string> symbols;
+};
+
+#endif // BINARY_LOG_H
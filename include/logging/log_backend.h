@@ -0,0 +1,157 @@
+#ifndef LOG_BACKEND_H
+#define LOG_BACKEND_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "logging/binary_log.h"
+
+enum class LogLevel : int {
+    Debug = 0,
+    Info = 1,
+    Warning = 2,
+    Error = 3,
+    Off = 4
+};
+
+const char* logLevelName(LogLevel level);
+LogLevel parseLogLevel(const std::string& name, LogLevel fallback);
+
+// formatId 為 0 時是文字記錄 (message); 否則為延遲格式化記錄,
+// 參數以原始位元組存放在 payload, 由背景線程或離線解碼工具渲染
+struct LogRecord {
+    LogLevel level = LogLevel::Info;
+    std::chrono::system_clock::time_point time;
+    std::string message;
+    uint32_t formatId = 0;
+    uint16_t payloadSize = 0;
+    std::array<uint8_t, LOG_PAYLOAD_BYTES> payload;
+};
+
+// 有界多生產者單消費者環形佇列 (每個槽位帶序號, 生產者以 CAS 領取位置),
+// 生產者之間及與消費者之間都不需要鎖
+class LogRing {
+public:
+    explicit LogRing(size_t capacity);   // 容量向上取整為 2 的冪
+
+    bool tryPush(LogRecord&& record);
+    // 只能由單一消費者線程調用
+    bool tryPop(LogRecord& record);
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) size_t dequeuePos = 0;
+};
+
+enum class OverflowPolicy {
+    Drop,   // 佇列已滿時丟棄並計數 (警告及錯誤仍會等待)
+    Block   // 佇列已滿時等待背景線程騰出空間
+};
+
+struct LogOptions {
+    LogLevel level = LogLevel::Debug;
+    bool console = true;
+    std::string filePath;                 // 空字串表示不寫文件
+    std::string binaryFilePath;           // 二進位日誌文件, 空字串表示不寫
+    size_t maxFileBytes = 10 * 1024 * 1024;
+    int maxFiles = 5;                     // 保留的輪替文件數量 (path.1 ... path.N)
+    size_t queueCapacity = 8192;
+    OverflowPolicy overflow = OverflowPolicy::Drop;
+
+    static LogOptions fromConfig();
+};
+
+// 非同步日誌後端: 調用線程只把記錄放入環形佇列,
+// 格式化、終端及文件 I/O 全部在背景線程進行
+class LogBackend {
+public:
+    static LogBackend& getInstance();
+
+    explicit LogBackend(const LogOptions& options = LogOptions());
+    ~LogBackend();
+    LogBackend(const LogBackend&) = delete;
+    LogBackend& operator=(const LogBackend&) = delete;
+
+    // 佇列容量只在尚未寫入任何記錄前生效, 應於程序啟動時調用
+    void configure(const LogOptions& options);
+
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= minLevel.load(std::memory_order_relaxed);
+    }
+    void setLevel(LogLevel level) { minLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel level() const { return static_cast<LogLevel>(minLevel.load(std::memory_order_relaxed)); }
+
+    void write(LogLevel level, std::string message);
+
+    // 延遲格式化: 只記錄格式 id 及參數的原始位元組
+    template <typename... Args>
+    void writeBinary(LogLevel level, uint32_t formatId, const Args&... args) {
+        if (!enabled(level)) {
+            return;
+        }
+        LogRecord record;
+        record.level = level;
+        record.time = std::chrono::system_clock::now();
+        record.formatId = formatId;
+        BinaryEncoder encoder(record.payload.data(), record.payload.size());
+        (encoder.put(args), ...);
+        record.payloadSize = static_cast<uint16_t>(encoder.size());
+        submit(std::move(record));
+    }
+    // 等待目前為止提交的記錄全部寫出
+    void flush();
+
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+    uint64_t writtenCount() const { return written.load(std::memory_order_acquire); }
+
+private:
+    void submit(LogRecord&& record);
+    void run();
+    void output(const LogRecord& record);
+    const std::string& formatOf(uint32_t formatId);
+    void writeBinaryRecord(const LogRecord& record);
+    void openFile();
+    void rotateFile();
+    void openBinaryFile();
+    void reportDropped();
+
+    std::atomic<int> minLevel;
+    std::unique_ptr<LogRing> ring;
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+    uint64_t reportedDropped = 0;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> consoleEnabled;
+    std::atomic<OverflowPolicy> overflow;
+
+    // 只由背景線程訪問 (configure 時持有 fileMutex)
+    std::mutex fileMutex;
+    std::string filePath;
+    size_t maxFileBytes;
+    int maxFiles;
+    std::ofstream file;
+    size_t fileBytes = 0;
+    std::string binaryFilePath;
+    BinaryLogWriter binaryFile;
+    std::vector<std::string> formatCache;   // 以格式 id 為索引, 避免每筆記錄查詢註冊表
+
+    std::thread worker;
+};
+
+#endif // LOG_BACKEND_H
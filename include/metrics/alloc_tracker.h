@@ -0,0 +1,57 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 分配次數及字節數
+struct AllocStats {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+// 分配位置 (AllocScope 標籤) 的累計統計, 不含內層標籤的分配
+struct AllocSite {
+    std::string label;
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+// 全局分配統計: 替換 operator new, 啟用時按線程計數並歸屬到當前的 AllocScope.
+// 關閉時每次分配只多一次原子讀取; 掛鉤內部不分配記憶體
+class AllocTracker {
+public:
+    static void setEnabled(bool enabled);
+    static bool enabled();
+
+    // 當前線程自啟用以來的分配總數
+    static AllocStats threadStats();
+    // 按分配次數降序的前 limit 個位置 (limit 為 0 表示全部)
+    static std::vector<AllocSite> topSites(size_t limit = 0);
+    // 將各位置自上次發佈以來的增量寫入 frt_alloc_total / frt_alloc_bytes_total
+    static void publish();
+    static void reset();
+};
+
+// 標記一段代碼的分配位置, 可以嵌套; label 必須是靜態字串.
+// 析構時把區段內 (不含內層區段) 的分配計入該標籤
+class AllocScope {
+public:
+    explicit AllocScope(const char* label);
+    ~AllocScope();
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+    // 區段開始至今的分配 (含內層區段)
+    AllocStats stats() const;
+
+private:
+    const char* label;
+    AllocScope* parent;
+    AllocStats start;
+    AllocStats children;
+};
+
+#endif // ALLOC_TRACKER_H
@@ -0,0 +1,66 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include "metrics/metrics.h"
+#include "logger.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct MetricsExportOptions {
+    bool httpEnabled = false;
+    std::string bindAddress = "127.0.0.1";
+    int httpPort = 9464;                    // 0 表示由系統分配 (測試用)
+    std::string filePath;                   // 空字串表示不寫文件
+    std::chrono::seconds fileInterval{60};
+    // 每個連接從接受到回應完畢的總時限, 逾時未送出請求行的連接直接關閉
+    std::chrono::milliseconds requestTimeout{500};
+    size_t maxPendingClients = 16;
+
+    static MetricsExportOptions fromConfig();
+};
+
+// 指標輸出: 本地 HTTP 監聽 (GET /metrics, Prometheus 文字格式) 及定期寫文件.
+// 兩者共用一個背景線程, 不影響交易線程. 連接均為非阻塞, 以 poll 同時等待,
+// 空閒或緩慢的客戶端不會阻塞其他抓取
+class MetricsExporter {
+public:
+    MetricsExporter(MetricsRegistry& registry, const MetricsExportOptions& options);
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // 打開監聽端口並啟動背景線程; 端口無法綁定時返回 false (文件輸出仍會啟動)
+    bool start();
+    void stop();
+    // 實際監聽的端口, 未監聽時為 0
+    int port() const { return boundPort; }
+    // 立即寫出指標文件 (先寫臨時文件再改名, 讀取方不會看到半份內容)
+    bool writeFile();
+
+private:
+    bool openListener();
+    struct PendingClient {
+        int fd;
+        std::string request;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    void run();
+    void acceptClient(std::vector<PendingClient>& clients);
+    // 讀取可用數據; 請求行完整時回應. 連接已處理完畢 (或出錯) 時返回 true
+    bool readClient(PendingClient& client);
+    void serveClient(const PendingClient& client, const std::string& requestLine);
+
+    MetricsRegistry& registry;
+    MetricsExportOptions options;
+    Logger logger;
+    int listenFd = -1;
+    int boundPort = 0;
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+};
+
+#endif // METRICS_EXPORTER_H
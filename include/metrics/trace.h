@@ -0,0 +1,126 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct TraceEvent {
+    const char* name;         // 靜態字串
+    const char* category;
+    std::string detail;       // 寫入 args, 例如交易對或 endpoint
+    int64_t startMicros;
+    int64_t durationMicros;
+    uint32_t threadId;
+};
+
+struct TraceOptions {
+    bool enabled = false;
+    std::string outputDir = "traces";
+    size_t maxEventsPerCycle = 100000;
+
+    static TraceOptions fromConfig();
+};
+
+// 區段追蹤: 只在週期進行中記錄, 每個線程寫入自己的緩衝區,
+// 週期結束時合併輸出為 Chrome trace-event JSON (可用 Perfetto 或 chrome://tracing 查看)
+class Tracer {
+public:
+    static Tracer& getInstance();
+
+    Tracer() = default;
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    void configure(const TraceOptions& options);
+    bool enabled() const { return tracingEnabled.load(std::memory_order_relaxed); }
+    // 是否有週期正在記錄; 關閉時 TraceSpan 只付出這一次讀取
+    bool active() const { return cycleDepth.load(std::memory_order_relaxed) > 0; }
+
+    // 週期可以嵌套, 只有最外層的結束會寫出文件. 返回寫出的文件路徑 (未寫出時為空)
+    void beginCycle(const std::string& label);
+    std::string endCycle();
+
+    void record(TraceEvent&& event);
+    static int64_t nowMicros();
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    // 取出目前緩衝的所有事件 (依開始時間排序), 並清空緩衝區
+    std::vector<TraceEvent> drain();
+    static std::string toChromeJson(const std::vector<TraceEvent>& events, const std::string& label);
+
+private:
+    struct ThreadBuffer {
+        std::mutex mutex;   // 只在合併時與記錄線程競爭
+        std::vector<TraceEvent> events;
+        uint32_t threadId;
+    };
+    ThreadBuffer& localBuffer();
+
+    std::atomic<bool> tracingEnabled{false};
+    std::atomic<int> cycleDepth{0};
+    std::atomic<size_t> cycleEvents{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint32_t> nextThreadId{1};
+
+    std::mutex mutex;
+    std::string outputDir = "traces";
+    size_t maxEventsPerCycle = 100000;
+    std::string cycleLabel;
+    int64_t cycleStartMicros = 0;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+// RAII 區段: 構造時記錄開始時間, 析構時寫入當前線程的緩衝區
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category, std::string_view detail = {}) {
+        if (Tracer::getInstance().active()) {
+            this->name = name;
+            this->category = category;
+            this->detail = detail;
+            start = Tracer::nowMicros();
+        }
+    }
+    ~TraceSpan() {
+        if (name) {
+            Tracer::getInstance().record(
+                TraceEvent{name, category, std::move(detail), start, Tracer::nowMicros() - start, 0});
+        }
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name = nullptr;
+    const char* category = nullptr;
+    std::string detail;
+    int64_t start = 0;
+};
+
+// 追蹤週期: 在最外層結束時輸出該週期內所有線程的區段
+class TraceCycle {
+public:
+    explicit TraceCycle(const std::string& label) : started(Tracer::getInstance().enabled()) {
+        if (started) {
+            Tracer::getInstance().beginCycle(label);
+        }
+    }
+    ~TraceCycle() {
+        if (started) {
+            Tracer::getInstance().endCycle();
+        }
+    }
+    TraceCycle(const TraceCycle&) = delete;
+    TraceCycle& operator=(const TraceCycle&) = delete;
+
+private:
+    bool started;
+};
+
+#endif // TRACE_H
@@ -0,0 +1,86 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// 時鐘抽象: 排程器與交易邏輯透過此介面取得時間及休眠,
+// 以便測試或回測時可替換成虛擬時鐘
+class IClock {
+public:
+    using Clock = std::chrono::system_clock;
+    using TimePoint = Clock::time_point;
+
+    virtual ~IClock() = default;
+    virtual TimePoint now() const = 0;
+    // 絕對時間休眠, 直到指定時間點為止
+    virtual void sleepUntil(TimePoint deadline) = 0;
+
+    void sleepFor(Clock::duration duration) {
+        sleepUntil(now() + duration);
+    }
+};
+
+class SystemClock : public IClock {
+public:
+    static SystemClock& getInstance() {
+        static SystemClock instance;
+        return instance;
+    }
+
+    TimePoint now() const override {
+        return Clock::now();
+    }
+
+    void sleepUntil(TimePoint deadline) override {
+        // sleep_until 可能因訊號或系統時間調整提前返回, 循環直到真正到期
+        while (Clock::now() < deadline) {
+            std::this_thread::sleep_until(deadline);
+        }
+    }
+
+private:
+    SystemClock() = default;
+};
+
+// 虛擬時鐘: 休眠立即將時間推進到截止時間, 用於回測及測試
+class VirtualClock : public IClock {
+public:
+    explicit VirtualClock(TimePoint start = TimePoint()) : current(start) {}
+
+    TimePoint now() const override {
+        return current;
+    }
+
+    void sleepUntil(TimePoint deadline) override {
+        if (deadline > current) {
+            current = deadline;
+        }
+    }
+
+    void setTime(TimePoint time) {
+        current = time;
+    }
+
+    void advance(Clock::duration duration) {
+        current += duration;
+    }
+
+private:
+    TimePoint current;
+};
+
+// 以 UTC 格式化時間點, 用於日誌及報告
+inline std::string formatUTC(IClock::TimePoint tp) {
+    std::time_t t = IClock::Clock::to_time_t(tp);
+    std::tm utc_tm = *std::gmtime(&t);
+    std::ostringstream ss;
+    ss << std::put_time(&utc_tm, "%Y-%m-%d %H:%M:%S") << " UTC";
+    return ss.str();
+}
+
+#endif // CLOCK_H
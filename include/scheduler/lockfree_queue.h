@@ -0,0 +1,147 @@
+#ifndef LOCKFREE_QUEUE_H
+#define LOCKFREE_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace lockfree_detail {
+
+// 兩個線程各自寫的計數器放在不同緩存行, 避免偽共享
+constexpr size_t CACHE_LINE = 64;
+
+inline size_t roundUpPowerOfTwo(size_t value) {
+    size_t capacity = 2;
+    while (capacity < value) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+} // namespace lockfree_detail
+
+// 有界單生產者單消費者隊列: 環形緩衝區, 生產者只寫 tail, 消費者只寫 head.
+// 容量向上取整為 2 的冪; 隊列已滿時 tryPush 返回 false 而不是阻塞
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) :
+        mask(lockfree_detail::roundUpPowerOfTwo(capacity) - 1),
+        slots(std::make_unique<std::optional<T>[]>(mask + 1)) {}
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    bool tryPush(T value) {
+        const size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headCache == mask + 1) {
+            headCache = headIndex.load(std::memory_order_acquire);
+            if (tail - headCache == mask + 1) {
+                return false;
+            }
+        }
+        slots[tail & mask].emplace(std::move(value));
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> tryPop() {
+        const size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailCache) {
+            tailCache = tailIndex.load(std::memory_order_acquire);
+            if (head == tailCache) {
+                return std::nullopt;
+            }
+        }
+        std::optional<T> value = std::move(slots[head & mask]);
+        slots[head & mask].reset();
+        headIndex.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    // 近似值: 其他線程同時操作時只用於監控
+    size_t size() const {
+        return tailIndex.load(std::memory_order_acquire) - headIndex.load(std::memory_order_acquire);
+    }
+    size_t capacity() const { return mask + 1; }
+
+private:
+    const size_t mask;
+    std::unique_ptr<std::optional<T>[]> slots;
+    alignas(lockfree_detail::CACHE_LINE) std::atomic<size_t> headIndex{0};
+    size_t tailCache = 0;  // 消費者看到的 tail
+    alignas(lockfree_detail::CACHE_LINE) std::atomic<size_t> tailIndex{0};
+    size_t headCache = 0;  // 生產者看到的 head
+};
+
+// 有界多生產者單消費者隊列 (Vyukov): 每個槽位帶序號, 生產者以 CAS 搶佔 tail.
+// 消費者只有一個, head 不需要 CAS
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity) :
+        mask(lockfree_detail::roundUpPowerOfTwo(capacity) - 1),
+        cells(std::make_unique<Cell[]>(mask + 1)) {
+        for (size_t i = 0; i <= mask; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    bool tryPush(T value) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[tail & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(tail);
+            if (diff == 0) {
+                if (tailIndex.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 已滿
+            } else {
+                tail = tailIndex.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value.emplace(std::move(value));
+        cell->sequence.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> tryPop() {
+        const size_t head = headIndex.load(std::memory_order_relaxed);
+        Cell& cell = cells[head & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+            return std::nullopt;
+        }
+        std::optional<T> value = std::move(cell.value);
+        cell.value.reset();
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        headIndex.store(head + 1, std::memory_order_relaxed);
+        return value;
+    }
+
+    size_t size() const {
+        const size_t tail = tailIndex.load(std::memory_order_acquire);
+        const size_t head = headIndex.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        std::optional<T> value;
+    };
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(lockfree_detail::CACHE_LINE) std::atomic<size_t> tailIndex{0};
+    alignas(lockfree_detail::CACHE_LINE) std::atomic<size_t> headIndex{0};
+};
+
+#endif // LOCKFREE_QUEUE_H
@@ -0,0 +1,41 @@
+#ifndef SETTLEMENT_CALENDAR_H
+#define SETTLEMENT_CALENDAR_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// 資金費率結算時間表: 啟動時一次性解析 "HH:MM" 字串,
+// 之後所有結算相關的時間計算都只做整數運算
+class SettlementCalendar {
+public:
+    using Clock = std::chrono::system_clock;
+    using TimePoint = Clock::time_point;
+
+    SettlementCalendar(const std::vector<std::string>& settlementTimesUTC,
+                       int preSettlementMinutes,
+                       int postSettlementMinutes = 0);
+    static SettlementCalendar fromConfig();
+
+    // 嚴格晚於 after 的下一個結算時間
+    TimePoint nextSettlement(TimePoint after) const;
+    // 不晚於 at 的上一個結算時間
+    TimePoint previousSettlement(TimePoint at) const;
+    // 下一個結算前進場時間點 (結算時間 - pre_settlement_minutes)
+    TimePoint nextPreSettlementEntry(TimePoint after) const;
+    // 下一個結算後刷新時間點 (結算時間 + post_settlement_minutes)
+    TimePoint nextPostSettlementRefresh(TimePoint after) const;
+    // 是否處於結算前的預留時間內
+    bool isNearSettlement(TimePoint now) const;
+
+    std::chrono::minutes preSettlementWindow() const { return preSettlement; }
+    std::chrono::minutes postSettlementDelay() const { return postSettlement; }
+    bool empty() const { return offsets.empty(); }
+
+private:
+    std::vector<std::chrono::minutes> offsets;  // 每日 UTC 分鐘偏移, 已排序
+    std::chrono::minutes preSettlement;
+    std::chrono::minutes postSettlement;
+};
+
+#endif // SETTLEMENT_CALENDAR_H
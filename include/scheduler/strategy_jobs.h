@@ -0,0 +1,25 @@
+#ifndef STRATEGY_JOBS_H
+#define STRATEGY_JOBS_H
+
+#include "scheduler/settlement_calendar.h"
+#include "scheduler/task_scheduler.h"
+#include "trading/trading_module.h"
+#include <chrono>
+
+struct StrategyJobOptions {
+    std::chrono::minutes reconcileInterval{5};
+    bool displayPositions = true;  // 對帳前後輸出持倉表
+    std::string archivePath;       // 結算後追加資金費率歸檔, 留空表示不寫
+};
+
+// 註冊對沖策略的三類工作: 結算前進場、結算後刷新及定期對帳。
+// calendar 與 trader 必須在 scheduler 執行期間保持有效
+void registerStrategyJobs(TaskScheduler& scheduler,
+                          TradingModule& trader,
+                          const SettlementCalendar& calendar,
+                          const StrategyJobOptions& options);
+
+// 一次完整對帳: 執行對沖策略並視需要輸出持倉
+void runReconcile(TradingModule& trader, bool displayPositions);
+
+#endif // STRATEGY_JOBS_H
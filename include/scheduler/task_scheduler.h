@@ -0,0 +1,73 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include "scheduler/clock.h"
+#include "logger.h"
+#include <atomic>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+enum class JobType {
+    PreSettlementEntry,     // 結算前進場
+    PostSettlementRefresh,  // 結算後刷新資金費率
+    PeriodicReconcile,      // 定期對帳/平衡倉位
+    FundingSettlement       // 資金費率結算 (回測模擬交易所使用)
+};
+
+const char* jobTypeName(JobType type);
+
+// 以最小堆管理各類工作的下一個截止時間, 只在精確的截止時間醒來,
+// 不做固定間隔輪詢
+class TaskScheduler {
+public:
+    using TimePoint = IClock::TimePoint;
+    // 給定上一次執行結束的時間, 返回嚴格晚於該時間的下一個截止時間
+    using NextDeadline = std::function<TimePoint(TimePoint after)>;
+    using Action = std::function<void()>;
+
+    explicit TaskScheduler(IClock& clock);
+
+    void addJob(JobType type, const std::string& name, NextDeadline next, Action action);
+    // 執行最早到期的工作; 沒有工作或已停止時返回 false
+    bool runNext();
+    void run();
+    void stop();
+
+    bool empty() const { return queue.empty(); }
+    TimePoint nextDeadline() const;
+    size_t jobCount() const { return jobs.size(); }
+
+private:
+    struct Job {
+        JobType type;
+        std::string name;
+        NextDeadline next;
+        Action action;
+    };
+
+    struct Entry {
+        TimePoint deadline;
+        uint64_t sequence;  // 相同截止時間時保持加入順序
+        size_t jobIndex;
+    };
+
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const {
+            if (a.deadline != b.deadline) return a.deadline > b.deadline;
+            return a.sequence > b.sequence;
+        }
+    };
+
+    void schedule(size_t jobIndex, TimePoint after);
+
+    IClock& clock;
+    Logger logger;
+    std::vector<Job> jobs;
+    std::priority_queue<Entry, std::vector<Entry>, Later> queue;
+    uint64_t nextSequence = 0;
+    std::atomic<bool> stopped{false};
+};
+
+#endif // TASK_SCHEDULER_H
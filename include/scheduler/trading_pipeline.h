@@ -0,0 +1,152 @@
+#ifndef TRADING_PIPELINE_H
+#define TRADING_PIPELINE_H
+
+#include "logger.h"
+#include "scheduler/lockfree_queue.h"
+#include "trading/rebalance_planner.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class LatencyHistogram;
+class MetricCounter;
+class MetricGauge;
+
+struct PipelineOptions {
+    bool enabled = false;
+    size_t queueCapacity = 64;
+    bool busyPoll = false;                        // 空閒時自旋 (yield) 而不是休眠
+    std::chrono::microseconds idleWait{1000};     // 非自旋模式下隊列為空時的休眠時間
+    int marketDataCpu = -1;                       // 綁定的 CPU 核心, -1 表示不綁定
+    int strategyCpu = -1;
+    int executionCpu = -1;
+
+    static PipelineOptions fromConfig();
+};
+
+using PipelineClock = std::chrono::steady_clock;
+
+enum class PipelineTriggerKind { Cycle, Refresh };
+
+// 請求完成後的後續步驟 (例如輸出持倉, 追加歸檔): 刷新在行情線程刷新後調用, 週期在執行線程
+// 執行後調用. 合併或重新請求時回調隨之轉移; 週期未能執行 (快照失敗, 隊列已滿) 時也會調用
+using PipelineCallback = std::function<void()>;
+
+// 排程器或執行線程投遞給行情線程的請求
+struct PipelineTrigger {
+    PipelineTriggerKind kind = PipelineTriggerKind::Cycle;
+    PipelineClock::time_point enqueuedAt;
+    std::vector<PipelineCallback> onComplete;
+};
+
+// 行情線程取得的一致快照: 排名與持倉在同一輪取得
+struct MarketSnapshot {
+    uint64_t sequence = 0;
+    uint64_t positionsEpoch = 0;  // 取得持倉前的執行紀元, 用於判斷決策是否過時
+    std::vector<std::pair<std::string, double>> topRates;
+    std::map<std::string, std::pair<double, double>> positions;
+    PipelineClock::time_point triggeredAt;
+    PipelineClock::time_point capturedAt;
+    std::vector<PipelineCallback> onComplete;
+};
+
+// 策略線程根據快照算出的再平衡計劃
+struct StrategyDecision {
+    uint64_t sequence = 0;
+    uint64_t positionsEpoch = 0;
+    RebalancePlan plan;
+    std::map<std::string, std::pair<double, double>> positions;
+    PipelineClock::time_point triggeredAt;
+    PipelineClock::time_point capturedAt;
+    PipelineClock::time_point decidedAt;
+    std::vector<PipelineCallback> onComplete;
+};
+
+// 各階段的實際工作, 由 TradingModule 提供; 測試可以替換
+struct PipelineStages {
+    std::function<void()> refresh;                                 // 行情線程: 結算後刷新排名
+    std::function<bool(MarketSnapshot&)> capture;                  // 行情線程: 取得排名及持倉, 失敗返回 false
+    std::function<RebalancePlan(const MarketSnapshot&)> decide;    // 策略線程
+    std::function<void(StrategyDecision&)> execute;                // 執行線程
+};
+
+struct PipelineStats {
+    uint64_t snapshots = 0;
+    uint64_t decisions = 0;
+    uint64_t executed = 0;
+    uint64_t superseded = 0;  // 策略線程處理前已被更新快照取代
+    uint64_t stale = 0;       // 持倉在快照後被執行改變, 丟棄並重新請求
+    uint64_t dropped = 0;     // 隊列已滿而丟棄的請求或快照
+};
+
+// 行情, 策略, 執行三線程流水線: 觸發請求經 MPSC 隊列到行情線程, 快照及決策經 SPSC 隊列傳遞.
+// 執行線程下單時策略線程可以處理下一個快照; 快照取得後若有計劃改變了持倉,
+// 其決策視為過時並重新請求, 不會以舊持倉重複下單
+class TradingPipeline {
+public:
+    TradingPipeline(PipelineStages stages, const PipelineOptions& options, const std::string& name = "");
+    ~TradingPipeline();
+    TradingPipeline(const TradingPipeline&) = delete;
+    TradingPipeline& operator=(const TradingPipeline&) = delete;
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    // 任何線程均可調用; 隊列已滿時返回 false 並立即調用 onComplete.
+    // 停止時仍在隊列中的請求不會再調用回調
+    bool requestCycle(PipelineCallback onComplete = {});
+    bool requestRefresh(PipelineCallback onComplete = {});
+
+    PipelineStats stats() const;
+
+private:
+    void runMarketData();
+    void runStrategy();
+    void runExecution();
+    void idle(unsigned& spins) const;
+    void pinCurrentThread(int cpu, const char* role);
+    bool post(PipelineTriggerKind kind, std::vector<PipelineCallback> onComplete);
+    void complete(std::vector<PipelineCallback>& callbacks);
+    void updateDepths();
+
+    PipelineStages stages;
+    PipelineOptions options;
+    Logger logger;
+
+    MpscQueue<PipelineTrigger> triggers;
+    SpscQueue<MarketSnapshot> snapshots;
+    SpscQueue<StrategyDecision> decisions;
+
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> positionsEpoch{0};
+    std::atomic<uint64_t> snapshotCount{0};
+    std::atomic<uint64_t> decisionCount{0};
+    std::atomic<uint64_t> executedCount{0};
+    std::atomic<uint64_t> supersededCount{0};
+    std::atomic<uint64_t> staleCount{0};
+    std::atomic<uint64_t> droppedCount{0};
+    uint64_t nextSequence = 0;  // 只由行情線程使用
+
+    MetricGauge& triggerDepth;
+    MetricGauge& snapshotDepth;
+    MetricGauge& decisionDepth;
+    LatencyHistogram& triggerToSnapshot;
+    LatencyHistogram& snapshotToDecision;
+    LatencyHistogram& decisionToExecution;
+    LatencyHistogram& executionLatency;
+    MetricCounter& staleDecisions;
+    MetricCounter& droppedMessages;
+
+    std::thread marketDataThread;
+    std::thread strategyThread;
+    std::thread executionThread;
+};
+
+#endif // TRADING_PIPELINE_H
@@ -0,0 +1,72 @@
+#ifndef FUNDING_ARCHIVE_H
+#define FUNDING_ARCHIVE_H
+
+#include "storage/funding_series.h"
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+class SQLiteStorage;
+
+// 只追加的列式資金費率歸檔, 用於研究及回測時快速載入多年數據.
+//
+// 文件格式 (小端序):
+//   文件頭 (64 字節)  magic "FRTARCH1", 版本, 索引位置/長度/CRC32
+//   資料塊 (8 字節對齊) 每塊為單一幣種的一段連續結算:
+//       塊頭 24 字節 {筆數, 時間戳字節數, 首個時間戳, CRC32}
+//       費率列        筆數 * double, 原樣存放以便映射後直接使用
+//       時間戳列      相鄰差值的 zigzag varint 編碼
+//   索引              每個資料塊的幣種, 位置, 筆數及首尾時間戳
+// 追加時新資料塊及新索引寫在文件末尾, 最後才更新文件頭, 中途中斷不影響舊內容
+class FundingArchive {
+public:
+    ~FundingArchive();
+    FundingArchive(const FundingArchive&) = delete;
+    FundingArchive& operator=(const FundingArchive&) = delete;
+
+    // 以 mmap 打開並校驗全部資料塊; 格式或校驗和錯誤時拋出 std::runtime_error
+    static std::unique_ptr<FundingArchive> open(const std::string& path);
+
+    std::vector<std::string> symbols() const;
+    // 按時間升序. 幣種只有一個資料塊時直接指向映射內存
+    std::span<const double> rates(const std::string& symbol) const;
+    std::span<const int64_t> timestamps(const std::string& symbol) const;
+    bool isMapped(const std::string& symbol) const;
+    // 不存在時返回 int64 最小值
+    int64_t lastTimestamp(const std::string& symbol) const;
+    size_t blockCount() const { return blocks; }
+    // asOfTs (含) 之前最近 depth 筆, 按時間升序, 可直接交給 FundingScorer::scoreOldestFirst
+    std::span<const double> window(const std::string& symbol, int64_t asOfTs, size_t depth) const;
+
+    // 追加比文件中已有數據更新的記錄, 文件不存在時建立. 返回追加的筆數, 寫入失敗時拋出 std::runtime_error
+    static size_t append(const std::string& path, const std::vector<FundingRecord>& records);
+    // 以 storage 中全部資金費率重建文件 (每個幣種一個資料塊)
+    static size_t exportFrom(SQLiteStorage& storage, const std::string& path);
+    // 從 storage 取出各幣種在文件最後時間戳之後的記錄並追加, 每次結算同步後調用
+    static size_t appendFromStorage(SQLiteStorage& storage, const std::string& path);
+    // 將多次追加產生的小資料塊合併成每個幣種一塊
+    static void compact(const std::string& path);
+
+private:
+    struct Series {
+        std::span<const double> rates;
+        std::vector<double> merged;       // 多個資料塊時的合併副本
+        std::vector<int64_t> timestamps;
+        bool mapped = false;
+    };
+
+    FundingArchive() = default;
+    const Series* find(const std::string& symbol) const;
+    static void writeNew(const std::string& path, const std::vector<FundingRecord>& records);
+
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    size_t blocks = 0;
+    std::map<std::string, Series> series;
+};
+
+#endif // FUNDING_ARCHIVE_H
@@ -0,0 +1,30 @@
+#ifndef FUNDING_SERIES_H
+#define FUNDING_SERIES_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// 單筆資金費率結算, ts 為結算時間 (Unix 毫秒)
+struct FundingRecord {
+    std::string symbol;
+    int64_t ts = 0;
+    double rate = 0.0;
+};
+
+// 多個幣種最近 depth 筆資金費率. 每個幣種佔連續的一行 (最新在前),
+// 不足 depth 筆時只有前 counts[i] 個值有效, 可直接交給 FundingScorer::score
+struct FundingWindow {
+    std::vector<std::string> symbols;
+    std::vector<int> counts;
+    std::vector<double> rates;   // symbols.size() * depth
+    int depth = 0;
+
+    size_t size() const { return symbols.size(); }
+    std::span<const double> row(size_t i) const {
+        return {rates.data() + i * static_cast<size_t>(depth), static_cast<size_t>(counts[i])};
+    }
+};
+
+#endif // FUNDING_SERIES_H
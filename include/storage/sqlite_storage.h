@@ -1,33 +1,123 @@
 #ifndef SQLITE_STORAGE_H
 #define SQLITE_STORAGE_H
 
+#include "storage/funding_series.h"
+#include "storage/trade_group.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <map>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 #include <memory>
 #include <mutex>
 #include <sqlite3.h>
 
+struct StorageOptions {
+    std::string path = "trading.db";
+    size_t queueCapacity = 4096;                      // 隊列滿時寫入方等待; 對沖組寫入 (下單路徑) 不等待, 允許超出
+    size_t batchSize = 256;                           // 單一事務最多寫入筆數
+    std::chrono::milliseconds batchInterval{200};     // 第一筆寫入後最多等待多久提交
+};
+
+// 寫入先放入有界隊列, 由背景線程按筆數或時間批次提交 (WAL 模式, 預編譯語句重複使用).
+// 需要確認已提交的調用方使用 flush(), 需要斷電後仍保留的使用 flushDurable()
 class SQLiteStorage {
 private:
+    struct WriteOp {
+        enum class Kind { Trade, TradeGroup, FundingRates } kind;
+        std::string symbol;
+        double rate = 0.0;
+        TradeGroup group;
+        std::vector<FundingRecord> fundingRates;
+    };
+
     static std::mutex mutex_;
     static std::unique_ptr<SQLiteStorage> instance;
+    StorageOptions options;
     sqlite3* db;
     bool isConnected;
 
-    SQLiteStorage();
+    // 預編譯語句, 只在 dbMutex 下使用
+    std::mutex dbMutex;
+    sqlite3_stmt* insertTradeStmt = nullptr;
+    sqlite3_stmt* upsertTradeGroupStmt = nullptr;
+    sqlite3_stmt* selectGroupHistoryStmt = nullptr;
+    sqlite3_stmt* upsertFundingStmt = nullptr;
+    sqlite3_stmt* selectFundingRangeStmt = nullptr;
+    sqlite3_stmt* selectFundingSymbolsStmt = nullptr;
+    sqlite3_stmt* selectLatestFundingStmt = nullptr;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCv;      // 通知背景線程有新寫入
+    std::condition_variable spaceCv;      // 通知寫入方隊列有空位
+    std::condition_variable committedCv;  // 通知 flush() 等待方
+    std::deque<WriteOp> queue;
+    uint64_t enqueuedSeq = 0;
+    uint64_t committedSeq = 0;
+    uint64_t flushTarget = 0;             // flush() 等待的序號, 背景線程達到前不等批次湊滿
+    bool stopping = false;
+    std::thread writer;
+
+    // 未平倉對沖組的內存鏡像, 啟動時從 trade_groups 載入
+    mutable std::mutex groupsMutex;
+    std::map<int64_t, TradeGroup> activeGroups;
+    int64_t nextGroupId = 1;
+
     void initDatabase();
+    bool migrateTradeGroups();
+    void loadActiveTradeGroups();
+    bool prepare(const char* sql, sqlite3_stmt** stmt);
+    void enqueue(WriteOp op);
+    void runWriter();
+    void commitBatch(std::vector<WriteOp>& batch);
+    bool execute(const WriteOp& op);
+    void stopWriter();
 
 public:
+    explicit SQLiteStorage(const StorageOptions& options = StorageOptions());
     static SQLiteStorage& getInstance();
     ~SQLiteStorage();
+    SQLiteStorage(const SQLiteStorage&) = delete;
+    SQLiteStorage& operator=(const SQLiteStorage&) = delete;
 
+    // 只放入隊列, 不等待寫盤
     void storeTradeData(const std::string& symbol, double rate);
+    // 以 Open 狀態記錄一個對沖組, 等同 openTradeGroup
     void storeTradeGroup(const std::string& exchangeId, const std::string& symbol,
                         const std::string& spotOrderId, const std::string& futuresOrderId,
                         int leverage);
+    // 新增對沖組並返回分配的 id; 內存鏡像立即更新, 寫盤經由背景隊列
+    int64_t openTradeGroup(TradeGroup group);
+    // 更新已有對沖組 (按 id), 狀態為 Closed 時從內存鏡像移除
+    void updateTradeGroup(TradeGroup group);
+    // 以下三個查詢只讀內存鏡像
+    std::vector<TradeGroup> activeTradeGroups() const;
+    std::optional<TradeGroup> findActiveTradeGroup(int64_t id) const;
+    std::optional<TradeGroup> findActiveTradeGroup(const std::string& exchangeId, const std::string& symbol) const;
+    // 單一幣種全部對沖組 (含已平倉), 按 id 升序; 讀取前先 flush
+    std::vector<TradeGroup> getTradeGroupHistory(const std::string& symbol);
+    // 批量寫入資金費率; 同一 (symbol, ts) 重複寫入時以新值覆蓋
+    void storeFundingRates(std::vector<FundingRecord> records);
+    // 等待目前為止放入隊列的寫入全部提交; 超時返回 false.
+    // WAL 模式下提交不會 fsync, 進程崩潰後仍在, 斷電時最後幾個事務可能丟失
+    bool flush(std::chrono::milliseconds timeout = std::chrono::seconds(30));
+    // 同 flush(), 之後執行 FULL 檢查點把 WAL 同步並寫回數據庫文件, 返回時寫入已落盤
+    bool flushDurable(std::chrono::milliseconds timeout = std::chrono::seconds(30));
+    // 舊格式 "exchange:symbol:spotOrderId_futuresOrderId_leverage", 由內存鏡像生成
     std::vector<std::string> getActiveTradeGroups();
+    // 單一幣種 [fromTs, toTs] 內的資金費率, 按時間升序
+    std::vector<FundingRecord> getFundingRates(const std::string& symbol, int64_t fromTs, int64_t toTs);
+    // 有資金費率記錄的全部幣種, 按字母排序
+    std::vector<std::string> getFundingSymbols();
+    // 一次查詢多個幣種在 asOfTs (含) 之前最近 depth 筆資金費率, 行順序與 symbols 相同
+    FundingWindow getLatestFundingRates(const std::vector<std::string>& symbols, int depth,
+                                        int64_t asOfTs = std::numeric_limits<int64_t>::max());
     bool isConnectionValid() const;
 };
 
 #endif // SQLITE_STORAGE_H
-
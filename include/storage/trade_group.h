@@ -0,0 +1,44 @@
+#ifndef TRADE_GROUP_H
+#define TRADE_GROUP_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// 對沖組生命週期: 下單中 -> 持有 -> 平倉中 -> 已平倉
+enum class TradeGroupState { Opening, Open, Closing, Closed };
+
+const char* toString(TradeGroupState state);
+std::optional<TradeGroupState> parseTradeGroupState(const std::string& text);
+
+// 單一幣種的現貨多單 + 合約空單對沖記錄. 數量均為正數, 時間為 Unix 毫秒
+struct TradeGroup {
+    int64_t id = 0;                 // 由 SQLiteStorage::openTradeGroup 分配
+    std::string exchangeId;
+    std::string symbol;
+    std::string spotOrderId;        // 最近一筆現貨訂單
+    std::string futuresOrderId;     // 最近一筆合約訂單
+    int leverage = 0;
+    TradeGroupState state = TradeGroupState::Opening;
+    double spotQty = 0.0;
+    double contractQty = 0.0;
+    double spotAvgPrice = 0.0;
+    double contractAvgPrice = 0.0;
+    double fees = 0.0;              // 累計手續費估算 (USDT)
+    int64_t openedAt = 0;
+    int64_t updatedAt = 0;
+    int orderSeq = 0;               // 已分配的下單批次序號, 每次調整倉位前遞增並放入寫入隊列
+
+    // 當前批次某一腿的客戶端訂單號 (Bybit orderLinkId): 由開倉時間, 進程啟動標識, 組 id,
+    // 批次序號及腿組成, 同一進程內重試時不變, 交易所據此去重. 序號不需同步落盤:
+    // 斷電後序號回退, 重啟後的啟動標識也不同. leg: s 現貨, c 合約, u 撤回現貨;
+    // slice 為切片序號, 0 表示不切片
+    std::string orderLinkId(char leg, int slice = 0) const;
+
+    bool active() const { return state != TradeGroupState::Closed; }
+    // 記錄一筆成交: quantity > 0 加倉並更新均價, < 0 減倉 (均價不變)
+    void applySpotFill(double quantity, double price, double feeRate);
+    void applyContractFill(double quantity, double price, double feeRate);
+};
+
+#endif // TRADE_GROUP_H
@@ -0,0 +1,140 @@
+#ifndef BASIS_TRACKER_H
+#define BASIS_TRACKER_H
+
+#include "trading/order_book.h"
+#include "scheduler/clock.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct BasisOptions {
+    bool enabled = false;                          // 是否以基差門控開倉/平倉
+    std::chrono::milliseconds pollInterval{2000};  // 輪詢最佳買賣價的間隔, 0 表示只依賴外部推送
+    size_t window = 600;                           // 百分位數統計的滾動樣本數
+    std::chrono::milliseconds maxSkew{500};        // 現貨與合約報價時間差上限, 超過不計入樣本
+    std::chrono::milliseconds maxAge{10000};       // 最新樣本超過此時間視為過期
+    size_t minSamples = 30;                        // 樣本數不足時不做判斷
+    double ewmaAlpha = 0.05;
+    double entryPercentile = 0.6;                  // 開倉基差需不低於歷史此百分位
+    double exitPercentile = 0.4;                   // 平倉基差需不高於歷史此百分位
+    std::chrono::seconds maxExitDelay{900};        // 平倉因基差不利最多延後的時間
+    double bucketBps = 0.5;                        // 直方圖桶寬 (基點)
+    double rangeBps = 200.0;                       // 直方圖覆蓋 ±rangeBps, 超出範圍歸入兩端
+
+    static BasisOptions fromConfig();
+};
+
+enum class BasisSide { Entry, Exit };
+enum class BasisVerdict { Unknown, Favourable, Unfavourable };
+
+const char* toString(BasisVerdict verdict);
+
+// 固定桶寬的滾動直方圖: 加入樣本 O(1), 百分位查詢只掃描固定數量的桶
+class RollingHistogram {
+public:
+    RollingHistogram(size_t window, double bucketWidth, double range);
+
+    void add(double value);
+    // q 介於 [0, 1]; 沒有樣本時返回 0
+    double percentile(double q) const;
+    size_t size() const { return count; }
+
+private:
+    size_t bucketOf(double value) const;
+
+    double bucketWidth;
+    double range;
+    std::vector<uint32_t> buckets;
+    std::vector<uint16_t> ring;  // 窗口內各樣本所在的桶
+    size_t head = 0;
+    size_t count = 0;
+};
+
+struct BasisSnapshot {
+    double mid = 0.0;        // (合約中間價 - 現貨中間價) / 現貨中間價
+    double entry = 0.0;      // 開倉可成交基差: 合約買一 (賣空) 相對現貨賣一 (買入)
+    double exit = 0.0;       // 平倉可成交基差: 合約賣一 (買回) 相對現貨買一 (賣出)
+    double ewma = 0.0;       // 中間價基差的指數加權均值
+    double ewmaStdDev = 0.0;
+    double entryThreshold = 0.0;  // 開倉基差歷史百分位
+    double exitThreshold = 0.0;   // 平倉基差歷史百分位
+    size_t samples = 0;
+    std::chrono::milliseconds skew{0};
+    bool fresh = false;
+};
+
+// 現貨與永續合約的連續基差追蹤: 每個幣種保留最近一次的雙邊最佳報價,
+// 任一邊更新且另一邊在 maxSkew 之內時產生一個同步樣本, 以 O(1) 更新 EWMA 及滾動直方圖.
+// 報價可由外部推送 (onSpotQuote / onPerpQuote), 或由背景線程按 pollInterval 輪詢觀察列表
+class BasisTracker {
+public:
+    // spot 為 true 時取現貨報價, 否則取合約報價
+    using QuoteSource = std::function<TopOfBook(const std::string& symbol, bool spot)>;
+
+    BasisTracker(IClock& clock, const BasisOptions& options);
+    ~BasisTracker();
+    BasisTracker(const BasisTracker&) = delete;
+    BasisTracker& operator=(const BasisTracker&) = delete;
+
+    // 可在任意線程調用; 返回是否產生了新樣本
+    bool onSpotQuote(const std::string& symbol, const TopOfBook& quote);
+    bool onPerpQuote(const std::string& symbol, const TopOfBook& quote);
+
+    std::optional<BasisSnapshot> snapshot(const std::string& symbol) const;
+    // 樣本不足或已過期時為 Unknown
+    BasisVerdict verdict(const std::string& symbol, BasisSide side) const;
+    const BasisOptions& getOptions() const { return options; }
+
+    void setWatchlist(const std::vector<std::string>& symbols);
+    void start(QuoteSource source);
+    void stop();
+    bool isRunning() const;
+
+private:
+    struct Quote {
+        TopOfBook book;
+        IClock::TimePoint at;
+    };
+
+    struct Series {
+        Series(const BasisOptions& options);
+
+        Quote spot;
+        Quote perp;
+        RollingHistogram entryHistory;
+        RollingHistogram exitHistory;
+        double ewma = 0.0;
+        double ewmaVariance = 0.0;
+        size_t samples = 0;
+        double mid = 0.0;
+        double entry = 0.0;
+        double exit = 0.0;
+        std::chrono::milliseconds skew{0};
+        IClock::TimePoint sampledAt;
+    };
+
+    bool onQuote(const std::string& symbol, const TopOfBook& quote, bool spot);
+    Series& seriesLocked(const std::string& symbol);
+    void run();
+
+    IClock& clock;
+    BasisOptions options;
+
+    mutable std::mutex stateMutex;
+    std::unordered_map<std::string, Series> series;
+    std::vector<std::string> watchlist;
+
+    QuoteSource source;
+    std::condition_variable wakeCv;
+    bool running = false;
+    std::thread worker;
+};
+
+#endif // BASIS_TRACKER_H
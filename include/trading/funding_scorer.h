@@ -0,0 +1,70 @@
+#ifndef FUNDING_SCORER_H
+#define FUNDING_SCORER_H
+
+#include "storage/funding_series.h"
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 資金費率評分參數 (對應 trading.funding_rate_scoring 及 top_pairs_count)
+struct ScoringParams {
+    std::vector<int> periods;      // 各時間段的結算次數
+    std::vector<double> weights;   // 各時間段權重, 與 periods 一一對應
+    int topPairsCount = 5;
+    bool reverseContractFundingRate = false;
+
+    static ScoringParams fromConfig();
+    bool valid() const { return !periods.empty() && periods.size() == weights.size(); }
+    // 評分需要的最多歷史筆數
+    int maxLookback() const;
+};
+
+// 倉位縮放參數 (對應 trading.position_scaling 等設定)
+struct PositionSizing {
+    double minPositionValue = 100.0;
+    double maxPositionValue = 200.0;
+    bool positionScaling = true;
+    double scalingFactor = 1.5;
+    double minScalingRate = 0.001;
+    double maxScalingRate = 0.01;
+
+    static PositionSizing fromConfig();
+    // 按資金費率計算目標倉位價值 (USDT), 未做精度調整
+    double targetValue(double rate) const;
+    double scalingMultiplier(double rate) const;
+};
+
+// 純計算的資金費率評分器: 不讀取配置、不輸出日誌, 可在多線程中共用
+class FundingScorer {
+public:
+    enum class Result {
+        Scored,
+        NoData,
+        NegativeNotSupported,   // 不支援反向費率且最新費率為負
+        ContradictsLatest       // 最新費率與加權分數方向相反
+    };
+
+    explicit FundingScorer(ScoringParams params);
+
+    // rates 以最新在前排列
+    Result score(std::span<const double> rates, double& score) const;
+    // rates 以時間升序排列 (最新在後), 用於直接評分歸檔映射出的序列而不必複製反轉
+    Result scoreOldestFirst(std::span<const double> rates, double& score) const;
+
+    // 對所有幣對評分, 按分數絕對值降序並保留前 topPairsCount 名
+    std::vector<std::pair<std::string, double>> rank(
+        const std::vector<std::pair<std::string, std::vector<double>>>& histories) const;
+    // 同上, 直接使用本地資料庫讀出的連續資料
+    std::vector<std::pair<std::string, double>> rank(const FundingWindow& window) const;
+
+    const ScoringParams& params() const { return scoringParams; }
+
+private:
+    ScoringParams scoringParams;
+};
+
+// 按分數絕對值降序排列並截取前 topCount 名 (topCount <= 0 表示不截取)
+void sortAndTruncateScores(std::vector<std::pair<std::string, double>>& scores, int topCount);
+
+#endif // FUNDING_SCORER_H
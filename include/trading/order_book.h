@@ -0,0 +1,40 @@
+#ifndef ORDER_BOOK_H
+#define ORDER_BOOK_H
+
+#include <string>
+#include <vector>
+#include <json/json.h>
+
+struct BookLevel {
+    double price;
+    double quantity;
+};
+
+// 最佳買賣價, 任一側缺失時為 0
+struct TopOfBook {
+    double bid = 0.0;
+    double ask = 0.0;
+
+    bool valid() const { return bid > 0 && ask > 0 && ask >= bid; }
+    double mid() const { return (bid + ask) / 2; }
+};
+
+// 解析一層報價 ["價格", "數量"], 直接讀取 JSON 字串緩衝區而不建立臨時字串;
+// 格式無效或數值不為正時返回 false
+bool parseBookLevel(const Json::Value& level, BookLevel& out);
+
+// 解析 Bybit 訂單簿回應的一側: "a" 為賣單 (買入時吃單), "b" 為買單 (賣出時吃單)
+std::vector<BookLevel> parseBookSide(const Json::Value& orderbook, const std::string& side);
+
+// 只讀取兩側第一個有效價位, 不分配記憶體
+TopOfBook parseTopOfBook(const Json::Value& orderbook);
+
+// 吃掉 quantity 數量時相對最佳價的平均滑點比例 (深度不足時按可成交部分計算)
+double averageImpact(const std::vector<BookLevel>& levels, double quantity);
+
+// 成本曲線反解: 平均滑點不超過 maxImpact 時可成交的最大數量
+double maxQuantityWithinImpact(const std::vector<BookLevel>& levels, double maxImpact);
+
+double totalDepth(const std::vector<BookLevel>& levels);
+
+#endif // ORDER_BOOK_H
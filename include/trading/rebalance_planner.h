@@ -0,0 +1,66 @@
+#ifndef REBALANCE_PLANNER_H
+#define REBALANCE_PLANNER_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 單一幣對的目標對衝倉位 (合約數量為空單大小, 以正數表示)
+struct HedgeTarget {
+    std::string symbol;
+    double spotQty;
+    double contractQty;
+    int priority;  // 資金費率排名, 數值越小越優先
+};
+
+// 單一幣對需要執行的淨額調整
+struct SymbolRebalance {
+    std::string symbol;
+    double currentSpot;
+    double currentContract;
+    double spotDelta;      // > 0 買入現貨, < 0 賣出現貨
+    double contractDelta;  // > 0 增加空單 (Sell), < 0 減少空單 (Buy)
+    int priority;
+    double marginImpact;   // 帶符號的名義價值變化 (USDT), 正值佔用保證金
+
+    bool isReducing() const { return marginImpact < 0; }
+    bool isClosing() const {
+        return currentSpot + spotDelta <= 0 && currentContract + contractDelta <= 0;
+    }
+    int orderCount() const { return (spotDelta != 0 ? 1 : 0) + (contractDelta != 0 ? 1 : 0); }
+};
+
+struct RebalancePlan {
+    std::vector<SymbolRebalance> actions;  // 已按執行順序排列
+    double tradedNotional = 0.0;     // 淨額後需成交的名義價值
+    double roundTripNotional = 0.0;  // 全部平倉再重開所需成交的名義價值
+
+    bool empty() const { return actions.empty(); }
+    int orderCount() const;
+};
+
+// 淨額再平衡規劃: 先計算每個幣對的目標現貨/合約數量, 與現有持倉軋差後
+// 只下淨額訂單, 避免仍在排行中的倉位被全平再重開
+class RebalancePlanner {
+public:
+    struct Options {
+        double minOrderValue = 5.0;    // 低於此名義價值 (USDT) 的調整忽略
+        double minDeltaRatio = 0.003;  // 相對目標數量的容忍度, 與倉位平衡檢查一致
+    };
+
+    RebalancePlanner() = default;
+    explicit RebalancePlanner(const Options& options) : options(options) {}
+
+    // holdings 與 prices 的值均為 (現貨, 合約); 不在 targets 中的持倉目標為 0
+    RebalancePlan plan(const std::map<std::string, std::pair<double, double>>& holdings,
+                       const std::vector<HedgeTarget>& targets,
+                       const std::map<std::string, std::pair<double, double>>& prices) const;
+
+private:
+    double filterDelta(double delta, double target, double price) const;
+
+    Options options;
+};
+
+#endif // REBALANCE_PLANNER_H
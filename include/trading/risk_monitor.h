@@ -0,0 +1,124 @@
+#ifndef RISK_MONITOR_H
+#define RISK_MONITOR_H
+
+#include "logger.h"
+#include "scheduler/clock.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct RiskOptions {
+    bool enabled = false;
+    std::chrono::milliseconds pollInterval{1000};   // 輪詢行情的間隔, 0 表示只依賴 onPrice 推送
+    double maintenanceMarginRate = 0.005;           // 合約維持保證金率
+    double spotCollateralRatio = 1.0;               // 現貨計入帳戶權益的折扣率
+    double warnRatio = 0.5;                         // 保證金率 (維持保證金 / 可用保證金) 警告門檻
+    double deleverageRatio = 0.7;                   // 達到此門檻時預先減倉
+    double deleverageFraction = 0.25;               // 每次減倉比例
+    std::chrono::seconds deleverageCooldown{30};    // 同一幣種兩次減倉的最短間隔
+
+    static RiskOptions fromConfig();
+};
+
+// 單一對沖倉位: 現貨多單 + 合約空單, 數量均為正數
+struct RiskPosition {
+    std::string symbol;
+    double spotQty = 0.0;
+    double contractQty = 0.0;
+    double contractEntryPrice = 0.0;
+    int leverage = 1;
+};
+
+enum class RiskLevel { Normal, Warning, Deleverage };
+
+struct RiskAlert {
+    std::string symbol;                  // 需要減倉的幣種 (帳戶觸發時為保證金率最高者)
+    RiskLevel level = RiskLevel::Normal;
+    double positionRatio = 0.0;
+    double accountRatio = 0.0;
+    bool accountTriggered = false;
+    double reduceFraction = 0.0;         // 建議減倉比例
+    std::chrono::steady_clock::time_point tickAt;   // 觸發此警報的行情到達時間
+};
+
+// 保證金及強平風險監控: 每筆行情只增量更新該幣種的貢獻 (O(1)), 跨過門檻時
+// 由背景線程立即調用減倉處理函數, 不必等下一個策略週期.
+// 行情可由外部推送 (onPrice), 或由背景線程按 pollInterval 向 PriceSource 輪詢
+class RiskMonitor {
+public:
+    // 返回 (現貨價, 合約價), 取不到時為 0
+    using PriceSource = std::function<std::pair<double, double>(const std::string&)>;
+    using DeleverageHandler = std::function<void(const RiskAlert&)>;
+
+    RiskMonitor(IClock& clock, const RiskOptions& options);
+    ~RiskMonitor();
+    RiskMonitor(const RiskMonitor&) = delete;
+    RiskMonitor& operator=(const RiskMonitor&) = delete;
+
+    // 以新的持倉簿及帳戶權益重設基準; 參考價在每個幣種的下一筆行情時確定
+    void sync(const std::vector<RiskPosition>& positions, double equity);
+    // 單一幣種數量變化 (例如減倉後): 已實現的盈虧併入權益基準
+    void updatePosition(const RiskPosition& position);
+    // 可在任意線程調用
+    void onPrice(const std::string& symbol, double spotPrice, double contractPrice);
+
+    double accountMarginRatio() const;
+    double positionMarginRatio(const std::string& symbol) const;
+    double equity() const;
+    std::vector<std::string> symbols() const;
+
+    void setDeleverageHandler(DeleverageHandler handler);
+    void start(PriceSource source);
+    void stop();
+    bool isRunning() const;
+
+private:
+    struct Entry {
+        RiskPosition position;
+        double spotRef = 0.0;        // 基準價, 0 表示尚未收到行情
+        double contractRef = 0.0;
+        double spotPrice = 0.0;      // 最新行情
+        double contractPrice = 0.0;
+        double pnl = 0.0;            // 相對基準價的未實現盈虧 (已計入 pnlSum)
+        double maintenance = 0.0;    // 已計入 maintenanceSum
+        double ratio = 0.0;
+        RiskLevel level = RiskLevel::Normal;
+        IClock::TimePoint lastDeleverage;
+    };
+
+    void run();
+    void refreshLocked(Entry& entry);
+    void evaluateLocked(Entry& entry, std::chrono::steady_clock::time_point tickAt);
+    double accountRatioLocked() const;
+    bool coolingDown(const Entry& entry, IClock::TimePoint now) const;
+    void drainAlerts();
+
+    IClock& clock;
+    RiskOptions options;
+    Logger logger;
+
+    mutable std::mutex stateMutex;
+    std::unordered_map<std::string, Entry> entries;
+    double baseEquity = 0.0;
+    double pnlSum = 0.0;
+    double maintenanceSum = 0.0;
+    RiskLevel accountLevel = RiskLevel::Normal;
+    std::deque<RiskAlert> alerts;
+
+    std::mutex handlerMutex;
+    DeleverageHandler handler;
+
+    PriceSource source;
+    std::condition_variable wakeCv;
+    bool running = false;
+    std::thread worker;
+};
+
+#endif // RISK_MONITOR_H
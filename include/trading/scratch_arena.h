@@ -0,0 +1,23 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+// 單次計算用的暫存區: 先使用內嵌緩衝區 (通常在棧上), 用完才向全局分配器申請,
+// 析構時一次釋放. 只用於生命週期不超過該次計算的臨時容器
+template <size_t Bytes>
+class ScratchArena {
+public:
+    ScratchArena() : resource(buffer, Bytes) {}
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    std::pmr::memory_resource* get() { return &resource; }
+
+private:
+    alignas(std::max_align_t) std::byte buffer[Bytes];
+    std::pmr::monotonic_buffer_resource resource;
+};
+
+#endif // SCRATCH_ARENA_H
@@ -0,0 +1,103 @@
+#ifndef SLICED_EXECUTOR_H
+#define SLICED_EXECUTOR_H
+
+#include "exchange/exchange_interface.h"
+#include "scheduler/clock.h"
+#include "logger.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 子單間隔方式: 固定時間間隔, 或等待訂單簿補充深度後立即下單
+enum class SliceTrigger {
+    Time,
+    Replenish
+};
+
+// 一組需要同步成交的對衝訂單: 現貨與合約數量相同, 方向相反
+struct HedgeSliceRequest {
+    std::string symbol;
+    std::string spotSide;      // "Buy" / "Sell"
+    std::string contractSide;  // "Sell" / "Buy"
+    double quantity;
+    double minQuantity;        // 子單最小數量, 剩餘低於此值時結束
+    double spotQtyMultiplier = 1.0;  // 現貨買入時用於補足手續費
+    std::function<double(double)> roundSpot;
+    std::function<double(double)> roundContract;
+    // 子單的客戶端訂單號 (leg: s 現貨, c 合約, u 撤回現貨; slice 從 1 開始), 未設置時不帶訂單號
+    std::function<std::string(char leg, int slice)> orderLinkId;
+    // 每個子單前及等待期間檢查, 返回 true 時停止 (例如有減倉在等待執行鎖), 未設置時不檢查
+    std::function<bool()> preempted;
+};
+
+struct SliceProgress {
+    std::string symbol;
+    double targetQuantity = 0.0;
+    double spotFilled = 0.0;
+    double contractFilled = 0.0;
+    int slicesDone = 0;
+    std::vector<double> sliceQuantities;   // 已完成子單 (切片序號 1..slicesDone) 各自的數量
+    bool running = false;
+    bool cancelled = false;
+    bool failed = false;
+    std::string message;
+
+    double completion() const {
+        return targetQuantity > 0 ? contractFilled / targetQuantity : 0.0;
+    }
+};
+
+// 深度感知的切片執行: 按訂單簿成本曲線決定子單大小, 現貨與合約子單
+// 成對下單以維持對衝比例, 支援取消及進度回報
+class SlicedExecutor {
+public:
+    struct Options {
+        double maxSliceImpact = 0.0005;   // 單一子單允許的平均滑點
+        int maxSlices = 20;
+        int sliceIntervalMs = 2000;
+        SliceTrigger trigger = SliceTrigger::Time;
+        int replenishPollMs = 250;
+        int replenishTimeoutMs = 10000;   // 深度長時間未恢復時中止
+    };
+
+    using ProgressCallback = std::function<void(const SliceProgress&)>;
+
+    SlicedExecutor(IExchange& exchange, IClock& clock);
+    SlicedExecutor(IExchange& exchange, IClock& clock, const Options& options);
+
+    static Options optionsFromConfig();
+
+    // 整筆訂單在任一邊的滑點超過單一子單上限時需要切片
+    bool needsSlicing(const std::string& symbol, const std::string& spotSide,
+                      const std::string& contractSide, double quantity);
+
+    SliceProgress execute(const HedgeSliceRequest& request, ProgressCallback onProgress = nullptr);
+
+    // 可在其他線程調用; 當前子單完成後停止. 在 execute() 開始前調用同樣有效,
+    // 取消在該次執行結束後才清除
+    void cancel();
+    SliceProgress progress() const;
+    const Options& getOptions() const { return options; }
+
+private:
+    // 兩邊訂單簿在滑點限制內可同時成交的數量
+    double sliceCapacity(const std::string& symbol, const std::string& spotSide,
+                         const std::string& contractSide);
+    bool waitForDepth(const HedgeSliceRequest& request, double wanted);
+    bool stopRequested(const HedgeSliceRequest& request) const;
+    // 分段等待以便及時響應取消; 被取消時返回 false
+    bool pause(const HedgeSliceRequest& request, std::chrono::milliseconds duration);
+    void publish(const SliceProgress& snapshot, const ProgressCallback& onProgress);
+
+    IExchange& exchange;
+    IClock& clock;
+    Options options;
+    Logger logger;
+    std::atomic<bool> cancelRequested{false};
+    mutable std::mutex progressMutex;
+    SliceProgress current;
+};
+
+#endif // SLICED_EXECUTOR_H
@@ -0,0 +1,89 @@
+#ifndef SYMBOL_REGISTRY_H
+#define SYMBOL_REGISTRY_H
+
+#include "config.h"
+#include "logger.h"
+#include "scheduler/clock.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct SymbolBlockOptions {
+    std::string filePath = Config::PAIR_LIST_FILE;
+    std::chrono::hours ttl{24};                     // 0 表示永久封鎖
+    std::chrono::milliseconds flushInterval{2000};  // 批次寫盤間隔
+
+    static SymbolBlockOptions fromConfig();
+};
+
+struct BlockedSymbol {
+    std::string reason;
+    IClock::TimePoint firstSeen;
+    IClock::TimePoint expiresAt = IClock::TimePoint::max();
+
+    bool permanent() const { return expiresAt == IClock::TimePoint::max(); }
+};
+
+// 不支持交易對登記表: 記憶體中的並發集合, 查詢只取共享鎖.
+// 變更由背景線程批次寫回 pair_list.json (先寫臨時文件再改名);
+// 永久項目寫入 unsupported_symbols, 有期限的項目寫入 blocked_symbols
+class SymbolRegistry {
+public:
+    SymbolRegistry(IClock& clock, const SymbolBlockOptions& options);
+    // 同一文件在進程內只有一個登記表, 多帳戶共用, 避免各自寫盤互相覆蓋.
+    // 已存在時沿用首次建立時的 clock 及 options; filePath 為空時每次返回新的登記表
+    static std::shared_ptr<SymbolRegistry> shared(IClock& clock, const SymbolBlockOptions& options);
+    ~SymbolRegistry();
+    SymbolRegistry(const SymbolRegistry&) = delete;
+    SymbolRegistry& operator=(const SymbolRegistry&) = delete;
+
+    // 以配置快照取代內容; 尚未寫盤的變更會保留. 同一版本只載入一次
+    void sync(const ConfigSnapshot& snapshot);
+
+    bool isBlocked(const std::string& symbol) const;
+    std::optional<BlockedSymbol> find(const std::string& symbol) const;
+    std::vector<std::string> blockedSymbols() const;
+
+    // 新增封鎖並排入寫盤; 已封鎖時返回 false
+    bool block(const std::string& symbol, const std::string& reason);
+    bool unblock(const std::string& symbol);
+    // 移除已過期項目, 返回移除數量
+    size_t purgeExpired();
+
+    void start();
+    void stop();
+    // 立即同步寫盤, 沒有待寫變更時直接返回 true
+    bool flush();
+
+private:
+    void run();
+    void markDirty();
+    bool writeFile(const std::unordered_map<std::string, BlockedSymbol>& entries);
+
+    IClock& clock;
+    SymbolBlockOptions options;
+    Logger logger;
+
+    mutable std::shared_mutex entriesMutex;
+    std::unordered_map<std::string, BlockedSymbol> entries;
+    std::unordered_set<std::string> pending;  // 上次寫盤後變更過的交易對
+    uint64_t loadedVersion = 0;
+
+    std::mutex flushMutex;                    // 序列化寫盤
+    std::mutex workerMutex;
+    std::condition_variable workerCv;
+    bool running = false;
+    bool dirty = false;
+    std::thread worker;
+};
+
+#endif // SYMBOL_REGISTRY_H
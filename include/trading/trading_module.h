@@ -1,16 +1,44 @@
 #ifndef TRADING_MODULE_H
 #define TRADING_MODULE_H
 
+#include "config.h"
 #include "exchange/exchange_interface.h"
+#include "exchange/coin_market_cap.h"
 #include "storage/sqlite_storage.h"
+#include "trading/basis_tracker.h"
+#include "trading/funding_scorer.h"
+#include "trading/rebalance_planner.h"
+#include "trading/risk_monitor.h"
+#include "trading/sliced_executor.h"
+#include "trading/symbol_registry.h"
+#include "trading/universe_provider.h"
+#include "trading/warm_state.h"
+#include "scheduler/clock.h"
+#include "scheduler/settlement_calendar.h"
+#include "scheduler/trading_pipeline.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <set>
 #include <vector>
 #include <utility>
 #include "logger.h"
 
 std::vector<std::string> splitString(const std::string& str, const std::string& delimiter);
 
+// 持久化輸出位置. 默認使用工作目錄下正式的數據庫, pair_list.json 及配置中的重啟快照;
+// 回測等離線運行指向自己的位置, 不影響同一目錄下運行中的實盤進程
+struct TradingSinks {
+    SQLiteStorage* storage = nullptr;          // nullptr 使用 SQLiteStorage::getInstance()
+    std::optional<std::string> pairListPath;   // 不支持交易對的登記文件, 空字串表示只保留在內存
+    bool warmState = true;                     // false 時不載入也不保存重啟快照
+};
+
 class TradingModule {
 private:
     static std::mutex mutex_;
@@ -18,9 +46,64 @@ private:
     IExchange& exchange;
     SQLiteStorage& storage;
     Logger logger;
- std::vector<std::pair<std::string, double>> cachedFundingRates;
+    // 子帳戶名稱及覆蓋配置, 單一帳戶模式時為空
+    const std::string accountName;
+    const Json::Value configOverrides;
+    mutable std::mutex configMutex;
+    mutable Config::Snapshot accountConfig;
+    mutable Config::Snapshot accountConfigBase;
+    // 序列化本帳戶的下單 (策略週期與風險監控減倉)
+    std::mutex executionMutex;
+    // 等待執行鎖的減倉數目: 再平衡在每個幣種之間檢查並讓出執行鎖.
+    // 本批次已減倉的幣種不再按舊持倉調整
+    std::mutex deleverageMutex;
+    std::condition_variable deleverageCv;
+    int deleveragePending = 0;
+    std::set<std::string> deleveragedSymbols;
+    IClock& clock;
+    SettlementCalendar settlementCalendar;
+    RebalancePlanner rebalancePlanner;
+    SlicedExecutor slicedExecutor;
+    // 多帳戶共用同一個登記表 (同一 pair_list.json)
+    std::shared_ptr<SymbolRegistry> symbolRegistry;
+    std::unique_ptr<CoinMarketCapSource> cmcSource;
+    std::unique_ptr<UniverseProvider> universeProvider;
+    // 流水線模式下排名由行情線程寫入, 執行線程保存快照時讀取
+    mutable std::mutex ratesMutex;
+    std::vector<std::pair<std::string, double>> cachedFundingRates;
     std::chrono::system_clock::time_point lastFundingUpdate;
-    TradingModule(IExchange& exchange);
+    std::vector<std::string> symbolUniverse;
+    WarmStateOptions warmStateOptions;
+    // 手續費率每個結算週期查詢一次, 負數表示尚未取得
+    std::atomic<double> spotFeeRate{-1.0};
+    std::atomic<double> contractFeeRate{-1.0};
+    // 最後一次成功取得的持倉, 隨快照保存; 風險監控線程也會讀寫
+    mutable std::mutex positionBookMutex;
+    std::map<std::string, std::pair<double, double>> positionBook;
+    bool positionBookKnown = false;
+    // 快照中的持倉, 重啟後第一次取得實際持倉時比對並清空
+    std::optional<std::map<std::string, std::pair<double, double>>> restoredPositions;
+    BasisOptions basisOptions;
+    BasisTracker basisTracker;
+    // 因基差不利而延後平倉的幣種及開始延後的時間
+    std::map<std::string, IClock::TimePoint> exitDeferredSince;
+    RiskOptions riskOptions;
+    // 最後析構: 背景線程的減倉處理會使用上面的成員
+    RiskMonitor riskMonitor;
+    PipelineOptions pipelineOptions;
+    // 流水線線程使用上面全部成員 (包括風險監控), 最先析構
+    std::unique_ptr<TradingPipeline> pipeline;
+    TradingModule(IExchange& exchange, IClock& clock, const AccountConfig& account, const TradingSinks& sinks);
+    // 全局配置合併本帳戶覆蓋後的快照
+    Config::Snapshot currentConfig() const;
+    // 以本帳戶的配置調用 Options::fromConfig() 一類的建構函數
+    template <typename Build>
+    auto fromAccountConfig(Build build) const {
+        ConfigSnapshotScope scope(currentConfig());
+        return build();
+    }
+    // 持倉記錄的交易所標識, 子帳戶附加帳戶名稱
+    std::string exchangeId() const;
     struct BalanceCheckResult {
         bool needBalance;
         double priceDiff;
@@ -43,37 +126,115 @@ private:
         const std::map<std::string, std::pair<double, double>>& positions, 
         IExchange& exchange);
     double calculateAdjustedPosition(double basePosition, double rate);
-    void updateUnsupportedSymbols(const std::string& symbol);
-    std::map<std::string, std::pair<double, double>> getCurrentPositionSizes();
-    void handleExistingPositions(std::map<std::string, std::pair<double, double>>& positionSizes,
-                                const std::vector<std::pair<std::string, double>>& topRates);
-    void balancePositions(const std::vector<std::pair<std::string, double>>& topRates,
-                          std::map<std::string, std::pair<double, double>>& positionSizes);
+    void updateUnsupportedSymbols(const std::string& symbol, const std::string& reason);
+    std::map<std::string, std::pair<double, double>> getCurrentPositionSizes(bool* fetched = nullptr);
+    double getSpotFeeRate();
+    double getContractFeeRate();
+    void reconcileRestoredPositions(const std::map<std::string, std::pair<double, double>>& live);
     void handleError(const std::string& symbol, const std::string& error);
     BalanceCheckResult checkPositionBalance(const std::string& symbol, 
                                           double spotSize, 
                                           double contractSize);
+    // 基差門控: 未啟用, 樣本不足或基差有利時允許開倉
+    bool basisAllowsEntry(const std::string& symbol);
+    // 平倉基差不利時延後平倉, 最多延後 maxExitDelay
+    bool deferExit(const std::string& symbol);
     double calculateDepthImpact(const Json::Value& orderbook, double size);
     double calculateRebalanceCost(const std::string& symbol, double size, bool isSpot, const Json::Value& orderbook);
     double calculateExpectedProfit(double size, double fundingRate);
-    bool createSpotOrderIncludeFee(const std::string& symbol, const std::string& side, double qty);
-    bool executeHedgePosition(
-        const std::string& symbol,
-        double targetValue,
-        const BalanceCheckResult& balanceCheck,
+    bool createSpotOrderIncludeFee(const std::string& symbol, const std::string& side, double qty,
+                                   const std::string& orderLinkId = "");
+    bool executeSymbolRebalance(
+        const SymbolRebalance& action,
         std::map<std::string, std::pair<double, double>>& positionSizes);
+    SliceProgress executeSlicedHedge(const TradeGroup& group, bool increase, double quantity);
+    // 調整前取得 (或建立) 幣種的未平倉對沖組, 標記為下單中/平倉中並分配新的下單批次序號
+    TradeGroup beginTradeGroup(const SymbolRebalance& action);
+    // 一筆已成交的訂單 (數量帶符號: 現貨買入, 合約加空為正)
+    struct LegFill {
+        bool spot;
+        double quantity;
+        std::string orderLinkId;
+        double price = 0.0;     // 下單響應已帶成交均價時填入
+    };
+    // 兩腿都下單後才按成交均價更新對沖組, 查詢不會延後對沖; 倉位歸零時標記為已平倉
+    void finishTradeGroup(TradeGroup group, const std::vector<LegFill>& fills);
+    // 成交均價: 下單響應, 否則按訂單號查詢; 查不到時減倉沿用組的均價, 最後才用行情價格
+    double fillPrice(const TradeGroup& group, const LegFill& fill);
+    // 以最新持倉簿及帳戶權益重設風險監控基準
+    void syncRiskMonitor();
+    // 減倉或平倉成交後從持倉簿扣除, 並更新風險監控中該幣種的數量
+    void reducePosition(const TradeGroup& group, double spotSold, double contractBought);
+    // 風險監控線程調用: 先買回部分合約空單, 再賣出等量現貨
+    void deleverage(const RiskAlert& alert);
+    // 有減倉等待時釋放執行鎖, 待減倉取得鎖後再重新等待; 返回 symbol 是否已在此期間減倉
+    bool yieldToDeleverage(std::unique_lock<std::mutex>& lock, const std::string& symbol);
     double calculateTotalPositionValue(
         const std::map<std::string, std::pair<double, double>>& positions,
         bool positionsIsSize,
         const std::map<std::string, std::pair<double, double>>* prices);
     std::vector<std::string> getSymbolsByCMC(int topCount);
-    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
     void displayPositionSizes(const std::map<std::string, std::pair<double, double>>& positionSizes);
+    void refreshFundingRatesNow();
+    // 在當前線程依次執行行情, 策略, 執行三個階段
+    void runHedgeCycle();
+    // 分配統計啟用時發佈各區段累計並輸出分配最多的區段
+    void reportAllocations();
+    // 基準測試 (benchmarks/) 直接調用內部熱路徑
+    friend struct BenchmarkAccess;
 public:
-    static TradingModule& getInstance(IExchange& exchange);
+    static TradingModule& getInstance(IExchange& exchange,
+                                      IClock& clock = SystemClock::getInstance());
+    // 多帳戶模式: 每個子帳戶一個實例, 由調用方持有; 回測以空帳戶及獨立的 sinks 建立
+    static std::unique_ptr<TradingModule> createForAccount(IExchange& exchange, IClock& clock,
+                                                           const AccountConfig& account,
+                                                           const TradingSinks& sinks = TradingSinks());
+    const std::string& getAccountName() const;
     std::vector<std::pair<std::string, double>> getTopFundingRates();
-    void closeTradeGroup(const std::string& group);
-    void executeHedgeStrategy();
+    // 按對沖組記錄的數量平倉, 不需要重新查詢持倉; 組不存在或下單失敗時返回 false
+    bool closeTradeGroup(int64_t groupId);
+    // 流水線運行時只投遞週期請求, afterExecution 由執行線程在本週期執行後調用;
+    // 否則在當前線程依次執行以下三個階段後調用 afterExecution
+    void executeHedgeStrategy(std::function<void()> afterExecution = {});
+    // 流水線運行時返回 true, 調用方只投遞請求而不在當前線程執行
+    bool pipelineRunning() const;
+    // 階段一 (行情): 取得排名及持倉; 持倉查詢失敗時返回 false
+    bool captureSnapshot(MarketSnapshot& snapshot);
+    // 階段二 (策略): 根據快照計算再平衡計劃
+    RebalancePlan decide(const MarketSnapshot& snapshot);
+    // 階段三 (執行): 下單, 輸出持倉並保存快照
+    void executeDecision(StrategyDecision& decision);
+    // 計算目標倉位並與現有持倉軋差, 得到按優先順序排列的淨額訂單
+    RebalancePlan planRebalance(
+        const std::vector<std::pair<std::string, double>>& topRates,
+        const std::map<std::string, std::pair<double, double>>& positionSizes);
+    void executeRebalancePlan(
+        const RebalancePlan& plan,
+        std::map<std::string, std::pair<double, double>>& positionSizes);
+    // 取消正在進行的切片執行 (可在其他線程調用)
+    void cancelExecution();
+    SliceProgress getExecutionProgress() const;
+    // 結算後排程調用: 丟棄緩存並重新計算資金費率排名 (流水線運行時交由行情線程),
+    // 完成後調用 afterRefresh
+    void refreshFundingRates(std::function<void()> afterRefresh = {});
+    // 載入重啟快照: 恢復本結算週期內算出的排名及手續費率, 持倉留待下一次查詢時比對.
+    // 快照不存在或過期時返回 false, 之後照常從交易所重建
+    bool warmStart();
+    // 保存重啟快照, 未設定快照路徑時直接返回 true
+    bool saveWarmState();
+    // 啟動基差追蹤輪詢線程 (basis_tracker.poll_interval_ms 為 0 時只使用策略週期取得的訂單簿)
+    void startBasisTracker();
+    void stopBasisTracker();
+    std::optional<BasisSnapshot> getBasis(const std::string& symbol) const;
+    // 啟動保證金風險監控線程 (trading.risk_monitor.enabled 為 false 時不做任何事)
+    void startRiskMonitor();
+    void stopRiskMonitor();
+    // 啟動行情/策略/執行三線程流水線 (pipeline.enabled 為 false 時不做任何事)
+    void startPipeline();
+    void stopPipeline();
+    std::optional<PipelineStats> getPipelineStats() const;
+    // 指定候選幣種, 取代 CMC 或配置中的交易對列表; 傳入空列表則恢復預設
+    void setSymbolUniverse(const std::vector<std::string>& symbols);
     static void resetInstance() {
         std::lock_guard<std::mutex> lock(mutex_);
         instance.reset();
@@ -0,0 +1,84 @@
+#ifndef UNIVERSE_PROVIDER_H
+#define UNIVERSE_PROVIDER_H
+
+#include "logger.h"
+#include "scheduler/clock.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 候選幣種來源 (CoinMarketCap 或測試替身)
+class IUniverseSource {
+public:
+    virtual ~IUniverseSource() = default;
+    // 取得排名前 topCount 的交易對; 失敗時返回 false 並填入 error
+    virtual bool fetch(int topCount, const std::string& sortBy,
+                       std::vector<std::string>& symbols, std::string& error) = 0;
+};
+
+struct UniverseOptions {
+    int topCount = 50;
+    std::string sortBy = "volume_7d";
+    std::string cachePath = "cmc_universe.json";  // 空字串表示不寫文件
+    std::chrono::seconds ttl{std::chrono::hours(6)};
+    std::chrono::seconds retryInterval{std::chrono::minutes(5)};  // 刷新失敗後的重試間隔
+
+    static UniverseOptions fromConfig();
+};
+
+// 幣種列表緩存: 讀取只返回內存中的列表, 過期後由背景線程刷新 (stale-while-revalidate).
+// 來源出錯或額度用完時保留上一份成功的列表, 並持久化到文件供重啟後使用
+class UniverseProvider {
+public:
+    UniverseProvider(IUniverseSource& source, IClock& clock, const UniverseOptions& options);
+    ~UniverseProvider();
+    UniverseProvider(const UniverseProvider&) = delete;
+    UniverseProvider& operator=(const UniverseProvider&) = delete;
+
+    // 當前列表, 不會等待網絡. 過期時喚醒背景線程刷新
+    std::vector<std::string> symbols();
+    // 同步刷新一次, 成功時替換列表並寫入文件
+    bool refresh();
+    // 從文件載入上次成功的列表, 文件不存在或格式不符時返回 false
+    bool loadCache();
+
+    bool empty() const;
+    bool isStale() const;
+    IClock::TimePoint fetchedAt() const;
+
+    void start();
+    void stop();
+
+private:
+    struct CacheEntry {
+        std::vector<std::string> symbols;
+        IClock::TimePoint fetchedAt;
+    };
+
+    void run();
+    bool refreshIfDue();
+    bool saveCache(const CacheEntry& entry);
+    IClock::TimePoint nextRefreshLocked() const;
+
+    IUniverseSource& source;
+    IClock& clock;
+    UniverseOptions options;
+    Logger logger;
+
+    mutable std::mutex stateMutex;        // 保護列表, 刷新狀態及背景線程旗標
+    std::shared_ptr<const CacheEntry> current;
+    IClock::TimePoint lastAttempt;
+    bool lastAttemptFailed = false;
+
+    std::mutex refreshMutex;              // 同一時間只有一個刷新請求
+    std::condition_variable workerCv;
+    bool running = false;
+    bool wakeRequested = false;
+    std::thread worker;
+};
+
+#endif // UNIVERSE_PROVIDER_H
@@ -0,0 +1,40 @@
+#ifndef WARM_STATE_H
+#define WARM_STATE_H
+
+#include "scheduler/clock.h"
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <json/json.h>
+
+struct WarmStateOptions {
+    std::string path;                                      // 空字串表示不保存
+    std::chrono::seconds maxAge{std::chrono::hours(1)};    // 超過此時間的快照整份丟棄
+
+    static WarmStateOptions fromConfig();
+};
+
+// 重啟後可直接沿用的衍生狀態. 資金費率序列 (SQLiteStorage) 及不支持交易對
+// (SymbolRegistry) 已各自持久化, 這裡只保存需要網絡往返才能重建的部分
+struct WarmState {
+    IClock::TimePoint savedAt;
+    IClock::TimePoint rankedAt;                                     // 排名計算時間
+    std::vector<std::pair<std::string, double>> rankings;           // 按分數排序的評分結果
+    double spotFeeRate = -1.0;                                      // 負數表示未知
+    double contractFeeRate = -1.0;
+    std::map<std::string, std::pair<double, double>> positions;     // 最後一次取得的 (現貨, 合約) 持倉
+    bool positionsKnown = false;
+
+    Json::Value toJson() const;
+    static std::optional<WarmState> fromJson(const Json::Value& root);
+
+    // 寫入臨時文件後改名, 失敗時返回 false
+    bool save(const std::string& path) const;
+    // 文件不存在, 無法解析或版本不符時返回空
+    static std::optional<WarmState> load(const std::string& path);
+};
+
+#endif // WARM_STATE_H
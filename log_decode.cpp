@@ -0,0 +1,87 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <ctime>
+#include "logging/binary_log.h"
+#include "logging/log_backend.h"
+
+// 二進位日誌解碼工具: 將 logging.binary_file 寫出的記錄還原為文字
+//   ./log_decode <file...> [--level debug|info|warning|error] [--location]
+// 多個文件按參數順序輸出, 輪替文件應由舊到新傳入 (path.N ... path.1 path)
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "用法: " << program << " <file...> [--level debug|info|warning|error] [--location]" << std::endl;
+}
+
+std::string formatTimestamp(int64_t timestampNs) {
+    std::time_t seconds = static_cast<std::time_t>(timestampNs / 1000000000);
+    int ms = static_cast<int>((timestampNs / 1000000) % 1000);
+    std::tm utc_tm = *std::gmtime(&seconds);
+    char buffer[32];
+    size_t len = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &utc_tm);
+    std::snprintf(buffer + len, sizeof(buffer) - len, ".%03d", ms);
+    return buffer;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    LogLevel minLevel = LogLevel::Debug;
+    bool showLocation = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--level" && i + 1 < argc) {
+            minLevel = parseLogLevel(argv[++i], LogLevel::Debug);
+        } else if (arg == "--location") {
+            showLocation = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    int status = 0;
+    for (const auto& path : files) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "無法打開文件: " << path << std::endl;
+            status = 1;
+            continue;
+        }
+        BinaryLogReader reader(in);
+        if (!reader.valid()) {
+            std::cerr << "不是二進位日誌文件: " << path << std::endl;
+            status = 1;
+            continue;
+        }
+
+        DecodedLogRecord record;
+        while (reader.next(record)) {
+            if (record.level < static_cast<int>(minLevel)) {
+                continue;
+            }
+            std::cout << formatTimestamp(record.timestampNs) << " ["
+                      << logLevelName(static_cast<LogLevel>(record.level)) << "] " << record.message;
+            if (showLocation && !record.location.empty()) {
+                std::cout << " (" << record.location << ")";
+            }
+            std::cout << '\n';
+        }
+        if (reader.corrupted()) {
+            std::cerr << "文件在中途損壞或被截斷: " << path << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}
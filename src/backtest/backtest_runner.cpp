@@ -0,0 +1,210 @@
+#include "backtest/backtest_runner.h"
+#include "scheduler/settlement_calendar.h"
+#include "scheduler/strategy_jobs.h"
+#include "scheduler/task_scheduler.h"
+#include "storage/sqlite_storage.h"
+#include "trading/trading_module.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <json/json.h>
+#include <unistd.h>
+
+namespace {
+
+int64_t toMs(IClock::TimePoint tp) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+}
+
+IClock::TimePoint fromMs(int64_t ms) {
+    return IClock::TimePoint(std::chrono::milliseconds(ms));
+}
+
+// 在作用域內關閉日誌並把 cout/cerr 導向空緩衝區
+class OutputSilencer {
+public:
+    explicit OutputSilencer(bool enabled) : enabled(enabled) {
+        if (enabled) {
+            // 先讓背景線程寫完既有日誌, 再替換輸出緩衝區
+            savedLevel = LogBackend::getInstance().level();
+            Logger::flush();
+            LogBackend::getInstance().setLevel(LogLevel::Off);
+            coutBuffer = std::cout.rdbuf(&nullBuffer);
+            cerrBuffer = std::cerr.rdbuf(&nullBuffer);
+        }
+    }
+    ~OutputSilencer() {
+        if (enabled) {
+            Logger::flush();
+            std::cout.rdbuf(coutBuffer);
+            std::cerr.rdbuf(cerrBuffer);
+            LogBackend::getInstance().setLevel(savedLevel);
+        }
+    }
+
+private:
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return c; }
+    };
+    bool enabled;
+    LogLevel savedLevel = LogLevel::Debug;
+    NullBuffer nullBuffer;
+    std::streambuf* coutBuffer = nullptr;
+    std::streambuf* cerrBuffer = nullptr;
+};
+
+// 回測專用的臨時目錄, 析構時刪除. 同一進程可同時運行多個回測 (參數掃描)
+class ScratchDirectory {
+public:
+    ScratchDirectory() {
+        static std::atomic<uint64_t> counter{0};
+        path = std::filesystem::temp_directory_path() /
+               ("frt_backtest_" + std::to_string(::getpid()) + "_" + std::to_string(counter++));
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+    ~ScratchDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+
+    std::filesystem::path path;
+};
+
+} // namespace
+
+void BacktestReport::print(std::ostream& out) const {
+    out << std::fixed << std::setprecision(2)
+        << "回測區間: " << formatUTC(fromMs(startMs)) << " ~ " << formatUTC(fromMs(endMs)) << "\n"
+        << "初始權益: " << initialEquity << " USDT\n"
+        << "最終權益: " << finalEquity << " USDT\n"
+        << "盈虧: " << pnl << " USDT (" << totalReturn * 100 << "%)\n"
+        << "最大回撤: " << maxDrawdown * 100 << "%\n"
+        << "資金費收入: " << fundingIncome << " USDT\n"
+        << "手續費: " << fees << " USDT\n"
+        << "成交額: " << turnover << " USDT\n"
+        << "訂單數: " << orders << " (拒絕 " << rejectedOrders << ")\n"
+        << "結算次數: " << settlements << std::endl;
+}
+
+bool BacktestReport::writeJson(const std::string& path) const {
+    Json::Value root;
+    root["start_ms"] = Json::Int64(startMs);
+    root["end_ms"] = Json::Int64(endMs);
+    root["initial_equity"] = initialEquity;
+    root["final_equity"] = finalEquity;
+    root["pnl"] = pnl;
+    root["return"] = totalReturn;
+    root["max_drawdown"] = maxDrawdown;
+    root["funding_income"] = fundingIncome;
+    root["fees"] = fees;
+    root["turnover"] = turnover;
+    root["orders"] = orders;
+    root["rejected_orders"] = rejectedOrders;
+    root["settlements"] = settlements;
+    Json::Value curve(Json::arrayValue);
+    for (const auto& point : equityCurve) {
+        Json::Value item;
+        item["ts"] = Json::Int64(point.timestampMs);
+        item["equity"] = point.equity;
+        curve.append(item);
+    }
+    root["equity_curve"] = curve;
+
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    out << Json::writeString(builder, root) << std::endl;
+    return true;
+}
+
+BacktestRunner::BacktestRunner(std::shared_ptr<const MarketHistory> history) :
+    history(std::move(history)) {}
+
+BacktestReport BacktestRunner::run(const BacktestOptions& options) {
+    BacktestReport report;
+    auto start = options.start == IClock::TimePoint() ? fromMs(history->firstTimestamp()) : options.start;
+    auto end = options.end == IClock::TimePoint() ? fromMs(history->lastTimestamp()) : options.end;
+    if (end <= start) {
+        logger.error("回測區間無效");
+        return report;
+    }
+
+    VirtualClock clock(start);
+    SimulatedExchange exchange(history, clock, options.simulation);
+    const SettlementCalendar calendar = SettlementCalendar::fromConfig();
+
+    report.startMs = toMs(start);
+    report.initialEquity = exchange.getTotalEquity();
+    double peak = report.initialEquity;
+    auto sampleEquity = [&]() {
+        double equity = exchange.getTotalEquity();
+        report.equityCurve.push_back({toMs(clock.now()), equity});
+        peak = std::max(peak, equity);
+        if (peak > 0) {
+            report.maxDrawdown = std::max(report.maxDrawdown, (peak - equity) / peak);
+        }
+    };
+
+    {
+        OutputSilencer silencer(options.quiet);
+        // 對沖組寫入臨時數據庫, 封鎖的交易對只留在內存, 不保存重啟快照:
+        // 不讀寫同一目錄下實盤進程的 trading.db, pair_list.json 及 warm_state.json
+        ScratchDirectory scratch;
+        StorageOptions storageOptions;
+        storageOptions.path = (scratch.path / "backtest.db").string();
+        SQLiteStorage storage(storageOptions);
+        TradingSinks sinks;
+        sinks.storage = &storage;
+        sinks.pairListPath = "";
+        sinks.warmState = false;
+        auto module = TradingModule::createForAccount(exchange, clock, AccountConfig{}, sinks);
+        TradingModule& trader = *module;
+        trader.setSymbolUniverse(history->symbols());
+
+        TaskScheduler scheduler(clock);
+        StrategyJobOptions jobOptions;
+        jobOptions.reconcileInterval = options.reconcileInterval;
+        jobOptions.displayPositions = false;
+        registerStrategyJobs(scheduler, trader, calendar, jobOptions);
+
+        // 結算工作先於同一時刻的其他工作加入, 但截止時間嚴格在結算點上
+        scheduler.addJob(JobType::FundingSettlement, "模擬資金費結算",
+            [&calendar](IClock::TimePoint after) { return calendar.nextSettlement(after); },
+            [&exchange, &sampleEquity]() {
+                exchange.settleFunding();
+                sampleEquity();
+            });
+
+        runReconcile(trader, false);
+        while (!scheduler.empty() && scheduler.nextDeadline() <= end) {
+            if (!scheduler.runNext()) {
+                break;
+            }
+        }
+
+        clock.setTime(std::max(clock.now(), end));
+        sampleEquity();
+    }
+
+    const SimulationStats& stats = exchange.stats();
+    report.endMs = toMs(clock.now());
+    report.finalEquity = report.equityCurve.back().equity;
+    report.pnl = report.finalEquity - report.initialEquity;
+    report.totalReturn = report.initialEquity > 0 ? report.pnl / report.initialEquity : 0.0;
+    report.fundingIncome = stats.fundingIncome;
+    report.fees = stats.fees;
+    report.turnover = stats.turnover;
+    report.orders = stats.orders;
+    report.rejectedOrders = stats.rejectedOrders;
+    report.settlements = stats.settlements;
+    return report;
+}
@@ -0,0 +1,204 @@
+#include "backtest/market_history.h"
+#include "logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::vector<std::string> splitFields(const std::string& line, char delimiter) {
+    std::vector<std::string> fields;
+    std::string field;
+    std::istringstream ss(line);
+    while (std::getline(ss, field, delimiter)) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+// 跳過空行及表頭 (非數字開頭)
+bool isDataLine(const std::string& line) {
+    return !line.empty() && (std::isdigit(static_cast<unsigned char>(line[0])) || line[0] == '-');
+}
+
+std::vector<BookLevel> parseLevels(const std::string& text) {
+    std::vector<BookLevel> levels;
+    for (const auto& item : splitFields(text, ';')) {
+        auto colon = item.find(':');
+        if (colon == std::string::npos) continue;
+        double price = std::stod(item.substr(0, colon));
+        double quantity = std::stod(item.substr(colon + 1));
+        if (price > 0 && quantity > 0) {
+            levels.push_back({price, quantity});
+        }
+    }
+    return levels;
+}
+
+template <typename T>
+void sortByTime(std::vector<T>& points) {
+    std::stable_sort(points.begin(), points.end(),
+        [](const T& a, const T& b) { return a.timestampMs < b.timestampMs; });
+}
+
+// 最後一個時間戳不晚於 timestampMs 的元素
+template <typename T>
+const T* latestAt(const std::vector<T>& points, int64_t timestampMs) {
+    auto it = std::upper_bound(points.begin(), points.end(), timestampMs,
+        [](int64_t ts, const T& point) { return ts < point.timestampMs; });
+    if (it == points.begin()) {
+        return nullptr;
+    }
+    return &*(it - 1);
+}
+
+void loadBooks(const std::filesystem::path& file, std::vector<BookSnapshot>& books) {
+    std::ifstream in(file);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!isDataLine(line)) continue;
+        auto fields = splitFields(line, ',');
+        if (fields.size() < 3) continue;
+        books.push_back({std::stoll(fields[0]), parseLevels(fields[1]), parseLevels(fields[2])});
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const MarketHistory> MarketHistory::loadFromDirectory(const std::string& directory) {
+    namespace fs = std::filesystem;
+    Logger logger;
+    auto history = std::make_shared<MarketHistory>();
+    const fs::path root(directory);
+    if (!fs::is_directory(root)) {
+        throw std::runtime_error("無法打開歷史數據目錄: " + directory);
+    }
+
+    if (fs::is_directory(root / "funding")) {
+        for (const auto& entry : fs::directory_iterator(root / "funding")) {
+            if (entry.path().extension() != ".csv") continue;
+            auto& points = history->symbol(entry.path().stem().string()).funding;
+            std::ifstream in(entry.path());
+            std::string line;
+            while (std::getline(in, line)) {
+                if (!isDataLine(line)) continue;
+                auto fields = splitFields(line, ',');
+                if (fields.size() < 2) continue;
+                points.push_back({std::stoll(fields[0]), std::stod(fields[1])});
+            }
+        }
+    }
+
+    if (fs::is_directory(root / "tickers")) {
+        for (const auto& entry : fs::directory_iterator(root / "tickers")) {
+            if (entry.path().extension() != ".csv") continue;
+            auto& points = history->symbol(entry.path().stem().string()).tickers;
+            std::ifstream in(entry.path());
+            std::string line;
+            while (std::getline(in, line)) {
+                if (!isDataLine(line)) continue;
+                auto fields = splitFields(line, ',');
+                if (fields.size() < 3) continue;
+                points.push_back({std::stoll(fields[0]), std::stod(fields[1]), std::stod(fields[2])});
+            }
+        }
+    }
+
+    if (fs::is_directory(root / "books")) {
+        for (const auto& entry : fs::directory_iterator(root / "books")) {
+            if (entry.path().extension() != ".csv") continue;
+            std::string stem = entry.path().stem().string();
+            auto underscore = stem.rfind('_');
+            if (underscore == std::string::npos) continue;
+            std::string category = stem.substr(underscore + 1);
+            auto& symbolHistory = history->symbol(stem.substr(0, underscore));
+            loadBooks(entry.path(), category == "spot" ? symbolHistory.spotBooks
+                                                       : symbolHistory.contractBooks);
+        }
+    }
+
+    history->finalize();
+    logger.info("已載入 " + std::to_string(history->data.size()) + " 個幣對的歷史數據: " + directory);
+    return history;
+}
+
+void MarketHistory::finalize() {
+    for (auto& [name, symbolHistory] : data) {
+        sortByTime(symbolHistory.funding);
+        sortByTime(symbolHistory.tickers);
+        sortByTime(symbolHistory.spotBooks);
+        sortByTime(symbolHistory.contractBooks);
+    }
+}
+
+const SymbolHistory* MarketHistory::find(const std::string& name) const {
+    auto it = data.find(name);
+    return it != data.end() ? &it->second : nullptr;
+}
+
+std::vector<std::string> MarketHistory::symbols() const {
+    std::vector<std::string> names;
+    for (const auto& [name, symbolHistory] : data) {
+        if (!symbolHistory.tickers.empty()) {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
+int64_t MarketHistory::firstTimestamp() const {
+    int64_t first = INT64_MAX;
+    for (const auto& [name, symbolHistory] : data) {
+        if (!symbolHistory.tickers.empty()) {
+            first = std::min(first, symbolHistory.tickers.front().timestampMs);
+        }
+    }
+    return first == INT64_MAX ? 0 : first;
+}
+
+int64_t MarketHistory::lastTimestamp() const {
+    int64_t last = 0;
+    for (const auto& [name, symbolHistory] : data) {
+        if (!symbolHistory.tickers.empty()) {
+            last = std::max(last, symbolHistory.tickers.back().timestampMs);
+        }
+    }
+    return last;
+}
+
+const TickerPoint* MarketHistory::tickerAt(const std::string& name, int64_t timestampMs) const {
+    const SymbolHistory* symbolHistory = find(name);
+    return symbolHistory ? latestAt(symbolHistory->tickers, timestampMs) : nullptr;
+}
+
+const FundingPoint* MarketHistory::fundingAt(const std::string& name, int64_t timestampMs) const {
+    const SymbolHistory* symbolHistory = find(name);
+    return symbolHistory ? latestAt(symbolHistory->funding, timestampMs) : nullptr;
+}
+
+std::vector<double> MarketHistory::fundingBefore(const std::string& name, int64_t timestampMs,
+                                                 size_t limit) const {
+    std::vector<double> rates;
+    const SymbolHistory* symbolHistory = find(name);
+    const FundingPoint* latest = symbolHistory ? latestAt(symbolHistory->funding, timestampMs) : nullptr;
+    if (!latest) {
+        return rates;
+    }
+    size_t index = static_cast<size_t>(latest - symbolHistory->funding.data()) + 1;
+    while (index > 0 && rates.size() < limit) {
+        rates.push_back(symbolHistory->funding[--index].rate);
+    }
+    return rates;
+}
+
+const BookSnapshot* MarketHistory::bookAt(const std::string& name, bool spot, int64_t timestampMs) const {
+    const SymbolHistory* symbolHistory = find(name);
+    if (!symbolHistory) {
+        return nullptr;
+    }
+    return latestAt(spot ? symbolHistory->spotBooks : symbolHistory->contractBooks, timestampMs);
+}
@@ -0,0 +1,420 @@
+#include "backtest/parameter_sweep.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+int64_t toMs(IClock::TimePoint tp) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+}
+
+IClock::TimePoint fromMs(int64_t ms) {
+    return IClock::TimePoint(std::chrono::milliseconds(ms));
+}
+
+template <typename T>
+std::string joinValues(const std::vector<T>& values) {
+    std::ostringstream ss;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i > 0) ss << "/";
+        ss << values[i];
+    }
+    return ss.str();
+}
+
+SweepSpace::Dimension parseDimension(const Json::Value& node) {
+    SweepSpace::Dimension dimension;
+    if (node.isArray()) {
+        for (const auto& value : node) {
+            dimension.values.push_back(value.asDouble());
+        }
+    } else if (node.isObject()) {
+        dimension.isRange = true;
+        dimension.min = node["min"].asDouble();
+        dimension.max = node["max"].asDouble();
+        dimension.step = node["step"].asDouble();
+        if (dimension.max < dimension.min) {
+            throw std::invalid_argument("搜索範圍 max 小於 min");
+        }
+    } else if (node.isNumeric()) {
+        dimension.values.push_back(node.asDouble());
+    }
+    return dimension;
+}
+
+template <typename T>
+std::vector<std::vector<T>> parseVectors(const Json::Value& node) {
+    std::vector<std::vector<T>> result;
+    for (const auto& item : node) {
+        std::vector<T> values;
+        for (const auto& value : item) {
+            values.push_back(static_cast<T>(value.asDouble()));
+        }
+        result.push_back(values);
+    }
+    return result;
+}
+
+// 沒有指定的維度以 base 值代替
+std::vector<double> orBase(const std::vector<double>& values, double base) {
+    return values.empty() ? std::vector<double>{base} : values;
+}
+
+bool validCandidate(const SweepParams& params) {
+    return params.scoring.valid() &&
+           params.sizing.minScalingRate <= params.sizing.maxScalingRate &&
+           params.scoring.topPairsCount > 0;
+}
+
+} // namespace
+
+std::string SweepParams::describe() const {
+    std::ostringstream ss;
+    ss << "periods=" << joinValues(scoring.periods)
+       << " weights=" << joinValues(scoring.weights)
+       << " top=" << scoring.topPairsCount
+       << " scaling=" << sizing.scalingFactor
+       << " rate=[" << sizing.minScalingRate << "," << sizing.maxScalingRate << "]";
+    return ss.str();
+}
+
+std::shared_ptr<const SweepDataset> SweepDataset::build(const MarketHistory& history,
+                                                        const SettlementCalendar& calendar,
+                                                        IClock::TimePoint start,
+                                                        IClock::TimePoint end,
+                                                        int maxLookback) {
+    auto dataset = std::make_shared<SweepDataset>();
+    dataset->lookback = std::max(maxLookback, 1);
+    dataset->symbolNames = history.symbols();
+
+    for (auto t = calendar.nextPreSettlementEntry(start - std::chrono::milliseconds(1)); t <= end;
+         t = calendar.nextPreSettlementEntry(t)) {
+        dataset->decisionTimes.push_back(toMs(t));
+    }
+
+    const size_t cells = dataset->decisionTimes.size() * dataset->symbolNames.size();
+    dataset->windows.assign(cells * dataset->lookback, 0.0);
+    dataset->windowSizes.assign(cells, 0);
+    dataset->spotPrices.assign(cells, 0.0);
+    dataset->contractPrices.assign(cells, 0.0);
+    dataset->settledRates.assign(cells, 0.0);
+
+    for (size_t step = 0; step < dataset->decisionTimes.size(); step++) {
+        int64_t decisionMs = dataset->decisionTimes[step];
+        int64_t settlementMs = toMs(calendar.nextSettlement(fromMs(decisionMs)));
+        for (size_t symbol = 0; symbol < dataset->symbolNames.size(); symbol++) {
+            const std::string& name = dataset->symbolNames[symbol];
+            size_t cell = dataset->index(step, symbol);
+
+            auto rates = history.fundingBefore(name, decisionMs, dataset->lookback);
+            std::copy(rates.begin(), rates.end(), dataset->windows.begin() + cell * dataset->lookback);
+            dataset->windowSizes[cell] = static_cast<int>(rates.size());
+
+            if (const TickerPoint* ticker = history.tickerAt(name, decisionMs)) {
+                dataset->spotPrices[cell] = ticker->spotPrice;
+                dataset->contractPrices[cell] = ticker->contractPrice;
+            }
+            const FundingPoint* settled = history.fundingAt(name, settlementMs);
+            if (settled && settled->timestampMs > decisionMs) {
+                dataset->settledRates[cell] = settled->rate;
+            }
+        }
+    }
+    return dataset;
+}
+
+std::span<const double> SweepDataset::fundingWindow(size_t step, size_t symbol) const {
+    size_t cell = index(step, symbol);
+    return std::span<const double>(windows.data() + cell * lookback, windowSizes[cell]);
+}
+
+std::vector<double> SweepSpace::Dimension::gridValues() const {
+    if (!isRange) {
+        return values;
+    }
+    std::vector<double> grid;
+    if (step <= 0) {
+        grid.push_back(min);
+        if (max > min) grid.push_back(max);
+        return grid;
+    }
+    // 以整數步數展開, 避免浮點累加誤差
+    int steps = static_cast<int>(std::floor((max - min) / step + 1e-9));
+    for (int i = 0; i <= steps; i++) {
+        grid.push_back(min + i * step);
+    }
+    return grid;
+}
+
+SweepSpace SweepSpace::fromJson(const Json::Value& root) {
+    SweepSpace space;
+    space.periods = parseVectors<int>(root["periods"]);
+    space.weights = parseVectors<double>(root["weights"]);
+    space.scalingFactor = parseDimension(root["scaling_factor"]);
+    space.minScalingRate = parseDimension(root["min_scaling_rate"]);
+    space.maxScalingRate = parseDimension(root["max_scaling_rate"]);
+    space.topPairsCount = parseDimension(root["top_pairs_count"]);
+    return space;
+}
+
+SweepSpace SweepSpace::loadFromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("無法打開文件: " + path);
+    }
+    Json::Value root;
+    Json::Reader reader;
+    if (!reader.parse(file, root)) {
+        throw std::runtime_error("解析失敗: " + path);
+    }
+    return fromJson(root);
+}
+
+std::vector<SweepParams> SweepSpace::grid(const SweepParams& base) const {
+    auto periodOptions = periods.empty() ? std::vector<std::vector<int>>{base.scoring.periods} : periods;
+    auto weightOptions = weights.empty() ? std::vector<std::vector<double>>{base.scoring.weights} : weights;
+    auto factors = orBase(scalingFactor.gridValues(), base.sizing.scalingFactor);
+    auto minRates = orBase(minScalingRate.gridValues(), base.sizing.minScalingRate);
+    auto maxRates = orBase(maxScalingRate.gridValues(), base.sizing.maxScalingRate);
+    auto topCounts = orBase(topPairsCount.gridValues(), base.scoring.topPairsCount);
+
+    std::vector<SweepParams> candidates;
+    for (const auto& p : periodOptions)
+    for (const auto& w : weightOptions)
+    for (double factor : factors)
+    for (double minRate : minRates)
+    for (double maxRate : maxRates)
+    for (double top : topCounts) {
+        SweepParams params = base;
+        params.scoring.periods = p;
+        params.scoring.weights = w;
+        params.scoring.topPairsCount = static_cast<int>(std::lround(top));
+        params.sizing.scalingFactor = factor;
+        params.sizing.minScalingRate = minRate;
+        params.sizing.maxScalingRate = maxRate;
+        if (validCandidate(params)) {
+            candidates.push_back(std::move(params));
+        }
+    }
+    return candidates;
+}
+
+std::vector<SweepParams> SweepSpace::random(const SweepParams& base, size_t count, uint32_t seed) const {
+    std::mt19937 rng(seed);
+    auto sample = [&rng](const Dimension& dimension, double fallback) {
+        if (dimension.isRange) {
+            return std::uniform_real_distribution<double>(dimension.min, dimension.max)(rng);
+        }
+        if (dimension.values.empty()) {
+            return fallback;
+        }
+        return dimension.values[std::uniform_int_distribution<size_t>(0, dimension.values.size() - 1)(rng)];
+    };
+    auto pick = [&rng](const auto& options, const auto& fallback) {
+        if (options.empty()) return fallback;
+        return options[std::uniform_int_distribution<size_t>(0, options.size() - 1)(rng)];
+    };
+
+    std::vector<SweepParams> candidates;
+    // 無效組合會被略過, 限制嘗試次數避免搜索空間全無效時死循環
+    for (size_t attempts = 0; candidates.size() < count && attempts < count * 20; attempts++) {
+        SweepParams params = base;
+        params.scoring.periods = pick(periods, base.scoring.periods);
+        params.scoring.weights = pick(weights, base.scoring.weights);
+        params.scoring.topPairsCount = static_cast<int>(std::lround(sample(topPairsCount, base.scoring.topPairsCount)));
+        params.sizing.scalingFactor = sample(scalingFactor, base.sizing.scalingFactor);
+        params.sizing.minScalingRate = sample(minScalingRate, base.sizing.minScalingRate);
+        params.sizing.maxScalingRate = sample(maxScalingRate, base.sizing.maxScalingRate);
+        if (validCandidate(params)) {
+            candidates.push_back(std::move(params));
+        }
+    }
+    return candidates;
+}
+
+ParameterSweep::ParameterSweep(std::shared_ptr<const SweepDataset> dataset, SweepCosts costs) :
+    dataset(std::move(dataset)), costs(costs) {}
+
+SweepResult ParameterSweep::evaluate(const SweepParams& params) const {
+    const SweepDataset& data = *dataset;
+    const FundingScorer scorer(params.scoring);
+    const size_t symbolCount = data.symbolCount();
+
+    SweepResult result;
+    std::vector<double> positions(symbolCount, 0.0);   // 帶符號: 正數為現貨多、合約空
+    std::vector<double> targets(symbolCount, 0.0);
+    std::vector<std::pair<size_t, double>> scores;
+    scores.reserve(symbolCount);
+
+    double equity = costs.initialCapital;
+    double peak = equity;
+
+    for (size_t step = 0; step < data.stepCount(); step++) {
+        // 1. 按上一決策時點至今的價格變化計算對衝倉位的基差盈虧
+        if (step > 0) {
+            for (size_t s = 0; s < symbolCount; s++) {
+                if (positions[s] == 0) continue;
+                double spotNow = data.spotPrice(step, s), spotPrev = data.spotPrice(step - 1, s);
+                double contractNow = data.contractPrice(step, s), contractPrev = data.contractPrice(step - 1, s);
+                if (spotNow <= 0 || spotPrev <= 0 || contractNow <= 0 || contractPrev <= 0) continue;
+                equity += positions[s] * ((spotNow - spotPrev) - (contractNow - contractPrev));
+            }
+        }
+        peak = std::max(peak, equity);
+        if (peak > 0) {
+            result.maxDrawdown = std::max(result.maxDrawdown, (peak - equity) / peak);
+        }
+
+        // 2. 評分並選出前 N 名
+        scores.clear();
+        for (size_t s = 0; s < symbolCount; s++) {
+            double score = 0.0;
+            if (scorer.score(data.fundingWindow(step, s), score) == FundingScorer::Result::Scored) {
+                scores.emplace_back(s, score);
+            }
+        }
+        std::stable_sort(scores.begin(), scores.end(),
+            [](const auto& a, const auto& b) { return std::abs(a.second) > std::abs(b.second); });
+        if (scores.size() > static_cast<size_t>(params.scoring.topPairsCount)) {
+            scores.resize(params.scoring.topPairsCount);
+        }
+
+        // 3. 目標倉位, 總倉位價值受權益及槓桿限制
+        std::fill(targets.begin(), targets.end(), 0.0);
+        double allocated = 0.0;
+        const double capacity = equity * costs.leverage;
+        for (const auto& [s, score] : scores) {
+            double price = data.spotPrice(step, s);
+            if (price <= 0) continue;
+            double value = params.sizing.targetValue(score);
+            if (value < params.sizing.minPositionValue || allocated + value > capacity) continue;
+            allocated += value;
+            targets[s] = (score > 0 ? 1.0 : -1.0) * value / price;
+        }
+
+        // 4. 按淨額調整倉位並扣除手續費
+        for (size_t s = 0; s < symbolCount; s++) {
+            double delta = targets[s] - positions[s];
+            if (delta == 0) continue;
+            double spot = data.spotPrice(step, s);
+            double contract = data.contractPrice(step, s);
+            if (spot <= 0 || contract <= 0) continue;
+            bool closing = targets[s] == 0;
+            if (!closing && (std::abs(delta) * spot < costs.minOrderValue ||
+                             (positions[s] != 0 && std::abs(delta / positions[s]) < costs.minDeltaRatio))) {
+                continue;
+            }
+            double fee = std::abs(delta) * (spot * costs.spotFeeRate + contract * costs.contractFeeRate);
+            equity -= fee;
+            result.fees += fee;
+            result.turnover += std::abs(delta) * (spot + contract);
+            result.trades += 2;
+            positions[s] = targets[s];
+        }
+
+        // 5. 結算資金費率: 合約空頭在費率為正時收取
+        for (size_t s = 0; s < symbolCount; s++) {
+            if (positions[s] == 0) continue;
+            double income = positions[s] * data.contractPrice(step, s) * data.settledRate(step, s);
+            equity += income;
+            result.fundingIncome += income;
+        }
+        peak = std::max(peak, equity);
+    }
+
+    result.finalEquity = equity;
+    result.totalReturn = costs.initialCapital > 0 ? equity / costs.initialCapital - 1.0 : 0.0;
+    return result;
+}
+
+std::vector<SweepResult> ParameterSweep::run(const std::vector<SweepParams>& candidates,
+                                             unsigned threads,
+                                             ProgressCallback progress) const {
+    std::vector<SweepResult> results(candidates.size());
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min<unsigned>(threads, std::max<size_t>(candidates.size(), 1));
+
+    // 工作線程以原子計數器領取下一個候選, 各自寫入自己的結果槽位
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < candidates.size(); i = next++) {
+            results[i] = evaluate(candidates[i]);
+            results[i].candidate = i;
+            size_t finished = ++done;
+            if (progress && threads == 1) {
+                progress(finished, candidates.size());
+            }
+        }
+    };
+
+    if (threads == 1) {
+        worker();
+        return results;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    // 進度回調只在調用線程中執行
+    while (progress && done < candidates.size()) {
+        progress(done, candidates.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    if (progress) {
+        progress(done, candidates.size());
+    }
+    return results;
+}
+
+void ParameterSweep::rank(std::vector<SweepResult>& results, double drawdownPenalty) {
+    for (auto& result : results) {
+        result.objective = result.totalReturn - drawdownPenalty * result.maxDrawdown;
+    }
+
+    // 按報酬降序掃描, 回撤低於此前所有組合者位於 Pareto 前沿
+    std::sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+        if (a.totalReturn != b.totalReturn) return a.totalReturn > b.totalReturn;
+        return a.maxDrawdown < b.maxDrawdown;
+    });
+    double bestDrawdown = std::numeric_limits<double>::infinity();
+    for (auto& result : results) {
+        result.paretoOptimal = result.maxDrawdown < bestDrawdown;
+        bestDrawdown = std::min(bestDrawdown, result.maxDrawdown);
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+        return a.objective > b.objective;
+    });
+}
+
+void ParameterSweep::writeCsv(std::ostream& out,
+                              const std::vector<SweepResult>& results,
+                              const std::vector<SweepParams>& candidates) {
+    out << "rank,objective,return,max_drawdown,pareto,funding_income,fees,turnover,trades,"
+           "periods,weights,top_pairs_count,scaling_factor,min_scaling_rate,max_scaling_rate\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const SweepResult& r = results[i];
+        const SweepParams& p = candidates[r.candidate];
+        out << i + 1 << "," << r.objective << "," << r.totalReturn << "," << r.maxDrawdown << ","
+            << (r.paretoOptimal ? 1 : 0) << "," << r.fundingIncome << "," << r.fees << ","
+            << r.turnover << "," << r.trades << ","
+            << joinValues(p.scoring.periods) << "," << joinValues(p.scoring.weights) << ","
+            << p.scoring.topPairsCount << "," << p.sizing.scalingFactor << ","
+            << p.sizing.minScalingRate << "," << p.sizing.maxScalingRate << "\n";
+    }
+}
@@ -0,0 +1,402 @@
+#include "backtest/simulated_exchange.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr double QTY_EPSILON = 1e-9;
+
+// 與 Bybit 一致, 數值以字串返回
+std::string toText(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.12g", value);
+    return buffer;
+}
+
+std::string baseCoin(const std::string& symbol) {
+    return symbol.size() > 4 ? symbol.substr(0, symbol.size() - 4) : symbol;
+}
+
+Json::Value okResponse() {
+    Json::Value response;
+    response["retCode"] = 0;
+    response["retMsg"] = "OK";
+    return response;
+}
+
+} // namespace
+
+SimulatedExchange::SimulatedExchange(std::shared_ptr<const MarketHistory> history,
+                                     IClock& clock,
+                                     const SimulationOptions& options) :
+    history(std::move(history)),
+    clock(clock),
+    options(options),
+    cash(options.initialCapital) {}
+
+int64_t SimulatedExchange::nowMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        clock.now().time_since_epoch()).count();
+}
+
+std::vector<std::pair<std::string, double>> SimulatedExchange::getFundingRates() {
+    std::vector<std::pair<std::string, double>> rates;
+    for (const auto& symbol : history->symbols()) {
+        if (const FundingPoint* point = history->fundingAt(symbol, nowMs())) {
+            rates.emplace_back(symbol, point->rate);
+        }
+    }
+    return rates;
+}
+
+std::vector<std::pair<std::string, std::vector<double>>> SimulatedExchange::getFundingHistory(
+    const std::vector<std::string>& symbols) {
+    std::vector<std::pair<std::string, std::vector<double>>> rates;
+    for (const auto& symbol : symbols) {
+        auto symbolRates = history->fundingBefore(symbol, nowMs(), options.fundingHistoryLimit);
+        if (!symbolRates.empty()) {
+            rates.emplace_back(symbol, std::move(symbolRates));
+        }
+    }
+    return rates;
+}
+
+std::vector<FundingRecord> SimulatedExchange::getFundingRecords(const std::vector<std::string>&) {
+    return {};
+}
+
+double SimulatedExchange::getSpotPrice(const std::string& symbol) {
+    const TickerPoint* ticker = history->tickerAt(symbol, nowMs());
+    return ticker ? ticker->spotPrice : 0.0;
+}
+
+double SimulatedExchange::getContractPrice(const std::string& symbol) {
+    const TickerPoint* ticker = history->tickerAt(symbol, nowMs());
+    return ticker ? ticker->contractPrice : 0.0;
+}
+
+std::optional<double> SimulatedExchange::getCurrentFundingRate(const std::string& symbol) {
+    const FundingPoint* point = history->fundingAt(symbol, nowMs());
+    if (!point) {
+        return std::nullopt;
+    }
+    return point->rate;
+}
+
+double SimulatedExchange::getTotalEquity() {
+    double equity = cash;
+    for (const auto& [symbol, qty] : spotHoldings) {
+        equity += qty * getSpotPrice(symbol);
+    }
+    for (const auto& [symbol, position] : perpPositions) {
+        equity += position.size * (getContractPrice(symbol) - position.entryPrice);
+    }
+    return equity;
+}
+
+Json::Value SimulatedExchange::getPositions(const std::string& symbol) {
+    Json::Value response = okResponse();
+    response["result"]["list"] = Json::Value(Json::arrayValue);
+    for (const auto& [name, position] : perpPositions) {
+        if (!symbol.empty() && name != symbol) continue;
+        if (std::abs(position.size) <= QTY_EPSILON) continue;
+        double markPrice = getContractPrice(name);
+        Json::Value item;
+        item["symbol"] = name;
+        item["side"] = position.size < 0 ? "Sell" : "Buy";
+        item["size"] = toText(std::abs(position.size));
+        item["avgPrice"] = toText(position.entryPrice);
+        item["positionValue"] = toText(std::abs(position.size) * markPrice);
+        item["unrealisedPnl"] = toText(position.size * (markPrice - position.entryPrice));
+        response["result"]["list"].append(item);
+    }
+    return response;
+}
+
+std::vector<std::string> SimulatedExchange::getInstruments(const std::string&) {
+    return history->symbols();
+}
+
+bool SimulatedExchange::setLeverage(const std::string&, int) {
+    return true;
+}
+
+std::vector<BookLevel> SimulatedExchange::bookSide(const std::string& symbol, bool spot, bool buy) const {
+    if (const BookSnapshot* book = history->bookAt(symbol, spot, nowMs())) {
+        return buy ? book->asks : book->bids;
+    }
+
+    // 合成訂單簿: 以行情價格為中心, 每層固定名義深度
+    std::vector<BookLevel> levels;
+    const TickerPoint* ticker = history->tickerAt(symbol, nowMs());
+    if (!ticker) {
+        return levels;
+    }
+    double mid = spot ? ticker->spotPrice : ticker->contractPrice;
+    if (mid <= 0) {
+        return levels;
+    }
+    levels.reserve(options.syntheticLevels);
+    for (int i = 0; i < options.syntheticLevels; i++) {
+        double offset = (i + 0.5) * options.syntheticTickRatio;
+        double price = buy ? mid * (1 + offset) : mid * (1 - offset);
+        levels.push_back({price, options.syntheticLevelNotional / price});
+    }
+    return levels;
+}
+
+Json::Value SimulatedExchange::bookJson(const std::string& symbol, bool spot) const {
+    Json::Value response = okResponse();
+    response["result"]["s"] = symbol;
+    response["result"]["ts"] = Json::Int64(nowMs());
+    const char* sides[] = {"b", "a"};
+    for (int i = 0; i < 2; i++) {
+        Json::Value list(Json::arrayValue);
+        for (const auto& level : bookSide(symbol, spot, i == 1)) {
+            Json::Value item(Json::arrayValue);
+            item.append(toText(level.price));
+            item.append(toText(level.quantity));
+            list.append(item);
+        }
+        response["result"][sides[i]] = list;
+    }
+    return response;
+}
+
+Json::Value SimulatedExchange::getSpotOrderBook(const std::string& symbol) {
+    return bookJson(symbol, true);
+}
+
+Json::Value SimulatedExchange::getContractOrderBook(const std::string& symbol) {
+    return bookJson(symbol, false);
+}
+
+double SimulatedExchange::fillPrice(const std::vector<BookLevel>& levels, double qty) const {
+    double remaining = qty;
+    double notional = 0.0;
+    for (const auto& level : levels) {
+        double take = std::min(remaining, level.quantity);
+        notional += take * level.price;
+        remaining -= take;
+        if (remaining <= 0) break;
+    }
+    if (remaining > 0) {
+        notional += remaining * levels.back().price;
+    }
+    return notional / qty;
+}
+
+Json::Value SimulatedExchange::reject(const std::string& message, int retCode) {
+    lastError = message;
+    simulationStats.rejectedOrders++;
+    Json::Value response;
+    response["retCode"] = retCode;
+    response["retMsg"] = message;
+    return response;
+}
+
+bool SimulatedExchange::duplicateOrderLinkId(const std::string& orderLinkId) {
+    return !orderLinkId.empty() && ordersByLinkId.count(orderLinkId) > 0;
+}
+
+std::string SimulatedExchange::recordOrder(const std::string& category, const std::string& symbol,
+                                           const std::string& side, double qty, double price,
+                                           const std::string& orderLinkId) {
+    std::string orderId = "sim-" + std::to_string(nextOrderId++);
+    if (!orderLinkId.empty()) {
+        Json::Value order;
+        order["orderId"] = orderId;
+        order["orderLinkId"] = orderLinkId;
+        order["category"] = category;
+        order["symbol"] = symbol;
+        order["side"] = side;
+        order["orderType"] = "Market";
+        order["orderStatus"] = "Filled";
+        order["qty"] = toText(qty);
+        order["cumExecQty"] = toText(qty);
+        order["avgPrice"] = toText(price);
+        ordersByLinkId[orderLinkId] = order;
+    }
+    return orderId;
+}
+
+Json::Value SimulatedExchange::getOrderByLinkId(const std::string& category, const std::string& orderLinkId) {
+    auto it = ordersByLinkId.find(orderLinkId);
+    if (it == ordersByLinkId.end() || it->second["category"].asString() != category) {
+        return Json::Value();
+    }
+    return it->second;
+}
+
+Json::Value SimulatedExchange::createOrder(const std::string& symbol, const std::string& side, double qty,
+                                           const std::string&, const std::string&,
+                                           const std::string& orderLinkId) {
+    if (qty <= 0) {
+        return reject("Invalid qty");
+    }
+    if (duplicateOrderLinkId(orderLinkId)) {
+        return reject("OrderLinkedID is duplicate", ORDER_LINK_ID_DUPLICATE);
+    }
+    bool buy = side == "Buy";
+    auto levels = bookSide(symbol, false, buy);
+    if (levels.empty()) {
+        return reject("Not supported symbols");
+    }
+
+    double price = fillPrice(levels, qty);
+    double signedQty = buy ? qty : -qty;
+    PerpPosition& position = perpPositions[symbol];
+
+    if (position.size == 0 || (position.size > 0) == (signedQty > 0)) {
+        // 開倉或加倉: 更新均價
+        double newSize = position.size + signedQty;
+        position.entryPrice = (position.size * position.entryPrice + signedQty * price) / newSize;
+        position.size = newSize;
+    } else {
+        // 減倉: 實現盈虧, 反向部分按成交價開新倉
+        double closing = std::min(std::abs(signedQty), std::abs(position.size));
+        double direction = position.size > 0 ? 1.0 : -1.0;
+        cash += closing * (price - position.entryPrice) * direction;
+        position.size += signedQty;
+        if (std::abs(position.size) <= QTY_EPSILON) {
+            perpPositions.erase(symbol);
+        } else if ((position.size > 0) != (direction > 0)) {
+            position.entryPrice = price;
+        }
+    }
+
+    double notional = qty * price;
+    double fee = notional * options.contractFeeRate;
+    cash -= fee;
+    simulationStats.fees += fee;
+    simulationStats.turnover += notional;
+    simulationStats.orders++;
+
+    Json::Value response = okResponse();
+    response["result"]["orderId"] = recordOrder("linear", symbol, side, qty, price, orderLinkId);
+    response["result"]["orderLinkId"] = orderLinkId;
+    response["result"]["avgPrice"] = toText(price);
+    return response;
+}
+
+bool SimulatedExchange::createSpotOrder(const std::string& symbol, const std::string& side, double qty,
+                                        const std::string& orderLinkId) {
+    if (qty <= 0) {
+        reject("Invalid qty");
+        return false;
+    }
+    if (duplicateOrderLinkId(orderLinkId)) {
+        reject("OrderLinkedID is duplicate", ORDER_LINK_ID_DUPLICATE);
+        return false;
+    }
+    bool buy = side == "Buy";
+    auto levels = bookSide(symbol, true, buy);
+    if (levels.empty()) {
+        reject("Not supported symbols");
+        return false;
+    }
+
+    double price = fillPrice(levels, qty);
+    double notional = qty * price;
+    double fee = notional * options.spotFeeRate;
+    double& holding = spotHoldings[symbol];
+
+    if (buy) {
+        if (cash < notional) {
+            reject("Insufficient balance");
+            return false;
+        }
+        // 現貨買入手續費以幣本位扣除
+        cash -= notional;
+        holding += qty * (1 - options.spotFeeRate);
+    } else {
+        if (holding + QTY_EPSILON < qty) {
+            reject("Insufficient balance");
+            return false;
+        }
+        holding = std::max(holding - qty, 0.0);
+        cash += notional - fee;
+    }
+    if (holding <= QTY_EPSILON) {
+        spotHoldings.erase(symbol);
+    }
+
+    simulationStats.fees += fee;
+    simulationStats.turnover += notional;
+    simulationStats.orders++;
+    recordOrder("spot", symbol, side, qty, price, orderLinkId);
+    return true;
+}
+
+void SimulatedExchange::closePosition(const std::string& symbol) {
+    auto it = perpPositions.find(symbol);
+    if (it == perpPositions.end()) {
+        return;
+    }
+    double size = it->second.size;
+    createOrder(symbol, size > 0 ? "Sell" : "Buy", std::abs(size));
+}
+
+std::string SimulatedExchange::getLastError() {
+    return lastError;
+}
+
+Json::Value SimulatedExchange::getSpotBalances() {
+    Json::Value response = okResponse();
+    Json::Value account;
+    account["accountType"] = "UNIFIED";
+    account["totalEquity"] = toText(getTotalEquity());
+    Json::Value coins(Json::arrayValue);
+    Json::Value usdt;
+    usdt["coin"] = "USDT";
+    usdt["walletBalance"] = toText(cash);
+    coins.append(usdt);
+    for (const auto& [symbol, qty] : spotHoldings) {
+        Json::Value coin;
+        coin["coin"] = baseCoin(symbol);
+        coin["walletBalance"] = toText(qty);
+        coins.append(coin);
+    }
+    account["coin"] = coins;
+    response["result"]["list"].append(account);
+    return response;
+}
+
+double SimulatedExchange::getSpotBalance(const std::string& symbol) {
+    auto it = spotHoldings.find(symbol);
+    return it != spotHoldings.end() ? it->second : 0.0;
+}
+
+double SimulatedExchange::getSpotFeeRate() {
+    return options.spotFeeRate;
+}
+
+double SimulatedExchange::getContractFeeRate() {
+    return options.contractFeeRate;
+}
+
+double SimulatedExchange::getMarginRatio(const std::string& symbol) {
+    double equity = getTotalEquity();
+    if (equity <= 0) {
+        return 1.0;
+    }
+    double maintenance = 0.0;
+    for (const auto& [name, position] : perpPositions) {
+        if (!symbol.empty() && name != symbol) continue;
+        maintenance += std::abs(position.size) * getContractPrice(name) * options.maintenanceMarginRate;
+    }
+    return maintenance / equity;
+}
+
+void SimulatedExchange::settleFunding() {
+    for (const auto& [symbol, position] : perpPositions) {
+        const FundingPoint* point = history->fundingAt(symbol, nowMs());
+        if (!point) continue;
+        // 費率為正時多頭支付空頭
+        double payment = -position.size * getContractPrice(symbol) * point->rate;
+        cash += payment;
+        simulationStats.fundingIncome += payment;
+    }
+    simulationStats.settlements++;
+}
@@ -1,17 +1,121 @@
 #include "include/config.h"
+#include "logger.h"
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 
 std::mutex Config::mutex_;
+std::once_flag Config::initFlag;
 std::unique_ptr<Config> Config::instance;
 
+namespace {
+
+// 當前線程由 ConfigSnapshotScope 指定的快照, 空指標表示使用全局快照
+thread_local Config::Snapshot scopedSnapshot;
+
+std::vector<std::string> toStrings(const Json::Value& array) {
+    std::vector<std::string> values;
+    for (const auto& item : array) {
+        values.push_back(item.asString());
+    }
+    return values;
+}
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+    return text;
+}
+
+void mergeInto(Json::Value& target, const Json::Value& overrides) {
+    for (const auto& key : overrides.getMemberNames()) {
+        const Json::Value& value = overrides[key];
+        if (value.isObject() && target[key].isObject()) {
+            mergeInto(target[key], value);
+        } else {
+            target[key] = value;
+        }
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const ConfigSnapshot> ConfigSnapshot::withOverrides(const Json::Value& overrides) const {
+    Json::Value merged = config;
+    if (overrides.isObject()) {
+        mergeInto(merged, overrides);
+    }
+    return build(merged, pairList, version);
+}
+
+std::shared_ptr<const ConfigSnapshot> ConfigSnapshot::build(const Json::Value& config,
+                                                            const Json::Value& pairList,
+                                                            uint64_t version) {
+    auto snap = std::make_shared<ConfigSnapshot>();
+    snap->version = version;
+    snap->config = config;
+    snap->pairList = pairList;
+
+    const Json::Value& bybit = config["exchanges"]["bybit"];
+    snap->preferredExchange = config["preferred_exchange"].asString();
+    snap->bybitApiKey = bybit["api_key"].asString();
+    snap->bybitApiSecret = bybit["api_secret"].asString();
+    snap->bybitBaseUrl = bybit["base_url"].asString();
+    snap->defaultLeverage = bybit["default_leverage"].asInt();
+    snap->spotMarginTrading =
+        config["exchanges"][toLower(snap->preferredExchange)]["spot_margin_trading"].asBool();
+
+    const Json::Value& trading = config["trading"];
+    const Json::Value& scoring = trading["funding_rate_scoring"];
+    snap->reverseContractFundingRate = trading["reverse_contract_funding_rate"].asBool();
+    snap->useCoinMarketCap = trading["use_coin_market_cap"].asBool();
+    snap->cmcApiKey = trading["cmc_api_key"].asString();
+    snap->cmcTopCount = trading["cmc_top_count"].asInt();
+    snap->cmcSortBy = trading["cmc_sort_by"].asString();
+    snap->settlementTimesUTC = toStrings(scoring["settlement_times_utc"]);
+    snap->preSettlementMinutes = scoring["pre_settlement_minutes"].asInt();
+    snap->postSettlementMinutes = scoring["post_settlement_minutes"].asInt();
+    for (const auto& period : scoring["periods"]) {
+        snap->fundingPeriods.push_back(period.asInt());
+    }
+    for (const auto& weight : scoring["weights"]) {
+        snap->fundingWeights.push_back(weight.asDouble());
+    }
+    snap->fundingHistoryDays = scoring["history_days"].asInt();
+    snap->fundingHoldingDays = trading["funding_holding_days"].asInt();
+    snap->minScalingRate = trading["min_scaling_rate"].asDouble();
+    snap->maxScalingRate = trading["max_scaling_rate"].asDouble();
+    snap->positionScaling = trading["position_scaling"].asBool();
+    snap->scalingFactor = trading["scaling_factor"].asDouble();
+
+    snap->checkIntervalMinutes = trading["check_interval_minutes"].asInt();
+    snap->topPairsCount = config["top_pairs_count"].asInt();
+    snap->tradingPairs = toStrings(pairList["pair_list"]);
+    snap->minPositionValue = trading["min_position_value"].asDouble();
+    snap->maxPositionValue = trading["max_position_value"].asDouble();
+    snap->unsupportedSymbols = toStrings(pairList["unsupported_symbols"]);
+    snap->unsupportedSet.insert(snap->unsupportedSymbols.begin(), snap->unsupportedSymbols.end());
+
+    const Json::Value& execution = trading["execution"];
+    snap->slicedExecution = execution["sliced_execution"].asBool();
+    snap->maxSliceImpact = execution["max_slice_impact"].asDouble();
+    snap->maxSlices = execution["max_slices"].asInt();
+    snap->sliceIntervalMs = execution["slice_interval_ms"].asInt();
+    snap->sliceTrigger = execution["slice_trigger"].asString();
+    snap->replenishTimeoutMs = execution["replenish_timeout_ms"].asInt();
+    return snap;
+}
+
 Config::Config() {
-    loadConfigFiles();
+    Json::Value config;
+    Json::Value pairList;
+    loadFile(CONFIG_FILE, config);
+    loadFile(PAIR_LIST_FILE, pairList);
+    filesChanged();   // 記錄初始修改時間
+    std::atomic_store(&current, ConfigSnapshot::build(config, pairList, 1));
 }
 
-void Config::loadConfigFiles() {
-    loadFile("config/config.json", config);
-    loadFile("config/pair_list.json", pair_list);
+Config::~Config() {
+    stopWatching();
 }
 
 void Config::loadFile(const std::string& filename, Json::Value& target) {
@@ -27,151 +131,614 @@ void Config::loadFile(const std::string& filename, Json::Value& target) {
 }
 
 Config& Config::getInstance() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!instance) {
+    // call_once 在初始化後只是一次原子讀取, 熱路徑不需要搶 mutex_
+    std::call_once(initFlag, [] {
+        std::lock_guard<std::mutex> lock(mutex_);
         instance.reset(new Config());
-    }
+    });
     return *instance;
 }
 
+Config::Snapshot Config::snapshot() const {
+    if (scopedSnapshot) {
+        return scopedSnapshot;
+    }
+    return std::atomic_load(&current);
+}
+
+ConfigSnapshotScope::ConfigSnapshotScope(Config::Snapshot snapshot) : previous(std::move(scopedSnapshot)) {
+    scopedSnapshot = std::move(snapshot);
+}
+
+ConfigSnapshotScope::~ConfigSnapshotScope() {
+    scopedSnapshot = std::move(previous);
+}
+
+void Config::publish(Snapshot next) {
+    std::vector<ReloadListener> toNotify;
+    {
+        std::lock_guard<std::mutex> lock(reloadMutex);
+        std::atomic_store(&current, next);
+        toNotify = listeners;
+    }
+    notify(toNotify, *next);
+}
+
+void Config::notify(const std::vector<ReloadListener>& toNotify, const ConfigSnapshot& snap) {
+    for (const auto& listener : toNotify) {
+        try {
+            listener(snap);
+        } catch (const std::exception& e) {
+            Logger logger;
+            logger.error("配置重新載入回調失敗: " + std::string(e.what()));
+        }
+    }
+}
+
+bool Config::reload() {
+    Logger logger;
+    Snapshot next;
+    std::vector<ReloadListener> toNotify;
+    {
+        std::lock_guard<std::mutex> lock(reloadMutex);
+        filesChanged();
+        const uint64_t version = snapshot()->version;
+        Json::Value config;
+        Json::Value pairList;
+        try {
+            loadFile(CONFIG_FILE, config);
+            loadFile(PAIR_LIST_FILE, pairList);
+        } catch (const std::exception& e) {
+            logger.error("重新載入配置失敗, 沿用版本 " + std::to_string(version) + ": " + e.what());
+            return false;
+        }
+        next = ConfigSnapshot::build(config, pairList, version + 1);
+        std::atomic_store(&current, next);
+        toNotify = listeners;
+    }
+    logger.info("配置已重新載入, 版本 " + std::to_string(next->version));
+    notify(toNotify, *next);
+    return true;
+}
+
+void Config::onReload(ReloadListener listener) {
+    std::lock_guard<std::mutex> lock(reloadMutex);
+    listeners.push_back(std::move(listener));
+}
+
+// 比較並更新記錄的修改時間; 文件暫時不存在時視為未變更
+bool Config::filesChanged() {
+    bool changed = false;
+    std::error_code ec;
+    auto configTime = std::filesystem::last_write_time(CONFIG_FILE, ec);
+    if (!ec && configTime != configMtime) {
+        configMtime = configTime;
+        changed = true;
+    }
+    auto pairListTime = std::filesystem::last_write_time(PAIR_LIST_FILE, ec);
+    if (!ec && pairListTime != pairListMtime) {
+        pairListMtime = pairListTime;
+        changed = true;
+    }
+    return changed;
+}
+
+void Config::startWatching(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(watchMutex);
+    if (watching) {
+        return;
+    }
+    watching = true;
+    watcher = std::thread(&Config::watchLoop, this, interval);
+}
+
+void Config::stopWatching() {
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        if (!watching) {
+            return;
+        }
+        watching = false;
+    }
+    watchCv.notify_all();
+    if (watcher.joinable()) {
+        watcher.join();
+    }
+}
+
+void Config::watchLoop(std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(watchMutex);
+    while (watching) {
+        watchCv.wait_for(lock, interval, [this] { return !watching; });
+        if (!watching) {
+            break;
+        }
+        lock.unlock();
+        bool changed;
+        {
+            std::lock_guard<std::mutex> reloadLock(reloadMutex);
+            changed = filesChanged();
+        }
+        if (changed) {
+            reload();
+        }
+        lock.lock();
+    }
+}
+
+bool Config::isHotReloadEnabled() const {
+    return snapshot()->config["config_reload"]["enabled"].asBool();
+}
+
+int Config::getHotReloadIntervalSeconds() const {
+    return snapshot()->config["config_reload"]["interval_seconds"].asInt();
+}
+
 std::string Config::getBybitApiKey() const {
-    return config["exchanges"]["bybit"]["api_key"].asString();
+    return snapshot()->bybitApiKey;
 }
 
 std::string Config::getBybitApiSecret() const {
-    return config["exchanges"]["bybit"]["api_secret"].asString();
+    return snapshot()->bybitApiSecret;
 }
 
 std::string Config::getBybitBaseUrl() const {
-    return config["exchanges"]["bybit"]["base_url"].asString();
+    return snapshot()->bybitBaseUrl;
+}
+
+std::vector<AccountConfig> Config::getAccounts() const {
+    const auto snap = snapshot();
+    std::vector<AccountConfig> accounts;
+    for (const auto& entry : snap->config["accounts"]) {
+        AccountConfig account;
+        account.name = entry["name"].asString();
+        account.apiKey = entry["api_key"].asString();
+        account.apiSecret = entry["api_secret"].asString();
+        account.baseUrl = entry.isMember("base_url") ? entry["base_url"].asString() : snap->bybitBaseUrl;
+        account.overrides = entry["overrides"];
+        if (account.name.empty()) {
+            account.name = "account" + std::to_string(accounts.size() + 1);
+        }
+        accounts.push_back(std::move(account));
+    }
+    if (accounts.empty()) {
+        accounts.push_back({"", snap->bybitApiKey, snap->bybitApiSecret, snap->bybitBaseUrl, Json::Value()});
+    }
+    return accounts;
 }
 
 int Config::getDefaultLeverage() const {
-    return config["exchanges"]["bybit"]["default_leverage"].asInt();
+    return snapshot()->defaultLeverage;
 }
 
 int Config::getCheckIntervalMinutes() const {
-    return config["trading"]["check_interval_minutes"].asInt();
+    return snapshot()->checkIntervalMinutes;
 }
 
 int Config::getTopPairsCount() const {
-    return config["top_pairs_count"].asInt();
+    return snapshot()->topPairsCount;
 }
 
 std::vector<std::string> Config::getTradingPairs() const {
-    std::vector<std::string> pairs;
-    const Json::Value& pairList = pair_list["pair_list"];
-    for (const auto& pair : pairList) {
-        pairs.push_back(pair.asString());
-    }
-    return pairs;
+    return snapshot()->tradingPairs;
 }
 
-
 std::vector<int> Config::getFundingPeriods() const {
-    std::vector<int> periods;
-    const Json::Value& periodsArray = config["trading"]["funding_rate_scoring"]["periods"];
-    for (const auto& period : periodsArray) {
-        periods.push_back(period.asInt());
-    }
-    return periods;
+    return snapshot()->fundingPeriods;
 }
 
 std::vector<double> Config::getFundingWeights() const {
-    std::vector<double> weights;
-    const Json::Value& weightsArray = config["trading"]["funding_rate_scoring"]["weights"];
-    for (const auto& weight : weightsArray) {
-        weights.push_back(weight.asDouble());
-    }
-    return weights;
+    return snapshot()->fundingWeights;
 }
 
 std::string Config::getPreferredExchange() const {
-    return config["preferred_exchange"].asString();
+    return snapshot()->preferredExchange;
 }
 
 bool Config::isExchangeEnabled(const std::string& exchange) const {
-    std::string lowerExchange = exchange;
-    std::transform(lowerExchange.begin(), lowerExchange.end(), lowerExchange.begin(), ::tolower);
-    return config["exchanges"][lowerExchange]["enabled"].asBool();
+    return snapshot()->config["exchanges"][toLower(exchange)]["enabled"].asBool();
 }
 
 std::vector<std::string> Config::getSettlementTimesUTC() const {
-    std::vector<std::string> times;
-    const Json::Value& timesArray = config["trading"]["funding_rate_scoring"]["settlement_times_utc"];
-    for (const auto& time : timesArray) {
-        times.push_back(time.asString());
-    }
-    return times;
+    return snapshot()->settlementTimesUTC;
 }
 
 int Config::getPreSettlementMinutes() const {
-    return config["trading"]["funding_rate_scoring"]["pre_settlement_minutes"].asInt();
+    return snapshot()->preSettlementMinutes;
+}
+
+int Config::getPostSettlementMinutes() const {
+    return snapshot()->postSettlementMinutes;
 }
 
 int Config::getFundingHistoryDays() const {
-    return config["trading"]["funding_rate_scoring"]["history_days"].asInt();
-} 
-// 在 Config 類的 public 部分添加：
-double Config::getMinPositionValue() const { 
-    return config["trading"]["min_position_value"].asDouble(); 
+    return snapshot()->fundingHistoryDays;
 }
 
-double Config::getMaxPositionValue() const { 
-    return config["trading"]["max_position_value"].asDouble(); 
+double Config::getMinPositionValue() const {
+    return snapshot()->minPositionValue;
+}
+
+double Config::getMaxPositionValue() const {
+    return snapshot()->maxPositionValue;
 }
 
 std::vector<std::string> Config::getUnsupportedSymbols() const {
-    std::vector<std::string> pairs;
-    const Json::Value& pairList = pair_list["unsupported_symbols"];
-    for (const auto& pair : pairList) {
-        pairs.push_back(pair.asString());
-    }
-    return pairs;
+    return snapshot()->unsupportedSymbols;
 }
 
 bool Config::isSpotMarginTradingEnabled() const {
-    std::string lowerExchange = getPreferredExchange();
-    std::transform(lowerExchange.begin(), lowerExchange.end(), lowerExchange.begin(), ::tolower);
-    return config["exchanges"][lowerExchange]["spot_margin_trading"].asBool();
+    return snapshot()->spotMarginTrading;
 }
 
 bool Config::getPositionScaling() const {
-    return config["trading"]["position_scaling"].asBool();
+    return snapshot()->positionScaling;
 }
 
 double Config::getScalingFactor() const {
-    return config["trading"]["scaling_factor"].asDouble();
+    return snapshot()->scalingFactor;
 }
 
 double Config::getMinScalingRate() const {
-    return config["trading"]["min_scaling_rate"].asDouble();
+    return snapshot()->minScalingRate;
 }
 
 double Config::getMaxScalingRate() const {
-    return config["trading"]["max_scaling_rate"].asDouble();
+    return snapshot()->maxScalingRate;
 }
 
 int Config::getFundingHoldingDays() const {
-    return config["trading"]["funding_holding_days"].asInt();
+    return snapshot()->fundingHoldingDays;
 }
 
 bool Config::getUseCoinMarketCap() const {
-    return config["trading"]["use_coin_market_cap"].asBool();
+    return snapshot()->useCoinMarketCap;
 }
 
 std::string Config::getCMCApiKey() const {
-    return config["trading"]["cmc_api_key"].asString();
+    return snapshot()->cmcApiKey;
 }
 
 std::string Config::getCMCSortBy() const {
-    return config["trading"]["cmc_sort_by"].asString();
+    return snapshot()->cmcSortBy;
 }
 
 int Config::getCMCTopCount() const {
-    return config["trading"]["cmc_top_count"].asInt();
+    return snapshot()->cmcTopCount;
+}
+
+std::string Config::getCMCBaseUrl() const {
+    return snapshot()->config["trading"]["cmc_base_url"].asString();
+}
+
+bool Config::hasCMCCacheConfig() const {
+    return snapshot()->config["trading"].isMember("cmc_cache");
+}
+
+std::string Config::getCMCCachePath() const {
+    return snapshot()->config["trading"]["cmc_cache"]["path"].asString();
+}
+
+int Config::getCMCCacheTtlMinutes() const {
+    return snapshot()->config["trading"]["cmc_cache"]["ttl_minutes"].asInt();
+}
+
+int Config::getCMCRetryMinutes() const {
+    return snapshot()->config["trading"]["cmc_cache"]["retry_minutes"].asInt();
+}
+
+std::string Config::getFundingArchivePath() const {
+    return snapshot()->config["storage"]["funding_archive"].asString();
+}
+
+bool Config::hasWarmStateConfig() const {
+    return snapshot()->config["storage"].isMember("warm_state");
+}
+
+std::string Config::getWarmStatePath() const {
+    return snapshot()->config["storage"]["warm_state"]["path"].asString();
+}
+
+int Config::getWarmStateMaxAgeMinutes() const {
+    return snapshot()->config["storage"]["warm_state"]["max_age_minutes"].asInt();
 }
 
 bool Config::getReverseContractFundingRate() const {
-    return config["trading"]["reverse_contract_funding_rate"].asBool();
-}
\ No newline at end of file
+    return snapshot()->reverseContractFundingRate;
+}
+
+bool Config::isSlicedExecutionEnabled() const {
+    return snapshot()->slicedExecution;
+}
+
+double Config::getMaxSliceImpact() const {
+    return snapshot()->maxSliceImpact;
+}
+
+int Config::getMaxSlices() const {
+    return snapshot()->maxSlices;
+}
+
+int Config::getSliceIntervalMs() const {
+    return snapshot()->sliceIntervalMs;
+}
+
+std::string Config::getSliceTrigger() const {
+    return snapshot()->sliceTrigger;
+}
+
+int Config::getReplenishTimeoutMs() const {
+    return snapshot()->replenishTimeoutMs;
+}
+
+bool Config::hasSymbolBlockConfig() const {
+    return snapshot()->config["trading"].isMember("symbol_block");
+}
+
+int Config::getSymbolBlockTtlHours() const {
+    return snapshot()->config["trading"]["symbol_block"]["ttl_hours"].asInt();
+}
+
+int Config::getSymbolBlockFlushIntervalMs() const {
+    return snapshot()->config["trading"]["symbol_block"]["flush_interval_ms"].asInt();
+}
+
+bool Config::hasRiskMonitorConfig() const {
+    return snapshot()->config["trading"].isMember("risk_monitor");
+}
+
+bool Config::isRiskMonitorEnabled() const {
+    return snapshot()->config["trading"]["risk_monitor"]["enabled"].asBool();
+}
+
+int Config::getRiskPollIntervalMs() const {
+    return snapshot()->config["trading"]["risk_monitor"]["poll_interval_ms"].asInt();
+}
+
+double Config::getRiskMaintenanceMarginRate() const {
+    return snapshot()->config["trading"]["risk_monitor"]["maintenance_margin_rate"].asDouble();
+}
+
+double Config::getRiskWarnRatio() const {
+    return snapshot()->config["trading"]["risk_monitor"]["warn_ratio"].asDouble();
+}
+
+double Config::getRiskDeleverageRatio() const {
+    return snapshot()->config["trading"]["risk_monitor"]["deleverage_ratio"].asDouble();
+}
+
+double Config::getRiskDeleverageFraction() const {
+    return snapshot()->config["trading"]["risk_monitor"]["deleverage_fraction"].asDouble();
+}
+
+int Config::getRiskCooldownSeconds() const {
+    return snapshot()->config["trading"]["risk_monitor"]["cooldown_seconds"].asInt();
+}
+
+bool Config::hasMarketDataConfig() const {
+    return snapshot()->config.isMember("market_data");
+}
+
+int Config::getMarketTickerTtlMs() const {
+    return snapshot()->config["market_data"]["ticker_ttl_ms"].asInt();
+}
+
+int Config::getMarketBookTtlMs() const {
+    return snapshot()->config["market_data"]["book_ttl_ms"].asInt();
+}
+
+int Config::getMarketFundingTtlSeconds() const {
+    return snapshot()->config["market_data"]["funding_ttl_seconds"].asInt();
+}
+
+int Config::getMarketInstrumentsTtlSeconds() const {
+    return snapshot()->config["market_data"]["instruments_ttl_seconds"].asInt();
+}
+
+int Config::getMarketDisplayMaxAgeSeconds() const {
+    return snapshot()->config["market_data"]["display_max_age_seconds"].asInt();
+}
+
+bool Config::hasBasisTrackerConfig() const {
+    return snapshot()->config["trading"].isMember("basis_tracker");
+}
+
+bool Config::isBasisGatingEnabled() const {
+    return snapshot()->config["trading"]["basis_tracker"]["enabled"].asBool();
+}
+
+int Config::getBasisPollIntervalMs() const {
+    return snapshot()->config["trading"]["basis_tracker"]["poll_interval_ms"].asInt();
+}
+
+int Config::getBasisWindow() const {
+    return snapshot()->config["trading"]["basis_tracker"]["window"].asInt();
+}
+
+int Config::getBasisMaxSkewMs() const {
+    return snapshot()->config["trading"]["basis_tracker"]["max_skew_ms"].asInt();
+}
+
+int Config::getBasisMaxAgeMs() const {
+    return snapshot()->config["trading"]["basis_tracker"]["max_age_ms"].asInt();
+}
+
+int Config::getBasisMinSamples() const {
+    return snapshot()->config["trading"]["basis_tracker"]["min_samples"].asInt();
+}
+
+double Config::getBasisEwmaAlpha() const {
+    return snapshot()->config["trading"]["basis_tracker"]["ewma_alpha"].asDouble();
+}
+
+double Config::getBasisEntryPercentile() const {
+    return snapshot()->config["trading"]["basis_tracker"]["entry_percentile"].asDouble();
+}
+
+double Config::getBasisExitPercentile() const {
+    return snapshot()->config["trading"]["basis_tracker"]["exit_percentile"].asDouble();
+}
+
+int Config::getBasisMaxExitDelaySeconds() const {
+    return snapshot()->config["trading"]["basis_tracker"]["max_exit_delay_seconds"].asInt();
+}
+
+bool Config::hasPipelineConfig() const {
+    return snapshot()->config.isMember("pipeline");
+}
+
+bool Config::isPipelineEnabled() const {
+    return snapshot()->config["pipeline"]["enabled"].asBool();
+}
+
+int Config::getPipelineQueueCapacity() const {
+    return snapshot()->config["pipeline"]["queue_capacity"].asInt();
+}
+
+bool Config::isPipelineBusyPoll() const {
+    return snapshot()->config["pipeline"]["busy_poll"].asBool();
+}
+
+int Config::getPipelineIdleWaitUs() const {
+    return snapshot()->config["pipeline"]["idle_wait_us"].asInt();
+}
+
+int Config::getPipelineMarketDataCpu() const {
+    return snapshot()->config["pipeline"].get("market_data_cpu", -1).asInt();
+}
+
+int Config::getPipelineStrategyCpu() const {
+    return snapshot()->config["pipeline"].get("strategy_cpu", -1).asInt();
+}
+
+int Config::getPipelineExecutionCpu() const {
+    return snapshot()->config["pipeline"].get("execution_cpu", -1).asInt();
+}
+
+bool Config::hasOrderRetryConfig() const {
+    return snapshot()->config.isMember("order_retry");
+}
+
+int Config::getRequestTimeoutMs() const {
+    return snapshot()->config["order_retry"]["request_timeout_ms"].asInt();
+}
+
+int Config::getOrderTimeoutMs() const {
+    return snapshot()->config["order_retry"]["order_timeout_ms"].asInt();
+}
+
+int Config::getConnectTimeoutMs() const {
+    return snapshot()->config["order_retry"]["connect_timeout_ms"].asInt();
+}
+
+int Config::getOrderMaxAttempts() const {
+    return snapshot()->config["order_retry"]["max_attempts"].asInt();
+}
+
+bool Config::hasRateLimitConfig() const {
+    return snapshot()->config.isMember("rate_limit");
+}
+
+bool Config::isRateLimitEnabled() const {
+    return snapshot()->config["rate_limit"].get("enabled", true).asBool();
+}
+
+double Config::getRateLimitPublicPerSecond() const {
+    return snapshot()->config["rate_limit"]["public_per_second"].asDouble();
+}
+
+double Config::getRateLimitPrivatePerSecond() const {
+    return snapshot()->config["rate_limit"]["private_per_second"].asDouble();
+}
+
+double Config::getRateLimitBurstSeconds() const {
+    return snapshot()->config["rate_limit"]["burst_seconds"].asDouble();
+}
+
+double Config::getRateLimitRiskReserve() const {
+    return snapshot()->config["rate_limit"]["risk_reserve"].asDouble();
+}
+
+double Config::getRateLimitMarketDataReserve() const {
+    return snapshot()->config["rate_limit"]["market_data_reserve"].asDouble();
+}
+
+double Config::getRateLimitDisplayReserve() const {
+    return snapshot()->config["rate_limit"]["display_reserve"].asDouble();
+}
+
+bool Config::hasLoggingConfig() const {
+    return snapshot()->config.isMember("logging");
+}
+
+std::string Config::getLogLevel() const {
+    return snapshot()->config["logging"]["level"].asString();
+}
+
+bool Config::isConsoleLogEnabled() const {
+    return snapshot()->config["logging"]["console"].asBool();
+}
+
+std::string Config::getLogFile() const {
+    return snapshot()->config["logging"]["file"].asString();
+}
+
+std::string Config::getBinaryLogFile() const {
+    return snapshot()->config["logging"]["binary_file"].asString();
+}
+
+int Config::getLogMaxFileSizeMB() const {
+    return snapshot()->config["logging"]["max_file_size_mb"].asInt();
+}
+
+int Config::getLogMaxFiles() const {
+    return snapshot()->config["logging"]["max_files"].asInt();
+}
+
+int Config::getLogQueueSize() const {
+    return snapshot()->config["logging"]["queue_size"].asInt();
+}
+
+std::string Config::getLogOverflowPolicy() const {
+    return snapshot()->config["logging"]["overflow_policy"].asString();
+}
+
+bool Config::hasMetricsConfig() const {
+    return snapshot()->config.isMember("metrics");
+}
+
+int Config::getMetricsHttpPort() const {
+    return snapshot()->config["metrics"]["http_port"].asInt();
+}
+
+std::string Config::getMetricsBindAddress() const {
+    return snapshot()->config["metrics"]["bind_address"].asString();
+}
+
+std::string Config::getMetricsFile() const {
+    return snapshot()->config["metrics"]["file"].asString();
+}
+
+int Config::getMetricsFileIntervalSeconds() const {
+    return snapshot()->config["metrics"]["file_interval_seconds"].asInt();
+}
+
+bool Config::isAllocTrackingEnabled() const {
+    return snapshot()->config["metrics"]["alloc_tracking"].asBool();
+}
+
+bool Config::hasTracingConfig() const {
+    return snapshot()->config.isMember("tracing");
+}
+
+bool Config::isTracingEnabled() const {
+    return snapshot()->config["tracing"]["enabled"].asBool();
+}
+
+std::string Config::getTraceOutputDir() const {
+    return snapshot()->config["tracing"]["output_dir"].asString();
+}
+
+int Config::getTraceMaxEventsPerCycle() const {
+    return snapshot()->config["tracing"]["max_events_per_cycle"].asInt();
+}
@@ -9,14 +9,99 @@
 #include <chrono>
 #include <thread>
 #include "logger.h"
+#include "metrics/metrics.h"
+#include "metrics/trace.h"
 
-std::mutex BybitAPI::mutex_;
-std::unique_ptr<BybitAPI> BybitAPI::instance;
+namespace {
 
-BybitAPI::BybitAPI() : 
-    API_KEY(Config::getInstance().getBybitApiKey()),
-    API_SECRET(Config::getInstance().getBybitApiSecret()),
-    BASE_URL(Config::getInstance().getBybitBaseUrl()) {}
+// 每個 endpoint 的指標引用, 第一次請求時向註冊表取得後緩存
+struct EndpointMetrics {
+    LatencyHistogram& dns;
+    LatencyHistogram& connect;
+    LatencyHistogram& tls;
+    LatencyHistogram& ttfb;
+    LatencyHistogram& total;
+    MetricCounter& requests;
+    MetricCounter& curlFailures;
+    MetricCounter& parseFailures;
+};
+
+EndpointMetrics& endpointMetrics(const std::string& endpoint, const std::string& method) {
+    static std::mutex metricsMutex;
+    static std::map<std::string, std::unique_ptr<EndpointMetrics>> cache;
+
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    auto& slot = cache[method + " " + endpoint];
+    if (!slot) {
+        MetricsRegistry& registry = MetricsRegistry::getInstance();
+        const std::string latencyName = "frt_http_request_seconds";
+        const std::string latencyHelp = "Bybit API 請求各階段耗時 (curl 計時)";
+        auto phase = [&](const char* name) -> LatencyHistogram& {
+            return registry.histogram(latencyName, latencyHelp,
+                                      {{"endpoint", endpoint}, {"method", method}, {"phase", name}});
+        };
+        auto failures = [&](const char* reason) -> MetricCounter& {
+            return registry.counter("frt_http_failures_total", "Bybit API 請求失敗次數 (curl 錯誤或響應無法解析)",
+                                    {{"endpoint", endpoint}, {"reason", reason}});
+        };
+        slot.reset(new EndpointMetrics{
+            phase("dns"), phase("connect"), phase("tls"), phase("ttfb"), phase("total"),
+            registry.counter("frt_http_requests_total", "Bybit API 請求次數",
+                             {{"endpoint", endpoint}, {"method", method}}),
+            failures("curl"), failures("parse")});
+    }
+    return *slot;
+}
+
+// curl 的時間點都從請求開始累計, 這裡換算成各階段的耗時.
+// ttfb 為請求送出後等待首個位元組的時間; 複用連線時 DNS/連線/TLS 為 0 不記錄
+void recordCurlTimings(CURL* curl, EndpointMetrics& metrics) {
+    curl_off_t nameLookup = 0, connect = 0, appConnect = 0, preTransfer = 0, startTransfer = 0, total = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &nameLookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &appConnect);
+    curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &preTransfer);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &startTransfer);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+
+    if (nameLookup > 0) {
+        metrics.dns.record(static_cast<uint64_t>(nameLookup));
+    }
+    if (connect > nameLookup) {
+        metrics.connect.record(static_cast<uint64_t>(connect - nameLookup));
+    }
+    if (appConnect > connect) {
+        metrics.tls.record(static_cast<uint64_t>(appConnect - connect));
+    }
+    if (startTransfer > 0) {
+        metrics.ttfb.record(static_cast<uint64_t>(std::max<curl_off_t>(0, startTransfer - preTransfer)));
+    }
+    metrics.total.record(static_cast<uint64_t>(total));
+}
+
+// Bybit: 超出請求頻率限制
+constexpr int RATE_LIMIT_EXCEEDED = 10006;
+
+RequestBudget& publicBudget(const RequestBudgetOptions& options) {
+    static RequestBudget budget("public", options.publicPerSecond, options);
+    return budget;
+}
+
+MetricCounter& retCodeCounter(const std::string& endpoint, int retCode) {
+    return MetricsRegistry::getInstance().counter(
+        "frt_api_retcode_errors_total", "Bybit API 返回非零 retCode 的次數",
+        {{"endpoint", endpoint}, {"ret_code", std::to_string(retCode)}});
+}
+
+} // namespace
+
+BybitAPI::BybitAPI(const AccountConfig& account) :
+    API_KEY(account.apiKey),
+    API_SECRET(account.apiSecret),
+    BASE_URL(account.baseUrl),
+    retryOptions(OrderRetryOptions::fromConfig()),
+    budgetOptions(RequestBudgetOptions::fromConfig()),
+    privateBudget("private", budgetOptions.privatePerSecond, budgetOptions) {}
 
 size_t BybitAPI::WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
     userp->append((char*)contents, size * nmemb);
@@ -46,7 +131,9 @@ std::string BybitAPI::generateSignature(const std::string& params, const std::st
 }
 
 Json::Value BybitAPI::makeRequest(const std::string& endpoint, const std::string& method, 
-                                  const std::map<std::string, std::string>& params) {
+                                  const std::map<std::string, std::string>& params,
+                                  std::chrono::milliseconds timeout) {
+    TraceSpan span("makeRequest", "rest", endpoint);
     Logger logger;
     
     // 檢查是否為無效的交易對請求
@@ -59,8 +146,12 @@ Json::Value BybitAPI::makeRequest(const std::string& endpoint, const std::string
         return errorResponse;
     }
     
+    RequestBudget& budget = endpoint.rfind("/v5/market/", 0) == 0 ? publicBudget(budgetOptions) : privateBudget;
+    budget.acquire(currentRequestPriority(defaultRequestPriority(endpoint)));
+
     CURL* curl = curl_easy_init();
     std::string response;
+    EndpointMetrics& metrics = endpointMetrics(endpoint, method);
     
     std::string url = BASE_URL;
     if (!url.empty() && url.back() == '/') {
@@ -123,6 +214,11 @@ Json::Value BybitAPI::makeRequest(const std::string& endpoint, const std::string
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+        // 毫秒級超時在多線程下需要關閉信號
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS,
+                         static_cast<long>((timeout.count() > 0 ? timeout : retryOptions.requestTimeout).count()));
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(retryOptions.connectTimeout.count()));
         
         if (method == "POST") {
             curl_easy_setopt(curl, CURLOPT_POST, 1L);
@@ -133,10 +229,15 @@ Json::Value BybitAPI::makeRequest(const std::string& endpoint, const std::string
         
         // 執行請求
         CURLcode res = curl_easy_perform(curl);
+        metrics.requests.increment();
+        if (res == CURLE_OK) {
+            recordCurlTimings(curl, metrics);
+        }
         curl_slist_free_all(headers);
         curl_easy_cleanup(curl);
         
         if (res != CURLE_OK) {
+            metrics.curlFailures.increment();
             logger.error("CURL請求失敗: " + std::string(curl_easy_strerror(res)));
             return Json::Value();
         }
@@ -151,6 +252,10 @@ Json::Value BybitAPI::makeRequest(const std::string& endpoint, const std::string
     if (!response.empty() && reader.parse(response, root)) {
         if (root.isObject() && root.isMember("retCode")) {
             if (root["retCode"].asInt() != 0) {
+                if (root["retCode"].asInt() == RATE_LIMIT_EXCEEDED) {
+                    budget.exhaust(std::chrono::steady_clock::now());
+                }
+                retCodeCounter(endpoint, root["retCode"].asInt()).increment();
                 logger.error("API錯誤碼: " + std::to_string(root["retCode"].asInt()));
                 logger.error("錯誤信息: " + root["retMsg"].asString());
             } else {
@@ -160,22 +265,16 @@ Json::Value BybitAPI::makeRequest(const std::string& endpoint, const std::string
         return root;
     }
     
+    metrics.parseFailures.increment();
     logger.error("JSON解析失敗");
     return Json::Value();
 }
 
-BybitAPI& BybitAPI::getInstance() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!instance) {
-        instance.reset(new BybitAPI());
-    }
-    return *instance;
-}
-
 std::vector<std::pair<std::string, double>> BybitAPI::getFundingRates() {
     std::vector<std::pair<std::string, double>> rates;
-    auto pairs = Config::getInstance().getTradingPairs();
-    int historyDays = Config::getInstance().getFundingHistoryDays();
+    const auto config = Config::getInstance().snapshot();
+    const auto& pairs = config->tradingPairs;
+    int historyDays = config->fundingHistoryDays;
     
     Logger logger;
     logger.info("開始獲取資金費率歷史數據");
@@ -217,10 +316,21 @@ std::vector<std::pair<std::string, double>> BybitAPI::getFundingRates() {
 
 std::vector<std::pair<std::string, std::vector<double>>> BybitAPI::getFundingHistory(
     const std::vector<std::string>& targetSymbols) {
-    
+    // 記錄按幣種連續排列, 組內最新在前
     std::vector<std::pair<std::string, std::vector<double>>> rates;
+    for (const auto& record : getFundingRecords(targetSymbols)) {
+        if (rates.empty() || rates.back().first != record.symbol) {
+            rates.emplace_back(record.symbol, std::vector<double>());
+        }
+        rates.back().second.push_back(record.rate);
+    }
+    return rates;
+}
+
+std::vector<FundingRecord> BybitAPI::getFundingRecords(const std::vector<std::string>& targetSymbols) {
+    std::vector<FundingRecord> records;
     
-    int historyDays = Config::getInstance().getFundingHistoryDays();
+    int historyDays = Config::getInstance().snapshot()->fundingHistoryDays;
     Logger logger;
     logger.info("開始獲取資金費率歷史數據,"+std::to_string(targetSymbols.size()));
     
@@ -239,23 +349,18 @@ std::vector<std::pair<std::string, std::vector<double>>> BybitAPI::getFundingHis
                 continue;
             }
             
-            std::vector<double> symbolRates;
             const Json::Value& list = response["result"]["list"];
             
             for (const auto& rate : list) {
                 try {
-                    double fundingRate = std::stod(rate["fundingRate"].asString());
-                    symbolRates.push_back(fundingRate);
+                    records.push_back({symbol, std::stoll(rate["fundingRateTimestamp"].asString()),
+                                       std::stod(rate["fundingRate"].asString())});
                 } catch (const std::exception& e) {
                     logger.error("解析資金費率失敗: " + symbol + " - " + e.what());
                     continue;
                 }
             }
             
-            if (!symbolRates.empty()) {
-                rates.emplace_back(symbol, symbolRates);
-            }
-            
         } catch (const std::exception& e) {
             logger.error("處理資金費率歷史時發生異常: " + symbol + " - " + e.what());
             continue;
@@ -265,7 +370,7 @@ std::vector<std::pair<std::string, std::vector<double>>> BybitAPI::getFundingHis
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     
-    return rates;
+    return records;
 }
 
 
@@ -280,24 +385,50 @@ bool BybitAPI::setLeverage(const std::string& symbol, int leverage) {
     return response.isObject() && response["retCode"].asInt() == 0;
 }
 
+Json::Value BybitAPI::submitOrder(const std::map<std::string, std::string>& params) {
+    Json::Value response;
+    auto linkId = params.find("orderLinkId");
+    if (linkId == params.end()) {
+        response = makeRequest("/v5/order/create", "POST", params);
+    } else {
+        const std::string& category = params.at("category");
+        OrderIntent intent{params.at("symbol"), params.at("side"), std::stod(params.at("qty"))};
+        response = submitIdempotentOrder(linkId->second, intent, retryOptions.maxAttempts,
+            [this, &params] { return makeRequest("/v5/order/create", "POST", params, retryOptions.orderTimeout); },
+            [this, &category, &linkId] { return getOrderByLinkId(category, linkId->second); });
+    }
+    // 沒有響應時無法確認訂單成立, 不能當作成功
+    if (!response.isObject() || !response.isMember("retCode")) {
+        response = Json::Value();
+        response["retCode"] = ORDER_STATUS_UNKNOWN;
+        response["retMsg"] = "No response";
+    }
+    if (response["retCode"].asInt() != 0) {
+        lastError = response["retMsg"].asString();
+    }
+    return response;
+}
+
 Json::Value BybitAPI::createOrder(const std::string& symbol, const std::string& side, double qty,
-                                const std::string& category, const std::string& orderType) {
+                                const std::string& category, const std::string& orderType,
+                                const std::string& orderLinkId) {
+    TraceSpan span("createOrder", "order", symbol);
     std::map<std::string, std::string> params;
     params["symbol"] = symbol;
     params["side"] = side;
     params["orderType"] = orderType;
     params["qty"] = std::to_string(qty);
     params["category"] = category;
-    
-    Json::Value response = makeRequest("/v5/order/create", "POST", params);
-    if (response["retCode"].asInt() != 0) {
-        lastError = response["retMsg"].asString();
+    if (!orderLinkId.empty()) {
+        params["orderLinkId"] = orderLinkId;
     }
     
-    return response;
+    return submitOrder(params);
 }
 
-bool BybitAPI::createSpotOrder(const std::string& symbol, const std::string& side, double qty) {
+bool BybitAPI::createSpotOrder(const std::string& symbol, const std::string& side, double qty,
+                               const std::string& orderLinkId) {
+    TraceSpan span("createSpotOrder", "order", symbol);
     std::map<std::string, std::string> params;
     params["symbol"] = symbol;
     params["side"] = side;
@@ -305,17 +436,33 @@ bool BybitAPI::createSpotOrder(const std::string& symbol, const std::string& sid
     params["qty"] = std::to_string(qty); //現貨倉位需要整數
     params["category"] = "spot";
     params["marketUnit"] = "baseCoin";
+    if (!orderLinkId.empty()) {
+        params["orderLinkId"] = orderLinkId;
+    }
     
-    Json::Value response = makeRequest("/v5/order/create", "POST", params);
-    if (response["retCode"].asInt() != 0) {
-        lastError = response["retMsg"].asString();
-        return false;
+    return submitOrder(params)["retCode"].asInt() == 0;
+}
+
+Json::Value BybitAPI::getOrderByLinkId(const std::string& category, const std::string& orderLinkId) {
+    std::map<std::string, std::string> params;
+    params["category"] = category;
+    params["orderLinkId"] = orderLinkId;
+    // 市價單成交後很快從活動訂單移到歷史訂單
+    for (const char* endpoint : {"/v5/order/realtime", "/v5/order/history"}) {
+        Json::Value response = makeRequest(endpoint, "GET", params, retryOptions.orderTimeout);
+        if (response.isObject() && response["retCode"].asInt() == 0) {
+            const Json::Value& list = response["result"]["list"];
+            if (list.isArray() && !list.empty()) {
+                return list[0];
+            }
+        }
     }
-    return true;
+    return Json::Value();
 }
 
 
 void BybitAPI::closePosition(const std::string& symbol) {
+    TraceSpan span("closePosition", "order", symbol);
     // 先獲取當前持倉
     auto position = getPositions(symbol);
     if (position.isNull() || !position["result"]["list"].isArray() || 
@@ -338,7 +485,7 @@ Json::Value BybitAPI::getPositions(const std::string& symbol) {
     params["settleCoin"] = "USDT";
     
     if (!symbol.empty()) {
-        logger.info("獲取指定幣對倉位: " + symbol);
+        LOG_INFO(logger, "獲取指定幣對倉位: " + symbol);
         params["symbol"] = symbol;
     } else {
         logger.info("獲取所有倉位");
@@ -349,7 +496,7 @@ Json::Value BybitAPI::getPositions(const std::string& symbol) {
     if (!symbol.empty()) {
         paramString += "&symbol=" + symbol;
     }
-    logger.info("請求參數: " + paramString);
+    LOG_INFO(logger, "請求參數: " + paramString);
     
     Json::Value response = makeRequest("/v5/position/list", "GET", params);
     
@@ -451,7 +598,7 @@ double BybitAPI::getSpotBalance(const std::string& symbol) {
         for (const auto& coinData : coins) {
             if (coinData["coin"].asString() == coin) {
                 double balance = std::stod(coinData["walletBalance"].asString());
-                logger.info(coin + " 現貨餘額: " + std::to_string(balance));
+                LOG_INFO(logger, coin + " 現貨餘額: " + std::to_string(balance));
                 return balance;
             }
         }
@@ -510,7 +657,7 @@ Json::Value BybitAPI::getContractOrderBook(const std::string& symbol) {
 }
 
 // 獲取當前資金費率
-double BybitAPI::getCurrentFundingRate(const std::string& symbol) {
+std::optional<double> BybitAPI::getCurrentFundingRate(const std::string& symbol) {
     std::map<std::string, std::string> params;
     params["symbol"] = symbol;
     params["category"] = "linear";
@@ -519,9 +666,14 @@ double BybitAPI::getCurrentFundingRate(const std::string& symbol) {
     
     if (response.isObject() && response["retCode"].asInt() == 0 && 
         response["result"]["list"].isArray() && !response["result"]["list"].empty()) {
-        return std::stod(response["result"]["list"][0]["fundingRate"].asString());
+        try {
+            return std::stod(response["result"]["list"][0]["fundingRate"].asString());
+        } catch (const std::exception& e) {
+            Logger logger;
+            logger.error("解析資金費率失敗: " + std::string(e.what()));
+        }
     }
-    return 0.0;
+    return std::nullopt;
 }
 
 // 獲取現貨手續費率
@@ -0,0 +1,106 @@
+#include "exchange/coin_market_cap.h"
+#include "config.h"
+#include <curl/curl.h>
+#include <json/json.h>
+
+CoinMarketCapSource::CoinMarketCapSource(const std::string& baseUrl, const std::string& apiKey,
+                                         long timeoutSeconds) :
+    baseUrl(baseUrl.empty() ? DEFAULT_BASE_URL : baseUrl),
+    apiKey(apiKey),
+    timeoutSeconds(timeoutSeconds) {}
+
+CoinMarketCapSource::~CoinMarketCapSource() {
+    if (curl) {
+        curl_easy_cleanup(static_cast<CURL*>(curl));
+    }
+}
+
+std::unique_ptr<CoinMarketCapSource> CoinMarketCapSource::fromConfig() {
+    const Config& config = Config::getInstance();
+    return std::make_unique<CoinMarketCapSource>(config.getCMCBaseUrl(), config.getCMCApiKey());
+}
+
+size_t CoinMarketCapSource::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    static_cast<std::string*>(userp)->append(static_cast<char*>(contents), size * nmemb);
+    return size * nmemb;
+}
+
+bool CoinMarketCapSource::fetch(int topCount, const std::string& sortBy,
+                                std::vector<std::string>& symbols, std::string& error) {
+    std::lock_guard<std::mutex> lock(curlMutex);
+    if (!curl) {
+        curl = curl_easy_init();
+        if (!curl) {
+            error = "無法初始化 CURL";
+            return false;
+        }
+    }
+    CURL* handle = static_cast<CURL*>(curl);
+    curl_easy_reset(handle);
+
+    std::string url = baseUrl + "/v1/cryptocurrency/listings/latest?sort=" + sortBy +
+                      "&limit=" + std::to_string(topCount) + "&aux=" + sortBy;
+    struct curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, ("X-CMC_PRO_API_KEY: " + apiKey).c_str());
+    headers = curl_slist_append(headers, "Accept: application/json");
+
+    std::string response;
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT, timeoutSeconds);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+
+    CURLcode res = curl_easy_perform(handle);
+    curl_slist_free_all(headers);
+    if (res != CURLE_OK) {
+        error = "CMC API 請求失敗: " + std::string(curl_easy_strerror(res));
+        return false;
+    }
+    long httpCode = 0;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &httpCode);
+
+    // 錯誤響應 (402 額度用完, 429 限流等) 也帶有 status, 優先使用其中的錯誤信息
+    if (!parseListings(response, topCount, symbols, error)) {
+        return false;
+    }
+    if (httpCode != 200) {
+        error = "CMC API HTTP " + std::to_string(httpCode);
+        return false;
+    }
+    return true;
+}
+
+bool CoinMarketCapSource::parseListings(const std::string& body, int topCount,
+                                        std::vector<std::string>& symbols, std::string& error) {
+    Json::Value root;
+    Json::Reader reader;
+    if (!reader.parse(body, root)) {
+        error = "解析 CMC 響應失敗";
+        return false;
+    }
+    const Json::Value& status = root["status"];
+    if (status["error_code"].asInt() != 0) {
+        error = "CMC API 錯誤 " + std::to_string(status["error_code"].asInt()) + ": " +
+                status["error_message"].asString();
+        return false;
+    }
+    if (!root["data"].isArray()) {
+        error = "CMC 響應中沒有找到數據數組";
+        return false;
+    }
+
+    symbols.clear();
+    for (const auto& coin : root["data"]) {
+        if (symbols.size() >= static_cast<size_t>(topCount)) {
+            break;
+        }
+        symbols.push_back(coin["symbol"].asString() + "USDT");
+    }
+    if (symbols.empty()) {
+        error = "CMC 響應沒有任何幣種";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,153 @@
+#include "exchange/market_data_hub.h"
+#include "config.h"
+#include "metrics/metrics.h"
+#include <algorithm>
+#include <map>
+
+namespace {
+
+template <typename T>
+using Outcome = typename TtlCache<T>::Outcome;
+
+// 按數據類型及結果 (命中, 合併, 實際請求) 統計, 用於確認多帳戶時公共請求沒有隨帳戶數增長
+void countRequest(const std::string& kind, const char* outcome) {
+    static std::mutex metricsMutex;
+    static std::map<std::string, MetricCounter*> cache;
+    std::string key = kind + "/" + outcome;
+    MetricCounter* counter;
+    {
+        std::lock_guard<std::mutex> lock(metricsMutex);
+        auto& slot = cache[key];
+        if (!slot) {
+            slot = &MetricsRegistry::getInstance().counter(
+                "frt_market_data_requests_total", "共用行情層的請求次數",
+                {{"kind", kind}, {"outcome", outcome}});
+        }
+        counter = slot;
+    }
+    counter->increment();
+}
+
+template <typename T, typename Fetch, typename Accept>
+T cachedRequest(TtlCache<T>& cache, const std::string& kind, const std::string& key,
+                std::chrono::milliseconds ttl, Fetch&& fetch, Accept&& accept) {
+    Outcome<T> outcome = Outcome<T>::Fetched;
+    T value = cache.get(key, ttl, std::forward<Fetch>(fetch), std::forward<Accept>(accept), &outcome);
+    countRequest(kind, outcome == Outcome<T>::Hit ? "hit" : outcome == Outcome<T>::Shared ? "shared" : "fetched");
+    return value;
+}
+
+bool positive(double value) {
+    return value > 0;
+}
+
+bool hasValue(const std::optional<double>& value) {
+    return value.has_value();
+}
+
+bool okResponse(const Json::Value& response) {
+    return response.isObject() && response["retCode"].asInt() == 0;
+}
+
+template <typename Container>
+bool nonEmpty(const Container& values) {
+    return !values.empty();
+}
+
+// 各帳戶的候選列表順序可能不同, 鍵使用排序後的列表
+std::string symbolListKey(const std::vector<std::string>& symbols) {
+    std::vector<std::string> sorted = symbols;
+    std::sort(sorted.begin(), sorted.end());
+    std::string key;
+    for (const auto& symbol : sorted) {
+        key += symbol + ",";
+    }
+    return key;
+}
+
+} // namespace
+
+MarketDataOptions MarketDataOptions::fromConfig() {
+    MarketDataOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasMarketDataConfig()) {
+        return options;
+    }
+    if (config.getMarketTickerTtlMs() > 0) {
+        options.tickerTtl = std::chrono::milliseconds(config.getMarketTickerTtlMs());
+    }
+    if (config.getMarketBookTtlMs() > 0) {
+        options.bookTtl = std::chrono::milliseconds(config.getMarketBookTtlMs());
+    }
+    if (config.getMarketFundingTtlSeconds() > 0) {
+        options.fundingTtl = std::chrono::seconds(config.getMarketFundingTtlSeconds());
+    }
+    if (config.getMarketInstrumentsTtlSeconds() > 0) {
+        options.instrumentsTtl = std::chrono::seconds(config.getMarketInstrumentsTtlSeconds());
+    }
+    if (config.getMarketDisplayMaxAgeSeconds() > 0) {
+        options.displayMaxAge = std::chrono::seconds(config.getMarketDisplayMaxAgeSeconds());
+    }
+    return options;
+}
+
+MarketDataHub::MarketDataHub(IExchange& source, const MarketDataOptions& options) :
+    source(source), options(options) {}
+
+std::chrono::milliseconds MarketDataHub::ttlFor(std::chrono::milliseconds ttl) const {
+    if (currentRequestPriority(RequestPriority::MarketData) == RequestPriority::Display) {
+        return std::max(ttl, std::chrono::milliseconds(options.displayMaxAge));
+    }
+    return ttl;
+}
+
+std::vector<std::pair<std::string, double>> MarketDataHub::getFundingRates() {
+    return cachedRequest(fundingRates, "funding_rates", "all", ttlFor(options.fundingTtl),
+                         [this] { return source.getFundingRates(); },
+                         nonEmpty<std::vector<std::pair<std::string, double>>>);
+}
+
+std::vector<std::pair<std::string, std::vector<double>>> MarketDataHub::getFundingHistory(
+    const std::vector<std::string>& symbols) {
+    return cachedRequest(fundingHistory, "funding_history", symbolListKey(symbols), ttlFor(options.fundingTtl),
+                         [this, &symbols] { return source.getFundingHistory(symbols); },
+                         nonEmpty<std::vector<std::pair<std::string, std::vector<double>>>>);
+}
+
+std::vector<FundingRecord> MarketDataHub::getFundingRecords(const std::vector<std::string>& symbols) {
+    return cachedRequest(fundingRecords, "funding_records", symbolListKey(symbols), ttlFor(options.fundingTtl),
+                         [this, &symbols] { return source.getFundingRecords(symbols); },
+                         nonEmpty<std::vector<FundingRecord>>);
+}
+
+double MarketDataHub::getSpotPrice(const std::string& symbol) {
+    return cachedRequest(prices, "spot_price", "spot:" + symbol, ttlFor(options.tickerTtl),
+                         [this, &symbol] { return source.getSpotPrice(symbol); }, positive);
+}
+
+double MarketDataHub::getContractPrice(const std::string& symbol) {
+    return cachedRequest(prices, "contract_price", "linear:" + symbol, ttlFor(options.tickerTtl),
+                         [this, &symbol] { return source.getContractPrice(symbol); }, positive);
+}
+
+std::optional<double> MarketDataHub::getCurrentFundingRate(const std::string& symbol) {
+    // 資金費率可以為 0 或負數, 失敗以空值表示, 只緩存成功的讀取
+    return cachedRequest(currentFundingRates, "funding_rate", symbol, ttlFor(options.tickerTtl),
+                         [this, &symbol] { return source.getCurrentFundingRate(symbol); }, hasValue);
+}
+
+Json::Value MarketDataHub::getSpotOrderBook(const std::string& symbol) {
+    return cachedRequest(books, "spot_orderbook", "spot:" + symbol, ttlFor(options.bookTtl),
+                         [this, &symbol] { return source.getSpotOrderBook(symbol); }, okResponse);
+}
+
+Json::Value MarketDataHub::getContractOrderBook(const std::string& symbol) {
+    return cachedRequest(books, "contract_orderbook", "linear:" + symbol, ttlFor(options.bookTtl),
+                         [this, &symbol] { return source.getContractOrderBook(symbol); }, okResponse);
+}
+
+std::vector<std::string> MarketDataHub::getInstruments(const std::string& category) {
+    return cachedRequest(instruments, "instruments", category, ttlFor(options.instrumentsTtl),
+                         [this, &category] { return source.getInstruments(category); },
+                         nonEmpty<std::vector<std::string>>);
+}
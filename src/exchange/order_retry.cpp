@@ -0,0 +1,141 @@
+#include "exchange/order_retry.h"
+#include "config.h"
+#include "logger.h"
+#include "metrics/metrics.h"
+#include <cmath>
+
+namespace {
+
+MetricCounter& retryCounter(const char* outcome) {
+    return MetricsRegistry::getInstance().counter(
+        "frt_order_retries_total", "帶訂單號下單的重試及確認結果 (resent/recovered/confirmed/unknown)",
+        {{"outcome", outcome}});
+}
+
+bool answered(const Json::Value& response) {
+    return response.isObject() && response.isMember("retCode");
+}
+
+Json::Value placedResponse(const std::string& orderLinkId, const std::string& orderId) {
+    Json::Value response;
+    response["retCode"] = 0;
+    response["retMsg"] = "OK";
+    response["result"]["orderId"] = orderId;
+    response["result"]["orderLinkId"] = orderLinkId;
+    return response;
+}
+
+Json::Value failedResponse(int retCode, const std::string& message) {
+    Json::Value response;
+    response["retCode"] = retCode;
+    response["retMsg"] = message;
+    return response;
+}
+
+// 訂單記錄中的數量以字串返回
+double quantity(const Json::Value& value) {
+    if (value.isNumeric()) {
+        return value.asDouble();
+    }
+    try {
+        return value.isString() ? std::stod(value.asString()) : 0.0;
+    } catch (const std::exception&) {
+        return 0.0;
+    }
+}
+
+bool sameQuantity(double actual, double expected) {
+    return std::abs(actual - expected) <= std::max(1e-9, std::abs(expected) * 1e-6);
+}
+
+// 核對按訂單號查到的訂單: 不屬於本次下單, 被拒絕或未完全成交時返回失敗響應
+Json::Value resolveFoundOrder(const std::string& orderLinkId, const OrderIntent& intent, const Json::Value& order) {
+    const std::string status = order["orderStatus"].asString();
+    if (status == "Rejected") {
+        return failedResponse(10001, "Order rejected: " + order["rejectReason"].asString());
+    }
+    if (order["symbol"].asString() != intent.symbol || order["side"].asString() != intent.side ||
+        !sameQuantity(quantity(order["qty"]), intent.qty)) {
+        Logger logger;
+        logger.error("訂單號 " + orderLinkId + " 對應的訂單 (" + order["symbol"].asString() + " " +
+                       order["side"].asString() + " " + order["qty"].asString() + ") 與本次下單不符");
+        return failedResponse(ORDER_LINK_ID_MISMATCH, "Order link id mismatch: " + orderLinkId);
+    }
+
+    double filled = quantity(order["cumExecQty"]);
+    Json::Value response;
+    // 市價單撤銷時未成交的部分不會再成交
+    if (status == "Cancelled" || status == "PartiallyFilledCanceled" || status == "Deactivated") {
+        response = failedResponse(ORDER_NOT_FILLED, "Order " + status + ": " + orderLinkId);
+    } else {
+        response = placedResponse(orderLinkId, order["orderId"].asString());
+    }
+    response["result"]["orderId"] = order["orderId"].asString();
+    response["result"]["orderLinkId"] = orderLinkId;
+    response["result"]["orderStatus"] = status;
+    response["result"]["cumExecQty"] = order["cumExecQty"].isNull() ? Json::Value("0") : order["cumExecQty"];
+    if (filled > 0 && !order["avgPrice"].isNull()) {
+        response["result"]["avgPrice"] = order["avgPrice"];
+    }
+    return response;
+}
+
+} // namespace
+
+OrderRetryOptions OrderRetryOptions::fromConfig() {
+    OrderRetryOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasOrderRetryConfig()) {
+        return options;
+    }
+    if (config.getRequestTimeoutMs() > 0) {
+        options.requestTimeout = std::chrono::milliseconds(config.getRequestTimeoutMs());
+    }
+    if (config.getOrderTimeoutMs() > 0) {
+        options.orderTimeout = std::chrono::milliseconds(config.getOrderTimeoutMs());
+    }
+    if (config.getConnectTimeoutMs() > 0) {
+        options.connectTimeout = std::chrono::milliseconds(config.getConnectTimeoutMs());
+    }
+    if (config.getOrderMaxAttempts() > 0) {
+        options.maxAttempts = config.getOrderMaxAttempts();
+    }
+    return options;
+}
+
+Json::Value submitIdempotentOrder(const std::string& orderLinkId, const OrderIntent& intent, int maxAttempts,
+                                  const std::function<Json::Value()>& send,
+                                  const std::function<Json::Value()>& lookup) {
+    Logger logger;
+    bool accepted = false;  // 交易所曾確認此訂單號已存在
+    for (int attempt = 1; attempt <= std::max(maxAttempts, 1); attempt++) {
+        if (attempt > 1) {
+            retryCounter("resent").increment();
+            logger.warning("訂單 " + orderLinkId + " 狀態未確認, 以相同訂單號重發 (第 " +
+                           std::to_string(attempt) + " 次)");
+        }
+        Json::Value response = send();
+        if (answered(response) && response["retCode"].asInt() != ORDER_LINK_ID_DUPLICATE) {
+            return response;
+        }
+        accepted = accepted || answered(response);
+
+        // 響應丟失或訂單號重複: 訂單可能已成立, 按訂單號確認後再決定是否重發
+        Json::Value order = lookup();
+        if (order.isObject() && !order["orderId"].asString().empty()) {
+            Json::Value resolved = resolveFoundOrder(orderLinkId, intent, order);
+            if (resolved["retCode"].asInt() == 0) {
+                retryCounter("recovered").increment();
+            }
+            return resolved;
+        }
+    }
+    if (accepted) {
+        // 交易所已拒絕重複訂單號, 訂單確實存在, 只是暫時查詢不到
+        retryCounter("confirmed").increment();
+        return placedResponse(orderLinkId, "");
+    }
+    retryCounter("unknown").increment();
+    logger.error("訂單 " + orderLinkId + " 多次嘗試後仍無法確認狀態");
+    return failedResponse(ORDER_STATUS_UNKNOWN, "Order status unknown: " + orderLinkId);
+}
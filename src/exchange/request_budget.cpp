@@ -0,0 +1,167 @@
+#include "exchange/request_budget.h"
+#include "config.h"
+#include "metrics/metrics.h"
+#include <algorithm>
+
+namespace {
+
+// -1 表示沒有覆蓋
+thread_local int scopedPriority = -1;
+
+size_t index(RequestPriority priority) {
+    return static_cast<size_t>(priority);
+}
+
+} // namespace
+
+const char* toString(RequestPriority priority) {
+    switch (priority) {
+        case RequestPriority::OrderEntry: return "order_entry";
+        case RequestPriority::Risk: return "risk";
+        case RequestPriority::MarketData: return "market_data";
+        case RequestPriority::Display: return "display";
+    }
+    return "unknown";
+}
+
+RequestPriority defaultRequestPriority(const std::string& endpoint) {
+    if (endpoint.rfind("/v5/order/", 0) == 0) {
+        return RequestPriority::OrderEntry;
+    }
+    if (endpoint.rfind("/v5/market/", 0) == 0) {
+        return RequestPriority::MarketData;
+    }
+    // 持倉, 槓桿, 錢包及保證金
+    return RequestPriority::Risk;
+}
+
+RequestPriority currentRequestPriority(RequestPriority fallback) {
+    return scopedPriority >= 0 ? static_cast<RequestPriority>(scopedPriority) : fallback;
+}
+
+RequestPriorityScope::RequestPriorityScope(RequestPriority priority) : previous(scopedPriority) {
+    scopedPriority = static_cast<int>(priority);
+}
+
+RequestPriorityScope::~RequestPriorityScope() {
+    scopedPriority = previous;
+}
+
+RequestBudgetOptions RequestBudgetOptions::fromConfig() {
+    RequestBudgetOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasRateLimitConfig()) {
+        return options;
+    }
+    options.enabled = config.isRateLimitEnabled();
+    if (config.getRateLimitPublicPerSecond() > 0) {
+        options.publicPerSecond = config.getRateLimitPublicPerSecond();
+    }
+    if (config.getRateLimitPrivatePerSecond() > 0) {
+        options.privatePerSecond = config.getRateLimitPrivatePerSecond();
+    }
+    if (config.getRateLimitBurstSeconds() > 0) {
+        options.burstSeconds = config.getRateLimitBurstSeconds();
+    }
+    if (config.getRateLimitRiskReserve() > 0) {
+        options.riskReserve = config.getRateLimitRiskReserve();
+    }
+    if (config.getRateLimitMarketDataReserve() > 0) {
+        options.marketDataReserve = config.getRateLimitMarketDataReserve();
+    }
+    if (config.getRateLimitDisplayReserve() > 0) {
+        options.displayReserve = config.getRateLimitDisplayReserve();
+    }
+    return options;
+}
+
+RequestBudget::RequestBudget(const std::string& group, double perSecond, const RequestBudgetOptions& options) :
+    group(group),
+    perSecond(options.enabled ? perSecond : 0.0),
+    capacity(std::max(1.0, perSecond * options.burstSeconds)),
+    tokens(capacity),
+    refilledAt(std::chrono::steady_clock::now()) {
+    reserve[index(RequestPriority::Risk)] = options.riskReserve;
+    reserve[index(RequestPriority::MarketData)] = options.marketDataReserve;
+    reserve[index(RequestPriority::Display)] = options.displayReserve;
+}
+
+void RequestBudget::refill(TimePoint now) {
+    if (now <= refilledAt) {
+        return;
+    }
+    double elapsed = std::chrono::duration<double>(now - refilledAt).count();
+    tokens = std::min(capacity, tokens + elapsed * perSecond);
+    refilledAt = now;
+}
+
+std::chrono::nanoseconds RequestBudget::admit(RequestPriority priority, TimePoint now) {
+    if (perSecond <= 0) {
+        counters.granted[index(priority)]++;
+        return std::chrono::nanoseconds::zero();
+    }
+    refill(now);
+    const auto oneToken = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / perSecond));
+    // 更高優先級正在等待時讓路
+    for (size_t higher = 0; higher < index(priority); higher++) {
+        if (waiting[higher] > 0) {
+            return oneToken;
+        }
+    }
+    double needed = std::min(capacity, 1.0 + reserve[index(priority)] * capacity);
+    if (tokens >= needed) {
+        tokens -= 1.0;
+        counters.granted[index(priority)]++;
+        return std::chrono::nanoseconds::zero();
+    }
+    return std::max(oneToken / 10,
+                    std::chrono::nanoseconds(static_cast<int64_t>((needed - tokens) / perSecond * 1e9)));
+}
+
+std::chrono::nanoseconds RequestBudget::tryAcquire(RequestPriority priority, TimePoint now) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return admit(priority, now);
+}
+
+void RequestBudget::acquire(RequestPriority priority) {
+    auto started = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    auto wait = admit(priority, started);
+    if (wait == std::chrono::nanoseconds::zero()) {
+        return;
+    }
+
+    counters.deferred[index(priority)]++;
+    waiting[index(priority)]++;
+    while (wait > std::chrono::nanoseconds::zero()) {
+        changed.wait_for(lock, wait);
+        wait = admit(priority, std::chrono::steady_clock::now());
+    }
+    waiting[index(priority)]--;
+    lock.unlock();
+    // 讓路的低優先級請求重新檢查
+    changed.notify_all();
+
+    MetricsRegistry& registry = MetricsRegistry::getInstance();
+    const MetricLabels labels{{"group", group}, {"priority", toString(priority)}};
+    registry.counter("frt_rate_budget_deferred_total", "因請求額度不足而延後的請求次數", labels).increment();
+    registry.histogram("frt_rate_budget_wait_seconds", "延後請求等待額度的時間", labels)
+        .record(std::chrono::steady_clock::now() - started);
+}
+
+void RequestBudget::exhaust(TimePoint now) {
+    std::lock_guard<std::mutex> lock(mutex);
+    refill(now);
+    tokens = 0.0;
+}
+
+double RequestBudget::available(TimePoint now) {
+    std::lock_guard<std::mutex> lock(mutex);
+    refill(now);
+    return tokens;
+}
+
+RequestBudget::Stats RequestBudget::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
@@ -0,0 +1,456 @@
+#include "logging/binary_log.h"
+#include "logging/log_backend.h"
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace {
+
+struct FormatRegistry {
+    std::mutex mutex;
+    std::vector<LogFormatInfo> formats{LogFormatInfo{0, 0, "{}", ""}};  // id 0 為純文字記錄
+};
+
+struct SymbolRegistry {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::string> names{""};
+};
+
+FormatRegistry& formatRegistry() {
+    static FormatRegistry registry;
+    return registry;
+}
+
+SymbolRegistry& symbolRegistry() {
+    static SymbolRegistry registry;
+    return registry;
+}
+
+std::string formatDouble(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+    return buffer;
+}
+
+// 逐一讀取參數區, 對每個參數調用 visit(文字)
+void decodeArguments(const uint8_t* payload, size_t size,
+                     const std::function<std::string(uint32_t)>& symbolName,
+                     const std::function<void(const std::string&)>& visit) {
+    size_t pos = 0;
+    auto need = [&](size_t length) { return pos + length <= size; };
+    while (pos < size) {
+        auto type = static_cast<LogArgType>(payload[pos++]);
+        switch (type) {
+            case LogArgType::Double: {
+                if (!need(8)) return;
+                double value;
+                std::memcpy(&value, payload + pos, 8);
+                pos += 8;
+                visit(formatDouble(value));
+                break;
+            }
+            case LogArgType::Int:
+            case LogArgType::UInt: {
+                uint64_t value;
+                size_t length = decodeVarint(payload + pos, size - pos, value);
+                if (length == 0) return;
+                pos += length;
+                visit(type == LogArgType::Int ? std::to_string(zigzagDecode(value)) : std::to_string(value));
+                break;
+            }
+            case LogArgType::Bool: {
+                if (!need(1)) return;
+                visit(payload[pos++] ? "true" : "false");
+                break;
+            }
+            case LogArgType::String: {
+                if (!need(2)) return;
+                uint16_t length;
+                std::memcpy(&length, payload + pos, 2);
+                pos += 2;
+                if (!need(length)) return;
+                visit(std::string(reinterpret_cast<const char*>(payload + pos), length));
+                pos += length;
+                break;
+            }
+            case LogArgType::Symbol: {
+                uint64_t id;
+                size_t length = decodeVarint(payload + pos, size - pos, id);
+                if (length == 0) return;
+                pos += length;
+                visit(symbolName(static_cast<uint32_t>(id)));
+                break;
+            }
+            case LogArgType::Truncated:
+                visit("<截斷>");
+                return;
+            default:
+                return;
+        }
+    }
+}
+
+std::string renderWith(const std::string& format, const uint8_t* payload, size_t size,
+                       const std::function<std::string(uint32_t)>& symbolName) {
+    std::vector<std::string> args;
+    decodeArguments(payload, size, symbolName, [&args](const std::string& arg) { args.push_back(arg); });
+
+    std::string text;
+    text.reserve(format.size() + args.size() * 12);
+    size_t next = 0;
+    for (size_t i = 0; i < format.size(); i++) {
+        if (format[i] == '{' && i + 1 < format.size() && format[i + 1] == '}' && next < args.size()) {
+            text += args[next++];
+            i++;
+        } else {
+            text += format[i];
+        }
+    }
+    // 參數多於佔位符時附加在末尾
+    for (; next < args.size(); next++) {
+        text += " " + args[next];
+    }
+    return text;
+}
+
+} // namespace
+
+size_t encodeVarint(uint64_t value, uint8_t* out) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+size_t decodeVarint(const uint8_t* data, size_t size, uint64_t& value) {
+    value = 0;
+    for (size_t i = 0; i < size && i < 10; i++) {
+        value |= static_cast<uint64_t>(data[i] & 0x7f) << (7 * i);
+        if ((data[i] & 0x80) == 0) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+uint32_t registerLogFormat(LogLevel level, const char* format, const char* file, int line) {
+    FormatRegistry& registry = formatRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    uint32_t id = static_cast<uint32_t>(registry.formats.size());
+    registry.formats.push_back(LogFormatInfo{id, static_cast<int>(level), format,
+                                             std::string(file) + ":" + std::to_string(line)});
+    return id;
+}
+
+bool findLogFormat(uint32_t id, LogFormatInfo& info) {
+    FormatRegistry& registry = formatRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (id >= registry.formats.size()) {
+        return false;
+    }
+    info = registry.formats[id];
+    return true;
+}
+
+uint32_t internLogSymbol(std::string_view name) {
+    SymbolRegistry& registry = symbolRegistry();
+    std::string key(name);
+    {
+        std::shared_lock<std::shared_mutex> lock(registry.mutex);
+        auto it = registry.ids.find(key);
+        if (it != registry.ids.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(registry.mutex);
+    auto [it, inserted] = registry.ids.emplace(key, static_cast<uint32_t>(registry.names.size()));
+    if (inserted) {
+        registry.names.push_back(key);
+    }
+    return it->second;
+}
+
+std::string logSymbolName(uint32_t id) {
+    SymbolRegistry& registry = symbolRegistry();
+    std::shared_lock<std::shared_mutex> lock(registry.mutex);
+    return id < registry.names.size() ? registry.names[id] : "?" + std::to_string(id);
+}
+
+void BinaryEncoder::put(std::string_view text) {
+    // 保留類型與長度欄位後, 字串按剩餘空間截斷
+    size_t header = 1 + sizeof(uint16_t);
+    if (truncated || used + header > capacity) {
+        markTruncated();
+        return;
+    }
+    size_t length = std::min({text.size(), capacity - used - header, size_t(UINT16_MAX)});
+    uint16_t raw = static_cast<uint16_t>(length);
+    buffer[used++] = static_cast<uint8_t>(LogArgType::String);
+    std::memcpy(buffer + used, &raw, sizeof(raw));
+    used += sizeof(raw);
+    std::memcpy(buffer + used, text.data(), length);
+    used += length;
+}
+
+void BinaryEncoder::putRaw(LogArgType type, const void* data, size_t length) {
+    if (truncated || used + 1 + length > capacity) {
+        markTruncated();
+        return;
+    }
+    buffer[used++] = static_cast<uint8_t>(type);
+    std::memcpy(buffer + used, data, length);
+    used += length;
+}
+
+void BinaryEncoder::putVarint(LogArgType type, uint64_t value) {
+    uint8_t raw[10];
+    size_t length = encodeVarint(value, raw);
+    putRaw(type, raw, length);
+}
+
+void BinaryEncoder::markTruncated() {
+    if (!truncated && used < capacity) {
+        buffer[used++] = static_cast<uint8_t>(LogArgType::Truncated);
+    }
+    truncated = true;
+}
+
+std::string renderLogMessage(const std::string& format, const uint8_t* payload, size_t size) {
+    return renderWith(format, payload, size, logSymbolName);
+}
+
+bool BinaryLogWriter::open(const std::string& path) {
+    close();
+    file.open(path, std::ios::binary | std::ios::app);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.seekp(0, std::ios::end);
+    fileBytes = static_cast<size_t>(file.tellp());
+    // 每個文件以文件頭開始; 附加到既有文件時重新輸出定義即可
+    if (fileBytes == 0) {
+        file.write(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+        fileBytes = sizeof(BINARY_LOG_MAGIC);
+    }
+    return true;
+}
+
+void BinaryLogWriter::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+    fileBytes = 0;
+    lastTimestampNs = 0;
+    sessionStarted = false;
+    writtenFormats.clear();
+    writtenSymbols.clear();
+}
+
+size_t BinaryLogWriter::writeEvent(uint32_t formatId, LogLevel level, std::chrono::system_clock::time_point time,
+                                   const uint8_t* payload, size_t size) {
+    size_t before = fileBytes;
+    ensureFormat(formatId);
+    ensureSymbols(payload, size);
+
+    int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    if (!sessionStarted) {
+        // 附加寫入時文件中已有上一會話的事件, 時間差必須從新的基準開始
+        writeValue(static_cast<uint8_t>(BinaryRecordType::Session));
+        writeValue(timestamp);
+        lastTimestampNs = timestamp;
+        sessionStarted = true;
+    }
+    writeValue(static_cast<uint8_t>(BinaryRecordType::Event));
+    writeVarint(formatId);
+    writeValue(static_cast<uint8_t>(level));
+    writeVarint(zigzagEncode(timestamp - lastTimestampNs));
+    writeVarint(size);
+    lastTimestampNs = timestamp;
+    file.write(reinterpret_cast<const char*>(payload), size);
+    fileBytes += size;
+    return fileBytes - before;
+}
+
+void BinaryLogWriter::ensureFormat(uint32_t formatId) {
+    if (!writtenFormats.insert(formatId).second) {
+        return;
+    }
+    LogFormatInfo info;
+    findLogFormat(formatId, info);
+    writeValue(static_cast<uint8_t>(BinaryRecordType::FormatDefinition));
+    writeValue(formatId);
+    writeValue(static_cast<uint8_t>(info.level));
+    writeString(info.format);
+    writeString(info.location);
+}
+
+void BinaryLogWriter::ensureSymbols(const uint8_t* payload, size_t size) {
+    // 只需找出 Symbol 參數, 借用解碼流程
+    size_t pos = 0;
+    while (pos < size) {
+        auto type = static_cast<LogArgType>(payload[pos++]);
+        size_t length = 0;
+        switch (type) {
+            case LogArgType::Double: length = 8; break;
+            case LogArgType::Int:
+            case LogArgType::UInt: {
+                uint64_t value;
+                length = decodeVarint(payload + pos, size - pos, value);
+                if (length == 0) return;
+                break;
+            }
+            case LogArgType::Bool: length = 1; break;
+            case LogArgType::String: {
+                if (pos + 2 > size) return;
+                uint16_t raw;
+                std::memcpy(&raw, payload + pos, 2);
+                length = 2 + raw;
+                break;
+            }
+            case LogArgType::Symbol: {
+                uint64_t id;
+                length = decodeVarint(payload + pos, size - pos, id);
+                if (length == 0) return;
+                if (writtenSymbols.insert(static_cast<uint32_t>(id)).second) {
+                    writeValue(static_cast<uint8_t>(BinaryRecordType::SymbolDefinition));
+                    writeValue(static_cast<uint32_t>(id));
+                    writeString(logSymbolName(static_cast<uint32_t>(id)));
+                }
+                break;
+            }
+            default:
+                return;
+        }
+        pos += length;
+    }
+}
+
+void BinaryLogWriter::writeString(std::string_view text) {
+    uint16_t length = static_cast<uint16_t>(std::min(text.size(), size_t(UINT16_MAX)));
+    writeValue(length);
+    file.write(text.data(), length);
+    fileBytes += length;
+}
+
+void BinaryLogWriter::writeVarint(uint64_t value) {
+    uint8_t raw[10];
+    size_t length = encodeVarint(value, raw);
+    file.write(reinterpret_cast<const char*>(raw), length);
+    fileBytes += length;
+}
+
+BinaryLogReader::BinaryLogReader(std::istream& in) : in(in) {
+    char magic[sizeof(BINARY_LOG_MAGIC)];
+    headerValid = static_cast<bool>(in.read(magic, sizeof(magic))) &&
+                  std::memcmp(magic, BINARY_LOG_MAGIC, sizeof(magic)) == 0;
+}
+
+bool BinaryLogReader::readString(std::string& text) {
+    uint16_t length;
+    if (!readValue(length)) return false;
+    text.resize(length);
+    return length == 0 || static_cast<bool>(in.read(text.data(), length));
+}
+
+bool BinaryLogReader::readVarint(uint64_t& value) {
+    value = 0;
+    for (int i = 0; i < 10; i++) {
+        int byte = in.get();
+        if (byte == EOF) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BinaryLogReader::next(DecodedLogRecord& record) {
+    if (!headerValid) {
+        return false;
+    }
+    uint8_t type;
+    while (readValue(type)) {
+        switch (static_cast<BinaryRecordType>(type)) {
+            case BinaryRecordType::FormatDefinition: {
+                LogFormatInfo info;
+                uint8_t level;
+                if (!readValue(info.id) || !readValue(level) ||
+                    !readString(info.format) || !readString(info.location)) {
+                    corrupt = true;
+                    return false;
+                }
+                info.level = level;
+                if (formats.size() <= info.id) formats.resize(info.id + 1);
+                formats[info.id] = info;
+                break;
+            }
+            case BinaryRecordType::SymbolDefinition: {
+                uint32_t id;
+                std::string name;
+                if (!readValue(id) || !readString(name)) {
+                    corrupt = true;
+                    return false;
+                }
+                if (symbols.size() <= id) symbols.resize(id + 1);
+                symbols[id] = name;
+                break;
+            }
+            case BinaryRecordType::Session: {
+                int64_t base;
+                if (!readValue(base)) {
+                    corrupt = true;
+                    return false;
+                }
+                lastTimestampNs = base;
+                break;
+            }
+            case BinaryRecordType::Event: {
+                uint64_t formatId, delta, size;
+                uint8_t level;
+                if (!readVarint(formatId) || !readValue(level) || !readVarint(delta) || !readVarint(size) ||
+                    size > UINT16_MAX) {
+                    corrupt = true;
+                    return false;
+                }
+                lastTimestampNs += zigzagDecode(delta);
+                std::vector<uint8_t> payload(size);
+                if (size > 0 && !in.read(reinterpret_cast<char*>(payload.data()), size)) {
+                    corrupt = true;
+                    return false;
+                }
+                record.level = level;
+                record.timestampNs = lastTimestampNs;
+                if (formatId < formats.size() && !formats[formatId].format.empty()) {
+                    record.message = render(formats[formatId].format, payload);
+                    record.location = formats[formatId].location;
+                } else if (formatId == 0) {
+                    record.message = render("{}", payload);
+                    record.location.clear();
+                } else {
+                    record.message = "<未知格式 " + std::to_string(formatId) + ">";
+                    record.location.clear();
+                }
+                return true;
+            }
+            default:
+                corrupt = true;
+                return false;
+        }
+    }
+    return false;
+}
+
+std::string BinaryLogReader::render(const std::string& format, const std::vector<uint8_t>& payload) const {
+    return renderWith(format, payload.data(), payload.size(), [this](uint32_t id) {
+        return id < symbols.size() ? symbols[id] : "?" + std::to_string(id);
+    });
+}
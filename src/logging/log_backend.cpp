@@ -0,0 +1,382 @@
+#include "logging/log_backend.h"
+#include "config.h"
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// 背景線程空閒時的等待: 先讓出 CPU, 再逐步延長休眠
+void idleWait(int& idleRounds) {
+    if (idleRounds < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(idleRounds < 256 ? 1 : 5));
+    }
+    idleRounds++;
+}
+
+std::string formatTime(std::chrono::system_clock::time_point time) {
+    std::time_t t = std::chrono::system_clock::to_time_t(time);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+    std::tm utc_tm = *std::gmtime(&t);
+    char buffer[32];
+    size_t len = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &utc_tm);
+    std::snprintf(buffer + len, sizeof(buffer) - len, ".%03d", static_cast<int>(ms));
+    return buffer;
+}
+
+// 輪替: path.(N-1) -> path.N, ..., path -> path.1
+void rotateLogFiles(const std::string& filePath, int maxFiles) {
+    std::error_code ec;
+    std::filesystem::remove(filePath + "." + std::to_string(maxFiles), ec);
+    for (int i = maxFiles - 1; i >= 1; i--) {
+        std::string from = filePath + "." + std::to_string(i);
+        if (std::filesystem::exists(from, ec)) {
+            std::filesystem::rename(from, filePath + "." + std::to_string(i + 1), ec);
+        }
+    }
+    if (maxFiles > 0) {
+        std::filesystem::rename(filePath, filePath + ".1", ec);
+    } else {
+        std::filesystem::remove(filePath, ec);
+    }
+}
+
+} // namespace
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug:   return "DEBUG";
+        case LogLevel::Info:    return "INFO";
+        case LogLevel::Warning: return "WARNING";
+        case LogLevel::Error:   return "ERROR";
+        case LogLevel::Off:     return "OFF";
+    }
+    return "UNKNOWN";
+}
+
+LogLevel parseLogLevel(const std::string& name, LogLevel fallback) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "debug") return LogLevel::Debug;
+    if (lower == "info") return LogLevel::Info;
+    if (lower == "warning" || lower == "warn") return LogLevel::Warning;
+    if (lower == "error") return LogLevel::Error;
+    if (lower == "off") return LogLevel::Off;
+    return fallback;
+}
+
+LogRing::LogRing(size_t capacity) :
+    cells(new Cell[roundUpToPowerOfTwo(capacity)]),
+    mask(roundUpToPowerOfTwo(capacity) - 1) {
+    for (size_t i = 0; i <= mask; i++) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool LogRing::tryPush(LogRecord&& record) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // 佇列已滿
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->record = std::move(record);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogRing::tryPop(LogRecord& record) {
+    Cell* cell = &cells[dequeuePos & mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(dequeuePos + 1) < 0) {
+        return false;  // 佇列為空或生產者尚未寫完
+    }
+    record = std::move(cell->record);
+    cell->sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+    dequeuePos++;
+    return true;
+}
+
+LogOptions LogOptions::fromConfig() {
+    LogOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasLoggingConfig()) {
+        return options;
+    }
+    options.level = parseLogLevel(config.getLogLevel(), options.level);
+    options.console = config.isConsoleLogEnabled();
+    options.filePath = config.getLogFile();
+    options.binaryFilePath = config.getBinaryLogFile();
+    if (config.getLogMaxFileSizeMB() > 0) {
+        options.maxFileBytes = static_cast<size_t>(config.getLogMaxFileSizeMB()) * 1024 * 1024;
+    }
+    if (config.getLogMaxFiles() > 0) {
+        options.maxFiles = config.getLogMaxFiles();
+    }
+    if (config.getLogQueueSize() > 0) {
+        options.queueCapacity = static_cast<size_t>(config.getLogQueueSize());
+    }
+    options.overflow = config.getLogOverflowPolicy() == "block" ? OverflowPolicy::Block : OverflowPolicy::Drop;
+    return options;
+}
+
+LogBackend& LogBackend::getInstance() {
+    static LogBackend instance;
+    return instance;
+}
+
+LogBackend::LogBackend(const LogOptions& options) :
+    minLevel(static_cast<int>(options.level)),
+    ring(new LogRing(options.queueCapacity)),
+    consoleEnabled(options.console),
+    overflow(options.overflow),
+    filePath(options.filePath),
+    maxFileBytes(options.maxFileBytes),
+    maxFiles(options.maxFiles),
+    binaryFilePath(options.binaryFilePath) {
+    openFile();
+    openBinaryFile();
+    worker = std::thread(&LogBackend::run, this);
+}
+
+LogBackend::~LogBackend() {
+    stopping.store(true, std::memory_order_release);
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void LogBackend::configure(const LogOptions& options) {
+    flush();
+    setLevel(options.level);
+    consoleEnabled.store(options.console, std::memory_order_relaxed);
+    overflow.store(options.overflow, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (submitted.load() == 0 && options.queueCapacity != ring->capacity()) {
+        ring.reset(new LogRing(options.queueCapacity));
+    }
+    if (options.filePath != filePath) {
+        file.close();
+        filePath = options.filePath;
+        openFile();
+    }
+    if (options.binaryFilePath != binaryFilePath) {
+        binaryFile.close();
+        binaryFilePath = options.binaryFilePath;
+        openBinaryFile();
+    }
+    maxFileBytes = options.maxFileBytes;
+    maxFiles = options.maxFiles;
+}
+
+void LogBackend::write(LogLevel level, std::string message) {
+    if (!enabled(level)) {
+        return;
+    }
+    LogRecord record;
+    record.level = level;
+    record.time = std::chrono::system_clock::now();
+    record.message = std::move(message);
+    submit(std::move(record));
+}
+
+void LogBackend::submit(LogRecord&& record) {
+    submitted.fetch_add(1, std::memory_order_relaxed);
+
+    // 警告及錯誤不可丟失, 即使設為丟棄策略也等待空位
+    bool mustDeliver = overflow.load(std::memory_order_relaxed) == OverflowPolicy::Block ||
+                       record.level >= LogLevel::Warning;
+    while (!ring->tryPush(std::move(record))) {
+        if (!mustDeliver) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            written.fetch_add(1, std::memory_order_release);  // 計入已處理, 避免 flush 等待
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void LogBackend::flush() {
+    uint64_t target = submitted.load(std::memory_order_acquire);
+    while (written.load(std::memory_order_acquire) < target && worker.joinable()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (file.is_open()) {
+        file.flush();
+    }
+    if (binaryFile.isOpen()) {
+        binaryFile.flush();
+    }
+    std::cout.flush();
+}
+
+void LogBackend::run() {
+    LogRecord record;
+    int idleRounds = 0;
+    while (true) {
+        bool any = false;
+        {
+            std::lock_guard<std::mutex> lock(fileMutex);
+            // 每批最多處理佇列容量筆, 然後統一刷新輸出
+            for (size_t n = 0; n < ring->capacity() && ring->tryPop(record); n++) {
+                output(record);
+                written.fetch_add(1, std::memory_order_release);
+                any = true;
+            }
+            if (any) {
+                reportDropped();
+                std::cout.flush();
+                if (file.is_open()) {
+                    file.flush();
+                }
+                if (binaryFile.isOpen()) {
+                    binaryFile.flush();
+                }
+            }
+        }
+
+        if (any) {
+            idleRounds = 0;
+        } else if (stopping.load(std::memory_order_acquire)) {
+            break;
+        } else {
+            idleWait(idleRounds);
+        }
+    }
+}
+
+void LogBackend::output(const LogRecord& record) {
+    if (binaryFile.isOpen()) {
+        writeBinaryRecord(record);
+    }
+
+    bool console = consoleEnabled.load(std::memory_order_relaxed);
+    if (!console && !file.is_open()) {
+        return;  // 只寫二進位文件時不需要渲染文字
+    }
+    std::string rendered;
+    if (record.formatId != 0) {
+        rendered = renderLogMessage(formatOf(record.formatId), record.payload.data(), record.payloadSize);
+    }
+    const std::string& message = record.formatId != 0 ? rendered : record.message;
+
+    const char* name = logLevelName(record.level);
+    if (console) {
+        std::ostream& out = record.level >= LogLevel::Warning ? std::cerr : std::cout;
+        out << "[" << name << "] " << message << '\n';
+    }
+    if (file.is_open()) {
+        std::string line = formatTime(record.time) + " [" + name + "] " + message + "\n";
+        if (fileBytes + line.size() > maxFileBytes && fileBytes > 0) {
+            rotateFile();
+        }
+        file << line;
+        fileBytes += line.size();
+    }
+}
+
+const std::string& LogBackend::formatOf(uint32_t formatId) {
+    if (formatId >= formatCache.size() || formatCache[formatId].empty()) {
+        LogFormatInfo info;
+        if (!findLogFormat(formatId, info)) {
+            info.format = "<未知格式>";
+        }
+        if (formatId >= formatCache.size()) {
+            formatCache.resize(formatId + 1);
+        }
+        formatCache[formatId] = info.format;
+    }
+    return formatCache[formatId];
+}
+
+void LogBackend::writeBinaryRecord(const LogRecord& record) {
+    if (binaryFile.bytesWritten() >= maxFileBytes) {
+        binaryFile.close();
+        rotateLogFiles(binaryFilePath, maxFiles);
+        openBinaryFile();
+    }
+    if (record.formatId != 0) {
+        binaryFile.writeEvent(record.formatId, record.level, record.time, record.payload.data(), record.payloadSize);
+        return;
+    }
+    // 文字記錄以格式 0 加單一字串參數存放
+    std::vector<uint8_t> payload(std::min<size_t>(record.message.size(), UINT16_MAX - 8) + 3);
+    BinaryEncoder encoder(payload.data(), payload.size());
+    encoder.put(record.message);
+    binaryFile.writeEvent(0, record.level, record.time, payload.data(), encoder.size());
+}
+
+void LogBackend::reportDropped() {
+    uint64_t count = dropped.load(std::memory_order_relaxed);
+    if (count == reportedDropped) {
+        return;
+    }
+    LogRecord notice{LogLevel::Warning, std::chrono::system_clock::now(),
+                     "日誌佇列已滿, 已丟棄 " + std::to_string(count - reportedDropped) + " 條記錄"};
+    reportedDropped = count;
+    output(notice);
+}
+
+void LogBackend::openFile() {
+    fileBytes = 0;
+    if (filePath.empty()) {
+        return;
+    }
+    std::filesystem::path path(filePath);
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    file.open(filePath, std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] 無法打開日誌文件: " << filePath << std::endl;
+        return;
+    }
+    fileBytes = std::filesystem::file_size(path, ec);
+    if (ec) {
+        fileBytes = 0;
+    }
+}
+
+void LogBackend::openBinaryFile() {
+    if (binaryFilePath.empty()) {
+        return;
+    }
+    std::filesystem::path path(binaryFilePath);
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    if (!binaryFile.open(binaryFilePath)) {
+        std::cerr << "[ERROR] 無法打開二進位日誌文件: " << binaryFilePath << std::endl;
+    }
+}
+
+void LogBackend::rotateFile() {
+    file.close();
+    rotateLogFiles(filePath, maxFiles);
+    openFile();
+}
\ No newline at end of file
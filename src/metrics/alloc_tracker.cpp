@@ -0,0 +1,204 @@
+#include "metrics/alloc_tracker.h"
+#include "metrics/metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace {
+
+std::atomic<bool> trackingEnabled{false};
+
+// 靜態 TLS, 不需要動態初始化, 可以在 operator new 中安全使用
+thread_local AllocStats threadCounters;
+thread_local AllocScope* currentScope = nullptr;
+
+constexpr size_t MAX_SITES = 128;
+
+struct SiteSlot {
+    std::atomic<const char*> label{nullptr};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> bytes{0};
+    uint64_t publishedCount = 0;  // 只在 publishMutex 下讀寫
+    uint64_t publishedBytes = 0;
+};
+
+SiteSlot sites[MAX_SITES];
+std::mutex publishMutex;
+
+// 同一字串在不同翻譯單元可能有不同地址, 以內容比對
+SiteSlot* findSite(const char* label) {
+    for (auto& slot : sites) {
+        const char* existing = slot.label.load(std::memory_order_acquire);
+        if (existing == nullptr) {
+            if (slot.label.compare_exchange_strong(existing, label, std::memory_order_acq_rel)) {
+                return &slot;
+            }
+        }
+        if (existing == label || std::strcmp(existing, label) == 0) {
+            return &slot;
+        }
+    }
+    return nullptr;  // 標籤過多時丟棄
+}
+
+inline void countAllocation(size_t size) {
+    if (trackingEnabled.load(std::memory_order_relaxed)) {
+        threadCounters.count++;
+        threadCounters.bytes += size;
+    }
+}
+
+void* allocate(size_t size) {
+    countAllocation(size);
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        if (void* p = std::malloc(size)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* allocateAligned(size_t size, std::align_val_t alignment) {
+    countAllocation(size);
+    size_t align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        void* p = nullptr;
+        if (posix_memalign(&p, align, size) == 0) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+} // namespace
+
+// 只替換基本形式: 標準庫的陣列及 nothrow 版本都轉調用這些函數
+void* operator new(size_t size) {
+    return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void AllocTracker::setEnabled(bool enabled) {
+    trackingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool AllocTracker::enabled() {
+    return trackingEnabled.load(std::memory_order_relaxed);
+}
+
+AllocStats AllocTracker::threadStats() {
+    return threadCounters;
+}
+
+std::vector<AllocSite> AllocTracker::topSites(size_t limit) {
+    std::vector<AllocSite> result;
+    for (const auto& slot : sites) {
+        const char* label = slot.label.load(std::memory_order_acquire);
+        if (label == nullptr) {
+            break;
+        }
+        result.push_back({label, slot.count.load(std::memory_order_relaxed),
+                          slot.bytes.load(std::memory_order_relaxed)});
+    }
+    std::stable_sort(result.begin(), result.end(),
+        [](const AllocSite& a, const AllocSite& b) { return a.count > b.count; });
+    if (limit > 0 && result.size() > limit) {
+        result.resize(limit);
+    }
+    return result;
+}
+
+void AllocTracker::publish() {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    MetricsRegistry& registry = MetricsRegistry::getInstance();
+    for (auto& slot : sites) {
+        const char* label = slot.label.load(std::memory_order_acquire);
+        if (label == nullptr) {
+            break;
+        }
+        uint64_t count = slot.count.load(std::memory_order_relaxed);
+        uint64_t bytes = slot.bytes.load(std::memory_order_relaxed);
+        if (count == slot.publishedCount) {
+            continue;
+        }
+        registry.counter("frt_alloc_total", "各區段的記憶體分配次數", {{"site", label}})
+            .increment(count - slot.publishedCount);
+        registry.counter("frt_alloc_bytes_total", "各區段的記憶體分配字節數", {{"site", label}})
+            .increment(bytes - slot.publishedBytes);
+        slot.publishedCount = count;
+        slot.publishedBytes = bytes;
+    }
+}
+
+void AllocTracker::reset() {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    for (auto& slot : sites) {
+        slot.count.store(0, std::memory_order_relaxed);
+        slot.bytes.store(0, std::memory_order_relaxed);
+        slot.publishedCount = 0;
+        slot.publishedBytes = 0;
+    }
+}
+
+AllocScope::AllocScope(const char* label) :
+    label(label), parent(currentScope), start(threadCounters) {
+    currentScope = this;
+}
+
+AllocScope::~AllocScope() {
+    currentScope = parent;
+    AllocStats total = stats();
+    if (parent) {
+        parent->children.count += total.count;
+        parent->children.bytes += total.bytes;
+    }
+    uint64_t count = total.count - children.count;
+    if (count == 0) {
+        return;
+    }
+    if (SiteSlot* slot = findSite(label)) {
+        slot->count.fetch_add(count, std::memory_order_relaxed);
+        slot->bytes.fetch_add(total.bytes - children.bytes, std::memory_order_relaxed);
+    }
+}
+
+AllocStats AllocScope::stats() const {
+    AllocStats now = threadCounters;
+    return {now.count - start.count, now.bytes - start.bytes};
+}
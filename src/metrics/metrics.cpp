@@ -0,0 +1,187 @@
+#include "metrics/metrics.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+std::string escapeLabelValue(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+// 標籤文字, 不含大括號, 例如 endpoint="/v5/market/tickers",phase="total"
+std::string renderLabels(const MetricLabels& labels) {
+    std::string text;
+    for (const auto& [key, value] : labels) {
+        if (!text.empty()) text += ',';
+        text += key + "=\"" + escapeLabelValue(value) + "\"";
+    }
+    return text;
+}
+
+std::string withLabels(const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) {
+        return "";
+    }
+    return "{" + labels + (!labels.empty() && !extra.empty() ? "," : "") + extra + "}";
+}
+
+std::string formatSeconds(uint64_t micros) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.6f", micros / 1e6);
+    return buffer;
+}
+
+} // namespace
+
+size_t LatencyHistogram::bucketIndex(uint64_t micros) {
+    if (micros < LINEAR_LIMIT) {
+        return static_cast<size_t>(micros);
+    }
+    int msb = std::bit_width(micros) - 1;
+    if (msb >= MAX_VALUE_BITS) {
+        return BUCKET_COUNT - 1;
+    }
+    int shift = msb - SUB_BUCKET_BITS;
+    uint64_t mantissa = micros >> shift;   // [32, 63]
+    return LINEAR_LIMIT + (shift - 1) * (size_t(1) << SUB_BUCKET_BITS) +
+           static_cast<size_t>(mantissa - (uint64_t(1) << SUB_BUCKET_BITS));
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < LINEAR_LIMIT) {
+        return index;
+    }
+    size_t offset = index - LINEAR_LIMIT;
+    int shift = static_cast<int>(offset >> SUB_BUCKET_BITS) + 1;
+    uint64_t mantissa = (offset & ((size_t(1) << SUB_BUCKET_BITS) - 1)) + (uint64_t(1) << SUB_BUCKET_BITS);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sumMicros.fetch_add(micros, std::memory_order_relaxed);
+    uint64_t current = maxMicros.load(std::memory_order_relaxed);
+    while (micros > current && !maxMicros.compare_exchange_weak(current, micros, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * n)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), max());
+        }
+    }
+    return max();
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sumMicros.store(0, std::memory_order_relaxed);
+    maxMicros.store(0, std::memory_order_relaxed);
+}
+
+MetricsRegistry& MetricsRegistry::getInstance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help, Kind kind) {
+    auto [it, inserted] = families.try_emplace(name);
+    if (inserted) {
+        it->second.kind = kind;
+        it->second.help = help;
+    }
+    return it->second;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                             const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = family(name, help, Kind::Summary).histograms[renderLabels(labels)];
+    if (!slot) {
+        slot = std::make_unique<LatencyHistogram>();
+    }
+    return *slot;
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                        const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = family(name, help, Kind::Counter).counters[renderLabels(labels)];
+    if (!slot) {
+        slot = std::make_unique<MetricCounter>();
+    }
+    return *slot;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                                    const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = family(name, help, Kind::Gauge).gauges[renderLabels(labels)];
+    if (!slot) {
+        slot = std::make_unique<MetricGauge>();
+    }
+    return *slot;
+}
+
+std::string MetricsRegistry::renderPrometheus() const {
+    static const std::pair<double, const char*> QUANTILES[] = {
+        {0.5, "0.5"}, {0.9, "0.9"}, {0.99, "0.99"}, {0.999, "0.999"}};
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string out;
+    for (const auto& [name, family] : families) {
+        out += "# HELP " + name + " " + family.help + "\n";
+        if (family.kind == Kind::Counter) {
+            out += "# TYPE " + name + " counter\n";
+            for (const auto& [labels, counter] : family.counters) {
+                out += name + withLabels(labels) + " " + std::to_string(counter->get()) + "\n";
+            }
+            continue;
+        }
+        if (family.kind == Kind::Gauge) {
+            out += "# TYPE " + name + " gauge\n";
+            for (const auto& [labels, gauge] : family.gauges) {
+                out += name + withLabels(labels) + " " + std::to_string(gauge->get()) + "\n";
+            }
+            continue;
+        }
+
+        out += "# TYPE " + name + " summary\n";
+        for (const auto& [labels, histogram] : family.histograms) {
+            for (const auto& [q, text] : QUANTILES) {
+                out += name + withLabels(labels, std::string("quantile=\"") + text + "\"") + " " +
+                       formatSeconds(histogram->percentile(q)) + "\n";
+            }
+            out += name + "_sum" + withLabels(labels) + " " + formatSeconds(histogram->sum()) + "\n";
+            out += name + "_count" + withLabels(labels) + " " + std::to_string(histogram->count()) + "\n";
+        }
+    }
+    return out;
+}
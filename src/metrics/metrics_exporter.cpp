@@ -0,0 +1,241 @@
+#include "metrics/metrics_exporter.h"
+#include "config.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t MAX_REQUEST_BYTES = 8192;
+
+// 在總時限內送出全部數據; 對方不讀取時放棄
+void sendAll(int client, const std::string& data, std::chrono::steady_clock::time_point deadline) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(client, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            pollfd pfd{client, POLLOUT, 0};
+            if (left.count() > 0 && poll(&pfd, 1, static_cast<int>(left.count())) > 0) {
+                continue;
+            }
+        }
+        return;
+    }
+}
+
+} // namespace
+
+MetricsExportOptions MetricsExportOptions::fromConfig() {
+    MetricsExportOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasMetricsConfig()) {
+        return options;
+    }
+    options.httpPort = config.getMetricsHttpPort();
+    options.httpEnabled = options.httpPort > 0;
+    if (!config.getMetricsBindAddress().empty()) {
+        options.bindAddress = config.getMetricsBindAddress();
+    }
+    options.filePath = config.getMetricsFile();
+    if (config.getMetricsFileIntervalSeconds() > 0) {
+        options.fileInterval = std::chrono::seconds(config.getMetricsFileIntervalSeconds());
+    }
+    return options;
+}
+
+MetricsExporter::MetricsExporter(MetricsRegistry& registry, const MetricsExportOptions& options) :
+    registry(registry), options(options) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start() {
+    if (worker.joinable()) {
+        return true;
+    }
+    bool listening = !options.httpEnabled || openListener();
+    if (listenFd < 0 && options.filePath.empty()) {
+        return listening;
+    }
+    stopping.store(false);
+    worker = std::thread(&MetricsExporter::run, this);
+    return listening;
+}
+
+void MetricsExporter::stop() {
+    stopping.store(true);
+    if (worker.joinable()) {
+        worker.join();
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+        boundPort = 0;
+    }
+}
+
+bool MetricsExporter::openListener() {
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        logger.error("無法建立指標監聽 socket: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(options.httpPort));
+    if (inet_pton(AF_INET, options.bindAddress.c_str(), &addr.sin_addr) != 1 ||
+        bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listenFd, 16) != 0) {
+        logger.error("無法監聽指標端口 " + options.bindAddress + ":" + std::to_string(options.httpPort) +
+                     ": " + std::strerror(errno));
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    socklen_t length = sizeof(addr);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &length);
+    boundPort = ntohs(addr.sin_port);
+    logger.info("指標監聽於 http://" + options.bindAddress + ":" + std::to_string(boundPort) + "/metrics");
+    return true;
+}
+
+void MetricsExporter::run() {
+    auto nextFileWrite = std::chrono::steady_clock::now() + options.fileInterval;
+    std::vector<PendingClient> clients;
+    std::vector<pollfd> fds;
+    while (!stopping.load()) {
+        if (listenFd >= 0) {
+            // 監聽 socket 在前, 之後每個連接一項; 等待時間不超過最近的連接時限
+            auto now = std::chrono::steady_clock::now();
+            auto wait = std::chrono::milliseconds(200);
+            fds.assign(1, pollfd{listenFd, POLLIN, 0});
+            for (const auto& client : clients) {
+                fds.push_back(pollfd{client.fd, POLLIN, 0});
+                wait = std::min(wait, std::chrono::duration_cast<std::chrono::milliseconds>(client.deadline - now));
+            }
+            int ready = poll(fds.data(), fds.size(), static_cast<int>(std::max<int64_t>(wait.count(), 0)));
+
+            now = std::chrono::steady_clock::now();
+            std::vector<PendingClient> remaining;
+            for (size_t i = 0; i < clients.size(); i++) {
+                bool done = now >= clients[i].deadline;
+                if (!done && ready > 0 && fds[i + 1].revents != 0) {
+                    done = readClient(clients[i]);
+                }
+                if (done) {
+                    close(clients[i].fd);
+                } else {
+                    remaining.push_back(std::move(clients[i]));
+                }
+            }
+            clients = std::move(remaining);
+            if (ready > 0 && (fds[0].revents & POLLIN)) {
+                acceptClient(clients);
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+
+        if (!options.filePath.empty() && std::chrono::steady_clock::now() >= nextFileWrite) {
+            writeFile();
+            nextFileWrite = std::chrono::steady_clock::now() + options.fileInterval;
+        }
+    }
+    for (const auto& client : clients) {
+        close(client.fd);
+    }
+    // 退出前保留最後一份數據
+    if (!options.filePath.empty()) {
+        writeFile();
+    }
+}
+
+void MetricsExporter::acceptClient(std::vector<PendingClient>& clients) {
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) {
+        return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    // 連接數達到上限時關閉最早的連接
+    if (clients.size() >= options.maxPendingClients && !clients.empty()) {
+        close(clients.front().fd);
+        clients.erase(clients.begin());
+    }
+    clients.push_back(PendingClient{fd, std::string(), std::chrono::steady_clock::now() + options.requestTimeout});
+}
+
+bool MetricsExporter::readClient(PendingClient& client) {
+    char buffer[1024];
+    while (true) {
+        ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return false;
+        }
+        if (n <= 0) {
+            return true;
+        }
+        client.request.append(buffer, static_cast<size_t>(n));
+        // 只處理請求行, 不解析其餘標頭
+        size_t end = client.request.find("\r\n");
+        if (end != std::string::npos) {
+            serveClient(client, client.request.substr(0, end));
+            return true;
+        }
+        if (client.request.size() >= MAX_REQUEST_BYTES) {
+            return true;
+        }
+    }
+}
+
+void MetricsExporter::serveClient(const PendingClient& client, const std::string& requestLine) {
+    std::string status = "200 OK";
+    std::string body;
+    if (requestLine.rfind("GET /metrics ", 0) == 0 || requestLine.rfind("GET / ", 0) == 0) {
+        body = registry.renderPrometheus();
+    } else {
+        status = "404 Not Found";
+        body = "not found\n";
+    }
+    sendAll(client.fd, "HTTP/1.1 " + status + "\r\n"
+                       "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                       "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                       "Connection: close\r\n\r\n" + body, client.deadline);
+}
+
+bool MetricsExporter::writeFile() {
+    std::filesystem::path path(options.filePath);
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    std::string tempPath = options.filePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::trunc);
+        if (!out.is_open()) {
+            logger.error("無法寫入指標文件: " + tempPath);
+            return false;
+        }
+        out << registry.renderPrometheus();
+    }
+    std::filesystem::rename(tempPath, path, ec);
+    return !ec;
+}
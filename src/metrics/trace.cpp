@@ -0,0 +1,199 @@
+#include "metrics/trace.h"
+#include "config.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+void appendJsonString(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+std::string fileTimestamp() {
+    auto now = std::chrono::system_clock::now();
+    std::time_t t = std::chrono::system_clock::to_time_t(now);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+    std::tm utc_tm = *std::gmtime(&t);
+    char buffer[32];
+    size_t len = std::strftime(buffer, sizeof(buffer), "%Y%m%d_%H%M%S", &utc_tm);
+    std::snprintf(buffer + len, sizeof(buffer) - len, "_%03d", static_cast<int>(ms));
+    return buffer;
+}
+
+} // namespace
+
+TraceOptions TraceOptions::fromConfig() {
+    TraceOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasTracingConfig()) {
+        return options;
+    }
+    options.enabled = config.isTracingEnabled();
+    if (!config.getTraceOutputDir().empty()) {
+        options.outputDir = config.getTraceOutputDir();
+    }
+    if (config.getTraceMaxEventsPerCycle() > 0) {
+        options.maxEventsPerCycle = static_cast<size_t>(config.getTraceMaxEventsPerCycle());
+    }
+    return options;
+}
+
+Tracer& Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+void Tracer::configure(const TraceOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex);
+    outputDir = options.outputDir;
+    maxEventsPerCycle = options.maxEventsPerCycle;
+    tracingEnabled.store(options.enabled, std::memory_order_relaxed);
+}
+
+int64_t Tracer::nowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Tracer::ThreadBuffer& Tracer::localBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    thread_local Tracer* owner = nullptr;
+    if (!buffer || owner != this) {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+        owner = this;
+        std::lock_guard<std::mutex> lock(mutex);
+        buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Tracer::record(TraceEvent&& event) {
+    if (cycleEvents.fetch_add(1, std::memory_order_relaxed) >= maxEventsPerCycle) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ThreadBuffer& buffer = localBuffer();
+    event.threadId = buffer.threadId;
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back(std::move(event));
+}
+
+void Tracer::beginCycle(const std::string& label) {
+    if (cycleDepth.load() == 0) {
+        drain();   // 丟棄上一週期結束後才完成的區段
+        std::lock_guard<std::mutex> lock(mutex);
+        cycleLabel = label;
+        cycleStartMicros = nowMicros();
+        cycleEvents.store(0, std::memory_order_relaxed);
+    }
+    cycleDepth.fetch_add(1);
+}
+
+std::string Tracer::endCycle() {
+    if (cycleDepth.fetch_sub(1) != 1) {
+        return "";
+    }
+
+    std::string label, dir;
+    int64_t start;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        label = cycleLabel;
+        dir = outputDir;
+        start = cycleStartMicros;
+    }
+    std::vector<TraceEvent> events = drain();
+    events.insert(events.begin(), TraceEvent{"cycle", "cycle", label, start, nowMicros() - start,
+                                             localBuffer().threadId});
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    std::string path = (std::filesystem::path(dir) / ("trace_" + fileTimestamp() + "_" + label + ".json")).string();
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[ERROR] 無法寫入追蹤文件: " << path << std::endl;
+        return "";
+    }
+    out << toChromeJson(events, label);
+    return path;
+}
+
+std::vector<TraceEvent> Tracer::drain() {
+    std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshot = buffers;
+    }
+    std::vector<TraceEvent> events;
+    for (auto& buffer : snapshot) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        std::move(buffer->events.begin(), buffer->events.end(), std::back_inserter(events));
+        buffer->events.clear();
+    }
+    std::stable_sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.startMicros < b.startMicros;
+    });
+    return events;
+}
+
+std::string Tracer::toChromeJson(const std::vector<TraceEvent>& events, const std::string& label) {
+    std::string out;
+    out.reserve(events.size() * 128 + 128);
+    out += "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"cycle\":";
+    appendJsonString(out, label);
+    out += "},\"traceEvents\":[";
+
+    std::vector<uint32_t> threads;
+    bool first = true;
+    for (const auto& event : events) {
+        if (!first) out += ',';
+        first = false;
+        out += "{\"name\":";
+        appendJsonString(out, event.name);
+        out += ",\"cat\":";
+        appendJsonString(out, event.category ? event.category : "");
+        out += ",\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(event.threadId) +
+               ",\"ts\":" + std::to_string(event.startMicros) +
+               ",\"dur\":" + std::to_string(event.durationMicros);
+        if (!event.detail.empty()) {
+            out += ",\"args\":{\"detail\":";
+            appendJsonString(out, event.detail);
+            out += '}';
+        }
+        out += '}';
+        if (std::find(threads.begin(), threads.end(), event.threadId) == threads.end()) {
+            threads.push_back(event.threadId);
+        }
+    }
+    // 線程名稱 (metadata 事件)
+    for (uint32_t tid : threads) {
+        if (!first) out += ',';
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(tid) +
+               ",\"args\":{\"name\":\"thread-" + std::to_string(tid) + "\"}}";
+    }
+    out += "]}\n";
+    return out;
+}
@@ -0,0 +1,96 @@
+#include "scheduler/settlement_calendar.h"
+#include "config.h"
+#include "logger.h"
+#include <algorithm>
+#include <sstream>
+
+SettlementCalendar::SettlementCalendar(const std::vector<std::string>& settlementTimesUTC,
+                                       int preSettlementMinutes,
+                                       int postSettlementMinutes) :
+    preSettlement(std::max(preSettlementMinutes, 0)),
+    postSettlement(std::max(postSettlementMinutes, 0)) {
+    Logger logger;
+    for (const auto& timeStr : settlementTimesUTC) {
+        std::istringstream ss(timeStr);
+        int hour = -1, minute = -1;
+        char delimiter = 0;
+        ss >> hour >> delimiter >> minute;
+        if (ss.fail() || delimiter != ':' || hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+            logger.error("無效的結算時間格式: " + timeStr);
+            continue;
+        }
+        offsets.emplace_back(hour * 60 + minute);
+    }
+    std::sort(offsets.begin(), offsets.end());
+    offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+}
+
+SettlementCalendar SettlementCalendar::fromConfig() {
+    const Config& config = Config::getInstance();
+    return SettlementCalendar(config.getSettlementTimesUTC(),
+                              config.getPreSettlementMinutes(),
+                              config.getPostSettlementMinutes());
+}
+
+SettlementCalendar::TimePoint SettlementCalendar::nextSettlement(TimePoint after) const {
+    if (offsets.empty()) {
+        return TimePoint::max();
+    }
+    // system_clock 的紀元為 UTC, 直接以日為單位取整即可得到 UTC 零點
+    auto day = std::chrono::floor<std::chrono::days>(after);
+    for (int i = 0; i < 2; i++) {
+        for (const auto& offset : offsets) {
+            TimePoint candidate = day + offset;
+            if (candidate > after) {
+                return candidate;
+            }
+        }
+        day += std::chrono::days(1);
+    }
+    return TimePoint::max();
+}
+
+SettlementCalendar::TimePoint SettlementCalendar::previousSettlement(TimePoint at) const {
+    if (offsets.empty()) {
+        return TimePoint::min();
+    }
+    auto day = std::chrono::floor<std::chrono::days>(at);
+    for (int i = 0; i < 2; i++) {
+        for (auto it = offsets.rbegin(); it != offsets.rend(); ++it) {
+            TimePoint candidate = day + *it;
+            if (candidate <= at) {
+                return candidate;
+            }
+        }
+        day -= std::chrono::days(1);
+    }
+    return TimePoint::min();
+}
+
+SettlementCalendar::TimePoint SettlementCalendar::nextPreSettlementEntry(TimePoint after) const {
+    TimePoint settlement = nextSettlement(after);
+    if (settlement == TimePoint::max()) {
+        return settlement;
+    }
+    // 預留時間可能跨越多個結算週期, 找到第一個仍在未來的進場點
+    while (settlement - preSettlement <= after) {
+        settlement = nextSettlement(settlement);
+    }
+    return settlement - preSettlement;
+}
+
+SettlementCalendar::TimePoint SettlementCalendar::nextPostSettlementRefresh(TimePoint after) const {
+    TimePoint settlement = nextSettlement(after - postSettlement);
+    if (settlement == TimePoint::max()) {
+        return settlement;
+    }
+    return settlement + postSettlement;
+}
+
+bool SettlementCalendar::isNearSettlement(TimePoint now) const {
+    TimePoint settlement = nextSettlement(now);
+    if (settlement == TimePoint::max()) {
+        return false;
+    }
+    return settlement - now <= preSettlement;
+}
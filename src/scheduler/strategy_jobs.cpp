@@ -0,0 +1,61 @@
+#include "scheduler/strategy_jobs.h"
+#include "storage/funding_archive.h"
+#include "storage/sqlite_storage.h"
+#include <algorithm>
+
+void runReconcile(TradingModule& trader, bool displayPositions) {
+    Logger logger;
+    if (trader.pipelineRunning()) {
+        // 流水線模式下週期在其他線程執行: 只在執行後輸出一次持倉, 沿用本週期取得的排名
+        trader.executeHedgeStrategy([&trader, displayPositions] {
+            if (displayPositions) {
+                trader.displayPositions();
+            }
+            Logger().info("對沖策略執行完成");
+        });
+        return;
+    }
+    if (displayPositions) {
+        trader.displayPositions();
+    }
+    trader.executeHedgeStrategy();
+    if (displayPositions) {
+        trader.displayPositions();
+    }
+    logger.info("對沖策略執行完成");
+}
+
+void registerStrategyJobs(TaskScheduler& scheduler,
+                          TradingModule& trader,
+                          const SettlementCalendar& calendar,
+                          const StrategyJobOptions& options) {
+    // 結算前進場: 此時資金費率排名會重新計算
+    scheduler.addJob(JobType::PreSettlementEntry, "對沖策略進場",
+        [&calendar](IClock::TimePoint after) { return calendar.nextPreSettlementEntry(after); },
+        [&trader]() { trader.executeHedgeStrategy(); });
+
+    // 結算後刷新: 新的結算費率已公佈
+    scheduler.addJob(JobType::PostSettlementRefresh, "資金費率刷新",
+        [&calendar](IClock::TimePoint after) { return calendar.nextPostSettlementRefresh(after); },
+        [&trader, archivePath = options.archivePath]() {
+            if (archivePath.empty()) {
+                trader.refreshFundingRates();
+                return;
+            }
+            // 刷新寫入本地時間序列後才追加歸檔 (流水線模式下在行情線程刷新後執行)
+            trader.refreshFundingRates([archivePath] {
+                try {
+                    FundingArchive::appendFromStorage(SQLiteStorage::getInstance(), archivePath);
+                } catch (const std::exception& e) {
+                    Logger().error("資金費率歸檔追加失敗: " + std::string(e.what()));
+                }
+            });
+        });
+
+    // 定期對帳: 處理成交偏差及倉位漂移
+    auto interval = std::max(options.reconcileInterval, std::chrono::minutes(1));
+    bool display = options.displayPositions;
+    scheduler.addJob(JobType::PeriodicReconcile, "倉位對帳",
+        [interval](IClock::TimePoint after) { return after + interval; },
+        [&trader, display]() { runReconcile(trader, display); });
+}
@@ -0,0 +1,68 @@
+#include "scheduler/task_scheduler.h"
+
+const char* jobTypeName(JobType type) {
+    switch (type) {
+        case JobType::PreSettlementEntry:    return "結算前進場";
+        case JobType::PostSettlementRefresh: return "結算後刷新";
+        case JobType::PeriodicReconcile:     return "定期對帳";
+        case JobType::FundingSettlement:     return "資金費率結算";
+    }
+    return "未知";
+}
+
+TaskScheduler::TaskScheduler(IClock& clock) : clock(clock) {}
+
+void TaskScheduler::addJob(JobType type, const std::string& name, NextDeadline next, Action action) {
+    jobs.push_back(Job{type, name, std::move(next), std::move(action)});
+    schedule(jobs.size() - 1, clock.now());
+}
+
+void TaskScheduler::schedule(size_t jobIndex, TimePoint after) {
+    const Job& job = jobs[jobIndex];
+    TimePoint deadline = job.next(after);
+    if (deadline == TimePoint::max()) {
+        logger.warning("工作 " + job.name + " 沒有下一個截止時間，停止排程");
+        return;
+    }
+    queue.push(Entry{deadline, nextSequence++, jobIndex});
+    LOG_INFO(logger, "排程 [" + std::string(jobTypeName(job.type)) + "] " + job.name +
+                     " 於 " + formatUTC(deadline));
+}
+
+TaskScheduler::TimePoint TaskScheduler::nextDeadline() const {
+    return queue.empty() ? TimePoint::max() : queue.top().deadline;
+}
+
+bool TaskScheduler::runNext() {
+    if (stopped || queue.empty()) {
+        return false;
+    }
+
+    Entry entry = queue.top();
+    queue.pop();
+    clock.sleepUntil(entry.deadline);
+    if (stopped) {
+        return false;
+    }
+
+    const Job& job = jobs[entry.jobIndex];
+    LOG_INFO(logger, "執行 [" + std::string(jobTypeName(job.type)) + "] " + job.name);
+    try {
+        job.action();
+    } catch (const std::exception& e) {
+        logger.error("工作 " + job.name + " 執行失敗: " + std::string(e.what()));
+    }
+
+    // 以實際結束時間計算下一次截止時間, 執行超時時不會補跑已錯過的週期
+    schedule(entry.jobIndex, std::max(entry.deadline, clock.now()));
+    return true;
+}
+
+void TaskScheduler::run() {
+    while (runNext()) {
+    }
+}
+
+void TaskScheduler::stop() {
+    stopped = true;
+}
@@ -0,0 +1,338 @@
+#include "scheduler/trading_pipeline.h"
+#include "config.h"
+#include "metrics/metrics.h"
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+
+namespace {
+
+std::string pipelineLabel(const std::string& name) {
+    return name.empty() ? "default" : name;
+}
+
+MetricGauge& queueDepth(const std::string& name, const char* queue) {
+    return MetricsRegistry::getInstance().gauge(
+        "frt_pipeline_queue_depth", "流水線隊列中等待處理的消息數",
+        {{"account", pipelineLabel(name)}, {"queue", queue}});
+}
+
+LatencyHistogram& hopLatency(const std::string& name, const char* hop) {
+    return MetricsRegistry::getInstance().histogram(
+        "frt_pipeline_hop_seconds", "流水線各段延遲 (含隊列等待)",
+        {{"account", pipelineLabel(name)}, {"hop", hop}});
+}
+
+MetricCounter& pipelineCounter(const std::string& name, const char* metric, const char* help) {
+    return MetricsRegistry::getInstance().counter(metric, help, {{"account", pipelineLabel(name)}});
+}
+
+std::vector<PipelineCallback> callbacksOf(PipelineCallback callback) {
+    std::vector<PipelineCallback> callbacks;
+    if (callback) {
+        callbacks.push_back(std::move(callback));
+    }
+    return callbacks;
+}
+
+void moveCallbacks(std::vector<PipelineCallback>& from, std::vector<PipelineCallback>& to) {
+    to.insert(to.end(), std::make_move_iterator(from.begin()), std::make_move_iterator(from.end()));
+    from.clear();
+}
+
+} // namespace
+
+PipelineOptions PipelineOptions::fromConfig() {
+    PipelineOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasPipelineConfig()) {
+        return options;
+    }
+    options.enabled = config.isPipelineEnabled();
+    if (config.getPipelineQueueCapacity() > 0) {
+        options.queueCapacity = static_cast<size_t>(config.getPipelineQueueCapacity());
+    }
+    options.busyPoll = config.isPipelineBusyPoll();
+    if (config.getPipelineIdleWaitUs() > 0) {
+        options.idleWait = std::chrono::microseconds(config.getPipelineIdleWaitUs());
+    }
+    options.marketDataCpu = config.getPipelineMarketDataCpu();
+    options.strategyCpu = config.getPipelineStrategyCpu();
+    options.executionCpu = config.getPipelineExecutionCpu();
+    return options;
+}
+
+TradingPipeline::TradingPipeline(PipelineStages stages, const PipelineOptions& options, const std::string& name) :
+    stages(std::move(stages)),
+    options(options),
+    triggers(options.queueCapacity),
+    snapshots(options.queueCapacity),
+    decisions(options.queueCapacity),
+    triggerDepth(queueDepth(name, "trigger")),
+    snapshotDepth(queueDepth(name, "snapshot")),
+    decisionDepth(queueDepth(name, "decision")),
+    triggerToSnapshot(hopLatency(name, "trigger_to_snapshot")),
+    snapshotToDecision(hopLatency(name, "snapshot_to_decision")),
+    decisionToExecution(hopLatency(name, "decision_to_execution")),
+    executionLatency(hopLatency(name, "execution")),
+    staleDecisions(pipelineCounter(name, "frt_pipeline_stale_decisions_total", "持倉已改變而丟棄的決策數")),
+    droppedMessages(pipelineCounter(name, "frt_pipeline_dropped_total", "隊列已滿而丟棄的消息數")) {}
+
+TradingPipeline::~TradingPipeline() {
+    stop();
+}
+
+void TradingPipeline::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    marketDataThread = std::thread(&TradingPipeline::runMarketData, this);
+    strategyThread = std::thread(&TradingPipeline::runStrategy, this);
+    executionThread = std::thread(&TradingPipeline::runExecution, this);
+}
+
+void TradingPipeline::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    for (std::thread* thread : {&marketDataThread, &strategyThread, &executionThread}) {
+        if (thread->joinable()) {
+            thread->join();
+        }
+    }
+}
+
+bool TradingPipeline::isRunning() const {
+    return running.load();
+}
+
+bool TradingPipeline::requestCycle(PipelineCallback onComplete) {
+    return post(PipelineTriggerKind::Cycle, callbacksOf(std::move(onComplete)));
+}
+
+bool TradingPipeline::requestRefresh(PipelineCallback onComplete) {
+    return post(PipelineTriggerKind::Refresh, callbacksOf(std::move(onComplete)));
+}
+
+bool TradingPipeline::post(PipelineTriggerKind kind, std::vector<PipelineCallback> onComplete) {
+    // 入隊失敗時隊列已取走參數, 保留一份以便立即調用
+    std::vector<PipelineCallback> fallback = onComplete;
+    if (!triggers.tryPush(PipelineTrigger{kind, PipelineClock::now(), std::move(onComplete)})) {
+        droppedCount++;
+        droppedMessages.increment();
+        complete(fallback);
+        return false;
+    }
+    triggerDepth.set(static_cast<int64_t>(triggers.size()));
+    return true;
+}
+
+void TradingPipeline::complete(std::vector<PipelineCallback>& callbacks) {
+    for (auto& callback : callbacks) {
+        try {
+            callback();
+        } catch (const std::exception& e) {
+            logger.error("流水線後續步驟發生錯誤: " + std::string(e.what()));
+        }
+    }
+    callbacks.clear();
+}
+
+PipelineStats TradingPipeline::stats() const {
+    PipelineStats stats;
+    stats.snapshots = snapshotCount.load();
+    stats.decisions = decisionCount.load();
+    stats.executed = executedCount.load();
+    stats.superseded = supersededCount.load();
+    stats.stale = staleCount.load();
+    stats.dropped = droppedCount.load();
+    return stats;
+}
+
+void TradingPipeline::updateDepths() {
+    triggerDepth.set(static_cast<int64_t>(triggers.size()));
+    snapshotDepth.set(static_cast<int64_t>(snapshots.size()));
+    decisionDepth.set(static_cast<int64_t>(decisions.size()));
+}
+
+void TradingPipeline::idle(unsigned& spins) const {
+    // 自旋模式先 yield 一段時間; 一般模式直接休眠, 不佔用 CPU
+    if (options.busyPoll && ++spins < 10000) {
+        std::this_thread::yield();
+        return;
+    }
+    spins = 0;
+    std::this_thread::sleep_for(options.idleWait);
+}
+
+void TradingPipeline::pinCurrentThread(int cpu, const char* role) {
+    if (cpu < 0) {
+        return;
+    }
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        logger.warning(std::string(role) + " 線程綁定 CPU " + std::to_string(cpu) + " 失敗");
+    }
+#else
+    logger.warning(std::string(role) + " 線程綁定 CPU 只支持 Linux, 已忽略");
+#endif
+}
+
+void TradingPipeline::runMarketData() {
+    pinCurrentThread(options.marketDataCpu, "行情");
+    unsigned spins = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        // 合併積壓的請求: 多個週期請求只取一次快照, 刷新排在快照之前
+        bool refresh = false;
+        bool cycle = false;
+        PipelineClock::time_point triggeredAt = PipelineClock::time_point::max();
+        std::vector<PipelineCallback> refreshed;
+        std::vector<PipelineCallback> executed;
+        while (auto trigger = triggers.tryPop()) {
+            if (trigger->kind == PipelineTriggerKind::Refresh) {
+                refresh = true;
+                moveCallbacks(trigger->onComplete, refreshed);
+            } else {
+                cycle = true;
+                triggeredAt = std::min(triggeredAt, trigger->enqueuedAt);
+                moveCallbacks(trigger->onComplete, executed);
+            }
+        }
+        if (!refresh && !cycle) {
+            idle(spins);
+            continue;
+        }
+        spins = 0;
+        updateDepths();
+
+        if (refresh && stages.refresh) {
+            try {
+                stages.refresh();
+            } catch (const std::exception& e) {
+                logger.error("行情線程刷新時發生錯誤: " + std::string(e.what()));
+            }
+        }
+        complete(refreshed);
+        if (!cycle) {
+            continue;
+        }
+        try {
+            MarketSnapshot snapshot;
+            snapshot.triggeredAt = triggeredAt;
+            // 先讀紀元再取持倉: 取持倉期間完成的執行會使這個快照的決策過時
+            snapshot.positionsEpoch = positionsEpoch.load(std::memory_order_acquire);
+            if (!stages.capture(snapshot)) {
+                logger.info("無法取得行情快照, 跳過本次週期");
+                complete(executed);
+                continue;
+            }
+            snapshot.sequence = ++nextSequence;
+            snapshot.capturedAt = PipelineClock::now();
+            snapshot.onComplete = std::move(executed);
+            executed.clear();
+            triggerToSnapshot.record(snapshot.capturedAt - snapshot.triggeredAt);
+            snapshotCount++;
+            std::vector<PipelineCallback> pending = snapshot.onComplete;
+            if (!snapshots.tryPush(std::move(snapshot))) {
+                droppedCount++;
+                droppedMessages.increment();
+                complete(pending);
+            }
+            snapshotDepth.set(static_cast<int64_t>(snapshots.size()));
+        } catch (const std::exception& e) {
+            logger.error("行情線程發生錯誤: " + std::string(e.what()));
+            complete(executed);
+        }
+    }
+}
+
+void TradingPipeline::runStrategy() {
+    pinCurrentThread(options.strategyCpu, "策略");
+    unsigned spins = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        // 只處理最新的快照, 較舊的已被取代
+        std::optional<MarketSnapshot> latest;
+        while (auto snapshot = snapshots.tryPop()) {
+            if (latest) {
+                supersededCount++;
+                // 被取代的快照的後續步驟改在最新快照執行後調用, 保持請求順序
+                moveCallbacks(snapshot->onComplete, latest->onComplete);
+                snapshot->onComplete = std::move(latest->onComplete);
+            }
+            latest = std::move(snapshot);
+        }
+        if (!latest) {
+            idle(spins);
+            continue;
+        }
+        spins = 0;
+        snapshotDepth.set(static_cast<int64_t>(snapshots.size()));
+
+        try {
+            StrategyDecision decision;
+            decision.plan = stages.decide(*latest);
+            decision.sequence = latest->sequence;
+            decision.positionsEpoch = latest->positionsEpoch;
+            decision.positions = std::move(latest->positions);
+            decision.triggeredAt = latest->triggeredAt;
+            decision.capturedAt = latest->capturedAt;
+            decision.decidedAt = PipelineClock::now();
+            decision.onComplete = std::move(latest->onComplete);
+            latest->onComplete.clear();
+            snapshotToDecision.record(decision.decidedAt - decision.capturedAt);
+            decisionCount++;
+            std::vector<PipelineCallback> pending = decision.onComplete;
+            if (!decisions.tryPush(std::move(decision))) {
+                droppedCount++;
+                droppedMessages.increment();
+                complete(pending);
+            }
+            decisionDepth.set(static_cast<int64_t>(decisions.size()));
+        } catch (const std::exception& e) {
+            logger.error("策略線程發生錯誤: " + std::string(e.what()));
+            complete(latest->onComplete);
+        }
+    }
+}
+
+void TradingPipeline::runExecution() {
+    pinCurrentThread(options.executionCpu, "執行");
+    unsigned spins = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        auto decision = decisions.tryPop();
+        if (!decision) {
+            idle(spins);
+            continue;
+        }
+        spins = 0;
+        decisionDepth.set(static_cast<int64_t>(decisions.size()));
+
+        // 快照之後已有計劃改變持倉: 依舊持倉下單會重複成交, 丟棄並請求新快照
+        if (decision->positionsEpoch != positionsEpoch.load(std::memory_order_acquire)) {
+            staleCount++;
+            staleDecisions.increment();
+            LOG_INFO(logger, "決策 #" + std::to_string(decision->sequence) + " 的持倉已過時, 重新取得快照");
+            post(PipelineTriggerKind::Cycle, std::move(decision->onComplete));
+            continue;
+        }
+
+        auto startedAt = PipelineClock::now();
+        decisionToExecution.record(startedAt - decision->decidedAt);
+        bool changesPositions = !decision->plan.empty();
+        try {
+            stages.execute(*decision);
+        } catch (const std::exception& e) {
+            logger.error("執行線程發生錯誤: " + std::string(e.what()));
+        }
+        // 即使執行中途失敗, 部分訂單可能已成交, 一律視為持倉已改變
+        if (changesPositions) {
+            positionsEpoch.fetch_add(1, std::memory_order_acq_rel);
+        }
+        executionLatency.record(PipelineClock::now() - startedAt);
+        executedCount++;
+        complete(decision->onComplete);
+    }
+}
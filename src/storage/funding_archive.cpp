@@ -0,0 +1,472 @@
+#include "storage/funding_archive.h"
+#include "storage/sqlite_storage.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::endian::native == std::endian::little, "FundingArchive 假設小端序");
+
+namespace {
+
+constexpr char MAGIC[8] = {'F', 'R', 'T', 'A', 'R', 'C', 'H', '1'};
+constexpr uint32_t VERSION = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t indexOffset;     // 0 表示沒有任何資料塊
+    uint64_t indexSize;
+    uint32_t indexChecksum;
+    uint32_t reserved;
+    uint8_t padding[24];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+struct BlockHeader {
+    uint32_t count;
+    uint32_t tsBytes;
+    int64_t firstTs;
+    uint32_t checksum;        // 費率列及時間戳列的 CRC32
+    uint32_t reserved;
+};
+static_assert(sizeof(BlockHeader) == 24);
+
+struct IndexEntry {
+    std::string symbol;
+    uint64_t offset = 0;
+    uint32_t count = 0;
+    int64_t firstTs = 0;
+    int64_t lastTs = 0;
+};
+
+uint32_t crc32(const void* data, size_t size, uint32_t crc = 0) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+size_t align8(size_t value) {
+    return (value + 7) & ~size_t(7);
+}
+
+template <typename T>
+void appendRaw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendVarint(std::string& out, int64_t value) {
+    uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    while (zigzag >= 0x80) {
+        out.push_back(static_cast<char>((zigzag & 0x7F) | 0x80));
+        zigzag >>= 7;
+    }
+    out.push_back(static_cast<char>(zigzag));
+}
+
+bool readVarint(const uint8_t*& cursor, const uint8_t* end, int64_t& value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+        uint8_t byte = *cursor++;
+        result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            value = static_cast<int64_t>(result >> 1) ^ -static_cast<int64_t>(result & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+bool readRaw(const uint8_t*& cursor, const uint8_t* end, T& value) {
+    if (static_cast<size_t>(end - cursor) < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+std::vector<IndexEntry> parseIndex(const uint8_t* data, size_t size, const std::string& path) {
+    std::vector<IndexEntry> entries;
+    const uint8_t* cursor = data;
+    const uint8_t* end = data + size;
+    uint32_t count = 0;
+    if (!readRaw(cursor, end, count)) {
+        throw std::runtime_error("歸檔索引損壞: " + path);
+    }
+    entries.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        IndexEntry entry;
+        uint16_t symbolLength = 0;
+        if (!readRaw(cursor, end, symbolLength) || static_cast<size_t>(end - cursor) < symbolLength) {
+            throw std::runtime_error("歸檔索引損壞: " + path);
+        }
+        entry.symbol.assign(reinterpret_cast<const char*>(cursor), symbolLength);
+        cursor += symbolLength;
+        if (!readRaw(cursor, end, entry.offset) || !readRaw(cursor, end, entry.count) ||
+            !readRaw(cursor, end, entry.firstTs) || !readRaw(cursor, end, entry.lastTs)) {
+            throw std::runtime_error("歸檔索引損壞: " + path);
+        }
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+std::string encodeIndex(const std::vector<IndexEntry>& entries) {
+    std::string out;
+    appendRaw(out, static_cast<uint32_t>(entries.size()));
+    for (const auto& entry : entries) {
+        appendRaw(out, static_cast<uint16_t>(entry.symbol.size()));
+        out += entry.symbol;
+        appendRaw(out, entry.offset);
+        appendRaw(out, entry.count);
+        appendRaw(out, entry.firstTs);
+        appendRaw(out, entry.lastTs);
+    }
+    return out;
+}
+
+// 只讀取文件頭及索引, 追加時不需要映射整個文件
+void readLayout(int fd, const std::string& path, FileHeader& header, std::vector<IndexEntry>& index) {
+    if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        throw std::runtime_error("不是有效的資金費率歸檔: " + path);
+    }
+    if (header.indexOffset == 0) {
+        return;
+    }
+    std::string buffer(header.indexSize, '\0');
+    if (pread(fd, buffer.data(), buffer.size(), static_cast<off_t>(header.indexOffset)) !=
+            static_cast<ssize_t>(buffer.size()) ||
+        crc32(buffer.data(), buffer.size()) != header.indexChecksum) {
+        throw std::runtime_error("歸檔索引校驗失敗: " + path);
+    }
+    index = parseIndex(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size(), path);
+}
+
+void writeAll(int fd, const std::string& data, uint64_t offset, const std::string& path) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = pwrite(fd, data.data() + written, data.size() - written,
+                           static_cast<off_t>(offset + written));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("寫入歸檔失敗: " + path + ": " + std::strerror(errno));
+        }
+        written += static_cast<size_t>(n);
+    }
+}
+
+std::string encodeBlock(const std::vector<std::pair<int64_t, double>>& points) {
+    std::string rates;
+    std::string timestamps;
+    int64_t previous = points.front().first;
+    for (size_t i = 0; i < points.size(); i++) {
+        appendRaw(rates, points[i].second);
+        if (i > 0) {
+            appendVarint(timestamps, points[i].first - previous);
+            previous = points[i].first;
+        }
+    }
+    BlockHeader header{};
+    header.count = static_cast<uint32_t>(points.size());
+    header.tsBytes = static_cast<uint32_t>(timestamps.size());
+    header.firstTs = points.front().first;
+    header.checksum = crc32(timestamps.data(), timestamps.size(), crc32(rates.data(), rates.size()));
+
+    std::string block;
+    appendRaw(block, header);
+    block += rates;
+    block += timestamps;
+    block.resize(align8(block.size()), '\0');
+    return block;
+}
+
+} // namespace
+
+FundingArchive::~FundingArchive() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+    }
+}
+
+std::unique_ptr<FundingArchive> FundingArchive::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("無法打開歸檔: " + path);
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        ::close(fd);
+        throw std::runtime_error("不是有效的資金費率歸檔: " + path);
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("無法映射歸檔: " + path);
+    }
+
+    std::unique_ptr<FundingArchive> archive(new FundingArchive());
+    archive->mapping = mapped;
+    archive->mappingSize = static_cast<size_t>(st.st_size);
+    const auto* data = static_cast<const uint8_t*>(mapped);
+    const size_t size = archive->mappingSize;
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        throw std::runtime_error("不是有效的資金費率歸檔: " + path);
+    }
+    if (header.indexOffset == 0) {
+        return archive;
+    }
+    if (header.indexOffset > size || header.indexSize > size - header.indexOffset ||
+        crc32(data + header.indexOffset, header.indexSize) != header.indexChecksum) {
+        throw std::runtime_error("歸檔索引校驗失敗: " + path);
+    }
+    auto index = parseIndex(data + header.indexOffset, header.indexSize, path);
+
+    // 同一幣種的資料塊按寫入順序排列, 時間必然遞增
+    std::map<std::string, std::vector<std::pair<const double*, uint32_t>>> blocksBySymbol;
+    for (const auto& entry : index) {
+        BlockHeader block;
+        if (entry.offset % 8 != 0 || entry.offset > size || size - entry.offset < sizeof(block)) {
+            throw std::runtime_error("歸檔資料塊越界: " + path);
+        }
+        std::memcpy(&block, data + entry.offset, sizeof(block));
+        const uint8_t* ratesBegin = data + entry.offset + sizeof(block);
+        const size_t ratesBytes = static_cast<size_t>(block.count) * sizeof(double);
+        if (block.count != entry.count || block.count == 0 ||
+            size - entry.offset - sizeof(block) < ratesBytes + block.tsBytes) {
+            throw std::runtime_error("歸檔資料塊越界: " + path);
+        }
+        const uint8_t* tsBegin = ratesBegin + ratesBytes;
+        if (crc32(tsBegin, block.tsBytes, crc32(ratesBegin, ratesBytes)) != block.checksum) {
+            throw std::runtime_error("歸檔資料塊校驗失敗: " + path + " (" + entry.symbol + ")");
+        }
+
+        Series& target = archive->series[entry.symbol];
+        int64_t ts = block.firstTs;
+        target.timestamps.push_back(ts);
+        const uint8_t* cursor = tsBegin;
+        for (uint32_t i = 1; i < block.count; i++) {
+            int64_t delta = 0;
+            if (!readVarint(cursor, tsBegin + block.tsBytes, delta)) {
+                throw std::runtime_error("歸檔時間戳損壞: " + path + " (" + entry.symbol + ")");
+            }
+            ts += delta;
+            target.timestamps.push_back(ts);
+        }
+        blocksBySymbol[entry.symbol].emplace_back(reinterpret_cast<const double*>(ratesBegin), block.count);
+    }
+
+    for (auto& [symbol, symbolBlocks] : blocksBySymbol) {
+        Series& target = archive->series[symbol];
+        if (symbolBlocks.size() == 1) {
+            target.rates = std::span<const double>(symbolBlocks[0].first, symbolBlocks[0].second);
+            target.mapped = true;
+        } else {
+            for (const auto& [rates, count] : symbolBlocks) {
+                target.merged.insert(target.merged.end(), rates, rates + count);
+            }
+            target.rates = target.merged;
+        }
+    }
+    archive->blocks = index.size();
+    return archive;
+}
+
+const FundingArchive::Series* FundingArchive::find(const std::string& symbol) const {
+    auto it = series.find(symbol);
+    return it == series.end() ? nullptr : &it->second;
+}
+
+std::vector<std::string> FundingArchive::symbols() const {
+    std::vector<std::string> names;
+    names.reserve(series.size());
+    for (const auto& [symbol, data] : series) {
+        names.push_back(symbol);
+    }
+    return names;
+}
+
+std::span<const double> FundingArchive::rates(const std::string& symbol) const {
+    const Series* data = find(symbol);
+    return data ? data->rates : std::span<const double>();
+}
+
+std::span<const int64_t> FundingArchive::timestamps(const std::string& symbol) const {
+    const Series* data = find(symbol);
+    return data ? std::span<const int64_t>(data->timestamps) : std::span<const int64_t>();
+}
+
+bool FundingArchive::isMapped(const std::string& symbol) const {
+    const Series* data = find(symbol);
+    return data && data->mapped;
+}
+
+int64_t FundingArchive::lastTimestamp(const std::string& symbol) const {
+    const Series* data = find(symbol);
+    return data && !data->timestamps.empty() ? data->timestamps.back()
+                                             : std::numeric_limits<int64_t>::min();
+}
+
+std::span<const double> FundingArchive::window(const std::string& symbol, int64_t asOfTs, size_t depth) const {
+    const Series* data = find(symbol);
+    if (!data) {
+        return {};
+    }
+    size_t end = static_cast<size_t>(
+        std::upper_bound(data->timestamps.begin(), data->timestamps.end(), asOfTs) - data->timestamps.begin());
+    size_t begin = end > depth ? end - depth : 0;
+    return data->rates.subspan(begin, end - begin);
+}
+
+size_t FundingArchive::append(const std::string& path, const std::vector<FundingRecord>& records) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("無法打開歸檔: " + path);
+    }
+    struct FdGuard {
+        int fd;
+        ~FdGuard() { ::close(fd); }
+    } guard{fd};
+
+    FileHeader header{};
+    std::vector<IndexEntry> index;
+    struct stat st {};
+    fstat(fd, &st);
+    const bool created = st.st_size == 0;
+    if (created) {
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.headerSize = sizeof(FileHeader);
+    } else {
+        readLayout(fd, path, header, index);
+    }
+
+    std::map<std::string, int64_t> lastTs;
+    for (const auto& entry : index) {
+        auto [it, inserted] = lastTs.emplace(entry.symbol, entry.lastTs);
+        if (!inserted) {
+            it->second = std::max(it->second, entry.lastTs);
+        }
+    }
+
+    // 只保留比文件中已有數據更新的記錄; 同一時間戳以最後一筆為準
+    std::map<std::string, std::map<int64_t, double>> pending;
+    for (const auto& record : records) {
+        auto it = lastTs.find(record.symbol);
+        if (it == lastTs.end() || record.ts > it->second) {
+            pending[record.symbol][record.ts] = record.rate;
+        }
+    }
+
+    uint64_t offset = created ? sizeof(FileHeader) : align8(static_cast<size_t>(st.st_size));
+    std::string data;
+    size_t appended = 0;
+    for (const auto& [symbol, points] : pending) {
+        std::vector<std::pair<int64_t, double>> sorted(points.begin(), points.end());
+        IndexEntry entry{symbol, offset + data.size(), static_cast<uint32_t>(sorted.size()),
+                         sorted.front().first, sorted.back().first};
+        data += encodeBlock(sorted);
+        index.push_back(std::move(entry));
+        appended += sorted.size();
+    }
+    if (appended == 0 && !created) {
+        return 0;
+    }
+
+    if (!index.empty()) {
+        std::string indexBytes = encodeIndex(index);
+        header.indexOffset = offset + data.size();
+        header.indexSize = indexBytes.size();
+        header.indexChecksum = crc32(indexBytes.data(), indexBytes.size());
+        data += indexBytes;
+    }
+
+    // 先寫入資料塊及索引並落盤, 再更新文件頭, 中途失敗時舊文件頭仍指向完整的舊索引
+    if (created) {
+        writeAll(fd, std::string(sizeof(FileHeader), '\0'), 0, path);
+    }
+    writeAll(fd, data, offset, path);
+    if (fsync(fd) != 0) {
+        throw std::runtime_error("歸檔落盤失敗: " + path);
+    }
+    writeAll(fd, std::string(reinterpret_cast<const char*>(&header), sizeof(header)), 0, path);
+    if (fsync(fd) != 0) {
+        throw std::runtime_error("歸檔落盤失敗: " + path);
+    }
+    return appended;
+}
+
+void FundingArchive::writeNew(const std::string& path, const std::vector<FundingRecord>& records) {
+    const std::string tempPath = path + ".tmp";
+    std::filesystem::remove(tempPath);
+    append(tempPath, records);
+    std::filesystem::rename(tempPath, path);
+}
+
+size_t FundingArchive::exportFrom(SQLiteStorage& storage, const std::string& path) {
+    std::vector<FundingRecord> records;
+    for (const auto& symbol : storage.getFundingSymbols()) {
+        auto symbolRecords = storage.getFundingRates(symbol, std::numeric_limits<int64_t>::min(),
+                                                     std::numeric_limits<int64_t>::max());
+        records.insert(records.end(), std::make_move_iterator(symbolRecords.begin()),
+                       std::make_move_iterator(symbolRecords.end()));
+    }
+    writeNew(path, records);
+    return records.size();
+}
+
+size_t FundingArchive::appendFromStorage(SQLiteStorage& storage, const std::string& path) {
+    if (!std::filesystem::exists(path)) {
+        return exportFrom(storage, path);
+    }
+    auto archive = open(path);
+    std::vector<FundingRecord> records;
+    for (const auto& symbol : storage.getFundingSymbols()) {
+        int64_t last = archive->lastTimestamp(symbol);
+        int64_t from = last == std::numeric_limits<int64_t>::min() ? last : last + 1;
+        auto symbolRecords = storage.getFundingRates(symbol, from, std::numeric_limits<int64_t>::max());
+        records.insert(records.end(), std::make_move_iterator(symbolRecords.begin()),
+                       std::make_move_iterator(symbolRecords.end()));
+    }
+    archive.reset();
+    return append(path, records);
+}
+
+void FundingArchive::compact(const std::string& path) {
+    auto archive = open(path);
+    std::vector<FundingRecord> records;
+    for (const auto& [symbol, data] : archive->series) {
+        for (size_t i = 0; i < data.timestamps.size(); i++) {
+            records.push_back({symbol, data.timestamps[i], data.rates[i]});
+        }
+    }
+    archive.reset();
+    writeNew(path, records);
+}
@@ -1,16 +1,26 @@
 #include "storage/sqlite_storage.h"
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <mutex>
 #include <memory>
 #include <sqlite3.h>
+#include <json/json.h>
+
+#define TRADE_GROUP_COLUMNS_SQL \
+    "SELECT id, exchange_id, symbol, spot_order_id, futures_order_id, leverage, state, spot_qty, " \
+    "contract_qty, spot_avg_price, contract_avg_price, fees, opened_at, updated_at, order_seq FROM trade_groups "
 
 std::mutex SQLiteStorage::mutex_;
 std::unique_ptr<SQLiteStorage> SQLiteStorage::instance;
 
-SQLiteStorage::SQLiteStorage() : db(nullptr), isConnected(false) {
+SQLiteStorage::SQLiteStorage(const StorageOptions& options) :
+    options(options), db(nullptr), isConnected(false) {
     initDatabase();
+    if (isConnected) {
+        writer = std::thread(&SQLiteStorage::runWriter, this);
+    }
 }
 
 SQLiteStorage& SQLiteStorage::getInstance() {
@@ -22,12 +32,24 @@ SQLiteStorage& SQLiteStorage::getInstance() {
 }
 
 void SQLiteStorage::initDatabase() {
-    int rc = sqlite3_open("trading.db", &db);
+    int rc = sqlite3_open(options.path.c_str(), &db);
     if (rc) {
         std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
         return;
     }
-    
+
+    // WAL 模式下讀寫互不阻塞; synchronous=NORMAL 只在檢查點時 fsync, 斷電最多丟失最後幾個事務.
+    // 必須落盤的寫入由 flushDurable() 執行檢查點
+    const char* pragmas = "PRAGMA journal_mode=WAL;"
+                          "PRAGMA synchronous=NORMAL;";
+    char* errMsg = nullptr;
+    rc = sqlite3_exec(db, pragmas, nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+    }
+    sqlite3_busy_timeout(db, 5000);
+
     // 創表格（如果不存在）
     const char* sql = "CREATE TABLE IF NOT EXISTS trades ("
                      "id INTEGER PRIMARY KEY AUTOINCREMENT,"
@@ -35,7 +57,6 @@ void SQLiteStorage::initDatabase() {
                      "rate REAL NOT NULL,"
                      "timestamp DATETIME DEFAULT CURRENT_TIMESTAMP"
                      ");";
-    char* errMsg = nullptr;
     rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
     if (rc != SQLITE_OK) {
         std::cerr << "SQL error: " << errMsg << std::endl;
@@ -52,49 +73,211 @@ void SQLiteStorage::initDatabase() {
           "futures_order_id TEXT NOT NULL,"
           "leverage INTEGER NOT NULL,"
           "active INTEGER DEFAULT 1,"
-          "created_at DATETIME DEFAULT CURRENT_TIMESTAMP"
+          "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+          "state TEXT NOT NULL DEFAULT 'open',"
+          "spot_qty REAL NOT NULL DEFAULT 0,"
+          "contract_qty REAL NOT NULL DEFAULT 0,"
+          "spot_avg_price REAL NOT NULL DEFAULT 0,"
+          "contract_avg_price REAL NOT NULL DEFAULT 0,"
+          "fees REAL NOT NULL DEFAULT 0,"
+          "opened_at INTEGER NOT NULL DEFAULT 0,"
+          "updated_at INTEGER NOT NULL DEFAULT 0,"
+          "order_seq INTEGER NOT NULL DEFAULT 0"
           ");";
-    
+
+    rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return;
+    }
+
+    if (!migrateTradeGroups()) {
+        return;
+    }
+
+    // 資金費率時間序列: 以 (symbol, ts) 為主鍵聚簇存放, 範圍查詢只需順序掃描
+    sql = "CREATE TABLE IF NOT EXISTS funding_rates ("
+          "symbol TEXT NOT NULL,"
+          "ts INTEGER NOT NULL,"
+          "rate REAL NOT NULL,"
+          "PRIMARY KEY (symbol, ts)"
+          ") WITHOUT ROWID;";
+
     rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
     if (rc != SQLITE_OK) {
         std::cerr << "SQL error: " << errMsg << std::endl;
         sqlite3_free(errMsg);
         return;
     }
-    
+
+    if (!prepare("INSERT INTO trades (symbol, rate) VALUES (?, ?);", &insertTradeStmt) ||
+        !prepare("INSERT INTO trade_groups (id, exchange_id, symbol, spot_order_id, futures_order_id, "
+                 "leverage, active, state, spot_qty, contract_qty, spot_avg_price, contract_avg_price, "
+                 "fees, opened_at, updated_at, order_seq) "
+                 "VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14, ?15, ?16) "
+                 "ON CONFLICT(id) DO UPDATE SET spot_order_id = excluded.spot_order_id, "
+                 "futures_order_id = excluded.futures_order_id, leverage = excluded.leverage, "
+                 "active = excluded.active, state = excluded.state, spot_qty = excluded.spot_qty, "
+                 "contract_qty = excluded.contract_qty, spot_avg_price = excluded.spot_avg_price, "
+                 "contract_avg_price = excluded.contract_avg_price, fees = excluded.fees, "
+                 "updated_at = excluded.updated_at, order_seq = excluded.order_seq;", &upsertTradeGroupStmt) ||
+        !prepare(TRADE_GROUP_COLUMNS_SQL "WHERE symbol = ?1 ORDER BY id;", &selectGroupHistoryStmt) ||
+        !prepare("INSERT OR REPLACE INTO funding_rates (symbol, ts, rate) VALUES (?, ?, ?);",
+                 &upsertFundingStmt) ||
+        !prepare("SELECT ts, rate FROM funding_rates "
+                 "WHERE symbol = ?1 AND ts BETWEEN ?2 AND ?3 ORDER BY ts;", &selectFundingRangeStmt) ||
+        !prepare("SELECT DISTINCT symbol FROM funding_rates ORDER BY symbol;", &selectFundingSymbolsStmt) ||
+        // 每個幣種先以主鍵定位第 depth 新的結算時間, 再讀取其後的資料; s.key 為幣種在參數陣列中的位置
+        !prepare("SELECT s.key, f.rate FROM json_each(?1) AS s "
+                 "JOIN funding_rates AS f ON f.symbol = s.value AND f.ts <= ?3 AND f.ts >= "
+                 "COALESCE((SELECT ts FROM funding_rates WHERE symbol = s.value AND ts <= ?3 "
+                 "ORDER BY ts DESC LIMIT 1 OFFSET ?2 - 1), -9223372036854775807) "
+                 "ORDER BY s.key, f.ts DESC;", &selectLatestFundingStmt)) {
+        return;
+    }
+
+    loadActiveTradeGroups();
     isConnected = true;
 }
 
-SQLiteStorage::~SQLiteStorage() {
-    if (db) {
-        sqlite3_close(db);
+// 舊版 trade_groups 只有 active 欄位: 補上生命週期及成交欄位, 並按 active 推斷狀態
+bool SQLiteStorage::migrateTradeGroups() {
+    static const std::pair<const char*, const char*> columns[] = {
+        {"state", "TEXT NOT NULL DEFAULT 'open'"},
+        {"spot_qty", "REAL NOT NULL DEFAULT 0"},
+        {"contract_qty", "REAL NOT NULL DEFAULT 0"},
+        {"spot_avg_price", "REAL NOT NULL DEFAULT 0"},
+        {"contract_avg_price", "REAL NOT NULL DEFAULT 0"},
+        {"fees", "REAL NOT NULL DEFAULT 0"},
+        {"opened_at", "INTEGER NOT NULL DEFAULT 0"},
+        {"updated_at", "INTEGER NOT NULL DEFAULT 0"},
+        {"order_seq", "INTEGER NOT NULL DEFAULT 0"},
+    };
+    std::vector<std::string> existing;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "PRAGMA table_info(trade_groups);", -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            existing.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+        }
     }
+    sqlite3_finalize(stmt);
+
+    std::string sql;
+    for (const auto& [name, definition] : columns) {
+        if (std::find(existing.begin(), existing.end(), name) == existing.end()) {
+            sql += std::string("ALTER TABLE trade_groups ADD COLUMN ") + name + " " + definition + ";";
+            if (std::string(name) == "state") {
+                sql += "UPDATE trade_groups SET state = 'closed' WHERE active = 0;";
+            }
+        }
+    }
+    // 未平倉組只佔表中極少部分, 部分索引讓啟動載入不必全表掃描
+    sql += "CREATE INDEX IF NOT EXISTS idx_trade_groups_active ON trade_groups (exchange_id, symbol) "
+           "WHERE active = 1;"
+           "CREATE INDEX IF NOT EXISTS idx_trade_groups_symbol ON trade_groups (symbol, id);";
+
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
 }
 
-void SQLiteStorage::storeTradeData(const std::string& symbol, const double rate) {
-    if (!isConnected || !db) {
-        std::cerr << "Cannot store data: SQLite not connected" << std::endl;
-        return;
+namespace {
+
+TradeGroup readTradeGroup(sqlite3_stmt* stmt) {
+    auto text = [stmt](int column) {
+        const unsigned char* value = sqlite3_column_text(stmt, column);
+        return value ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+    };
+    TradeGroup group;
+    group.id = sqlite3_column_int64(stmt, 0);
+    group.exchangeId = text(1);
+    group.symbol = text(2);
+    group.spotOrderId = text(3);
+    group.futuresOrderId = text(4);
+    group.leverage = sqlite3_column_int(stmt, 5);
+    group.state = parseTradeGroupState(text(6)).value_or(TradeGroupState::Open);
+    group.spotQty = sqlite3_column_double(stmt, 7);
+    group.contractQty = sqlite3_column_double(stmt, 8);
+    group.spotAvgPrice = sqlite3_column_double(stmt, 9);
+    group.contractAvgPrice = sqlite3_column_double(stmt, 10);
+    group.fees = sqlite3_column_double(stmt, 11);
+    group.openedAt = sqlite3_column_int64(stmt, 12);
+    group.updatedAt = sqlite3_column_int64(stmt, 13);
+    group.orderSeq = sqlite3_column_int(stmt, 14);
+    return group;
+}
+
+int64_t nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+void SQLiteStorage::loadActiveTradeGroups() {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, TRADE_GROUP_COLUMNS_SQL "WHERE active = 1;", -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            TradeGroup group = readTradeGroup(stmt);
+            activeGroups[group.id] = std::move(group);
+        }
     }
+    sqlite3_finalize(stmt);
 
-    const char* sql = "INSERT INTO trades (symbol, rate) VALUES (?, ?);";
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    
-    if (rc != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, "SELECT COALESCE(MAX(id), 0) + 1 FROM trade_groups;", -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        nextGroupId = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+}
+
+bool SQLiteStorage::prepare(const char* sql, sqlite3_stmt** stmt) {
+    if (sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, stmt, nullptr) != SQLITE_OK) {
         std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return;
+        return false;
     }
+    return true;
+}
 
-    sqlite3_bind_text(stmt, 1, symbol.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 2, rate);
+SQLiteStorage::~SQLiteStorage() {
+    stopWriter();
+    sqlite3_finalize(insertTradeStmt);
+    sqlite3_finalize(upsertTradeGroupStmt);
+    sqlite3_finalize(selectGroupHistoryStmt);
+    sqlite3_finalize(upsertFundingStmt);
+    sqlite3_finalize(selectFundingRangeStmt);
+    sqlite3_finalize(selectFundingSymbolsStmt);
+    sqlite3_finalize(selectLatestFundingStmt);
+    if (db) {
+        sqlite3_close(db);
+    }
+}
 
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) {
-        std::cerr << "Failed to insert data: " << sqlite3_errmsg(db) << std::endl;
+void SQLiteStorage::stopWriter() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
     }
+    queueCv.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
 
-    sqlite3_finalize(stmt);
+void SQLiteStorage::storeTradeData(const std::string& symbol, const double rate) {
+    if (!isConnected || !db) {
+        std::cerr << "Cannot store data: SQLite not connected" << std::endl;
+        return;
+    }
+    WriteOp op{WriteOp::Kind::Trade};
+    op.symbol = symbol;
+    op.rate = rate;
+    enqueue(std::move(op));
 }
 
 bool SQLiteStorage::isConnectionValid() const {
@@ -104,48 +287,340 @@ bool SQLiteStorage::isConnectionValid() const {
 void SQLiteStorage::storeTradeGroup(const std::string& exchangeId, const std::string& symbol,
                                   const std::string& spotOrderId, const std::string& futuresOrderId,
                                   int leverage) {
+    TradeGroup group;
+    group.exchangeId = exchangeId;
+    group.symbol = symbol;
+    group.spotOrderId = spotOrderId;
+    group.futuresOrderId = futuresOrderId;
+    group.leverage = leverage;
+    group.state = TradeGroupState::Open;
+    openTradeGroup(std::move(group));
+}
+
+int64_t SQLiteStorage::openTradeGroup(TradeGroup group) {
+    {
+        std::lock_guard<std::mutex> lock(groupsMutex);
+        group.id = nextGroupId++;
+        group.openedAt = group.updatedAt = nowMillis();
+        if (group.active()) {
+            activeGroups[group.id] = group;
+        }
+    }
+    if (!isConnected || !db) {
+        std::cerr << "Cannot store trade group: SQLite not connected" << std::endl;
+        return group.id;
+    }
+    int64_t id = group.id;
+    WriteOp op{WriteOp::Kind::TradeGroup};
+    op.group = std::move(group);
+    enqueue(std::move(op));
+    return id;
+}
+
+void SQLiteStorage::updateTradeGroup(TradeGroup group) {
+    {
+        std::lock_guard<std::mutex> lock(groupsMutex);
+        group.updatedAt = nowMillis();
+        if (group.active()) {
+            activeGroups[group.id] = group;
+        } else {
+            activeGroups.erase(group.id);
+        }
+    }
     if (!isConnected || !db) {
         std::cerr << "Cannot store trade group: SQLite not connected" << std::endl;
         return;
     }
+    WriteOp op{WriteOp::Kind::TradeGroup};
+    op.group = std::move(group);
+    enqueue(std::move(op));
+}
 
-    const char* sql = "INSERT INTO trade_groups (exchange_id, symbol, spot_order_id, "
-                     "futures_order_id, leverage) VALUES (?, ?, ?, ?, ?);";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+std::vector<TradeGroup> SQLiteStorage::activeTradeGroups() const {
+    std::lock_guard<std::mutex> lock(groupsMutex);
+    std::vector<TradeGroup> groups;
+    groups.reserve(activeGroups.size());
+    for (const auto& [id, group] : activeGroups) {
+        groups.push_back(group);
+    }
+    return groups;
+}
+
+std::optional<TradeGroup> SQLiteStorage::findActiveTradeGroup(int64_t id) const {
+    std::lock_guard<std::mutex> lock(groupsMutex);
+    auto it = activeGroups.find(id);
+    return it == activeGroups.end() ? std::nullopt : std::optional<TradeGroup>(it->second);
+}
+
+std::optional<TradeGroup> SQLiteStorage::findActiveTradeGroup(const std::string& exchangeId,
+                                                              const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(groupsMutex);
+    // 同一幣種正常只有一個未平倉組; 有多個時取最新的
+    for (auto it = activeGroups.rbegin(); it != activeGroups.rend(); ++it) {
+        if (it->second.exchangeId == exchangeId && it->second.symbol == symbol) {
+            return it->second;
+        }
+    }
+    return std::nullopt;
+}
+
+void SQLiteStorage::storeFundingRates(std::vector<FundingRecord> records) {
+    if (!isConnected || !db) {
+        std::cerr << "Cannot store funding rates: SQLite not connected" << std::endl;
         return;
     }
+    if (records.empty()) {
+        return;
+    }
+    WriteOp op{WriteOp::Kind::FundingRates};
+    op.fundingRates = std::move(records);
+    enqueue(std::move(op));
+}
 
-    sqlite3_bind_text(stmt, 1, exchangeId.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, symbol.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, spotOrderId.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 4, futuresOrderId.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_int(stmt, 5, leverage);
+void SQLiteStorage::enqueue(WriteOp op) {
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        // 隊列滿表示磁盤已嚴重落後. 對沖組在下單線程寫入, 不能因此停止下單, 超出容量放入;
+        // 其他寫入 (行情記錄, 資金費率) 寧可等待也不丟棄
+        if (op.kind == WriteOp::Kind::TradeGroup) {
+            if (queue.size() >= options.queueCapacity && !stopping) {
+                std::cerr << "SQLite write queue full (" << queue.size() << "), trade group queued beyond capacity"
+                          << std::endl;
+            }
+        } else {
+            spaceCv.wait(lock, [this] { return queue.size() < options.queueCapacity || stopping; });
+        }
+        if (stopping) {
+            std::cerr << "Cannot store data: SQLite writer stopped" << std::endl;
+            return;
+        }
+        queue.push_back(std::move(op));
+        ++enqueuedSeq;
+    }
+    queueCv.notify_one();
+}
 
-    rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) {
-        std::cerr << "Failed to insert trade group: " << sqlite3_errmsg(db) << std::endl;
+bool SQLiteStorage::flush(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    const uint64_t target = enqueuedSeq;
+    // 通知背景線程不必等滿一批
+    flushTarget = std::max(flushTarget, target);
+    queueCv.notify_all();
+    return committedCv.wait_for(lock, timeout, [this, target] { return committedSeq >= target; });
+}
+
+bool SQLiteStorage::flushDurable(std::chrono::milliseconds timeout) {
+    if (!isConnectionValid() || !flush(timeout)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(dbMutex);
+    // FULL 檢查點先 fsync WAL, 再把已提交的頁寫回數據庫文件並 fsync
+    int rc = sqlite3_wal_checkpoint_v2(db, nullptr, SQLITE_CHECKPOINT_FULL, nullptr, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to checkpoint: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void SQLiteStorage::runWriter() {
+    std::vector<WriteOp> batch;
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueCv.wait(lock, [this] { return !queue.empty() || stopping; });
+        if (queue.empty() && stopping) {
+            break;
+        }
+        // 第一筆到達後再等一小段時間, 或湊滿一批立即提交
+        auto deadline = std::chrono::steady_clock::now() + options.batchInterval;
+        queueCv.wait_until(lock, deadline, [this] {
+            return queue.size() >= options.batchSize || stopping || flushTarget > committedSeq;
+        });
+
+        size_t count = std::min(queue.size(), options.batchSize);
+        for (size_t i = 0; i < count; i++) {
+            batch.push_back(std::move(queue.front()));
+            queue.pop_front();
+        }
+        lock.unlock();
+        spaceCv.notify_all();
+
+        commitBatch(batch);
+        batch.clear();
+
+        lock.lock();
+        committedSeq += count;
+        committedCv.notify_all();
     }
+}
 
-    sqlite3_finalize(stmt);
+void SQLiteStorage::commitBatch(std::vector<WriteOp>& batch) {
+    std::lock_guard<std::mutex> lock(dbMutex);
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, "BEGIN;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        errMsg = nullptr;
+    }
+    // 單筆失敗只記錄錯誤, 不影響同一批的其他寫入
+    for (const auto& op : batch) {
+        execute(op);
+    }
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Failed to commit batch: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+    }
+}
+
+bool SQLiteStorage::execute(const WriteOp& op) {
+    sqlite3_stmt* stmt = nullptr;
+    switch (op.kind) {
+        case WriteOp::Kind::FundingRates: {
+            bool ok = true;
+            for (const auto& record : op.fundingRates) {
+                sqlite3_bind_text(upsertFundingStmt, 1, record.symbol.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_int64(upsertFundingStmt, 2, record.ts);
+                sqlite3_bind_double(upsertFundingStmt, 3, record.rate);
+                if (sqlite3_step(upsertFundingStmt) != SQLITE_DONE) {
+                    std::cerr << "Failed to insert funding rate: " << sqlite3_errmsg(db) << std::endl;
+                    ok = false;
+                }
+                sqlite3_reset(upsertFundingStmt);
+            }
+            sqlite3_clear_bindings(upsertFundingStmt);
+            return ok;
+        }
+        case WriteOp::Kind::Trade:
+            stmt = insertTradeStmt;
+            sqlite3_bind_text(stmt, 1, op.symbol.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_double(stmt, 2, op.rate);
+            break;
+        case WriteOp::Kind::TradeGroup: {
+            const TradeGroup& group = op.group;
+            stmt = upsertTradeGroupStmt;
+            sqlite3_bind_int64(stmt, 1, group.id);
+            sqlite3_bind_text(stmt, 2, group.exchangeId.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 3, group.symbol.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 4, group.spotOrderId.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 5, group.futuresOrderId.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int(stmt, 6, group.leverage);
+            sqlite3_bind_int(stmt, 7, group.active() ? 1 : 0);
+            sqlite3_bind_text(stmt, 8, toString(group.state), -1, SQLITE_STATIC);
+            sqlite3_bind_double(stmt, 9, group.spotQty);
+            sqlite3_bind_double(stmt, 10, group.contractQty);
+            sqlite3_bind_double(stmt, 11, group.spotAvgPrice);
+            sqlite3_bind_double(stmt, 12, group.contractAvgPrice);
+            sqlite3_bind_double(stmt, 13, group.fees);
+            sqlite3_bind_int64(stmt, 14, group.openedAt);
+            sqlite3_bind_int64(stmt, 15, group.updatedAt);
+            sqlite3_bind_int(stmt, 16, group.orderSeq);
+            break;
+        }
+    }
+
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to insert data: " << sqlite3_errmsg(db) << std::endl;
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return rc == SQLITE_DONE;
 }
 
 std::vector<std::string> SQLiteStorage::getActiveTradeGroups() {
     std::vector<std::string> groups;
-    const char* sql = "SELECT exchange_id || ':' || symbol || ':' || "
-                     "spot_order_id || '_' || futures_order_id || '_' || leverage "
-                     "FROM trade_groups WHERE active = 1;";
-    
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            groups.push_back((const char*)sqlite3_column_text(stmt, 0));
-        }
-        sqlite3_finalize(stmt);
+    for (const auto& group : activeTradeGroups()) {
+        groups.push_back(group.exchangeId + ":" + group.symbol + ":" + group.spotOrderId + "_" +
+                         group.futuresOrderId + "_" + std::to_string(group.leverage));
     }
     return groups;
 }
+
+std::vector<TradeGroup> SQLiteStorage::getTradeGroupHistory(const std::string& symbol) {
+    std::vector<TradeGroup> groups;
+    if (!isConnectionValid()) {
+        return groups;
+    }
+    flush();
+
+    std::lock_guard<std::mutex> lock(dbMutex);
+    sqlite3_bind_text(selectGroupHistoryStmt, 1, symbol.c_str(), -1, SQLITE_STATIC);
+    while (sqlite3_step(selectGroupHistoryStmt) == SQLITE_ROW) {
+        groups.push_back(readTradeGroup(selectGroupHistoryStmt));
+    }
+    sqlite3_reset(selectGroupHistoryStmt);
+    sqlite3_clear_bindings(selectGroupHistoryStmt);
+    return groups;
+}
+
+std::vector<FundingRecord> SQLiteStorage::getFundingRates(const std::string& symbol, int64_t fromTs, int64_t toTs) {
+    std::vector<FundingRecord> records;
+    if (!isConnectionValid()) {
+        return records;
+    }
+    flush();
+
+    std::lock_guard<std::mutex> lock(dbMutex);
+    sqlite3_bind_text(selectFundingRangeStmt, 1, symbol.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(selectFundingRangeStmt, 2, fromTs);
+    sqlite3_bind_int64(selectFundingRangeStmt, 3, toTs);
+    while (sqlite3_step(selectFundingRangeStmt) == SQLITE_ROW) {
+        records.push_back({symbol, sqlite3_column_int64(selectFundingRangeStmt, 0),
+                           sqlite3_column_double(selectFundingRangeStmt, 1)});
+    }
+    sqlite3_reset(selectFundingRangeStmt);
+    sqlite3_clear_bindings(selectFundingRangeStmt);
+    return records;
+}
+
+std::vector<std::string> SQLiteStorage::getFundingSymbols() {
+    std::vector<std::string> symbols;
+    if (!isConnectionValid()) {
+        return symbols;
+    }
+    flush();
+
+    std::lock_guard<std::mutex> lock(dbMutex);
+    while (sqlite3_step(selectFundingSymbolsStmt) == SQLITE_ROW) {
+        symbols.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(selectFundingSymbolsStmt, 0)));
+    }
+    sqlite3_reset(selectFundingSymbolsStmt);
+    return symbols;
+}
+
+FundingWindow SQLiteStorage::getLatestFundingRates(const std::vector<std::string>& symbols, int depth,
+                                                   int64_t asOfTs) {
+    FundingWindow window;
+    window.symbols = symbols;
+    window.depth = std::max(depth, 0);
+    window.counts.assign(symbols.size(), 0);
+    window.rates.assign(symbols.size() * window.depth, 0.0);
+    if (!isConnectionValid() || symbols.empty() || window.depth == 0) {
+        return window;
+    }
+    flush();
+
+    // 以 JSON 陣列傳入幣種列表, 一次查詢完成
+    Json::Value array(Json::arrayValue);
+    for (const auto& symbol : symbols) {
+        array.append(symbol);
+    }
+    Json::FastWriter writer;
+    const std::string symbolsJson = writer.write(array);
+
+    std::lock_guard<std::mutex> lock(dbMutex);
+    sqlite3_bind_text(selectLatestFundingStmt, 1, symbolsJson.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(selectLatestFundingStmt, 2, window.depth);
+    sqlite3_bind_int64(selectLatestFundingStmt, 3, asOfTs);
+    while (sqlite3_step(selectLatestFundingStmt) == SQLITE_ROW) {
+        size_t index = static_cast<size_t>(sqlite3_column_int64(selectLatestFundingStmt, 0));
+        int& count = window.counts[index];
+        if (count < window.depth) {
+            window.rates[index * window.depth + count] = sqlite3_column_double(selectLatestFundingStmt, 1);
+            ++count;
+        }
+    }
+    sqlite3_reset(selectLatestFundingStmt);
+    sqlite3_clear_bindings(selectLatestFundingStmt);
+    return window;
+}
@@ -0,0 +1,90 @@
+#include "storage/trade_group.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <unistd.h>
+
+const char* toString(TradeGroupState state) {
+    switch (state) {
+        case TradeGroupState::Opening: return "opening";
+        case TradeGroupState::Open: return "open";
+        case TradeGroupState::Closing: return "closing";
+        case TradeGroupState::Closed: return "closed";
+    }
+    return "unknown";
+}
+
+std::optional<TradeGroupState> parseTradeGroupState(const std::string& text) {
+    if (text == "opening") return TradeGroupState::Opening;
+    if (text == "open") return TradeGroupState::Open;
+    if (text == "closing") return TradeGroupState::Closing;
+    if (text == "closed") return TradeGroupState::Closed;
+    return std::nullopt;
+}
+
+namespace {
+
+void applyFill(double& held, double& avgPrice, double& fees, double quantity, double price, double feeRate) {
+    if (quantity > 0) {
+        double total = held + quantity;
+        avgPrice = total > 0 ? (held * avgPrice + quantity * price) / total : 0.0;
+        held = total;
+    } else {
+        held = std::max(0.0, held + quantity);
+        if (held == 0.0) {
+            avgPrice = 0.0;
+        }
+    }
+    fees += std::abs(quantity) * price * feeRate;
+}
+
+const char BASE36[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+std::string base36(uint64_t value) {
+    std::string text;
+    do {
+        text.insert(text.begin(), BASE36[value % 36]);
+        value /= 36;
+    } while (value > 0);
+    return text;
+}
+
+// 進程啟動時隨機產生的 5 位標識: 訂單序號只經由背景隊列寫盤, 斷電後可能回退,
+// 重啟後的訂單號仍與之前發出的不同
+const std::string& bootNonce() {
+    static const std::string nonce = [] {
+        std::random_device device;
+        std::seed_seq seed{device(), device(), static_cast<unsigned>(::getpid()),
+                           static_cast<unsigned>(std::chrono::steady_clock::now().time_since_epoch().count())};
+        std::mt19937_64 engine(seed);
+        std::string text;
+        for (int i = 0; i < 5; i++) {
+            text += BASE36[engine() % 36];
+        }
+        return text;
+    }();
+    return nonce;
+}
+
+} // namespace
+
+std::string TradeGroup::orderLinkId(char leg, int slice) const {
+    // 開倉時間區分重建數據庫後重複的組 id, 啟動標識區分重啟前後重複的序號.
+    // 數字以 36 進位縮短, 最長 34 字元, 低於 36 字元上限
+    std::string id = "frt" + base36(static_cast<uint64_t>(std::max<int64_t>(openedAt, 0))) + "-" + bootNonce() +
+                     "-" + base36(static_cast<uint64_t>(std::max<int64_t>(this->id, 0))) + "-" +
+                     base36(static_cast<uint64_t>(std::max(orderSeq, 0))) + leg;
+    if (slice > 0) {
+        id += std::to_string(slice);
+    }
+    return id;
+}
+
+void TradeGroup::applySpotFill(double quantity, double price, double feeRate) {
+    applyFill(spotQty, spotAvgPrice, fees, quantity, price, feeRate);
+}
+
+void TradeGroup::applyContractFill(double quantity, double price, double feeRate) {
+    applyFill(contractQty, contractAvgPrice, fees, quantity, price, feeRate);
+}
@@ -0,0 +1,242 @@
+#include "trading/basis_tracker.h"
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+BasisOptions BasisOptions::fromConfig() {
+    BasisOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasBasisTrackerConfig()) {
+        return options;
+    }
+    options.enabled = config.isBasisGatingEnabled();
+    options.pollInterval = std::chrono::milliseconds(std::max(config.getBasisPollIntervalMs(), 0));
+    if (config.getBasisWindow() > 0) {
+        options.window = static_cast<size_t>(config.getBasisWindow());
+    }
+    if (config.getBasisMaxSkewMs() > 0) {
+        options.maxSkew = std::chrono::milliseconds(config.getBasisMaxSkewMs());
+    }
+    if (config.getBasisMaxAgeMs() > 0) {
+        options.maxAge = std::chrono::milliseconds(config.getBasisMaxAgeMs());
+    }
+    if (config.getBasisMinSamples() > 0) {
+        options.minSamples = static_cast<size_t>(config.getBasisMinSamples());
+    }
+    if (config.getBasisEwmaAlpha() > 0 && config.getBasisEwmaAlpha() <= 1) {
+        options.ewmaAlpha = config.getBasisEwmaAlpha();
+    }
+    if (config.getBasisEntryPercentile() > 0) {
+        options.entryPercentile = std::min(config.getBasisEntryPercentile(), 1.0);
+    }
+    if (config.getBasisExitPercentile() > 0) {
+        options.exitPercentile = std::min(config.getBasisExitPercentile(), 1.0);
+    }
+    if (config.getBasisMaxExitDelaySeconds() > 0) {
+        options.maxExitDelay = std::chrono::seconds(config.getBasisMaxExitDelaySeconds());
+    }
+    return options;
+}
+
+const char* toString(BasisVerdict verdict) {
+    switch (verdict) {
+        case BasisVerdict::Unknown: return "unknown";
+        case BasisVerdict::Favourable: return "favourable";
+        case BasisVerdict::Unfavourable: return "unfavourable";
+    }
+    return "unknown";
+}
+
+RollingHistogram::RollingHistogram(size_t window, double bucketWidth, double range) :
+    bucketWidth(bucketWidth), range(range) {
+    size_t bucketCount = static_cast<size_t>(std::ceil(2 * range / bucketWidth)) + 1;
+    buckets.assign(std::min<size_t>(bucketCount, std::numeric_limits<uint16_t>::max()), 0);
+    ring.assign(std::max<size_t>(window, 1), 0);
+}
+
+size_t RollingHistogram::bucketOf(double value) const {
+    double position = std::round((value + range) / bucketWidth);
+    if (!(position > 0)) {
+        return 0;
+    }
+    return std::min(static_cast<size_t>(position), buckets.size() - 1);
+}
+
+void RollingHistogram::add(double value) {
+    if (count == ring.size()) {
+        buckets[ring[head]]--;
+    } else {
+        count++;
+    }
+    size_t bucket = bucketOf(value);
+    ring[head] = static_cast<uint16_t>(bucket);
+    buckets[bucket]++;
+    head = (head + 1) % ring.size();
+}
+
+double RollingHistogram::percentile(double q) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    size_t rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::clamp(q, 0.0, 1.0) * count)));
+    size_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return -range + static_cast<double>(i) * bucketWidth;
+        }
+    }
+    return range;
+}
+
+BasisTracker::Series::Series(const BasisOptions& options) :
+    entryHistory(options.window, options.bucketBps / 10000, options.rangeBps / 10000),
+    exitHistory(options.window, options.bucketBps / 10000, options.rangeBps / 10000) {}
+
+BasisTracker::BasisTracker(IClock& clock, const BasisOptions& options) :
+    clock(clock), options(options) {}
+
+BasisTracker::~BasisTracker() {
+    stop();
+}
+
+BasisTracker::Series& BasisTracker::seriesLocked(const std::string& symbol) {
+    auto it = series.find(symbol);
+    if (it == series.end()) {
+        it = series.emplace(symbol, Series(options)).first;
+    }
+    return it->second;
+}
+
+bool BasisTracker::onSpotQuote(const std::string& symbol, const TopOfBook& quote) {
+    return onQuote(symbol, quote, true);
+}
+
+bool BasisTracker::onPerpQuote(const std::string& symbol, const TopOfBook& quote) {
+    return onQuote(symbol, quote, false);
+}
+
+bool BasisTracker::onQuote(const std::string& symbol, const TopOfBook& quote, bool spot) {
+    if (!quote.valid()) {
+        return false;
+    }
+    const auto now = clock.now();
+    std::lock_guard<std::mutex> lock(stateMutex);
+    Series& s = seriesLocked(symbol);
+    (spot ? s.spot : s.perp) = Quote{quote, now};
+
+    // 兩邊報價都存在且時間差在容忍範圍內才算一個同步樣本
+    const Quote& other = spot ? s.perp : s.spot;
+    if (!other.book.valid()) {
+        return false;
+    }
+    auto skew = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now > other.at ? now - other.at : other.at - now);
+    if (skew > options.maxSkew) {
+        return false;
+    }
+
+    s.mid = (s.perp.book.mid() - s.spot.book.mid()) / s.spot.book.mid();
+    s.entry = (s.perp.book.bid - s.spot.book.ask) / s.spot.book.ask;
+    s.exit = (s.perp.book.ask - s.spot.book.bid) / s.spot.book.bid;
+    s.skew = skew;
+    s.sampledAt = now;
+    s.entryHistory.add(s.entry);
+    s.exitHistory.add(s.exit);
+    if (s.samples++ == 0) {
+        s.ewma = s.mid;
+        s.ewmaVariance = 0.0;
+    } else {
+        double diff = s.mid - s.ewma;
+        s.ewma += options.ewmaAlpha * diff;
+        s.ewmaVariance = (1 - options.ewmaAlpha) * (s.ewmaVariance + options.ewmaAlpha * diff * diff);
+    }
+    return true;
+}
+
+std::optional<BasisSnapshot> BasisTracker::snapshot(const std::string& symbol) const {
+    const auto now = clock.now();
+    std::lock_guard<std::mutex> lock(stateMutex);
+    auto it = series.find(symbol);
+    if (it == series.end() || it->second.samples == 0) {
+        return std::nullopt;
+    }
+    const Series& s = it->second;
+    BasisSnapshot snap;
+    snap.mid = s.mid;
+    snap.entry = s.entry;
+    snap.exit = s.exit;
+    snap.ewma = s.ewma;
+    snap.ewmaStdDev = std::sqrt(s.ewmaVariance);
+    snap.entryThreshold = s.entryHistory.percentile(options.entryPercentile);
+    snap.exitThreshold = s.exitHistory.percentile(options.exitPercentile);
+    snap.samples = s.samples;
+    snap.skew = s.skew;
+    snap.fresh = now - s.sampledAt <= options.maxAge;
+    return snap;
+}
+
+BasisVerdict BasisTracker::verdict(const std::string& symbol, BasisSide side) const {
+    auto snap = snapshot(symbol);
+    if (!snap || !snap->fresh || snap->samples < options.minSamples) {
+        return BasisVerdict::Unknown;
+    }
+    bool favourable = side == BasisSide::Entry ? snap->entry >= snap->entryThreshold
+                                               : snap->exit <= snap->exitThreshold;
+    return favourable ? BasisVerdict::Favourable : BasisVerdict::Unfavourable;
+}
+
+void BasisTracker::setWatchlist(const std::vector<std::string>& symbols) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    watchlist = symbols;
+}
+
+void BasisTracker::start(QuoteSource quoteSource) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (running || !quoteSource || options.pollInterval.count() <= 0) {
+        return;
+    }
+    source = std::move(quoteSource);
+    running = true;
+    worker = std::thread(&BasisTracker::run, this);
+}
+
+void BasisTracker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    wakeCv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool BasisTracker::isRunning() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return running;
+}
+
+void BasisTracker::run() {
+    while (true) {
+        std::vector<std::string> symbols;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (!running) {
+                break;
+            }
+            symbols = watchlist;
+        }
+        // 同一幣種的兩邊報價背靠背取得, 時間差由各自的到達時間計算
+        for (const auto& symbol : symbols) {
+            onSpotQuote(symbol, source(symbol, true));
+            onPerpQuote(symbol, source(symbol, false));
+        }
+        std::unique_lock<std::mutex> lock(stateMutex);
+        wakeCv.wait_for(lock, options.pollInterval, [this] { return !running; });
+    }
+}
@@ -0,0 +1,141 @@
+#include "trading/funding_scorer.h"
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <ranges>
+
+ScoringParams ScoringParams::fromConfig() {
+    const auto config = Config::getInstance().snapshot();
+    ScoringParams params;
+    params.periods = config->fundingPeriods;
+    params.weights = config->fundingWeights;
+    params.topPairsCount = config->topPairsCount;
+    params.reverseContractFundingRate = config->reverseContractFundingRate;
+    return params;
+}
+
+int ScoringParams::maxLookback() const {
+    return periods.empty() ? 0 : *std::max_element(periods.begin(), periods.end());
+}
+
+PositionSizing PositionSizing::fromConfig() {
+    const auto config = Config::getInstance().snapshot();
+    PositionSizing sizing;
+    sizing.minPositionValue = config->minPositionValue;
+    sizing.maxPositionValue = config->maxPositionValue;
+    sizing.positionScaling = config->positionScaling;
+    sizing.scalingFactor = config->scalingFactor;
+    sizing.minScalingRate = config->minScalingRate;
+    sizing.maxScalingRate = config->maxScalingRate;
+    return sizing;
+}
+
+double PositionSizing::scalingMultiplier(double rate) const {
+    // 將費率限制在合理範圍內, 再以對數函數平滑縮放
+    double normalizedRate = std::clamp(std::abs(rate), minScalingRate, maxScalingRate);
+    return 1.0 + std::log1p(normalizedRate * scalingFactor);
+}
+
+double PositionSizing::targetValue(double rate) const {
+    double value = minPositionValue;
+    if (positionScaling) {
+        value = std::min(value * scalingMultiplier(rate), maxPositionValue);
+    }
+    return value;
+}
+
+FundingScorer::FundingScorer(ScoringParams params) : scoringParams(std::move(params)) {}
+
+namespace {
+
+// rates 為任意隨機訪問序列, [0] 為最新一筆
+template <typename Rates>
+FundingScorer::Result scoreNewestFirst(const ScoringParams& scoringParams, const Rates& rates, double& score) {
+    using Result = FundingScorer::Result;
+    if (std::ranges::empty(rates)) {
+        return Result::NoData;
+    }
+
+    // 是否支援反向現貨合約資金費率, 即空付多收
+    if (!scoringParams.reverseContractFundingRate && rates[0] < 0) {
+        return Result::NegativeNotSupported;
+    }
+
+    double weightedScore = 0.0;
+    double totalWeight = 0.0;
+    const auto& periods = scoringParams.periods;
+    const auto& weights = scoringParams.weights;
+
+    // 對每個週期計算加權平均
+    for (size_t i = 0; i < periods.size() && i < weights.size(); i++) {
+        int periodLimit = std::min(periods[i], static_cast<int>(std::ranges::size(rates)));
+        if (periodLimit <= 0) continue;
+
+        double periodSum = 0.0;
+        for (int j = 0; j < periodLimit; j++) {
+            if (std::isfinite(rates[j])) {
+                periodSum += rates[j];
+            }
+        }
+        weightedScore += periodSum / periodLimit * weights[i];
+        totalWeight += weights[i];
+    }
+
+    if (totalWeight <= 0) {
+        return Result::NoData;
+    }
+
+    score = weightedScore / totalWeight;
+    // 最新資金費率與加權分數方向相反時不進場
+    if (rates[0] * score < 0) {
+        return Result::ContradictsLatest;
+    }
+    return Result::Scored;
+}
+
+} // namespace
+
+FundingScorer::Result FundingScorer::score(std::span<const double> rates, double& score) const {
+    return scoreNewestFirst(scoringParams, rates, score);
+}
+
+FundingScorer::Result FundingScorer::scoreOldestFirst(std::span<const double> rates, double& score) const {
+    return scoreNewestFirst(scoringParams, rates | std::views::reverse, score);
+}
+
+std::vector<std::pair<std::string, double>> FundingScorer::rank(
+    const std::vector<std::pair<std::string, std::vector<double>>>& histories) const {
+    std::vector<std::pair<std::string, double>> scores;
+    scores.reserve(histories.size());
+    for (const auto& [symbol, rates] : histories) {
+        double value = 0.0;
+        if (score(rates, value) == Result::Scored) {
+            scores.emplace_back(symbol, value);
+        }
+    }
+    sortAndTruncateScores(scores, scoringParams.topPairsCount);
+    return scores;
+}
+
+std::vector<std::pair<std::string, double>> FundingScorer::rank(const FundingWindow& window) const {
+    std::vector<std::pair<std::string, double>> scores;
+    scores.reserve(window.size());
+    for (size_t i = 0; i < window.size(); i++) {
+        double value = 0.0;
+        if (score(window.row(i), value) == Result::Scored) {
+            scores.emplace_back(window.symbols[i], value);
+        }
+    }
+    sortAndTruncateScores(scores, scoringParams.topPairsCount);
+    return scores;
+}
+
+void sortAndTruncateScores(std::vector<std::pair<std::string, double>>& scores, int topCount) {
+    std::stable_sort(scores.begin(), scores.end(),
+        [](const auto& a, const auto& b) {
+            return std::abs(a.second) > std::abs(b.second);
+        });
+    if (topCount > 0 && scores.size() > static_cast<size_t>(topCount)) {
+        scores.resize(topCount);
+    }
+}
@@ -0,0 +1,133 @@
+#include "trading/order_book.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace {
+
+bool parseNumber(const Json::Value& value, double& out) {
+    if (value.isNumeric()) {
+        out = value.asDouble();
+        return true;
+    }
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    if (!value.isString() || !value.getString(&begin, &end)) {
+        return false;
+    }
+    auto [ptr, ec] = std::from_chars(begin, end, out);
+    return ec == std::errc() && ptr != begin;
+}
+
+// 一側中第一個有效價位的價格, 沒有時為 0
+double firstPrice(const Json::Value& orderbook, const char* side) {
+    if (!orderbook.isObject() || !orderbook["result"].isObject()) {
+        return 0.0;
+    }
+    const Json::Value& list = orderbook["result"][side];
+    if (!list.isArray()) {
+        return 0.0;
+    }
+    BookLevel level;
+    for (const auto& entry : list) {
+        if (parseBookLevel(entry, level)) {
+            return level.price;
+        }
+    }
+    return 0.0;
+}
+
+} // namespace
+
+bool parseBookLevel(const Json::Value& level, BookLevel& out) {
+    if (!level.isArray() || level.size() < 2) {
+        return false;
+    }
+    double price = 0.0;
+    double quantity = 0.0;
+    if (!parseNumber(level[0], price) || !parseNumber(level[1], quantity) || !(price > 0) || !(quantity > 0)) {
+        return false;
+    }
+    out = {price, quantity};
+    return true;
+}
+
+std::vector<BookLevel> parseBookSide(const Json::Value& orderbook, const std::string& side) {
+    std::vector<BookLevel> levels;
+    if (!orderbook.isObject() || !orderbook["result"].isObject()) {
+        return levels;
+    }
+    const Json::Value& list = orderbook["result"][side];
+    if (!list.isArray()) {
+        return levels;
+    }
+
+    levels.reserve(list.size());
+    BookLevel level;
+    for (const auto& entry : list) {
+        if (parseBookLevel(entry, level)) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+TopOfBook parseTopOfBook(const Json::Value& orderbook) {
+    TopOfBook top;
+    top.bid = firstPrice(orderbook, "b");
+    top.ask = firstPrice(orderbook, "a");
+    return top;
+}
+
+double averageImpact(const std::vector<BookLevel>& levels, double quantity) {
+    if (levels.empty() || quantity <= 0) {
+        return 0.0;
+    }
+
+    const double basePrice = levels[0].price;
+    double remaining = quantity;
+    double filled = 0.0;
+    double impact = 0.0;
+    for (const auto& level : levels) {
+        double take = std::min(remaining, level.quantity);
+        impact += take * std::abs(level.price - basePrice) / basePrice;
+        filled += take;
+        remaining -= take;
+        if (remaining <= 0) {
+            break;
+        }
+    }
+    return filled > 0 ? impact / filled : 0.0;
+}
+
+double maxQuantityWithinImpact(const std::vector<BookLevel>& levels, double maxImpact) {
+    if (levels.empty()) {
+        return 0.0;
+    }
+
+    const double basePrice = levels[0].price;
+    double filled = 0.0;
+    double impact = 0.0;  // 已成交部分的滑點總和 (數量 * 比例)
+    for (const auto& level : levels) {
+        double levelImpact = std::abs(level.price - basePrice) / basePrice;
+        if (impact + level.quantity * levelImpact <= maxImpact * (filled + level.quantity)) {
+            filled += level.quantity;
+            impact += level.quantity * levelImpact;
+            continue;
+        }
+        // 此層只能部分成交: 解 impact + q * levelImpact = maxImpact * (filled + q)
+        if (levelImpact > maxImpact) {
+            filled += (maxImpact * filled - impact) / (levelImpact - maxImpact);
+        }
+        break;
+    }
+    return filled;
+}
+
+double totalDepth(const std::vector<BookLevel>& levels) {
+    double total = 0.0;
+    for (const auto& level : levels) {
+        total += level.quantity;
+    }
+    return total;
+}
@@ -0,0 +1,102 @@
+#include "trading/rebalance_planner.h"
+#include "trading/scratch_arena.h"
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+
+int RebalancePlan::orderCount() const {
+    int count = 0;
+    for (const auto& action : actions) {
+        count += action.orderCount();
+    }
+    return count;
+}
+
+double RebalancePlanner::filterDelta(double delta, double target, double price) const {
+    if (delta == 0.0) {
+        return 0.0;
+    }
+    // 數量差異在容忍度內視為已平衡
+    if (std::abs(delta) <= std::abs(target) * options.minDeltaRatio) {
+        return 0.0;
+    }
+    // 平倉時不受最小金額限制, 否則會留下無法處理的殘倉
+    if (target > 0 && price > 0 && std::abs(delta) * price < options.minOrderValue) {
+        return 0.0;
+    }
+    return delta;
+}
+
+RebalancePlan RebalancePlanner::plan(
+    const std::map<std::string, std::pair<double, double>>& holdings,
+    const std::vector<HedgeTarget>& targets,
+    const std::map<std::string, std::pair<double, double>>& prices) const {
+
+    RebalancePlan result;
+
+    // 查找表只引用輸入中的字串, 節點放在暫存區, 不逐個分配
+    ScratchArena<8192> arena;
+    std::pmr::map<std::string_view, const HedgeTarget*> targetBySymbol(arena.get());
+    for (const auto& target : targets) {
+        targetBySymbol[target.symbol] = &target;
+    }
+
+    std::pmr::vector<const std::string*> symbols(arena.get());
+    symbols.reserve(holdings.size() + targets.size());
+    for (const auto& [symbol, sizes] : holdings) {
+        symbols.push_back(&symbol);
+    }
+    for (const auto& target : targets) {
+        if (holdings.find(target.symbol) == holdings.end()) {
+            symbols.push_back(&target.symbol);
+        }
+    }
+    result.actions.reserve(symbols.size());
+
+    for (const std::string* symbolPtr : symbols) {
+        const std::string& symbol = *symbolPtr;
+        auto holdingIt = holdings.find(symbol);
+        double currentSpot = holdingIt != holdings.end() ? holdingIt->second.first : 0.0;
+        double currentContract = holdingIt != holdings.end() ? holdingIt->second.second : 0.0;
+
+        auto targetIt = targetBySymbol.find(symbol);
+        double targetSpot = targetIt != targetBySymbol.end() ? targetIt->second->spotQty : 0.0;
+        double targetContract = targetIt != targetBySymbol.end() ? targetIt->second->contractQty : 0.0;
+        // 不在目標中的倉位優先處理 (釋放保證金)
+        int priority = targetIt != targetBySymbol.end() ? targetIt->second->priority : -1;
+
+        auto priceIt = prices.find(symbol);
+        double spotPrice = priceIt != prices.end() ? priceIt->second.first : 0.0;
+        double contractPrice = priceIt != prices.end() ? priceIt->second.second : 0.0;
+
+        double spotDelta = filterDelta(targetSpot - currentSpot, targetSpot, spotPrice);
+        double contractDelta = filterDelta(targetContract - currentContract, targetContract, contractPrice);
+        if (spotDelta == 0.0 && contractDelta == 0.0) {
+            continue;
+        }
+
+        SymbolRebalance action{symbol, currentSpot, currentContract, spotDelta, contractDelta,
+                               priority, spotDelta * spotPrice + contractDelta * contractPrice};
+        result.tradedNotional += std::abs(spotDelta) * spotPrice + std::abs(contractDelta) * contractPrice;
+        result.roundTripNotional += (currentSpot + targetSpot) * spotPrice +
+                                    (currentContract + targetContract) * contractPrice;
+        result.actions.push_back(action);
+    }
+
+    // 先執行減倉 (釋放保證金最多者優先), 再按排名執行加倉 (佔用保證金少者優先)
+    std::stable_sort(result.actions.begin(), result.actions.end(),
+        [](const SymbolRebalance& a, const SymbolRebalance& b) {
+            if (a.isReducing() != b.isReducing()) {
+                return a.isReducing();
+            }
+            if (a.isReducing()) {
+                return a.marginImpact < b.marginImpact;
+            }
+            if (a.priority != b.priority) {
+                return a.priority < b.priority;
+            }
+            return a.marginImpact < b.marginImpact;
+        });
+
+    return result;
+}
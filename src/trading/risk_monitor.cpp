@@ -0,0 +1,331 @@
+#include "trading/risk_monitor.h"
+#include "config.h"
+#include "metrics/metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr double UNBOUNDED = std::numeric_limits<double>::infinity();
+
+MetricCounter& deleverageCounter() {
+    static MetricCounter& counter = MetricsRegistry::getInstance().counter(
+        "frt_risk_deleverage_total", "風險監控觸發的減倉次數");
+    return counter;
+}
+
+std::string formatRatio(double ratio) {
+    return std::isinf(ratio) ? "inf" : std::to_string(ratio * 100) + "%";
+}
+
+} // namespace
+
+RiskOptions RiskOptions::fromConfig() {
+    RiskOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasRiskMonitorConfig()) {
+        return options;
+    }
+    options.enabled = config.isRiskMonitorEnabled();
+    options.pollInterval = std::chrono::milliseconds(std::max(config.getRiskPollIntervalMs(), 0));
+    if (config.getRiskMaintenanceMarginRate() > 0) {
+        options.maintenanceMarginRate = config.getRiskMaintenanceMarginRate();
+    }
+    if (config.getRiskWarnRatio() > 0) {
+        options.warnRatio = config.getRiskWarnRatio();
+    }
+    if (config.getRiskDeleverageRatio() > 0) {
+        options.deleverageRatio = config.getRiskDeleverageRatio();
+    }
+    if (config.getRiskDeleverageFraction() > 0) {
+        options.deleverageFraction = std::min(config.getRiskDeleverageFraction(), 1.0);
+    }
+    options.deleverageCooldown = std::chrono::seconds(std::max(config.getRiskCooldownSeconds(), 0));
+    return options;
+}
+
+RiskMonitor::RiskMonitor(IClock& clock, const RiskOptions& options) :
+    clock(clock), options(options) {}
+
+RiskMonitor::~RiskMonitor() {
+    stop();
+}
+
+void RiskMonitor::sync(const std::vector<RiskPosition>& positions, double equity) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::unordered_map<std::string, Entry> next;
+    for (const auto& position : positions) {
+        if (position.spotQty <= 0 && position.contractQty <= 0) {
+            continue;
+        }
+        Entry& entry = next[position.symbol];
+        entry.position = position;
+        // 減倉冷卻期跨同步保留, 避免策略週期剛結束又立即重複減倉
+        auto previous = entries.find(position.symbol);
+        if (previous != entries.end()) {
+            entry.lastDeleverage = previous->second.lastDeleverage;
+            entry.level = previous->second.level;
+        }
+    }
+    entries = std::move(next);
+    baseEquity = equity;
+    pnlSum = 0.0;
+    maintenanceSum = 0.0;
+}
+
+void RiskMonitor::updatePosition(const RiskPosition& position) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    auto it = entries.find(position.symbol);
+    if (it == entries.end()) {
+        if (position.spotQty <= 0 && position.contractQty <= 0) {
+            return;
+        }
+        it = entries.emplace(position.symbol, Entry{}).first;
+    }
+    Entry& entry = it->second;
+    // 數量變化前的盈虧已實現, 轉入權益基準後以最新價重新起算
+    baseEquity += entry.pnl;
+    pnlSum -= entry.pnl;
+    maintenanceSum -= entry.maintenance;
+    entry.pnl = 0.0;
+    entry.maintenance = 0.0;
+    entry.position = position;
+    entry.spotRef = entry.spotPrice;
+    entry.contractRef = entry.contractPrice;
+    if (position.spotQty <= 0 && position.contractQty <= 0) {
+        entries.erase(it);
+        return;
+    }
+    if (entry.contractPrice > 0) {
+        refreshLocked(entry);
+    }
+}
+
+void RiskMonitor::onPrice(const std::string& symbol, double spotPrice, double contractPrice) {
+    const auto tickAt = std::chrono::steady_clock::now();
+    bool alerted = false;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        auto it = entries.find(symbol);
+        if (it == entries.end() || contractPrice <= 0) {
+            return;
+        }
+        Entry& entry = it->second;
+        entry.contractPrice = contractPrice;
+        if (spotPrice > 0) {
+            entry.spotPrice = spotPrice;
+        }
+        if (entry.contractRef <= 0) {
+            entry.contractRef = contractPrice;
+        }
+        if (entry.spotRef <= 0) {
+            entry.spotRef = entry.spotPrice;
+        }
+        refreshLocked(entry);
+        size_t before = alerts.size();
+        evaluateLocked(entry, tickAt);
+        alerted = alerts.size() > before;
+    }
+    if (alerted) {
+        wakeCv.notify_all();
+    }
+}
+
+// 只重算單一幣種的貢獻並以差值更新帳戶合計
+void RiskMonitor::refreshLocked(Entry& entry) {
+    const RiskPosition& position = entry.position;
+    double spotMove = entry.spotRef > 0 ? entry.spotPrice - entry.spotRef : 0.0;
+    double pnl = position.spotQty * spotMove * options.spotCollateralRatio +
+                 position.contractQty * (entry.contractRef - entry.contractPrice);
+    double maintenance = position.contractQty * entry.contractPrice * options.maintenanceMarginRate;
+    pnlSum += pnl - entry.pnl;
+    maintenanceSum += maintenance - entry.maintenance;
+    entry.pnl = pnl;
+    entry.maintenance = maintenance;
+
+    // 合約腿按逐倉估算: 維持保證金 / (初始保證金 + 未實現盈虧)
+    double entryPrice = position.contractEntryPrice > 0 ? position.contractEntryPrice : entry.contractRef;
+    double margin = position.contractQty * entryPrice / std::max(position.leverage, 1) +
+                    position.contractQty * (entryPrice - entry.contractPrice);
+    if (position.contractQty <= 0) {
+        entry.ratio = 0.0;
+    } else {
+        entry.ratio = margin > 0 ? maintenance / margin : UNBOUNDED;
+    }
+}
+
+double RiskMonitor::accountRatioLocked() const {
+    if (maintenanceSum <= 0) {
+        return 0.0;
+    }
+    double equity = baseEquity + pnlSum;
+    return equity > 0 ? maintenanceSum / equity : UNBOUNDED;
+}
+
+bool RiskMonitor::coolingDown(const Entry& entry, IClock::TimePoint now) const {
+    return entry.lastDeleverage != IClock::TimePoint() &&
+           now - entry.lastDeleverage < options.deleverageCooldown;
+}
+
+void RiskMonitor::evaluateLocked(Entry& entry, std::chrono::steady_clock::time_point tickAt) {
+    auto levelOf = [this](double ratio) {
+        if (ratio >= options.deleverageRatio) return RiskLevel::Deleverage;
+        if (ratio >= options.warnRatio) return RiskLevel::Warning;
+        return RiskLevel::Normal;
+    };
+    const double accountRatio = accountRatioLocked();
+    const RiskLevel positionLevel = levelOf(entry.ratio);
+    const RiskLevel newAccountLevel = levelOf(accountRatio);
+    const auto now = clock.now();
+
+    // 警告只在級別上升時記錄一次
+    if (positionLevel == RiskLevel::Warning && entry.level == RiskLevel::Normal) {
+        logger.warning(entry.position.symbol + " 保證金率 " + formatRatio(entry.ratio) + " 超過警告門檻");
+    }
+    if (newAccountLevel == RiskLevel::Warning && accountLevel == RiskLevel::Normal) {
+        logger.warning("帳戶保證金率 " + formatRatio(accountRatio) + " 超過警告門檻");
+    }
+    entry.level = positionLevel;
+    accountLevel = newAccountLevel;
+
+    Entry* target = nullptr;
+    bool accountTriggered = false;
+    if (positionLevel == RiskLevel::Deleverage && !coolingDown(entry, now)) {
+        target = &entry;
+    } else if (newAccountLevel == RiskLevel::Deleverage) {
+        // 帳戶層級觸發時減倉保證金率最高且不在冷卻期的幣種
+        for (auto& [symbol, candidate] : entries) {
+            if (candidate.position.contractQty > 0 && !coolingDown(candidate, now) &&
+                (!target || candidate.ratio > target->ratio)) {
+                target = &candidate;
+            }
+        }
+        accountTriggered = target != nullptr;
+    }
+    if (!target) {
+        return;
+    }
+    target->lastDeleverage = now;
+    RiskAlert alert;
+    alert.symbol = target->position.symbol;
+    alert.level = RiskLevel::Deleverage;
+    alert.positionRatio = target->ratio;
+    alert.accountRatio = accountRatio;
+    alert.accountTriggered = accountTriggered;
+    alert.reduceFraction = options.deleverageFraction;
+    alert.tickAt = tickAt;
+    alerts.push_back(std::move(alert));
+}
+
+double RiskMonitor::accountMarginRatio() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return accountRatioLocked();
+}
+
+double RiskMonitor::positionMarginRatio(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    auto it = entries.find(symbol);
+    return it == entries.end() ? 0.0 : it->second.ratio;
+}
+
+double RiskMonitor::equity() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return baseEquity + pnlSum;
+}
+
+std::vector<std::string> RiskMonitor::symbols() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::vector<std::string> names;
+    names.reserve(entries.size());
+    for (const auto& [symbol, entry] : entries) {
+        names.push_back(symbol);
+    }
+    return names;
+}
+
+void RiskMonitor::setDeleverageHandler(DeleverageHandler newHandler) {
+    std::lock_guard<std::mutex> lock(handlerMutex);
+    handler = std::move(newHandler);
+}
+
+void RiskMonitor::start(PriceSource priceSource) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (running) {
+        return;
+    }
+    source = std::move(priceSource);
+    running = true;
+    worker = std::thread(&RiskMonitor::run, this);
+}
+
+void RiskMonitor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    wakeCv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool RiskMonitor::isRunning() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return running;
+}
+
+void RiskMonitor::drainAlerts() {
+    while (true) {
+        RiskAlert alert;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (alerts.empty()) {
+                return;
+            }
+            alert = std::move(alerts.front());
+            alerts.pop_front();
+        }
+        deleverageCounter().increment();
+        logger.warning(alert.symbol + " 觸發預先減倉: 倉位保證金率 " + formatRatio(alert.positionRatio) +
+                       ", 帳戶保證金率 " + formatRatio(alert.accountRatio) +
+                       (alert.accountTriggered ? " (帳戶門檻)" : ""));
+        std::lock_guard<std::mutex> lock(handlerMutex);
+        if (handler) {
+            handler(alert);
+        }
+    }
+}
+
+void RiskMonitor::run() {
+    const bool polling = source && options.pollInterval.count() > 0;
+    auto nextPoll = std::chrono::steady_clock::now();
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            auto ready = [this] { return !running || !alerts.empty(); };
+            if (polling) {
+                wakeCv.wait_until(lock, nextPoll, ready);
+            } else {
+                wakeCv.wait(lock, ready);
+            }
+            if (!running) {
+                break;
+            }
+        }
+        drainAlerts();
+
+        if (polling && std::chrono::steady_clock::now() >= nextPoll) {
+            // 每取得一個幣種的行情就立即處理警報, 不等整輪輪詢結束
+            for (const auto& symbol : symbols()) {
+                auto [spotPrice, contractPrice] = source(symbol);
+                onPrice(symbol, spotPrice, contractPrice);
+                drainAlerts();
+            }
+            nextPoll = std::chrono::steady_clock::now() + options.pollInterval;
+        }
+    }
+}
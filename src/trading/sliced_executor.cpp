@@ -0,0 +1,225 @@
+#include "trading/sliced_executor.h"
+#include "trading/order_book.h"
+#include "metrics/trace.h"
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 買入吃賣單, 賣出吃買單
+const char* bookSideFor(const std::string& orderSide) {
+    return orderSide == "Buy" ? "a" : "b";
+}
+
+std::string oppositeSide(const std::string& side) {
+    return side == "Buy" ? "Sell" : "Buy";
+}
+
+// 累加子單數量會產生浮點誤差, 取整前加上極小的偏移避免少算一個精度單位
+constexpr double QTY_EPSILON = 1e-9;
+
+} // namespace
+
+SlicedExecutor::SlicedExecutor(IExchange& exchange, IClock& clock) :
+    SlicedExecutor(exchange, clock, Options()) {}
+
+SlicedExecutor::SlicedExecutor(IExchange& exchange, IClock& clock, const Options& options) :
+    exchange(exchange), clock(clock), options(options) {}
+
+SlicedExecutor::Options SlicedExecutor::optionsFromConfig() {
+    const auto config = Config::getInstance().snapshot();
+    Options options;
+    options.maxSliceImpact = config->maxSliceImpact;
+    options.maxSlices = std::max(config->maxSlices, 1);
+    options.sliceIntervalMs = std::max(config->sliceIntervalMs, 0);
+    options.trigger = config->sliceTrigger == "replenish" ? SliceTrigger::Replenish
+                                                          : SliceTrigger::Time;
+    options.replenishTimeoutMs = std::max(config->replenishTimeoutMs, 0);
+    return options;
+}
+
+double SlicedExecutor::sliceCapacity(const std::string& symbol, const std::string& spotSide,
+                                     const std::string& contractSide) {
+    auto spotLevels = parseBookSide(exchange.getSpotOrderBook(symbol), bookSideFor(spotSide));
+    auto contractLevels = parseBookSide(exchange.getContractOrderBook(symbol), bookSideFor(contractSide));
+    if (spotLevels.empty() || contractLevels.empty()) {
+        return 0.0;
+    }
+    return std::min(maxQuantityWithinImpact(spotLevels, options.maxSliceImpact),
+                    maxQuantityWithinImpact(contractLevels, options.maxSliceImpact));
+}
+
+bool SlicedExecutor::needsSlicing(const std::string& symbol, const std::string& spotSide,
+                                  const std::string& contractSide, double quantity) {
+    auto spotLevels = parseBookSide(exchange.getSpotOrderBook(symbol), bookSideFor(spotSide));
+    auto contractLevels = parseBookSide(exchange.getContractOrderBook(symbol), bookSideFor(contractSide));
+    if (spotLevels.empty() || contractLevels.empty()) {
+        return false;
+    }
+    return quantity > totalDepth(spotLevels) || quantity > totalDepth(contractLevels) ||
+           averageImpact(spotLevels, quantity) > options.maxSliceImpact ||
+           averageImpact(contractLevels, quantity) > options.maxSliceImpact;
+}
+
+bool SlicedExecutor::stopRequested(const HedgeSliceRequest& request) const {
+    return cancelRequested || (request.preempted && request.preempted());
+}
+
+bool SlicedExecutor::pause(const HedgeSliceRequest& request, std::chrono::milliseconds duration) {
+    const auto step = std::chrono::milliseconds(std::max(options.replenishPollMs, 1));
+    auto deadline = clock.now() + duration;
+    while (!stopRequested(request)) {
+        auto left = deadline - clock.now();
+        if (left <= decltype(left)::zero()) {
+            return true;
+        }
+        clock.sleepFor(std::min(std::chrono::duration_cast<decltype(left)>(step), left));
+    }
+    return false;
+}
+
+bool SlicedExecutor::waitForDepth(const HedgeSliceRequest& request, double wanted) {
+    auto deadline = clock.now() + std::chrono::milliseconds(options.replenishTimeoutMs);
+    while (!stopRequested(request)) {
+        if (sliceCapacity(request.symbol, request.spotSide, request.contractSide) >= wanted) {
+            return true;
+        }
+        if (clock.now() >= deadline) {
+            return false;
+        }
+        TraceSpan span("sleep", "wait", "等待深度補充");
+        clock.sleepFor(std::chrono::milliseconds(options.replenishPollMs));
+    }
+    return false;
+}
+
+void SlicedExecutor::publish(const SliceProgress& snapshot, const ProgressCallback& onProgress) {
+    {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        current = snapshot;
+    }
+    if (onProgress) {
+        onProgress(snapshot);
+    }
+}
+
+SliceProgress SlicedExecutor::execute(const HedgeSliceRequest& request, ProgressCallback onProgress) {
+    SliceProgress state;
+    state.symbol = request.symbol;
+    state.targetQuantity = request.quantity;
+    state.running = true;
+    publish(state, onProgress);
+
+    auto roundSpot = request.roundSpot ? request.roundSpot : [](double q) { return q; };
+    auto roundContract = request.roundContract ? request.roundContract : [](double q) { return q; };
+
+    double remaining = request.quantity;
+    double lastSlice = 0.0;
+    const double minRemaining = request.minQuantity - request.quantity * QTY_EPSILON;
+    while (remaining >= minRemaining && state.slicesDone < options.maxSlices) {
+        if (stopRequested(request)) {
+            state.cancelled = true;
+            state.message = "已取消";
+            break;
+        }
+
+        double capacity = sliceCapacity(request.symbol, request.spotSide, request.contractSide);
+        if (capacity < request.minQuantity) {
+            // 深度不足, 等待補充
+            if (!waitForDepth(request, request.minQuantity)) {
+                state.cancelled = stopRequested(request);
+                state.failed = !state.cancelled;
+                state.message = state.cancelled ? "已取消" : "訂單簿深度未恢復";
+                break;
+            }
+            continue;
+        }
+
+        // 子單至少要能在剩餘次數內完成全部數量
+        int slicesLeft = options.maxSlices - state.slicesDone;
+        double child = std::min(remaining, std::max(capacity, remaining / slicesLeft));
+        if (remaining - child < minRemaining) {
+            child = remaining;
+        }
+        // 兩邊使用相同數量以維持對衝比例
+        double nudge = request.quantity * QTY_EPSILON;
+        double qty = std::min(roundSpot(child + nudge), roundContract(child + nudge));
+        if (qty < request.minQuantity || qty <= 0) {
+            qty = std::min(roundSpot(remaining + nudge), roundContract(remaining + nudge));
+            if (qty < request.minQuantity || qty <= 0) {
+                break;
+            }
+        }
+
+        const int slice = state.slicesDone + 1;
+        auto linkId = [&request, slice](char leg) {
+            return request.orderLinkId ? request.orderLinkId(leg, slice) : std::string();
+        };
+        double spotQty = roundSpot(qty * request.spotQtyMultiplier);
+        if (!exchange.createSpotOrder(request.symbol, request.spotSide, spotQty, linkId('s'))) {
+            state.failed = true;
+            state.message = "現貨子單失敗: " + exchange.getLastError();
+            break;
+        }
+        state.spotFilled += qty;
+
+        Json::Value result = exchange.createOrder(request.symbol, request.contractSide, qty,
+                                                  "linear", "MARKET", linkId('c'));
+        if (result["retCode"].asInt() != 0) {
+            // 撤回本次現貨子單, 使兩邊保持對等
+            exchange.createSpotOrder(request.symbol, oppositeSide(request.spotSide), spotQty, linkId('u'));
+            state.spotFilled -= qty;
+            state.failed = true;
+            state.message = "合約子單失敗: " + exchange.getLastError();
+            break;
+        }
+        state.contractFilled += qty;
+        state.slicesDone++;
+        state.sliceQuantities.push_back(qty);
+        remaining -= qty;
+        lastSlice = qty;
+
+        LOG_INFO(logger, request.symbol + " 切片 " + std::to_string(state.slicesDone) + ": " +
+                         std::to_string(qty) + ", 完成 " +
+                         std::to_string(state.completion() * 100) + "%");
+        publish(state, onProgress);
+
+        if (remaining < minRemaining) {
+            break;
+        }
+        if (options.trigger == SliceTrigger::Replenish) {
+            if (!waitForDepth(request, std::min(lastSlice, remaining))) {
+                state.cancelled = stopRequested(request);
+                state.failed = !state.cancelled;
+                state.message = state.cancelled ? "已取消" : "訂單簿深度未恢復";
+                break;
+            }
+        } else {
+            TraceSpan span("sleep", "wait", "切片間隔");
+            if (!pause(request, std::chrono::milliseconds(options.sliceIntervalMs))) {
+                state.cancelled = true;
+                state.message = "已取消";
+                break;
+            }
+        }
+    }
+
+    // 本次執行已響應取消; 執行期間才到達的取消同樣只作用於本次
+    cancelRequested = false;
+    state.running = false;
+    if (state.message.empty()) {
+        state.message = remaining < minRemaining ? "完成" : "達到最大切片數";
+    }
+    publish(state, onProgress);
+    return state;
+}
+
+void SlicedExecutor::cancel() {
+    cancelRequested = true;
+}
+
+SliceProgress SlicedExecutor::progress() const {
+    std::lock_guard<std::mutex> lock(progressMutex);
+    return current;
+}
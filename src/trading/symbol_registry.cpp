@@ -0,0 +1,315 @@
+#include "trading/symbol_registry.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+
+std::mutex sharedMutex;
+std::unordered_map<std::string, std::weak_ptr<SymbolRegistry>> sharedRegistries;
+std::atomic<uint64_t> tempCounter{0};
+
+int64_t toEpochSeconds(IClock::TimePoint tp) {
+    return std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count();
+}
+
+IClock::TimePoint fromEpochSeconds(int64_t seconds) {
+    return IClock::TimePoint(std::chrono::seconds(seconds));
+}
+
+} // namespace
+
+SymbolBlockOptions SymbolBlockOptions::fromConfig() {
+    SymbolBlockOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasSymbolBlockConfig()) {
+        return options;
+    }
+    options.ttl = std::chrono::hours(std::max(config.getSymbolBlockTtlHours(), 0));
+    if (config.getSymbolBlockFlushIntervalMs() > 0) {
+        options.flushInterval = std::chrono::milliseconds(config.getSymbolBlockFlushIntervalMs());
+    }
+    return options;
+}
+
+SymbolRegistry::SymbolRegistry(IClock& clock, const SymbolBlockOptions& options) :
+    clock(clock), options(options) {}
+
+SymbolRegistry::~SymbolRegistry() {
+    stop();
+}
+
+std::shared_ptr<SymbolRegistry> SymbolRegistry::shared(IClock& clock, const SymbolBlockOptions& options) {
+    // 不寫文件的登記表 (例如回測) 各自獨立
+    if (options.filePath.empty()) {
+        return std::make_shared<SymbolRegistry>(clock, options);
+    }
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    auto& slot = sharedRegistries[options.filePath];
+    auto registry = slot.lock();
+    if (!registry) {
+        registry = std::make_shared<SymbolRegistry>(clock, options);
+        slot = registry;
+    }
+    return registry;
+}
+
+void SymbolRegistry::sync(const ConfigSnapshot& snapshot) {
+    {
+        std::shared_lock<std::shared_mutex> lock(entriesMutex);
+        if (snapshot.version == loadedVersion) {
+            return;
+        }
+    }
+
+    std::unordered_map<std::string, BlockedSymbol> next;
+    const auto now = clock.now();
+    for (const auto& symbol : snapshot.unsupportedSymbols) {
+        next[symbol] = BlockedSymbol{"config", now};
+    }
+    const Json::Value& blocked = snapshot.pairList["blocked_symbols"];
+    if (blocked.isObject()) {
+        for (const auto& symbol : blocked.getMemberNames()) {
+            const Json::Value& item = blocked[symbol];
+            BlockedSymbol entry{item["reason"].asString(),
+                                fromEpochSeconds(item["first_seen"].asInt64()),
+                                fromEpochSeconds(item["expires_at"].asInt64())};
+            if (entry.expiresAt > now) {
+                next.emplace(symbol, std::move(entry));
+            }
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(entriesMutex);
+    // 文件中還沒有的本地變更以記憶體為準
+    for (const auto& symbol : pending) {
+        auto it = entries.find(symbol);
+        if (it != entries.end()) {
+            next[symbol] = it->second;
+        } else {
+            next.erase(symbol);
+        }
+    }
+    entries = std::move(next);
+    loadedVersion = snapshot.version;
+}
+
+bool SymbolRegistry::isBlocked(const std::string& symbol) const {
+    std::shared_lock<std::shared_mutex> lock(entriesMutex);
+    auto it = entries.find(symbol);
+    return it != entries.end() && clock.now() < it->second.expiresAt;
+}
+
+std::optional<BlockedSymbol> SymbolRegistry::find(const std::string& symbol) const {
+    std::shared_lock<std::shared_mutex> lock(entriesMutex);
+    auto it = entries.find(symbol);
+    if (it == entries.end() || clock.now() >= it->second.expiresAt) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::vector<std::string> SymbolRegistry::blockedSymbols() const {
+    std::vector<std::string> symbols;
+    const auto now = clock.now();
+    std::shared_lock<std::shared_mutex> lock(entriesMutex);
+    for (const auto& [symbol, entry] : entries) {
+        if (now < entry.expiresAt) {
+            symbols.push_back(symbol);
+        }
+    }
+    std::sort(symbols.begin(), symbols.end());
+    return symbols;
+}
+
+bool SymbolRegistry::block(const std::string& symbol, const std::string& reason) {
+    const auto now = clock.now();
+    {
+        std::unique_lock<std::shared_mutex> lock(entriesMutex);
+        auto it = entries.find(symbol);
+        if (it != entries.end() && now < it->second.expiresAt) {
+            return false;
+        }
+        BlockedSymbol entry{reason, now};
+        if (options.ttl.count() > 0) {
+            entry.expiresAt = now + options.ttl;
+        }
+        entries[symbol] = std::move(entry);
+        pending.insert(symbol);
+    }
+    markDirty();
+    return true;
+}
+
+bool SymbolRegistry::unblock(const std::string& symbol) {
+    {
+        std::unique_lock<std::shared_mutex> lock(entriesMutex);
+        if (entries.erase(symbol) == 0) {
+            return false;
+        }
+        pending.insert(symbol);
+    }
+    markDirty();
+    return true;
+}
+
+size_t SymbolRegistry::purgeExpired() {
+    const auto now = clock.now();
+    std::vector<std::string> expired;
+    {
+        std::unique_lock<std::shared_mutex> lock(entriesMutex);
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (now >= it->second.expiresAt) {
+                expired.push_back(it->first);
+                pending.insert(it->first);
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (const auto& symbol : expired) {
+        logger.info("交易對封鎖已過期: " + symbol);
+    }
+    if (!expired.empty()) {
+        markDirty();
+    }
+    return expired.size();
+}
+
+void SymbolRegistry::markDirty() {
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        dirty = true;
+    }
+    workerCv.notify_all();
+}
+
+void SymbolRegistry::start() {
+    std::lock_guard<std::mutex> lock(workerMutex);
+    if (running || options.filePath.empty()) {
+        return;
+    }
+    running = true;
+    worker = std::thread(&SymbolRegistry::run, this);
+}
+
+void SymbolRegistry::stop() {
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    workerCv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    // 退出前寫出剩餘變更
+    flush();
+}
+
+void SymbolRegistry::run() {
+    std::unique_lock<std::mutex> lock(workerMutex);
+    while (running) {
+        // 第一筆變更到達後再等一個間隔, 讓同一輪的變更合併寫盤
+        workerCv.wait(lock, [this] { return !running || dirty; });
+        if (!running) {
+            break;
+        }
+        workerCv.wait_for(lock, options.flushInterval, [this] { return !running; });
+        lock.unlock();
+        purgeExpired();
+        flush();
+        lock.lock();
+    }
+}
+
+bool SymbolRegistry::flush() {
+    if (options.filePath.empty()) {
+        return true;
+    }
+    std::lock_guard<std::mutex> flushLock(flushMutex);
+    std::unordered_map<std::string, BlockedSymbol> snapshot;
+    std::unordered_set<std::string> written;
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        dirty = false;
+    }
+    {
+        std::shared_lock<std::shared_mutex> lock(entriesMutex);
+        if (pending.empty()) {
+            return true;
+        }
+        snapshot = entries;
+        written = pending;
+    }
+    if (!writeFile(snapshot)) {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        dirty = true;
+        return false;
+    }
+    std::unique_lock<std::shared_mutex> lock(entriesMutex);
+    for (const auto& symbol : written) {
+        pending.erase(symbol);
+    }
+    logger.info("已寫入不支持的交易對列表: " + std::to_string(written.size()) + " 項變更");
+    return true;
+}
+
+bool SymbolRegistry::writeFile(const std::unordered_map<std::string, BlockedSymbol>& entries) {
+    // 保留文件中的其他內容 (例如 pair_list)
+    Json::Value root(Json::objectValue);
+    {
+        std::ifstream in(options.filePath);
+        Json::Reader reader;
+        if (in.is_open() && !reader.parse(in, root)) {
+            logger.error("解析失敗, 放棄寫入: " + options.filePath);
+            return false;
+        }
+    }
+
+    std::vector<std::string> permanent;
+    Json::Value blocked(Json::objectValue);
+    for (const auto& [symbol, entry] : entries) {
+        if (entry.permanent()) {
+            permanent.push_back(symbol);
+            continue;
+        }
+        Json::Value item;
+        item["reason"] = entry.reason;
+        item["first_seen"] = Json::Int64(toEpochSeconds(entry.firstSeen));
+        item["expires_at"] = Json::Int64(toEpochSeconds(entry.expiresAt));
+        blocked[symbol] = item;
+    }
+    std::sort(permanent.begin(), permanent.end());
+    root["unsupported_symbols"] = Json::Value(Json::arrayValue);
+    for (const auto& symbol : permanent) {
+        root["unsupported_symbols"].append(symbol);
+    }
+    root["blocked_symbols"] = blocked;
+
+    // 臨時文件名帶進程號及序號, 其他進程或登記表同時寫盤時不會寫進同一個臨時文件
+    std::string tempPath = options.filePath + ".tmp." + std::to_string(::getpid()) + "." +
+                           std::to_string(tempCounter.fetch_add(1));
+    {
+        std::ofstream out(tempPath, std::ios::trunc);
+        if (!out.is_open()) {
+            logger.error("無法寫入文件: " + tempPath);
+            return false;
+        }
+        Json::StyledWriter writer;
+        out << writer.write(root);
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, options.filePath, ec);
+    if (ec) {
+        logger.error("無法替換文件: " + options.filePath + ": " + ec.message());
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
@@ -1,32 +1,139 @@
 #include "trading/trading_module.h"
 #include "config.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <ctime>
 #include <iomanip>
 #include <thread>
 #include <chrono>
 #include <set>
+#include <string_view>
 #include <fstream>
 #include <sstream>
-#include <curl/curl.h>
+#include "exchange/request_budget.h"
+#include "metrics/alloc_tracker.h"
+#include "metrics/metrics.h"
+#include "metrics/trace.h"
+#include "trading/scratch_arena.h"
+
+namespace {
+
+LatencyHistogram& strategyStage(const char* stage) {
+    return MetricsRegistry::getInstance().histogram(
+        "frt_strategy_stage_seconds", "executeHedgeStrategy 各階段耗時", {{"stage", stage}});
+}
+
+LatencyHistogram& riskReaction() {
+    static LatencyHistogram& histogram = MetricsRegistry::getInstance().histogram(
+        "frt_risk_reaction_seconds", "行情到達至送出第一筆減倉訂單的延遲");
+    return histogram;
+}
+
+// 訂單響應或查詢結果中的數值欄位 (交易所以字串返回), 沒有或無法解析時返回 0
+double orderNumber(const Json::Value& value) {
+    if (value.isNumeric()) {
+        return value.asDouble();
+    }
+    try {
+        return value.isString() && !value.asString().empty() ? std::stod(value.asString()) : 0.0;
+    } catch (const std::exception&) {
+        return 0.0;
+    }
+}
+
+SymbolBlockOptions blockOptions(const TradingSinks& sinks) {
+    SymbolBlockOptions options = SymbolBlockOptions::fromConfig();
+    if (sinks.pairListPath) {
+        options.filePath = *sinks.pairListPath;
+    }
+    return options;
+}
+
+} // namespace
 
 std::mutex TradingModule::mutex_;
 std::unique_ptr<TradingModule> TradingModule::instance;
 
-TradingModule::TradingModule(IExchange& exchange) : 
+std::vector<std::string> splitString(const std::string& str, const std::string& delimiter) {
+    std::vector<std::string> tokens;
+    size_t prev = 0, pos = 0;
+    do {
+        pos = str.find(delimiter, prev);
+        if (pos == std::string::npos) pos = str.length();
+        std::string token = str.substr(prev, pos-prev);
+        if (!token.empty()) tokens.push_back(token);
+        prev = pos + delimiter.length();
+    } while (pos < str.length() && prev < str.length());
+    return tokens;
+}
+
+TradingModule::TradingModule(IExchange& exchange, IClock& clock, const AccountConfig& account,
+                             const TradingSinks& sinks) :
     exchange(exchange),
-    storage(SQLiteStorage::getInstance()) {}
+    storage(sinks.storage ? *sinks.storage : SQLiteStorage::getInstance()),
+    accountName(account.name),
+    configOverrides(account.overrides),
+    clock(clock),
+    settlementCalendar(fromAccountConfig(SettlementCalendar::fromConfig)),
+    slicedExecutor(exchange, clock, fromAccountConfig(SlicedExecutor::optionsFromConfig)),
+    symbolRegistry(SymbolRegistry::shared(clock, blockOptions(sinks))),
+    warmStateOptions(fromAccountConfig(WarmStateOptions::fromConfig)),
+    basisOptions(fromAccountConfig(BasisOptions::fromConfig)),
+    basisTracker(clock, basisOptions),
+    riskOptions(fromAccountConfig(RiskOptions::fromConfig)),
+    riskMonitor(clock, riskOptions),
+    pipelineOptions(fromAccountConfig(PipelineOptions::fromConfig)) {
+    riskMonitor.setDeleverageHandler([this](const RiskAlert& alert) { deleverage(alert); });
+    if (!sinks.warmState) {
+        warmStateOptions.path.clear();
+    }
+    // 各帳戶的快照分開保存
+    if (!accountName.empty() && !warmStateOptions.path.empty()) {
+        warmStateOptions.path += "." + accountName;
+    }
+    symbolRegistry->sync(*currentConfig());
+    symbolRegistry->start();
+}
 
-TradingModule& TradingModule::getInstance(IExchange& exchange) {
+TradingModule& TradingModule::getInstance(IExchange& exchange, IClock& clock) {
     std::lock_guard<std::mutex> lock(mutex_);
     if (!instance) {
-        instance.reset(new TradingModule(exchange));
+        instance.reset(new TradingModule(exchange, clock, AccountConfig{}, TradingSinks()));
     }
     return *instance;
 }
 
+std::unique_ptr<TradingModule> TradingModule::createForAccount(IExchange& exchange, IClock& clock,
+                                                               const AccountConfig& account,
+                                                               const TradingSinks& sinks) {
+    return std::unique_ptr<TradingModule>(new TradingModule(exchange, clock, account, sinks));
+}
+
+Config::Snapshot TradingModule::currentConfig() const {
+    Config::Snapshot base = Config::getInstance().snapshot();
+    if (configOverrides.isNull()) {
+        return base;
+    }
+    // 全局快照重新載入後才重新合併帳戶覆蓋配置
+    std::lock_guard<std::mutex> lock(configMutex);
+    if (!accountConfig || accountConfigBase != base) {
+        accountConfig = base->withOverrides(configOverrides);
+        accountConfigBase = base;
+    }
+    return accountConfig;
+}
+
+std::string TradingModule::exchangeId() const {
+    const std::string preferred = currentConfig()->preferredExchange;
+    return accountName.empty() ? preferred : preferred + ":" + accountName;
+}
+
+const std::string& TradingModule::getAccountName() const {
+    return accountName;
+}
+
 double TradingModule::calculatePositionSize(const std::string& symbol, double rate) {
-    const Config& config = Config::getInstance();
     double availableEquity = exchange.getTotalEquity();
     
     // 檢查可用資金
@@ -42,38 +149,16 @@ double TradingModule::calculatePositionSize(const std::string& symbol, double ra
         return 0.0;
     }
 
-    // 設置最小倉位價值（USDT）
-    double minPositionValue = config.getMinPositionValue();
-    double maxPositionValue = config.getMaxPositionValue();
-    
-    // 基礎倉位計算
-    double basePosition = minPositionValue;
-    
-    // 根據資金費率調整倉位大小
-    double adjustedPosition = basePosition;
-    if (config.getPositionScaling()) {
-        double scalingFactor = config.getScalingFactor();
-        double minRate = config.getMinScalingRate();  // 新增最小縮放費率閾值
-        double maxRate = config.getMaxScalingRate();  // 新增最大縮放費率閾值
-        
-        // 將費率限制在合理範圍內
-        double normalizedRate = std::clamp(std::abs(rate), minRate, maxRate);
-        
-        // 使用對數函數進行平滑縮放
-        double scalingMultiplier = 1.0 + std::log1p(normalizedRate * scalingFactor);
-        
-        // 應用縮放
-        adjustedPosition = basePosition * scalingMultiplier;
-        
-        // 限制最大倉位價值
-        adjustedPosition = std::min(adjustedPosition, maxPositionValue);
-        
+    // 按資金費率縮放倉位價值
+    const PositionSizing sizing = fromAccountConfig(PositionSizing::fromConfig);
+    double minPositionValue = sizing.minPositionValue;
+    double adjustedPosition = sizing.targetValue(rate);
+    if (sizing.positionScaling) {
         std::stringstream ss;
         ss << "倉位調整詳情: "
-           << "原始倉位=" << basePosition
+           << "原始倉位=" << minPositionValue
            << ", 費率=" << rate
-           << ", 標準化費率=" << normalizedRate
-           << ", 縮放倍數=" << scalingMultiplier
+           << ", 縮放倍數=" << sizing.scalingMultiplier(rate)
            << ", 調整後倉位=" << adjustedPosition;
         logger.debug(ss.str());
     }
@@ -92,56 +177,74 @@ double TradingModule::calculatePositionSize(const std::string& symbol, double ra
 }
 
 std::vector<std::pair<std::string, double>> TradingModule::getTopFundingRates() {
+    TraceSpan span("getTopFundingRates", "strategy");
     // 檢查是否需要更新資金費率
-    bool needUpdate = cachedFundingRates.empty() || isNearSettlement();
-    
-    if (!needUpdate) {
-        logger.info("使用緩存的資金費率數據");
-        return cachedFundingRates;
+    {
+        std::lock_guard<std::mutex> lock(ratesMutex);
+        bool needUpdate = cachedFundingRates.empty() || isNearSettlement();
+        if (!needUpdate) {
+            logger.info("使用緩存的資金費率數據");
+            return cachedFundingRates;
+        }
     }
     
     logger.info("重新獲取資金費率數據...");
     
-    int topCount = Config::getInstance().getTopPairsCount();
-    
-    const Config& config = Config::getInstance();
-    bool useCoinMarketCap = config.getUseCoinMarketCap();
-    int cmcTopCount = config.getCMCTopCount();
+    const auto config = currentConfig();
+    bool useCoinMarketCap = config->useCoinMarketCap;
+    int cmcTopCount = config->cmcTopCount;
+    symbolRegistry->sync(*config);
     std::vector<std::string> symbols;
     
-    if (useCoinMarketCap) {
+    if (!symbolUniverse.empty()) {
+        //使用外部指定的幣種 (例如回測)
+        symbols = symbolUniverse;
+    } else if (useCoinMarketCap) {
         //使用CMC的幣種 
         symbols = getSymbolsByCMC(cmcTopCount);
     } else {
         //使用配置中的所有交易對
-        symbols = config.getTradingPairs();
+        symbols = config->tradingPairs;
     }
     
     
     // 獲取不支持的交易對, 並從symbols中移除
-    auto unsupportedList = config.getUnsupportedSymbols();
-    std::set<std::string> unsupportedSymbols(unsupportedList.begin(), unsupportedList.end());
     symbols.erase(std::remove_if(symbols.begin(), symbols.end(),
-        [&unsupportedSymbols](const std::string& symbol) {
-            return unsupportedSymbols.find(symbol) != unsupportedSymbols.end();
+        [this](const std::string& symbol) {
+            return symbolRegistry->isBlocked(symbol);
         }), symbols.end());
     
     //移除重複
     symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
 
-    // 獲取配置參數
-    auto periods = Config::getInstance().getFundingPeriods();  // [a, b, c]
-    auto weights = Config::getInstance().getFundingWeights();  // [o, p, q]
-    
-    if (periods.size() != weights.size()) {
+    // 獲取評分參數
+    const FundingScorer scorer(fromAccountConfig(ScoringParams::fromConfig));
+    if (!scorer.params().valid()) {
         logger.error("資金費率週期和權重配置不匹配");
         return {};
     }
     
-    // 獲取資金費率數據
+    // 獲取資金費率數據: 帶結算時間的記錄先寫入本地時間序列, 再從本地讀取最近的窗口評分;
+    // 交易所不提供結算時間時 (回測) 直接使用返回的歷史
     std::vector<std::pair<std::string, std::vector<double>>> historicalRates;
+    std::vector<std::pair<std::string, double>> weightedRates;
+    bool scoredLocally = false;
     try {
-        historicalRates = exchange.getFundingHistory(symbols);
+        std::vector<FundingRecord> records = exchange.getFundingRecords(symbols);
+        if (!records.empty()) {
+            scoredLocally = true;
+            storage.storeFundingRates(std::move(records));
+            FundingWindow window = storage.getLatestFundingRates(symbols, scorer.params().maxLookback());
+            AllocScope allocScope("scoring");
+            weightedRates = scorer.rank(window);
+            // 排名輸出需要各週期的費率
+            for (size_t i = 0; i < window.size(); i++) {
+                auto row = window.row(i);
+                historicalRates.emplace_back(window.symbols[i], std::vector<double>(row.begin(), row.end()));
+            }
+        } else {
+            historicalRates = exchange.getFundingHistory(symbols);
+        }
         if (historicalRates.empty()) {
             logger.warning("沒有獲取到任何資金費率數據");
             return {};
@@ -151,60 +254,35 @@ std::vector<std::pair<std::string, double>> TradingModule::getTopFundingRates()
         return {};
     }
     
-    
-    
-    // 計算加權分數
-    std::vector<std::pair<std::string, double>> weightedRates;
-    for (const auto& [symbol, rates] : historicalRates) {
-
-        if (unsupportedSymbols.find(symbol) != unsupportedSymbols.end()) {
-            logger.info("跳過不支持的交易對: " + symbol);
-            continue;
-        }
-        
-        if (rates.empty()) {
-            logger.warning("無效的資金費率數據: " + symbol);
-            continue;
-        }
+    // 計算加權分數 (本地時間序列已在上面評分)
+    if (!scoredLocally) {
+        AllocScope allocScope("scoring");
+        weightedRates.reserve(historicalRates.size());
+        for (const auto& [symbol, rates] : historicalRates) {
 
-        // 是否支援反向現貨合約資金費率, 即空付多收，借現貨賣做多合約（反向合約資金費率 = 現貨資金費率 * -1）
-        if (!config.getReverseContractFundingRate()) {
-            if (rates[0] < 0) {
-                logger.info("不支援反向現貨合約資金費率，跳過資金費率為負值的幣種: " + symbol);
+            if (symbolRegistry->isBlocked(symbol)) {
+                LOG_INFO(logger, "跳過不支持的交易對: " + symbol);
                 continue;
             }
-        }
-        
-        double weightedScore = 0.0;
-        double totalWeight = 0.0;
-        
-        // 對每個週期計算加權平均
-        for (size_t i = 0; i < periods.size(); i++) {
-            int periodLimit = std::min(periods[i], static_cast<int>(rates.size()));
-            double periodSum = 0.0;
-            
-            for (int j = 0; j < periodLimit; j++) {
-                if (std::isfinite(rates[j])) {
-                    periodSum += rates[j];
-                }
-            }
             
-            if (periodLimit > 0) {
-                double periodAvg = periodSum / periodLimit;
-                weightedScore += periodAvg * weights[i];
-                totalWeight += weights[i];
-            }
-        }
-        
-        if (totalWeight > 0) {
-            double finalScore = weightedScore / totalWeight;
-            // 檢查最新資金費率是否與finalScore相反
-            if (rates.empty() || rates[0] * finalScore < 0) {
-                logger.info("跳過資金費率與最後一個週期相反的幣種: " + symbol);
-                continue;
+            double finalScore = 0.0;
+            switch (scorer.score(rates, finalScore)) {
+                case FundingScorer::Result::Scored:
+                    weightedRates.emplace_back(symbol, finalScore);
+                    break;
+                case FundingScorer::Result::NoData:
+                    logger.warning("無效的資金費率數據: " + symbol);
+                    break;
+                case FundingScorer::Result::NegativeNotSupported:
+                    LOG_INFO(logger, "不支援反向現貨合約資金費率，跳過資金費率為負值的幣種: " + symbol);
+                    break;
+                case FundingScorer::Result::ContradictsLatest:
+                    LOG_INFO(logger, "跳過資金費率與最後一個週期相反的幣種: " + symbol);
+                    break;
             }
-            weightedRates.emplace_back(symbol, finalScore);
         }
+        // 按資金費率絕對值排序, 只保留前N個交易對
+        sortAndTruncateScores(weightedRates, scorer.params().topPairsCount);
     }
     
     if (weightedRates.empty()) {
@@ -212,17 +290,6 @@ std::vector<std::pair<std::string, double>> TradingModule::getTopFundingRates()
         return {};
     }
     
-    // 按資金費率絕對值排序
-    std::sort(weightedRates.begin(), weightedRates.end(),
-        [](const auto& a, const auto& b) {
-            return std::abs(a.second) > std::abs(b.second);
-        });
-    
-    // 只保留前N個交易對
-    if (topCount > 0 && weightedRates.size() > static_cast<size_t>(topCount)) {
-        weightedRates.resize(topCount);
-    }
-    
     // 輸出排名結果
     std::cout << "\n=== 資金費率排名 ===" << std::endl;
     for (const auto& [symbol, rate] : weightedRates) {
@@ -244,6 +311,7 @@ std::vector<std::pair<std::string, double>> TradingModule::getTopFundingRates()
         // 顯示各週期的平均分數
         if (it != historicalRates.end()) {
             const auto& rates = it->second;
+            const auto& periods = scorer.params().periods;
             std::cout << " [";
             for (size_t i = 0; i < periods.size(); i++) {
                 int periodLimit = std::min(periods[i], static_cast<int>(rates.size()));
@@ -272,82 +340,315 @@ std::vector<std::pair<std::string, double>> TradingModule::getTopFundingRates()
     std::cout << std::endl;
     
     // 更新緩存
+    std::lock_guard<std::mutex> lock(ratesMutex);
     cachedFundingRates = weightedRates;
-    lastFundingUpdate = std::chrono::system_clock::now();
+    lastFundingUpdate = clock.now();
     
     return cachedFundingRates;
 }
 
-void TradingModule::closeTradeGroup(const std::string& group) {
-    auto parts = splitString(group, ":");
-    if (parts.size() >= 2) {
-        std::string symbol = parts[1];
-        exchange.closePosition(symbol);
+bool TradingModule::closeTradeGroup(int64_t groupId) {
+    // 與再平衡及風險減倉互斥, 取得鎖後再讀取組, 避免按已變化的數量下單
+    std::unique_lock<std::mutex> lock(executionMutex);
+    auto found = storage.findActiveTradeGroup(groupId);
+    if (!found) {
+        logger.warning("找不到未平倉的對沖組: " + std::to_string(groupId));
+        return false;
     }
-}
+    RequestPriorityScope priorityScope(RequestPriority::OrderEntry);
+    TradeGroup group = *found;
+    const std::string& symbol = group.symbol;
+    group.state = TradeGroupState::Closing;
+    group.orderSeq++;
+    storage.updateTradeGroup(group);
 
-void TradingModule::executeHedgeStrategy() {
-    try {
+    std::vector<LegFill> fills;
+    double spotSold = 0.0;
+    if (group.spotQty > 0) {
+        double qty = adjustSpotPrecision(group.spotQty, symbol);
+        if (!exchange.createSpotOrder(symbol, "Sell", qty, group.orderLinkId('s'))) {
+            logger.error("平倉現貨失敗: " + symbol);
+            handleError(symbol, exchange.getLastError());
+            finishTradeGroup(group, fills);
+            return false;
+        }
+        spotSold = qty;
+        // 精度調整後的餘數視為已平
+        fills.push_back({true, -group.spotQty, group.orderLinkId('s')});
+    }
+    if (group.contractQty > 0) {
+        Json::Value result = exchange.createOrder(symbol, "Buy", group.contractQty, "linear", "MARKET",
+                                                  group.orderLinkId('c'));
+        if (result["retCode"].asInt() != 0) {
+            logger.error("平倉合約失敗: " + symbol);
+            handleError(symbol, exchange.getLastError());
+            reducePosition(group, spotSold, 0.0);
+            finishTradeGroup(group, fills);
+            return false;
+        }
+        group.futuresOrderId = result["result"]["orderId"].asString();
+        fills.push_back({false, -group.contractQty, group.orderLinkId('c'),
+                         orderNumber(result["result"]["avgPrice"])});
+    }
+    reducePosition(group, spotSold, group.contractQty);
+    finishTradeGroup(group, fills);
+    logger.info("對沖組已平倉: " + symbol + " #" + std::to_string(groupId));
+    return true;
+}
 
-        // 1. 獲取資金費率
-        auto topRates = getTopFundingRates(); 
+void TradingModule::executeHedgeStrategy(std::function<void()> afterExecution) {
+    if (pipelineRunning()) {
+        pipeline->requestCycle(std::move(afterExecution));
+        return;
+    }
+    runHedgeCycle();
+    if (afterExecution) {
+        afterExecution();
+    }
+}
 
-        logger.info("開始執行對衝策略...");
+void TradingModule::runHedgeCycle() {
+    static LatencyHistogram& totalStage = strategyStage("total");
+    ScopedLatencyTimer totalTimer(totalStage);
+    TraceCycle traceCycle("hedge_strategy");
+    AllocScope allocScope("cycle");
 
-        // 2. 獲取當前倉位狀態
-        auto positionSizes = getCurrentPositionSizes();
-        if (positionSizes.empty()) {
+    try {
+        // 1. 獲取資金費率及當前倉位狀態
+        MarketSnapshot snapshot;
+        if (!captureSnapshot(snapshot)) {
             logger.info("無法獲取倉位信息，跳過本次執行");
             return;
         }
-        
-        // 3. 關閉不在topRates的現有倉位
-        if (!positionSizes.empty()) {
-            logger.info("開始關閉不在topRates的現有倉位");
-            handleExistingPositions(positionSizes, topRates);
-            displayPositionSizes(positionSizes);
+
+        // 2. 計算淨額再平衡計劃 (平倉、減倉與加倉合併為單一批次)
+        StrategyDecision decision;
+        decision.plan = decide(snapshot);
+        decision.positions = std::move(snapshot.positions);
+
+        // 3. 執行計劃
+        executeDecision(decision);
+        if (AllocTracker::enabled()) {
+            AllocStats cycle = allocScope.stats();
+            logger.info("本週期記憶體分配: " + std::to_string(cycle.count) + " 次, " +
+                        std::to_string(cycle.bytes) + " 字節");
         }
-    
-        // 4. 新建倉位並平衡現有倉位
-        logger.info("開始平衡倉位...");
-        balancePositions(topRates, positionSizes);
-        
-        logger.info("對衝策略執行完成");
-        
     } catch (const std::exception& e) {
         logger.error("執行對衝策略時發生錯誤: " + std::string(e.what()));
     }
 }
 
+bool TradingModule::captureSnapshot(MarketSnapshot& snapshot) {
+    static LatencyHistogram& ratesStage = strategyStage("funding_rates");
+    static LatencyHistogram& positionsStage = strategyStage("positions");
+    {
+        ScopedLatencyTimer timer(ratesStage);
+        AllocScope allocScope("funding_rates");
+        snapshot.topRates = getTopFundingRates();
+    }
+
+    logger.info("開始執行對衝策略...");
+
+    bool fetched = false;
+    {
+        ScopedLatencyTimer timer(positionsStage);
+        AllocScope allocScope("positions");
+        snapshot.positions = getCurrentPositionSizes(&fetched);
+    }
+    return fetched;
+}
+
+RebalancePlan TradingModule::decide(const MarketSnapshot& snapshot) {
+    static LatencyHistogram& planStage = strategyStage("plan");
+    ScopedLatencyTimer timer(planStage);
+    TraceSpan span("planRebalance", "strategy");
+    AllocScope allocScope("plan");
+    return planRebalance(snapshot.topRates, snapshot.positions);
+}
+
+void TradingModule::executeDecision(StrategyDecision& decision) {
+    static LatencyHistogram& executeStage = strategyStage("execute");
+    static LatencyHistogram& displayStage = strategyStage("display");
+    logger.info("開始執行再平衡批次...");
+    {
+        // 執行期間的行情及下單請求優先於顯示和報表, 結算前下單不排在顯示請求之後
+        RequestPriorityScope priorityScope(RequestPriority::OrderEntry);
+        ScopedLatencyTimer timer(executeStage);
+        TraceSpan span("executeRebalancePlan", "strategy");
+        AllocScope allocScope("execute");
+        executeRebalancePlan(decision.plan, decision.positions);
+    }
+    {
+        RequestPriorityScope priorityScope(RequestPriority::Display);
+        ScopedLatencyTimer timer(displayStage);
+        AllocScope allocScope("display");
+        displayPositionSizes(decision.positions);
+    }
+
+    logger.info("對衝策略執行完成");
+    saveWarmState();
+    syncRiskMonitor();
+    reportAllocations();
+}
+
+void TradingModule::reportAllocations() {
+    if (!AllocTracker::enabled()) {
+        return;
+    }
+    AllocTracker::publish();
+    std::stringstream ss;
+    ss << "記憶體分配最多的區段:";
+    for (const auto& site : AllocTracker::topSites(5)) {
+        ss << " " << site.label << "=" << site.count << "次/" << site.bytes << "B";
+    }
+    logger.info(ss.str());
+}
+
 bool TradingModule::isNearSettlement() {
-    auto now = std::chrono::system_clock::now();
-    auto utc_time = std::chrono::system_clock::to_time_t(now);
-    std::tm utc_tm = *std::gmtime(&utc_time);
-    int current_minutes = utc_tm.tm_hour * 60 + utc_tm.tm_min;
-    auto settlement_times = Config::getInstance().getSettlementTimesUTC();
-    int pre_minutes = Config::getInstance().getPreSettlementMinutes();
-
-    // 找到下一個結算時間
-    for (const auto& time_str : settlement_times) {
-        std::istringstream ss(time_str);
-        int hour, minute;
-        char delimiter;
-        ss >> hour >> delimiter >> minute;
-        int settlement_minutes = hour * 60 + minute;
-        
-        // 計算時間差（考慮跨日情況）
-        int diff = settlement_minutes - current_minutes;
-        if (diff < 0) {
-            diff += 1440; // 24小時 = 1440分鐘
+    auto now = clock.now();
+    if (!settlementCalendar.isNearSettlement(now)) {
+        return false;
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::minutes>(
+        settlementCalendar.nextSettlement(now) - now);
+    logger.info("距離下次結算時間還有：" + std::to_string(remaining.count()) + "分鐘");
+    return true;
+}
+
+void TradingModule::setSymbolUniverse(const std::vector<std::string>& symbols) {
+    symbolUniverse = symbols;
+    std::lock_guard<std::mutex> lock(ratesMutex);
+    cachedFundingRates.clear();
+}
+
+void TradingModule::refreshFundingRates(std::function<void()> afterRefresh) {
+    if (pipelineRunning()) {
+        pipeline->requestRefresh(std::move(afterRefresh));
+        return;
+    }
+    refreshFundingRatesNow();
+    if (afterRefresh) {
+        afterRefresh();
+    }
+}
+
+void TradingModule::refreshFundingRatesNow() {
+    {
+        std::lock_guard<std::mutex> lock(ratesMutex);
+        cachedFundingRates.clear();
+    }
+    spotFeeRate = -1.0;
+    contractFeeRate = -1.0;
+    getTopFundingRates();
+    saveWarmState();
+}
+
+double TradingModule::getSpotFeeRate() {
+    if (spotFeeRate < 0) {
+        spotFeeRate = exchange.getSpotFeeRate();
+    }
+    return spotFeeRate;
+}
+
+double TradingModule::getContractFeeRate() {
+    if (contractFeeRate < 0) {
+        contractFeeRate = exchange.getContractFeeRate();
+    }
+    return contractFeeRate;
+}
+
+bool TradingModule::warmStart() {
+    if (warmStateOptions.path.empty()) {
+        return false;
+    }
+    auto state = WarmState::load(warmStateOptions.path);
+    if (!state) {
+        logger.info("沒有可用的重啟快照, 從交易所重建狀態");
+        return false;
+    }
+    auto now = clock.now();
+    if (now - state->savedAt > warmStateOptions.maxAge) {
+        logger.info("重啟快照已過期, 從交易所重建狀態");
+        return false;
+    }
+
+    // 排名只在同一結算週期內有效, 跨越結算點後需要新的費率
+    bool rankingsValid = !state->rankings.empty() &&
+        (settlementCalendar.empty() || state->rankedAt >= settlementCalendar.previousSettlement(now));
+    if (rankingsValid) {
+        std::lock_guard<std::mutex> lock(ratesMutex);
+        cachedFundingRates = state->rankings;
+        lastFundingUpdate = state->rankedAt;
+    }
+    if (state->spotFeeRate >= 0) {
+        spotFeeRate = state->spotFeeRate;
+    }
+    if (state->contractFeeRate >= 0) {
+        contractFeeRate = state->contractFeeRate;
+    }
+    if (state->positionsKnown) {
+        restoredPositions = std::move(state->positions);
+    }
+    logger.info("已載入重啟快照: 排名 " + std::to_string(rankingsValid ? state->rankings.size() : 0) +
+                " 個, 持倉 " + std::to_string(restoredPositions ? restoredPositions->size() : 0) + " 個");
+    return true;
+}
+
+bool TradingModule::saveWarmState() {
+    if (warmStateOptions.path.empty()) {
+        return true;
+    }
+    WarmState state;
+    state.savedAt = clock.now();
+    {
+        std::lock_guard<std::mutex> lock(ratesMutex);
+        state.rankedAt = lastFundingUpdate;
+        state.rankings = cachedFundingRates;
+    }
+    state.spotFeeRate = spotFeeRate;
+    state.contractFeeRate = contractFeeRate;
+    {
+        std::lock_guard<std::mutex> lock(positionBookMutex);
+        state.positions = positionBook;
+        state.positionsKnown = positionBookKnown;
+    }
+    if (!state.save(warmStateOptions.path)) {
+        logger.error("無法寫入重啟快照: " + warmStateOptions.path);
+        return false;
+    }
+    return true;
+}
+
+// 只記錄快照保存後發生變化的幣種, 實際倉位以交易所為準
+void TradingModule::reconcileRestoredPositions(const std::map<std::string, std::pair<double, double>>& live) {
+    if (!restoredPositions) {
+        return;
+    }
+    constexpr double EPSILON = 1e-9;
+    std::vector<std::string> changed;
+    for (const auto& [symbol, sizes] : live) {
+        auto it = restoredPositions->find(symbol);
+        if (it == restoredPositions->end() ||
+            std::abs(it->second.first - sizes.first) > EPSILON ||
+            std::abs(it->second.second - sizes.second) > EPSILON) {
+            changed.push_back(symbol);
         }
-        
-        // 如果在預設時間範圍內
-        if (diff <= pre_minutes) {
-            logger.info("距離下次結算時間還有：" + std::to_string(diff) + "分鐘");
-            return true;
+    }
+    for (const auto& [symbol, sizes] : *restoredPositions) {
+        if (!live.count(symbol)) {
+            changed.push_back(symbol);
         }
     }
-    return false;
+    if (changed.empty()) {
+        logger.info("持倉與重啟快照一致");
+    } else {
+        std::string list;
+        for (const auto& symbol : changed) {
+            list += (list.empty() ? "" : ", ") + symbol;
+        }
+        logger.warning("持倉自快照保存後有變化: " + list);
+    }
+    restoredPositions.reset();
 }
 
 std::vector<std::string> TradingModule::getCurrentPositionSymbols() {
@@ -519,74 +820,27 @@ double TradingModule::getMinOrderSize(const std::string& symbol) {
     }
 }
 
-void TradingModule::updateUnsupportedSymbols(const std::string& symbol) {
-    Json::Value pairList;
-    Json::Reader reader;
-    std::ifstream file("config/pair_list.json");
-    
-    // 讀取現有文件內容
-    if (file.is_open()) {
-        if (!reader.parse(file, pairList)) {
-            logger.error("解析 pair_list.json 失敗");
-            return;
-        }
-        file.close();
-    }
-    
-    // 保留原有的 pair_list 內容
-    Json::Value originalPairList;
-    if (pairList.isMember("pair_list")) {
-        originalPairList = pairList["pair_list"];
-    }
-    
-    // 確保 unsupported_symbols 陣列存在
-    if (!pairList.isMember("unsupported_symbols")) {
-        pairList["unsupported_symbols"] = Json::Value(Json::arrayValue);
-    }
-    
-    // 檢查是否已經存在
-    bool exists = false;
-    auto& unsupportedList = pairList["unsupported_symbols"];
-    for (const auto& item : unsupportedList) {
-        if (item.asString() == symbol) {
-            exists = true;
-            break;
-        }
-    }
-    
-    // 如果不存在，則添加
-    if (!exists) {
-        unsupportedList.append(symbol);
-        
-        // 保原有的 pair_list
-        pairList["pair_list"] = originalPairList;
-        
-        // 寫回文件
-        Json::StyledWriter writer;
-        std::ofstream outFile("config/pair_list.json");
-        if (outFile.is_open()) {
-            outFile << writer.write(pairList);
-            outFile.close();
-            logger.info("已將 " + symbol + " 添加到不支持的交易對列表中");
-            std::cout << "已將 " + symbol + " 添加到不支持的交易對列表中" << std::endl;
-        } else {
-            logger.error("無法打開配置文件進行寫入: config/pair_list.json");
-            std::cout << "無法打開配置文件進行寫入: config/pair_list.json" << std::endl;
-        }
+// 只更新記憶體中的登記表, 寫盤由登記表的背景線程完成
+void TradingModule::updateUnsupportedSymbols(const std::string& symbol, const std::string& reason) {
+    if (symbolRegistry->block(symbol, reason)) {
+        logger.info("已將 " + symbol + " 添加到不支持的交易對列表中");
     } else {
         logger.info(symbol + " 已在不支持的交易對列表中");
-        std::cout << symbol + " 已在不支持的交易對列表中" << std::endl;
     }
 }
 
 // 獲取當前所有倉位大小
-std::map<std::string, std::pair<double, double>> TradingModule::getCurrentPositionSizes() {
+std::map<std::string, std::pair<double, double>> TradingModule::getCurrentPositionSizes(bool* fetched) {
+    TraceSpan span("getCurrentPositionSizes", "strategy");
     std::map<std::string, std::pair<double, double>> positionSizes;
+    bool spotFetched = false;
+    bool contractFetched = false;
     
     try {
         // 獲取現貨倉位
         auto spotBalances = exchange.getSpotBalances();
         if (spotBalances["result"]["list"].isArray()) {
+            spotFetched = true;
             const auto& list = spotBalances["result"]["list"][0]["coin"];
             if (list.isArray()) {
                 for (const auto& coin : list) {
@@ -610,6 +864,7 @@ std::map<std::string, std::pair<double, double>> TradingModule::getCurrentPositi
         // 獲取合約倉位
         auto positions = exchange.getPositions();
         if (positions["result"]["list"].isArray()) {
+            contractFetched = true;
             for (const auto& pos : positions["result"]["list"]) {
                 try {
                     std::string symbol = pos["symbol"].asString();
@@ -631,148 +886,106 @@ std::map<std::string, std::pair<double, double>> TradingModule::getCurrentPositi
     }
 
     //排除不支持的交易對
-    for (const auto& symbol : Config::getInstance().getUnsupportedSymbols()) {
-        positionSizes.erase(symbol);
+    for (auto it = positionSizes.begin(); it != positionSizes.end();) {
+        it = symbolRegistry->isBlocked(it->first) ? positionSizes.erase(it) : std::next(it);
+    }
+
+    if (spotFetched && contractFetched) {
+        reconcileRestoredPositions(positionSizes);
+        std::lock_guard<std::mutex> lock(positionBookMutex);
+        positionBook = positionSizes;
+        positionBookKnown = true;
+    }
+
+    // 空倉帳戶返回空結果, 只有查詢失敗時才視為無法獲取
+    if (fetched) {
+        *fetched = spotFetched && contractFetched;
     }
-    
     return positionSizes;
 }
 
-// 處理現有倉位
-void TradingModule::handleExistingPositions(
-    std::map<std::string, std::pair<double, double>>& positionSizes,
-    const std::vector<std::pair<std::string, double>>& topRates) {
+// 計算所有幣對的目標倉位並與現有持倉軋差
+RebalancePlan TradingModule::planRebalance(
+    const std::vector<std::pair<std::string, double>>& topRates,
+    const std::map<std::string, std::pair<double, double>>& positionSizes) {
     
-    logger.info("開始處理現有倉位...");
+    logger.info("開始規劃倉位再平衡...");
     
-    // 建立 topRates 的 symbol 集合，用於快速查找
-    std::set<std::string> topSymbols;
+    // 獲取配置參數
+    const auto config = currentConfig();
+    const double minPositionValue = config->minPositionValue;
+    const double maxPositionValue = config->maxPositionValue;
+    symbolRegistry->sync(*config);
+    
+    // 建立 topRates 的 symbol 集合，用於快速查找 (只引用輸入字串, 節點放在暫存區)
+    ScratchArena<4096> arena;
+    std::pmr::set<std::string_view> topSymbols(arena.get());
     for (const auto& [symbol, rate] : topRates) {
         topSymbols.insert(symbol);
     }
     
-    // 檢查每個現有倉位
-    std::vector<std::string> positionsToClose;
+    // 獲取現有倉位的價格
+    std::map<std::string, std::pair<double, double>> prices;
+    for (const auto& [symbol, sizes] : positionSizes) {
+        prices[symbol] = {exchange.getSpotPrice(symbol), exchange.getContractPrice(symbol)};
+    }
+    
+    // 基差追蹤輪詢候選及持倉幣種
+    std::pmr::set<std::string_view> watched(topSymbols, arena.get());
+    for (const auto& [symbol, sizes] : positionSizes) {
+        watched.insert(symbol);
+    }
+    basisTracker.setWatchlist(std::vector<std::string>(watched.begin(), watched.end()));
+    
+    // 不在 topRates 中的倉位目標為 0，其價值會在平倉後釋放; 平倉基差不利時維持現狀
+    double projectedValue = calculateTotalPositionValue(positionSizes, true, &prices);
+    std::vector<HedgeTarget> deferredExits;
     for (const auto& [symbol, sizes] : positionSizes) {
-        double spotSize = sizes.first;
-        double contractSize = sizes.second;
-        
-        // 如果該幣對不在 topRates 中，則加入關閉列表
         if (topSymbols.find(symbol) == topSymbols.end()) {
-            
+            if (deferExit(symbol)) {
+                deferredExits.push_back({symbol, sizes.first, sizes.second,
+                                         static_cast<int>(topRates.size() + deferredExits.size())});
+                continue;
+            }
             std::stringstream ss;
             ss << "準備關閉 " << symbol << " 倉位 "
-               << "(現貨: " << spotSize 
-               << ", 合約: " << contractSize << ")";
+               << "(現貨: " << sizes.first 
+               << ", 合約: " << sizes.second << ")";
             logger.info(ss.str());
-            
-            positionsToClose.push_back(symbol);
-        }
-    }
-    
-    // 關閉需要關閉的倉位
-    for (const auto& symbol : positionsToClose) {
-        try {
-            auto it = positionSizes.find(symbol);
-            if (it == positionSizes.end()) continue;
-            
-            double spotSize = it->second.first;
-            double contractSize = it->second.second;
-            
-            // 關閉現貨倉位
-            if (spotSize > 0) {
-                spotSize = adjustSpotPrecision(spotSize, symbol);
-                if (spotSize >= getMinOrderSize(symbol)) {
-                    logger.info("關閉 " + symbol + " 現貨倉位: " + std::to_string(spotSize));
-                    bool success = exchange.createSpotOrder(symbol, "Sell", spotSize);
-                    if (!success) {
-                        logger.error("關閉現貨倉位失敗: " + symbol);
-                        continue;  // 如果現貨關閉失敗，不執行合約關閉
-                    }
-                }
-            }
-            
-            // 關閉合約倉位
-            if (contractSize > 0) {
-                contractSize = adjustContractPrecision(contractSize, symbol);
-                if (contractSize >= getMinOrderSize(symbol)) {
-                    logger.info("關閉 " + symbol + " 合約倉位: " + std::to_string(contractSize));
-                    Json::Value result = exchange.createOrder(
-                        symbol, "Buy", contractSize, "linear", "MARKET");
-                    if (result["retCode"].asInt() != 0) {
-                        logger.error("關閉合約倉位失敗: " + symbol);
-                    }
-                }
-            }
-            
-            // 等待訂單執行
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-            
-            // 從 positionSizes 中移除該倉位
-            positionSizes.erase(symbol);
-            
-        } catch (const std::exception& e) {
-            logger.error("處理 " + symbol + " 倉位時發生錯誤: " + std::string(e.what()));
-            continue;
+            std::map<std::string, std::pair<double, double>> closing{{symbol, sizes}};
+            projectedValue -= calculateTotalPositionValue(closing, true, &prices);
         }
     }
     
-    // 輸出處理結果
-    if (positionsToClose.empty()) {
-        logger.info("沒有需要關閉的倉位");
-    } else {
-        logger.info("完成關閉 " + std::to_string(positionsToClose.size()) + " 個倉位");
-    }
-}
-
-// 平衡倉位
-void TradingModule::balancePositions(
-    const std::vector<std::pair<std::string, double>>& topRates,
-    std::map<std::string, std::pair<double, double>>& positionSizes) {
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (topRates.empty()) {
-        logger.warning("topRates 為空, 不進行倉位平衡");
-        return;
-    }
-    
-    // 獲取配置參數
-    const Config& config = Config::getInstance();
-    const double minPositionValue = config.getMinPositionValue();
-    const double maxPositionValue = config.getMaxPositionValue();
-    const auto& unsupportedSymbols = config.getUnsupportedSymbols();
-    
     // 獲取賬戶狀態
     double equity = exchange.getTotalEquity();
     if (equity <= 0) {
-        logger.error("無法獲取賬戶權益或權益不足");
-        return;
+        logger.error("無法獲取賬戶權益或權益不足, 只處理平倉");
     }
     
-    // 計算當前總倉位價值
-    double totalPositionValue = calculateTotalPositionValue(positionSizes, true, nullptr);
-    logger.info("當前總倉位價值: " + std::to_string(totalPositionValue) + " USDT");
-    
+    std::vector<HedgeTarget> targets;
+    int rank = 0;
     for (const auto& [symbol, rate] : topRates) {
+        auto it = positionSizes.find(symbol);
+        double existingSpotSize = (it != positionSizes.end()) ? it->second.first : 0.0;
+        double existingContractSize = (it != positionSizes.end()) ? it->second.second : 0.0;
+        // 預設維持現有倉位
+        HedgeTarget target{symbol, existingSpotSize, existingContractSize, rank++};
+        
         try {
             logger.info("--------------------------------");
-            logger.info("開始處理交易對: " + symbol);
-            if (std::find(unsupportedSymbols.begin(), unsupportedSymbols.end(), symbol) 
-                != unsupportedSymbols.end()) {
-                logger.info("不支持的交易對: " + symbol);
+            LOG_INFO(logger, "開始處理交易對: " + symbol);
+            if (symbolRegistry->isBlocked(symbol)) {
+                LOG_INFO(logger, "不支持的交易對: " + symbol);
+                targets.push_back(target);
                 continue;
             }
             
-            // 檢查現有倉位並獲取平衡結果
-            auto it = positionSizes.find(symbol);
-            double existingSpotSize = (it != positionSizes.end()) ? it->second.first : 0.0;
-            double existingContractSize = (it != positionSizes.end()) ? it->second.second : 0.0;
-            
             auto balanceCheck = checkPositionBalance(symbol, existingSpotSize, existingContractSize);
             
-            // 果不需要平衡，跳過
-            if (!balanceCheck.needBalance) {
+            // 如果不需要平衡或無可用權益，維持現狀
+            if (!balanceCheck.needBalance || equity <= 0) {
+                targets.push_back(target);
                 continue;
             }
             
@@ -780,148 +993,557 @@ void TradingModule::balancePositions(
             double targetValue = calculatePositionSize(symbol, rate);
             if (targetValue <= 0 || targetValue < minPositionValue || 
                 targetValue > maxPositionValue) {
+                targets.push_back(target);
                 continue;
             }
             
-            // 檢查總倉位限制
-            if (totalPositionValue + targetValue > equity * config.getDefaultLeverage()) {
-                logger.warning("總倉位價值將超過最大槓桿限制，跳過 " + symbol);
+            double spotPrice = exchange.getSpotPrice(symbol);
+            double contractPrice = exchange.getContractPrice(symbol);
+            if (spotPrice <= 0 || contractPrice <= 0) {
+                logger.error("無法獲取 " + symbol + " 價格");
+                targets.push_back(target);
                 continue;
             }
             
-            // 執行平衡操作
-            if (executeHedgePosition(symbol, targetValue, balanceCheck, positionSizes)) {
-                totalPositionValue += targetValue;
-                std::this_thread::sleep_for(std::chrono::seconds(2));
+            // 計算目標數量並調整精度
+            double targetQuantity = adjustSpotPrecision(targetValue / spotPrice, symbol);
+            if (targetQuantity < getMinOrderSize(symbol)) {
+                LOG_INFO(logger, symbol + " 數量小於最小訂單要求");
+                targets.push_back(target);
+                continue;
             }
             
+            // 基差門控: 加倉需要開倉基差有利, 減倉需要平倉基差有利
+            if (targetQuantity > existingSpotSize ? !basisAllowsEntry(symbol)
+                                                  : targetQuantity < existingSpotSize && deferExit(symbol)) {
+                targets.push_back(target);
+                continue;
+            }
+            
+            // 檢查總倉位限制 (只計算相對現有倉位的增量)
+            std::map<std::string, std::pair<double, double>> existing{
+                {symbol, {existingSpotSize, existingContractSize}}};
+            std::map<std::string, std::pair<double, double>> symbolPrices{
+                {symbol, {spotPrice, contractPrice}}};
+            double existingValue = calculateTotalPositionValue(existing, true, &symbolPrices);
+            if (projectedValue - existingValue + targetValue > equity * config->defaultLeverage) {
+                logger.warning("總倉位價值將超過最大槓桿限制，跳過 " + symbol);
+                targets.push_back(target);
+                continue;
+            }
+            projectedValue += targetValue - existingValue;
+            
+            target.spotQty = targetQuantity;
+            target.contractQty = adjustContractPrecision(targetQuantity, symbol);
+            prices[symbol] = {spotPrice, contractPrice};
+            
+            BINLOG_INFO(logger, "{} 目標倉位: 現貨={}, 合約={}, 價差={}%, 預期收益={} USDT",
+                        logSymbol(symbol), target.spotQty, target.contractQty,
+                        balanceCheck.priceDiff * 100, balanceCheck.expectedProfit);
+            
         } catch (const std::exception& e) {
             logger.error("處理 " + symbol + " 時發生錯誤: " + std::string(e.what()));
-            continue;
         }
+        targets.push_back(target);
     }
     
-    logger.info("倉位平衡完成，最新總倉位價值: " + 
-                std::to_string(totalPositionValue) + " USDT (" + 
-                std::to_string(totalPositionValue / equity * 100) + "% 槓桿率)");
+    targets.insert(targets.end(), deferredExits.begin(), deferredExits.end());
+    RebalancePlan plan = rebalancePlanner.plan(positionSizes, targets, prices);
+    logger.info("再平衡計劃: " + std::to_string(plan.actions.size()) + " 個幣對, " +
+                std::to_string(plan.orderCount()) + " 筆訂單, 成交名義價值 " +
+                std::to_string(plan.tradedNotional) + " USDT (全平重開需 " +
+                std::to_string(plan.roundTripNotional) + " USDT)");
+    return plan;
 }
 
-bool TradingModule::executeHedgePosition(
-    const std::string& symbol,
-    double targetValue,
-    const BalanceCheckResult& balanceCheck,
+// 以單一批次執行再平衡計劃
+void TradingModule::executeRebalancePlan(
+    const RebalancePlan& plan,
     std::map<std::string, std::pair<double, double>>& positionSizes) {
     
-    logger.info("開始執行對衝交易平衡: " + symbol); 
-    try {
-        // 1. 檢查是否需要平衡
-        if (!balanceCheck.needBalance) {
-            logger.info(symbol + " 無需平衡倉位");
-            return true;
+    std::unique_lock<std::mutex> lock(executionMutex);
+    
+    if (plan.empty()) {
+        logger.info("倉位已平衡，沒有需要執行的訂單");
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> pendingLock(deleverageMutex);
+        deleveragedSymbols.clear();
+    }
+    
+    size_t succeeded = 0;
+    for (const auto& action : plan.actions) {
+        if (yieldToDeleverage(lock, action.symbol)) {
+            logger.warning(action.symbol + " 已在本批次中風險減倉, 跳過按舊持倉計算的調整");
+            continue;
+        }
+        try {
+            if (executeSymbolRebalance(action, positionSizes)) {
+                succeeded++;
+            }
+        } catch (const std::exception& e) {
+            logger.error("處理 " + action.symbol + " 倉位時發生錯誤: " + std::string(e.what()));
         }
+    }
+    
+    logger.info("再平衡批次完成: " + std::to_string(succeeded) + "/" +
+                std::to_string(plan.actions.size()) + " 個幣對成功");
+}
 
-        // 2. 獲取當前價格
-        double currentPrice = exchange.getSpotPrice(symbol);
-        if (currentPrice <= 0) {
-            logger.error("無法獲取 " + symbol + " 價格");
-            return false;
+bool TradingModule::executeSymbolRebalance(
+    const SymbolRebalance& action,
+    std::map<std::string, std::pair<double, double>>& positionSizes) {
+    
+    const std::string& symbol = action.symbol;
+    double spotQty = 0.0;
+    double contractQty = 0.0;
+    TradeGroup group = beginTradeGroup(action);
+    std::vector<LegFill> fills;
+    
+    // 0. 兩腿同向調整且深度不足時，對衝部分改用切片執行
+    SymbolRebalance remaining = action;
+    bool sameDirection = (action.spotDelta > 0 && action.contractDelta > 0) ||
+                         (action.spotDelta < 0 && action.contractDelta < 0);
+    if (sameDirection && currentConfig()->slicedExecution) {
+        bool increase = action.spotDelta > 0;
+        double hedgeQty = std::min(std::abs(action.spotDelta), std::abs(action.contractDelta));
+        if (slicedExecutor.needsSlicing(symbol, increase ? "Buy" : "Sell",
+                                        increase ? "Sell" : "Buy", hedgeQty)) {
+            auto progress = executeSlicedHedge(group, increase, hedgeQty);
+            double sign = increase ? 1.0 : -1.0;
+            remaining.currentSpot += sign * progress.spotFilled;
+            remaining.currentContract += sign * progress.contractFilled;
+            remaining.spotDelta -= sign * progress.spotFilled;
+            remaining.contractDelta -= sign * progress.contractFilled;
+            for (size_t i = 0; i < progress.sliceQuantities.size(); i++) {
+                const int slice = static_cast<int>(i) + 1;
+                fills.push_back({true, sign * progress.sliceQuantities[i], group.orderLinkId('s', slice)});
+                fills.push_back({false, sign * progress.sliceQuantities[i], group.orderLinkId('c', slice)});
+            }
+            if (progress.failed || progress.cancelled) {
+                positionSizes[symbol] = std::make_pair(remaining.currentSpot, remaining.currentContract);
+                logger.error(symbol + " 切片執行未完成: " + progress.message);
+                finishTradeGroup(group, fills);
+                return false;
+            }
         }
-        
-        // 3. 計算目標數量並調整精度
-        double targetQuantity = adjustSpotPrecision(targetValue / currentPrice, symbol);
-        
-        // 4. 檢查最小訂單要求
-        if (targetQuantity < getMinOrderSize(symbol)) {
-            logger.info(symbol + " 數量小於最小訂單要求");
-            return false;
+    }
+    
+    // 1. 現貨腿
+    if (remaining.spotDelta != 0) {
+        spotQty = adjustSpotPrecision(std::abs(remaining.spotDelta), symbol);
+        if (spotQty >= getMinOrderSize(symbol)) {
+            bool success;
+            if (remaining.spotDelta > 0) {
+                success = createSpotOrderIncludeFee(symbol, "Buy", spotQty, group.orderLinkId('s'));
+            } else {
+                LOG_INFO(logger, "減少 " + symbol + " 現貨倉位: " + std::to_string(spotQty));
+                success = exchange.createSpotOrder(symbol, "Sell", spotQty, group.orderLinkId('s'));
+            }
+            if (!success) {
+                logger.error("調整現貨倉位失敗: " + symbol);
+                handleError(symbol, exchange.getLastError());
+                finishTradeGroup(group, fills);
+                return false;  // 如果現貨失敗，不執行合約調整
+            }
+            fills.push_back({true, remaining.spotDelta > 0 ? spotQty : -spotQty, group.orderLinkId('s')});
+        } else {
+            spotQty = 0.0;
         }
-        
-        // 5. 關閉現有倉位
-        auto it = positionSizes.find(symbol);
-        if (it != positionSizes.end()) {
-            if (it->second.first > 0) {
-                double spotCloseQty = adjustSpotPrecision(it->second.first, symbol);
-                bool spotCloseSuccess = exchange.createSpotOrder(
-                    symbol, "Sell", spotCloseQty);
-                if (!spotCloseSuccess) {
-                    logger.error("關閉現有現貨倉位失敗: " + symbol);
-                    return false;
-                }
+    }
+    
+    // 2. 合約腿
+    if (remaining.contractDelta != 0) {
+        contractQty = adjustContractPrecision(std::abs(remaining.contractDelta), symbol);
+        if (contractQty >= getMinOrderSize(symbol)) {
+            if (spotQty > 0) {
+                // 等待現貨訂單執行
+                TraceSpan span("sleep", "wait", "等待現貨訂單執行");
+                clock.sleepFor(std::chrono::seconds(1));
             }
-            
-            if (it->second.second > 0) {
-                double contractCloseQty = adjustContractPrecision(it->second.second, symbol);
-                Json::Value result = exchange.createOrder(
-                    symbol, "Buy", contractCloseQty, "linear", "MARKET");
-                if (result["retCode"].asInt() != 0) {
-                    logger.error("關閉現有合約倉位失敗: " + symbol);
-                    return false;
+            std::string side = remaining.contractDelta > 0 ? "Sell" : "Buy";
+            LOG_INFO(logger, "調整 " + symbol + " 合約倉位: " + side + " " + std::to_string(contractQty));
+            Json::Value result = exchange.createOrder(symbol, side, contractQty, "linear", "MARKET",
+                                                      group.orderLinkId('c'));
+            if (result["retCode"].asInt() != 0) {
+                logger.error("調整合約倉位失敗: " + symbol);
+                // 撤回剛買入的現貨，避免留下未對衝的倉位
+                if (remaining.spotDelta > 0 && spotQty > 0) {
+                    exchange.createSpotOrder(symbol, "Sell", spotQty, group.orderLinkId('u'));
+                    fills.push_back({true, -spotQty, group.orderLinkId('u')});
                 }
+                handleError(symbol, exchange.getLastError());
+                finishTradeGroup(group, fills);
+                return false;
             }
-            
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            group.futuresOrderId = result["result"]["orderId"].asString();
+            fills.push_back({false, remaining.contractDelta > 0 ? contractQty : -contractQty,
+                             group.orderLinkId('c'), orderNumber(result["result"]["avgPrice"])});
+        } else {
+            contractQty = 0.0;
         }
-        
-        // 6. 建立新倉位
-        bool spotSuccess = createSpotOrderIncludeFee(symbol, "Buy", targetQuantity);
-        if (!spotSuccess) {
-            logger.error("建立現貨倉位失敗: " + symbol);
-            return false;
+    }
+    
+    // 3. 更新倉位記錄
+    finishTradeGroup(group, fills);
+    double newSpot = remaining.currentSpot + (remaining.spotDelta > 0 ? spotQty : -spotQty);
+    double newContract = remaining.currentContract + (remaining.contractDelta > 0 ? contractQty : -contractQty);
+    if (remaining.isClosing()) {
+        positionSizes.erase(symbol);
+    } else {
+        positionSizes[symbol] = std::make_pair(newSpot, newContract);
+    }
+    
+    LOG_INFO(logger, symbol + " 淨額調整完成: " +
+                    "現貨=" + std::to_string(newSpot) +
+                    ", 合約=" + std::to_string(newContract));
+    return true;
+}
+
+TradeGroup TradingModule::beginTradeGroup(const SymbolRebalance& action) {
+    const auto config = currentConfig();
+    auto existing = storage.findActiveTradeGroup(exchangeId(), action.symbol);
+    TradeGroup group;
+    if (existing) {
+        group = *existing;
+    } else {
+        group.exchangeId = exchangeId();
+        group.symbol = action.symbol;
+        group.leverage = config->defaultLeverage;
+    }
+    // 以交易所返回的持倉為準, 也涵蓋沒有記錄的既有倉位 (例如升級前開的倉)
+    group.spotQty = std::max(0.0, action.currentSpot);
+    group.contractQty = std::max(0.0, action.currentContract);
+    if (action.isClosing()) {
+        group.state = TradeGroupState::Closing;
+    } else if (!existing) {
+        group.state = TradeGroupState::Opening;
+    }
+    group.orderSeq++;
+    if (existing) {
+        storage.updateTradeGroup(group);
+    } else {
+        group.id = storage.openTradeGroup(group);
+        // 開倉時間由存儲分配, 訂單號需要用到
+        group = storage.findActiveTradeGroup(group.id).value_or(group);
+    }
+    return group;
+}
+
+void TradingModule::finishTradeGroup(TradeGroup group, const std::vector<LegFill>& fills) {
+    for (const auto& fill : fills) {
+        if (fill.quantity == 0) {
+            continue;
         }
-        
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        
-        double contractQty = adjustContractPrecision(targetQuantity, symbol);
-        Json::Value result = exchange.createOrder(
-            symbol, "Sell", contractQty, "linear", "MARKET"
-        );
-        
-        if (result["retCode"].asInt() != 0) {
-            logger.error("建立合約倉位失敗: " + symbol);
-            exchange.createSpotOrder(symbol, "Sell", targetQuantity);
-            return false;
+        double price = fillPrice(group, fill);
+        if (fill.spot) {
+            group.applySpotFill(fill.quantity, price, getSpotFeeRate());
+        } else {
+            group.applyContractFill(fill.quantity, price, getContractFeeRate());
         }
-        
-        // 7. 更新倉位記錄
-        positionSizes[symbol] = std::make_pair(targetQuantity, contractQty);
-        
-        logger.info(symbol + " 對衝交易完成: " +
-                   "現貨=" + std::to_string(targetQuantity) +
-                   ", 合約=" + std::to_string(contractQty) +
-                   ", 價差=" + std::to_string(balanceCheck.priceDiff * 100) + "%" +
-                   ", 預期收益=" + std::to_string(balanceCheck.expectedProfit) + " USDT");
-                   
+    }
+    bool flat = group.spotQty <= 0 && group.contractQty <= 0;
+    group.state = flat ? TradeGroupState::Closed : TradeGroupState::Open;
+    storage.updateTradeGroup(std::move(group));
+}
+
+double TradingModule::fillPrice(const TradeGroup& group, const LegFill& fill) {
+    if (fill.price > 0) {
+        return fill.price;
+    }
+    if (!fill.orderLinkId.empty()) {
+        Json::Value order = exchange.getOrderByLinkId(fill.spot ? "spot" : "linear", fill.orderLinkId);
+        double price = orderNumber(order["avgPrice"]);
+        if (price > 0) {
+            return price;
+        }
+    }
+    // 減倉不改變均價, 價格只用於估算手續費
+    double average = fill.spot ? group.spotAvgPrice : group.contractAvgPrice;
+    if (fill.quantity < 0 && average > 0) {
+        return average;
+    }
+    logger.warning(group.symbol + " 查詢不到訂單 " + fill.orderLinkId + " 的成交均價, 以行情價格記錄");
+    return fill.spot ? exchange.getSpotPrice(group.symbol) : exchange.getContractPrice(group.symbol);
+}
+
+SliceProgress TradingModule::executeSlicedHedge(const TradeGroup& group, bool increase, double quantity) {
+    const std::string& symbol = group.symbol;
+    HedgeSliceRequest request;
+    request.symbol = symbol;
+    request.spotSide = increase ? "Buy" : "Sell";
+    request.contractSide = increase ? "Sell" : "Buy";
+    request.quantity = quantity;
+    request.minQuantity = getMinOrderSize(symbol);
+    if (increase) {
+        // 與 createSpotOrderIncludeFee 相同的手續費補足
+        double fee = getSpotFeeRate();
+        request.spotQtyMultiplier = 1 + fee * (1 + fee);
+    }
+    request.roundSpot = [this, &symbol](double qty) { return adjustSpotPrecision(qty, symbol); };
+    request.roundContract = [this, &symbol](double qty) { return adjustContractPrecision(qty, symbol); };
+    request.orderLinkId = [&group](char leg, int slice) { return group.orderLinkId(leg, slice); };
+    // 減倉等待執行鎖時在下一個子單前停止
+    request.preempted = [this] {
+        std::lock_guard<std::mutex> pendingLock(deleverageMutex);
+        return deleveragePending > 0;
+    };
+    
+    LOG_INFO(logger, symbol + " 深度不足，切片執行對衝: " + std::to_string(quantity));
+    return slicedExecutor.execute(request, [this](const SliceProgress& progress) {
+        LOG_DEBUG(logger, progress.symbol + " 切片進度: " + std::to_string(progress.slicesDone) +
+                          " 筆, " + std::to_string(progress.completion() * 100) + "%");
+    });
+}
+
+bool TradingModule::basisAllowsEntry(const std::string& symbol) {
+    if (!basisOptions.enabled || basisTracker.verdict(symbol, BasisSide::Entry) != BasisVerdict::Unfavourable) {
         return true;
-        
-    } catch (const std::exception& e) {
-        logger.error("執行對衝交易時發生錯誤: " + std::string(e.what()));
+    }
+    auto basis = basisTracker.snapshot(symbol);
+    BINLOG_INFO(logger, "{} 開倉基差不利, 暫不加倉: 基差={}%, 門檻={}%", logSymbol(symbol),
+                basis->entry * 100, basis->entryThreshold * 100);
+    return false;
+}
+
+bool TradingModule::deferExit(const std::string& symbol) {
+    if (!basisOptions.enabled || basisTracker.verdict(symbol, BasisSide::Exit) != BasisVerdict::Unfavourable) {
+        exitDeferredSince.erase(symbol);
+        return false;
+    }
+    const auto now = clock.now();
+    auto [it, inserted] = exitDeferredSince.emplace(symbol, now);
+    if (now - it->second >= basisOptions.maxExitDelay) {
+        logger.warning(symbol + " 平倉基差持續不利, 已達最長延後時間, 照常平倉");
+        exitDeferredSince.erase(it);
         return false;
     }
+    auto basis = basisTracker.snapshot(symbol);
+    BINLOG_INFO(logger, "{} 平倉基差不利, 延後減倉: 基差={}%, 門檻={}%", logSymbol(symbol),
+                basis->exit * 100, basis->exitThreshold * 100);
+    return true;
+}
+
+void TradingModule::startBasisTracker() {
+    basisTracker.start([this](const std::string& symbol, bool spot) {
+        return parseTopOfBook(spot ? exchange.getSpotOrderBook(symbol) : exchange.getContractOrderBook(symbol));
+    });
+    if (basisTracker.isRunning()) {
+        logger.info("基差追蹤已啟動");
+    }
+}
+
+void TradingModule::stopBasisTracker() {
+    basisTracker.stop();
+}
+
+std::optional<BasisSnapshot> TradingModule::getBasis(const std::string& symbol) const {
+    return basisTracker.snapshot(symbol);
+}
+
+void TradingModule::startRiskMonitor() {
+    if (!riskOptions.enabled) {
+        return;
+    }
+    riskMonitor.start([this](const std::string& symbol) {
+        RequestPriorityScope priorityScope(RequestPriority::Risk);
+        return std::make_pair(exchange.getSpotPrice(symbol), exchange.getContractPrice(symbol));
+    });
+    syncRiskMonitor();
+    logger.info("保證金風險監控已啟動");
+}
+
+void TradingModule::stopRiskMonitor() {
+    riskMonitor.stop();
+}
+
+void TradingModule::startPipeline() {
+    if (!pipelineOptions.enabled || pipeline) {
+        return;
+    }
+    PipelineStages stages;
+    stages.refresh = [this] { refreshFundingRatesNow(); };
+    stages.capture = [this](MarketSnapshot& snapshot) { return captureSnapshot(snapshot); };
+    stages.decide = [this](const MarketSnapshot& snapshot) { return decide(snapshot); };
+    stages.execute = [this](StrategyDecision& decision) { executeDecision(decision); };
+    pipeline = std::make_unique<TradingPipeline>(std::move(stages), pipelineOptions, accountName);
+    pipeline->start();
+    logger.info("行情/策略/執行流水線已啟動");
+}
+
+void TradingModule::stopPipeline() {
+    if (pipeline) {
+        pipeline->stop();
+    }
+}
+
+bool TradingModule::pipelineRunning() const {
+    return pipeline && pipeline->isRunning();
+}
+
+std::optional<PipelineStats> TradingModule::getPipelineStats() const {
+    if (!pipeline) {
+        return std::nullopt;
+    }
+    return pipeline->stats();
+}
+
+void TradingModule::syncRiskMonitor() {
+    std::map<std::string, std::pair<double, double>> book;
+    {
+        std::lock_guard<std::mutex> lock(positionBookMutex);
+        if (!riskMonitor.isRunning() || !positionBookKnown) {
+            return;
+        }
+        book = positionBook;
+    }
+    const std::string groupExchangeId = exchangeId();
+    std::vector<RiskPosition> positions;
+    for (const auto& [symbol, sizes] : book) {
+        RiskPosition position{symbol, sizes.first, sizes.second};
+        if (auto group = storage.findActiveTradeGroup(groupExchangeId, symbol)) {
+            position.contractEntryPrice = group->contractAvgPrice;
+            position.leverage = std::max(group->leverage, 1);
+        }
+        positions.push_back(std::move(position));
+    }
+    riskMonitor.sync(positions, exchange.getTotalEquity());
+}
+
+bool TradingModule::yieldToDeleverage(std::unique_lock<std::mutex>& lock, const std::string& symbol) {
+    std::unique_lock<std::mutex> pendingLock(deleverageMutex);
+    if (deleveragePending > 0) {
+        lock.unlock();
+        deleverageCv.wait(pendingLock, [this] { return deleveragePending == 0; });
+        pendingLock.unlock();
+        lock.lock();
+        pendingLock.lock();
+    }
+    return deleveragedSymbols.count(symbol) > 0;
+}
+
+void TradingModule::deleverage(const RiskAlert& alert) {
+    const std::string& symbol = alert.symbol;
+    {
+        std::lock_guard<std::mutex> pendingLock(deleverageMutex);
+        deleveragePending++;
+    }
+    // 進行中的切片執行在下一個子單前停止, 再平衡在下一個幣種之前讓出執行鎖.
+    // 兩者都檢查 deleveragePending, 不論減倉在執行開始之前或之後到達
+    std::unique_lock<std::mutex> lock(executionMutex);
+    {
+        std::lock_guard<std::mutex> pendingLock(deleverageMutex);
+        deleveragePending--;
+        deleveragedSymbols.insert(symbol);
+    }
+    deleverageCv.notify_all();
+    RequestPriorityScope priorityScope(RequestPriority::OrderEntry);
+
+    double spotHeld = 0.0;
+    double contractHeld = 0.0;
+    {
+        std::lock_guard<std::mutex> bookLock(positionBookMutex);
+        auto it = positionBook.find(symbol);
+        if (it == positionBook.end() || it->second.second <= 0) {
+            return;
+        }
+        spotHeld = it->second.first;
+        contractHeld = it->second.second;
+    }
+    double contractQty = adjustContractPrecision(contractHeld * alert.reduceFraction, symbol);
+    double spotQty = std::min(adjustSpotPrecision(spotHeld * alert.reduceFraction, symbol), spotHeld);
+    if (contractQty < getMinOrderSize(symbol)) {
+        // 倉位太小無法按比例減倉時整個平掉
+        contractQty = contractHeld;
+        spotQty = spotHeld;
+    }
+
+    SymbolRebalance action{symbol, spotHeld, contractHeld, -spotQty, -contractQty, 0, 0.0};
+    TradeGroup group = beginTradeGroup(action);
+    riskReaction().record(std::chrono::steady_clock::now() - alert.tickAt);
+    Json::Value result = exchange.createOrder(symbol, "Buy", contractQty, "linear", "MARKET",
+                                              group.orderLinkId('c'));
+    if (result["retCode"].asInt() != 0) {
+        logger.error("風險減倉合約失敗: " + symbol);
+        handleError(symbol, exchange.getLastError());
+        finishTradeGroup(group, {});
+        return;
+    }
+    group.futuresOrderId = result["result"]["orderId"].asString();
+    std::vector<LegFill> fills{{false, -contractQty, group.orderLinkId('c'), orderNumber(result["result"]["avgPrice"])}};
+
+    double spotTraded = 0.0;
+    if (spotQty > 0) {
+        if (exchange.createSpotOrder(symbol, "Sell", spotQty, group.orderLinkId('s'))) {
+            spotTraded = -spotQty;
+            fills.push_back({true, spotTraded, group.orderLinkId('s')});
+        } else {
+            logger.error("風險減倉現貨失敗, 現貨多於合約: " + symbol);
+            handleError(symbol, exchange.getLastError());
+        }
+    }
+    reducePosition(group, -spotTraded, contractQty);
+    finishTradeGroup(group, fills);
+    logger.warning(symbol + " 風險減倉完成: 合約 -" + std::to_string(contractQty) +
+                   ", 現貨 " + std::to_string(spotTraded));
+}
+
+void TradingModule::reducePosition(const TradeGroup& group, double spotSold, double contractBought) {
+    double spotLeft = 0.0;
+    double contractLeft = 0.0;
+    {
+        std::lock_guard<std::mutex> bookLock(positionBookMutex);
+        auto it = positionBook.find(group.symbol);
+        if (it == positionBook.end()) {
+            return;
+        }
+        spotLeft = std::max(0.0, it->second.first - spotSold);
+        contractLeft = std::max(0.0, it->second.second - contractBought);
+        if (spotLeft <= 0 && contractLeft <= 0) {
+            positionBook.erase(it);
+        } else {
+            it->second = {spotLeft, contractLeft};
+        }
+    }
+    riskMonitor.updatePosition({group.symbol, spotLeft, contractLeft, group.contractAvgPrice,
+                                std::max(group.leverage, 1)});
+}
+
+void TradingModule::cancelExecution() {
+    slicedExecutor.cancel();
+}
+
+SliceProgress TradingModule::getExecutionProgress() const {
+    return slicedExecutor.progress();
 }
 
 // 錯誤處理
 void TradingModule::handleError(const std::string& symbol, const std::string& error) {
     logger.error("交易錯誤: " + error);
     if (error.find("Not supported symbols") != std::string::npos) {
-        updateUnsupportedSymbols(symbol);
+        updateUnsupportedSymbols(symbol, error);
     }
 }
 
 TradingModule::BalanceCheckResult TradingModule::checkPositionBalance(const std::string& symbol, 
                                       double spotSize, 
                                       double contractSize) {
+    TraceSpan span("checkPositionBalance", "strategy", symbol);
+    AllocScope allocScope("cost_estimate");
     BalanceCheckResult result{false, 0.0, 0.0, 0.0, 0.0};
-    logger.info("開始檢查對衝合約現貨組合倉位平衡: " + symbol);
+    LogSymbol logSym = logSymbol(symbol);
+    BINLOG_INFO(logger, "開始檢查對衝合約現貨組合倉位平衡: {}", logSym);
     
     // 獲取配置參數
-    const Config& config = Config::getInstance();
-    double minPositionValue = config.getMinPositionValue();
-    double maxPositionValue = config.getMaxPositionValue();
-    const bool isSpotMarginTradingEnabled = config.isSpotMarginTradingEnabled();
+    const auto config = currentConfig();
+    double minPositionValue = config->minPositionValue;
+    double maxPositionValue = config->maxPositionValue;
+    const bool isSpotMarginTradingEnabled = config->spotMarginTrading;
     
     // 1. 檢查倉位數量是否對等
-    logger.info("現貨倉位: " + std::to_string(spotSize));
-    logger.info("合約倉位: " + std::to_string(contractSize));
+    BINLOG_INFO(logger, "現貨倉位: {}", spotSize);
+    BINLOG_INFO(logger, "合約倉位: {}", contractSize);
     double sizeDiff = std::abs(spotSize - contractSize);
     const double SIZE_DIFF_THRESHOLD = 0.003;  // 0.3% 誤差容忍度
     bool sizeBalanced = (sizeDiff <= std::min(spotSize, contractSize) * SIZE_DIFF_THRESHOLD);
@@ -942,16 +1564,16 @@ TradingModule::BalanceCheckResult TradingModule::checkPositionBalance(const std:
     double pairValue;
     if (isSpotMarginTradingEnabled) {
         pairValue = (spotValue + contractValue) / 2;
-        logger.info("支援現貨保證金，使用平均倉位價值計算");
+        BINLOG_INFO(logger, "支援現貨保證金，使用平均倉位價值計算");
     } else {
         pairValue = spotValue + contractValue;
-        logger.info("不支援現貨保證金，使用對衝組合總倉位價值計算");
+        BINLOG_INFO(logger, "不支援現貨保證金，使用對衝組合總倉位價值計算");
     }
     
-    logger.info("倉位價值計算:");
-    logger.info("- 現貨價值: " + std::to_string(spotValue) + " USDT");
-    logger.info("- 合約價值: " + std::to_string(contractValue) + " USDT");
-    logger.info("- 對衝組合總倉位價值: " + std::to_string(pairValue) + " USDT");
+    BINLOG_INFO(logger, "倉位價值計算:");
+    BINLOG_INFO(logger, "- 現貨價值: {} USDT", spotValue);
+    BINLOG_INFO(logger, "- 合約價值: {} USDT", contractValue);
+    BINLOG_INFO(logger, "- 對衝組合總倉位價值: {} USDT", pairValue);
     
     // 4. 檢查倉位價值是否在允許範圍內
     bool valueInRange = (pairValue >= minPositionValue && pairValue <= maxPositionValue);
@@ -960,12 +1582,19 @@ TradingModule::BalanceCheckResult TradingModule::checkPositionBalance(const std:
     double predictedSpotSize = minPositionValue / spotPrice;
     double predictedContractSize = minPositionValue / contractPrice;
     
-    // 6. 計算價格差
-    result.priceDiff = std::abs(spotPrice - contractPrice) / spotPrice;
-    
-    // 7. 分別計算現貨和合約的深度影響
+    // 6. 計算價格差: 優先使用同步的最佳買賣價基差, 取不到時退回兩次行情查詢的差值
     auto spotOrderbook = exchange.getSpotOrderBook(symbol);
+    basisTracker.onSpotQuote(symbol, parseTopOfBook(spotOrderbook));
     auto contractOrderbook = exchange.getContractOrderBook(symbol);
+    basisTracker.onPerpQuote(symbol, parseTopOfBook(contractOrderbook));
+    auto basis = basisTracker.snapshot(symbol);
+    if (basis && basis->fresh) {
+        result.priceDiff = std::abs(basis->mid);
+    } else {
+        result.priceDiff = std::abs(spotPrice - contractPrice) / spotPrice;
+    }
+    
+    // 7. 分別計算現貨和合約的深度影響
     
     double spotDepthImpact = calculateDepthImpact(spotOrderbook, predictedSpotSize);
     double contractDepthImpact = calculateDepthImpact(contractOrderbook, predictedContractSize);
@@ -978,7 +1607,8 @@ TradingModule::BalanceCheckResult TradingModule::checkPositionBalance(const std:
     double contractCost = calculateRebalanceCost(symbol, predictedContractSize, false, contractOrderbook); // false 表示合約
     result.estimatedCost = spotCost + contractCost;
     
-    double fundingRate = exchange.getCurrentFundingRate(symbol);
+    // 費率取不到時按 0 估算收益, 不觸發重平衡
+    double fundingRate = exchange.getCurrentFundingRate(symbol).value_or(0.0);
     // 使用較小的倉位大小計算預期收益（保守估計）
     double minSize = std::min(predictedSpotSize, predictedContractSize);
     result.expectedProfit = calculateExpectedProfit(minSize, fundingRate);
@@ -995,24 +1625,22 @@ TradingModule::BalanceCheckResult TradingModule::checkPositionBalance(const std:
         (result.expectedProfit > result.estimatedCost * MIN_PROFIT_RATIO);
     
     // 10. 記錄詳細日誌
-    logger.info(symbol + " 倉位檢查結果:");
-    logger.info("- 現貨倉位: " + std::to_string(spotSize) + 
-               " (" + std::to_string(spotValue) + " USDT)");
-    logger.info("- 合約倉位: " + std::to_string(contractSize) + 
-               " (" + std::to_string(contractValue) + " USDT)");
-    logger.info("- 倉位數量對等: " + std::string(sizeBalanced ? "是" : "否"));
-    logger.info("- 倉位價值在範圍內: " + std::string(valueInRange ? "是" : "否"));
-    logger.info("- 預測現貨倉位: " + std::to_string(predictedSpotSize));
-    logger.info("- 預測合約倉位: " + std::to_string(predictedContractSize));
-    logger.info("- 價格差異: " + std::to_string(result.priceDiff * 100) + "%");
-    logger.info("- 現貨深度影響: " + std::to_string(spotDepthImpact * 100) + "%");
-    logger.info("- 合約深度影響: " + std::to_string(contractDepthImpact * 100) + "%");
-    logger.info("- 最終深度影響: " + std::to_string(result.depthImpact * 100) + "%");
-    logger.info("- 現貨預估成本: " + std::to_string(spotCost) + " USDT");
-    logger.info("- 合約預估成本: " + std::to_string(contractCost) + " USDT");
-    logger.info("- 總預估成本: " + std::to_string(result.estimatedCost) + " USDT");
-    logger.info("- 預期收益: " + std::to_string(result.expectedProfit) + " USDT");
-    logger.info("- 需要重平衡: " + std::string(result.needBalance ? "是" : "否"));
+    BINLOG_INFO(logger, "{} 倉位檢查結果:", logSym);
+    BINLOG_INFO(logger, "- 現貨倉位: {} ({} USDT)", spotSize, spotValue);
+    BINLOG_INFO(logger, "- 合約倉位: {} ({} USDT)", contractSize, contractValue);
+    BINLOG_INFO(logger, "- 倉位數量對等: {}", sizeBalanced ? "是" : "否");
+    BINLOG_INFO(logger, "- 倉位價值在範圍內: {}", valueInRange ? "是" : "否");
+    BINLOG_INFO(logger, "- 預測現貨倉位: {}", predictedSpotSize);
+    BINLOG_INFO(logger, "- 預測合約倉位: {}", predictedContractSize);
+    BINLOG_INFO(logger, "- 價格差異: {}%", result.priceDiff * 100);
+    BINLOG_INFO(logger, "- 現貨深度影響: {}%", spotDepthImpact * 100);
+    BINLOG_INFO(logger, "- 合約深度影響: {}%", contractDepthImpact * 100);
+    BINLOG_INFO(logger, "- 最終深度影響: {}%", result.depthImpact * 100);
+    BINLOG_INFO(logger, "- 現貨預估成本: {} USDT", spotCost);
+    BINLOG_INFO(logger, "- 合約預估成本: {} USDT", contractCost);
+    BINLOG_INFO(logger, "- 總預估成本: {} USDT", result.estimatedCost);
+    BINLOG_INFO(logger, "- 預期收益: {} USDT", result.expectedProfit);
+    BINLOG_INFO(logger, "- 需要重平衡: {}", result.needBalance ? "是" : "否");
     
     return result;
 }
@@ -1032,47 +1660,42 @@ double TradingModule::calculateDepthImpact(const Json::Value& orderbook, double
         const Json::Value& asks = orderbook["result"]["a"];
         
         // 獲取基準價格（第一個賣單價格）
-        if (!asks[0].isArray() || asks[0].size() < 2) {
+        BookLevel best;
+        if (!parseBookLevel(asks[0], best)) {
             logger.error("訂單簿價格數據格式無效");
             return 0.0;
         }
         
-        double basePrice = std::stod(asks[0][0].asString());
+        double basePrice = best.price;
         
-        // 遍歷賣單計算滑點
-        for (const auto& level : asks) {
-            if (!level.isArray() || level.size() < 2) {
+        // 遍歷賣單計算滑點 (直接解析 JSON 字串, 不建立臨時字串)
+        BookLevel level;
+        for (const auto& entry : asks) {
+            if (!parseBookLevel(entry, level)) {
+                BINLOG_DEBUG(logger, "跳過無效的深度級別");
                 continue;
             }
+            double price = level.price;
+            double quantity = level.quantity;
             
-            try {
-                double price = std::stod(level[0].asString());
-                double quantity = std::stod(level[1].asString());
-                
-                double levelImpact = 0.0;
-                if (remainingSize <= quantity) {
-                    levelImpact = remainingSize * (price - basePrice) / basePrice;
-                    totalImpact += levelImpact;
-                    break;
-                } else {
-                    levelImpact = quantity * (price - basePrice) / basePrice;
-                    totalImpact += levelImpact;
-                    remainingSize -= quantity;
-                }
-                
-                logger.debug("深度級別: 價格=" + std::to_string(price) + 
-                           ", 數量=" + std::to_string(quantity) + 
-                           ", 影響=" + std::to_string(levelImpact));
-                
-            } catch (const std::exception& e) {
-                logger.error("處理深度數據時發生錯誤: " + std::string(e.what()));
-                continue;
+            double levelImpact = 0.0;
+            if (remainingSize <= quantity) {
+                levelImpact = remainingSize * (price - basePrice) / basePrice;
+                totalImpact += levelImpact;
+                remainingSize = 0.0;
+                break;
+            } else {
+                levelImpact = quantity * (price - basePrice) / basePrice;
+                totalImpact += levelImpact;
+                remainingSize -= quantity;
             }
+            
+            BINLOG_DEBUG(logger, "深度級別: 價格={}, 數量={}, 影響={}", price, quantity, levelImpact);
         }
         
         // 如果還有剩餘未匹配的數量，記錄警告
         if (remainingSize > 0) {
-            logger.warning("深度不足以完全匹配訂單大小，剩餘: " + std::to_string(remainingSize));
+            BINLOG_WARNING(logger, "深度不足以完全匹配訂單大小，剩餘: {}", remainingSize);
         }
         
         return size != 0 ? totalImpact / std::abs(size) : 0.0;
@@ -1095,19 +1718,25 @@ double TradingModule::calculateRebalanceCost(const std::string& symbol, double s
         }
 
         // 獲取對應的手續費率
-        double feeRate = isSpot ? exchange.getSpotFeeRate() : exchange.getContractFeeRate();
+        double feeRate = isSpot ? getSpotFeeRate() : getContractFeeRate();
         
         // 計算滑點成本
         double remainingSize = size;
         double totalCost = 0.0;
         const Json::Value& asks = orderbook["result"]["a"];
-        double basePrice = std::stod(asks[0][0].asString());  // 最佳賣價作為基準價格
+        BookLevel best;
+        if (!parseBookLevel(asks[0], best)) {
+            logger.error(std::string(isSpot ? "現貨" : "合約") + "訂單簿價格數據格式無效");
+            return 0.0;
+        }
+        double basePrice = best.price;  // 最佳賣價作為基準價格
         
-        for (const auto& level : asks) {
-            if (!level.isArray() || level.size() < 2) continue;
+        BookLevel level;
+        for (const auto& entry : asks) {
+            if (!parseBookLevel(entry, level)) continue;
             
-            double price = std::stod(level[0].asString());
-            double quantity = std::stod(level[1].asString());
+            double price = level.price;
+            double quantity = level.quantity;
             
             if (remainingSize <= quantity) {
                 // 最後一筆訂單
@@ -1127,13 +1756,10 @@ double TradingModule::calculateRebalanceCost(const std::string& symbol, double s
         double totalRebalanceCost = totalCost + tradingFee;
         
         // 記錄詳細成本信息
-        logger.info(std::string(isSpot ? "現貨" : "合約") + "重平衡成本計算:");
-        logger.info("- 基準價格: " + std::to_string(basePrice) + " USDT");
-        logger.info("- 交易數量: " + std::to_string(size));
-        logger.info("- 滑點成本: " + std::to_string(totalCost) + " USDT");
-        logger.info("- 手續費率: " + std::to_string(feeRate * 100) + "%");
-        logger.info("- 手續費成本: " + std::to_string(tradingFee) + " USDT");
-        logger.info("- 總成本: " + std::to_string(totalRebalanceCost) + " USDT");
+        BINLOG_DEBUG(logger, "{}重平衡成本: 基準價格={} USDT, 交易數量={}, 滑點成本={} USDT, "
+                     "手續費率={}%, 手續費成本={} USDT, 總成本={} USDT",
+                     isSpot ? "現貨" : "合約", basePrice, size, totalCost, feeRate * 100,
+                     tradingFee, totalRebalanceCost);
         
         return totalRebalanceCost;
         
@@ -1149,7 +1775,7 @@ double TradingModule::calculateExpectedProfit(double size, double fundingRate) {
     double annualRate = fundingRate * 3 * 365;
     
     // 從設定檔獲取預期持有天數
-    const int holdingDays = Config::getInstance().getFundingHoldingDays();
+    const int holdingDays = currentConfig()->fundingHoldingDays;
     
     // 年化轉換為持有收益
     double periodRate = annualRate * (holdingDays / 365.0);
@@ -1158,12 +1784,13 @@ double TradingModule::calculateExpectedProfit(double size, double fundingRate) {
 }
 
 
-bool TradingModule::createSpotOrderIncludeFee(const std::string& symbol, const std::string& side, double qty) {
-    double fee = exchange.getSpotFeeRate();
+bool TradingModule::createSpotOrderIncludeFee(const std::string& symbol, const std::string& side, double qty,
+                                              const std::string& orderLinkId) {
+    double fee = getSpotFeeRate();
     qty = qty * (1 + fee * ( 1 + fee )); //現貨倉位
     qty = adjustSpotPrecision(qty, symbol);
-    logger.info("實際現貨含手續費下單倉位: " + std::to_string(qty) + " " + symbol);
-    return exchange.createSpotOrder(symbol, side, qty);
+    LOG_INFO(logger, "實際現貨含手續費下單倉位: " + std::to_string(qty) + " " + symbol);
+    return exchange.createSpotOrder(symbol, side, qty, orderLinkId);
 }
 
 
@@ -1174,7 +1801,7 @@ double TradingModule::calculateTotalPositionValue(
     const std::map<std::string, std::pair<double, double>>* prices = nullptr) {
     
     double totalValue = 0.0;
-    const bool isSpotMarginTradingEnabled = Config::getInstance().isSpotMarginTradingEnabled();
+    const bool isSpotMarginTradingEnabled = currentConfig()->spotMarginTrading;
     
     for (const auto& [symbol, position] : positions) {
         double spotValue = 0.0;
@@ -1192,11 +1819,9 @@ double TradingModule::calculateTotalPositionValue(
                     spotValue = position.first * spotPrice;
                     contractValue = position.second * contractPrice;
                     
-                    logger.debug(symbol + " 倉位計算: " 
-                        + "現貨=" + std::to_string(spotValue) + " USDT"
-                        + " (" + std::to_string(position.first) + "*" + std::to_string(spotPrice) + ")"
-                        + ", 合約=" + std::to_string(contractValue) + " USDT"
-                        + " (" + std::to_string(position.second) + "*" + std::to_string(contractPrice) + ")");
+                    BINLOG_DEBUG(logger, "{} 倉位計算: 現貨={} USDT ({}*{}), 合約={} USDT ({}*{})",
+                                 logSymbol(symbol), spotValue, position.first, spotPrice,
+                                 contractValue, position.second, contractPrice);
                 }
             }
         } else if (!positionsIsSize && prices == nullptr) {
@@ -1212,11 +1837,9 @@ double TradingModule::calculateTotalPositionValue(
                 spotValue = position.first * spotPrice;
                 contractValue = position.second * contractPrice;
                 
-                logger.debug(symbol + " 倉位計算: " 
-                    + "現貨=" + std::to_string(spotValue) + " USDT"
-                    + " (" + std::to_string(position.first) + "*" + std::to_string(spotPrice) + ")"
-                    + ", 合約=" + std::to_string(contractValue) + " USDT"
-                    + " (" + std::to_string(position.second) + "*" + std::to_string(contractPrice) + ")");
+                BINLOG_DEBUG(logger, "{} 倉位計算: 現貨={} USDT ({}*{}), 合約={} USDT ({}*{})",
+                             logSymbol(symbol), spotValue, position.first, spotPrice,
+                             contractValue, position.second, contractPrice);
             }
         }
         
@@ -1228,15 +1851,17 @@ double TradingModule::calculateTotalPositionValue(
         }
     }
     
-    logger.info("總倉位價值: " + std::to_string(totalValue) + " USDT" + 
-                (isSpotMarginTradingEnabled ? " (使用平均值計算)" : " (使用總和計算)"));
+    BINLOG_INFO(logger, "總倉位價值: {} USDT ({})", totalValue,
+                isSpotMarginTradingEnabled ? "使用平均值計算" : "使用總和計算");
     
     return totalValue;
 }
 
 void TradingModule::displayPositions() {
+    // 顯示請求只用剩餘額度, 行情沿用策略已取得的緩存
+    RequestPriorityScope priorityScope(RequestPriority::Display);
     Logger logger;
-    const bool isSpotMarginTradingEnabled = Config::getInstance().isSpotMarginTradingEnabled();
+    const bool isSpotMarginTradingEnabled = currentConfig()->spotMarginTrading;
     
     // 獲取資金費率排行
     auto topRates = getTopFundingRates();
@@ -1288,7 +1913,7 @@ void TradingModule::displayPositions() {
                 
                 double positionValue = std::stod(pos["positionValue"].asString());
                 double price = std::stod(pos["avgPrice"].asString());
-                double fundingRate = exchange.getCurrentFundingRate(symbol);
+                double fundingRate = exchange.getCurrentFundingRate(symbol).value_or(0.0);
                 symbolValues[symbol].second = positionValue;
                 
                 std::cout << std::left
@@ -1329,7 +1954,7 @@ void TradingModule::displayPositions() {
                     
                     double spotPrice = exchange.getSpotPrice(pairSymbol);
                     double positionValue = size * spotPrice;
-                    double fundingRate = exchange.getCurrentFundingRate(pairSymbol);
+                    double fundingRate = exchange.getCurrentFundingRate(pairSymbol).value_or(0.0);
                     symbolValues[pairSymbol].first = positionValue;
                     
                     if (positionValue > 0) {
@@ -1369,104 +1994,31 @@ void TradingModule::displayPositions() {
     }
 }
 
+// 只讀取緩存的列表, 刷新由 UniverseProvider 的背景線程完成.
+// 第一次使用時建立; 沒有任何緩存 (首次啟動) 才會同步等待一次
 std::vector<std::string> TradingModule::getSymbolsByCMC(int topCount) {
-    Logger logger;
-    std::vector<std::string> selectedSymbols;
-    const Config& config = Config::getInstance();
-    
-    
-    try {
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            logger.error("無法初始化 CURL");
-            return {};
-        }
-        const std::string& sortBy = config.getCMCSortBy();
-        logger.info("開始從 CMC 獲取交易對列表 " + std::to_string(topCount) + " 個，排序方式: " + sortBy);
-
-        
-        // 設置 API 請求
-        std::string apiKey = config.getCMCApiKey();
-        std::string url = "https://pro-api.coinmarketcap.com/v1/cryptocurrency/listings/latest?sort=" + sortBy + "&limit=" 
-        + std::to_string(topCount) + "&aux=" + sortBy;
-        logger.debug("請求 URL: " + url);
-        
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, ("X-CMC_PRO_API_KEY: " + apiKey).c_str());
-        headers = curl_slist_append(headers, "Accept: application/json");
-        
-        std::string response;
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        
-        CURLcode res = curl_easy_perform(curl);
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
-        
-        if (res != CURLE_OK) {
-            logger.error("CMC API 請求失敗: " + std::string(curl_easy_strerror(res)));
-            return {};
+    if (!universeProvider) {
+        cmcSource = CoinMarketCapSource::fromConfig();
+        universeProvider = std::make_unique<UniverseProvider>(*cmcSource, clock,
+                                                              fromAccountConfig(UniverseOptions::fromConfig));
+        // 冷啟動時先同步獲取, 再啟動背景線程, 避免背景線程的首次刷新重複請求 CMC
+        if (!universeProvider->loadCache()) {
+            logger.info("沒有可用的幣種列表緩存, 同步獲取 CMC 數據");
+            universeProvider->refresh();
         }
-        
-        logger.debug("收到 CMC 響應，長度: " + std::to_string(response.length()));
-        // logger.debug("收到 CMC 響應: " + response);
+        universeProvider->start();
+    } else if (universeProvider->empty()) {
+        logger.info("沒有可用的幣種列表, 同步獲取 CMC 數據");
+        universeProvider->refresh();
+    }
 
-        
-        // 解析 JSON 響應
-        Json::Value root;
-        Json::Reader reader;
-        if (!reader.parse(response, root)) {
-            logger.error("解析 CMC 響應失敗");
-            logger.debug("響應內容: " + response);
-            return {};
-        }
-        
-        // 檢查錯誤狀態
-        if (root.isMember("status")) {
-            logger.debug("API 狀態: " + root["status"]["error_message"].asString());
-        }
-        
-        // 處理數據
-        if (root["data"].isArray()) {
-            
-            for (const auto& coin : root["data"]) {
-                if (selectedSymbols.size() >= static_cast<size_t>(topCount)) {
-                    logger.debug("已達到設定的 Top " + std::to_string(topCount) + " 數量，停止處理");
-                    break;
-                }
-                
-                std::string symbol = coin["symbol"].asString() + "USDT";
-                // double sortByValue = coin["quote"]["USD"][sortBy].asDouble();
-                // logger.debug(symbol + " - " + sortBy + ": " + std::to_string(sortByValue));
-                selectedSymbols.push_back(symbol);
-            }
-            
-            // 顯示選中的交易對
-            logger.info("根據 " + sortBy + " 排序選擇了 " + 
-                       std::to_string(selectedSymbols.size()) + " 個交易對:");
-            for (const auto& symbol : selectedSymbols) {
-                logger.info("- " + symbol);
-            }
-        } else {
-            logger.error("CMC 響應中沒有找到數據數組");
-            logger.debug("響應內容: " + response);
-        }
-        
-    } catch (const std::exception& e) {
-        logger.error("獲取 CMC 數據時發生錯誤: " + std::string(e.what()));
+    std::vector<std::string> selectedSymbols = universeProvider->symbols();
+    if (selectedSymbols.size() > static_cast<size_t>(topCount)) {
+        selectedSymbols.resize(topCount);
     }
-    
     return selectedSymbols;
 }
 
-size_t TradingModule::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-    ((std::string*)userp)->append((char*)contents, size * nmemb);
-    return size * nmemb;
-}
-
-
 void TradingModule::displayPositionSizes(
     const std::map<std::string, std::pair<double, double>>& positionSizes) {
     
@@ -0,0 +1,230 @@
+#include "trading/universe_provider.h"
+#include "config.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <json/json.h>
+
+namespace {
+
+// 系統時間可能被調整, 背景線程最長每分鐘重新計算一次下次刷新時間
+constexpr std::chrono::seconds MAX_WAIT{60};
+
+} // namespace
+
+UniverseOptions UniverseOptions::fromConfig() {
+    UniverseOptions options;
+    const Config& config = Config::getInstance();
+    options.topCount = config.getCMCTopCount();
+    options.sortBy = config.getCMCSortBy();
+    if (!config.hasCMCCacheConfig()) {
+        return options;
+    }
+    options.cachePath = config.getCMCCachePath();
+    if (config.getCMCCacheTtlMinutes() > 0) {
+        options.ttl = std::chrono::minutes(config.getCMCCacheTtlMinutes());
+    }
+    if (config.getCMCRetryMinutes() > 0) {
+        options.retryInterval = std::chrono::minutes(config.getCMCRetryMinutes());
+    }
+    return options;
+}
+
+UniverseProvider::UniverseProvider(IUniverseSource& source, IClock& clock, const UniverseOptions& options) :
+    source(source), clock(clock), options(options) {}
+
+UniverseProvider::~UniverseProvider() {
+    stop();
+}
+
+std::vector<std::string> UniverseProvider::symbols() {
+    std::shared_ptr<const CacheEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        entry = current;
+        if (!entry || clock.now() - entry->fetchedAt >= options.ttl) {
+            wakeRequested = true;
+        }
+    }
+    workerCv.notify_all();
+    return entry ? entry->symbols : std::vector<std::string>{};
+}
+
+bool UniverseProvider::empty() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return !current;
+}
+
+bool UniverseProvider::isStale() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return !current || clock.now() - current->fetchedAt >= options.ttl;
+}
+
+IClock::TimePoint UniverseProvider::fetchedAt() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return current ? current->fetchedAt : IClock::TimePoint();
+}
+
+bool UniverseProvider::refresh() {
+    std::lock_guard<std::mutex> refreshLock(refreshMutex);
+    const auto now = clock.now();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        lastAttempt = now;
+    }
+
+    std::vector<std::string> fetched;
+    std::string error;
+    bool ok = false;
+    try {
+        ok = source.fetch(options.topCount, options.sortBy, fetched, error);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    if (!ok || fetched.empty()) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        lastAttemptFailed = true;
+        logger.warning("刷新幣種列表失敗, " +
+                       std::string(current ? "沿用上一份列表" : "目前沒有可用列表") + ": " + error);
+        return false;
+    }
+
+    auto entry = std::make_shared<CacheEntry>(CacheEntry{std::move(fetched), now});
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        current = entry;
+        lastAttemptFailed = false;
+    }
+    logger.info("已刷新幣種列表: " + std::to_string(entry->symbols.size()) + " 個, 排序方式: " + options.sortBy);
+    saveCache(*entry);
+    return true;
+}
+
+bool UniverseProvider::refreshIfDue() {
+    std::unique_lock<std::mutex> refreshLock(refreshMutex);
+    {
+        // 等待期間可能已有同步刷新完成 (例如冷啟動時), 不再重複請求
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (clock.now() < nextRefreshLocked()) {
+            return false;
+        }
+    }
+    refreshLock.unlock();
+    return refresh();
+}
+
+bool UniverseProvider::loadCache() {
+    if (options.cachePath.empty()) {
+        return false;
+    }
+    std::ifstream in(options.cachePath);
+    if (!in.is_open()) {
+        return false;
+    }
+    Json::Value root;
+    Json::Reader reader;
+    if (!reader.parse(in, root)) {
+        logger.warning("幣種列表緩存無法解析: " + options.cachePath);
+        return false;
+    }
+    // 排序方式或數量變更後舊緩存不再適用
+    if (root["sort_by"].asString() != options.sortBy || root["top_count"].asInt() != options.topCount) {
+        logger.info("幣種列表緩存參數已變更, 忽略緩存");
+        return false;
+    }
+
+    auto entry = std::make_shared<CacheEntry>();
+    entry->fetchedAt = IClock::TimePoint(std::chrono::seconds(root["fetched_at"].asInt64()));
+    for (const auto& symbol : root["symbols"]) {
+        entry->symbols.push_back(symbol.asString());
+    }
+    if (entry->symbols.empty()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(stateMutex);
+    current = entry;
+    logger.info("已載入幣種列表緩存: " + std::to_string(entry->symbols.size()) + " 個, 取得時間 " +
+                formatUTC(entry->fetchedAt));
+    return true;
+}
+
+bool UniverseProvider::saveCache(const CacheEntry& entry) {
+    if (options.cachePath.empty()) {
+        return true;
+    }
+    Json::Value root;
+    root["sort_by"] = options.sortBy;
+    root["top_count"] = options.topCount;
+    root["fetched_at"] = Json::Int64(
+        std::chrono::duration_cast<std::chrono::seconds>(entry.fetchedAt.time_since_epoch()).count());
+    root["symbols"] = Json::Value(Json::arrayValue);
+    for (const auto& symbol : entry.symbols) {
+        root["symbols"].append(symbol);
+    }
+
+    std::filesystem::path path(options.cachePath);
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    std::string tempPath = options.cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::trunc);
+        if (!out.is_open()) {
+            logger.error("無法寫入幣種列表緩存: " + tempPath);
+            return false;
+        }
+        Json::StyledWriter writer;
+        out << writer.write(root);
+    }
+    std::filesystem::rename(tempPath, path, ec);
+    return !ec;
+}
+
+IClock::TimePoint UniverseProvider::nextRefreshLocked() const {
+    if (!current || lastAttemptFailed) {
+        return lastAttempt == IClock::TimePoint() ? lastAttempt : lastAttempt + options.retryInterval;
+    }
+    return current->fetchedAt + options.ttl;
+}
+
+void UniverseProvider::start() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (running) {
+        return;
+    }
+    running = true;
+    worker = std::thread(&UniverseProvider::run, this);
+}
+
+void UniverseProvider::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    workerCv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void UniverseProvider::run() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    while (running) {
+        wakeRequested = false;
+        const auto now = clock.now();
+        const auto next = nextRefreshLocked();
+        if (now >= next) {
+            lock.unlock();
+            refreshIfDue();
+            lock.lock();
+            continue;
+        }
+        // 讀取端的喚醒只觸發重新計算, 失敗後仍遵守重試間隔
+        auto wait = std::min<IClock::Clock::duration>(next - now, MAX_WAIT);
+        workerCv.wait_for(lock, wait, [this] { return !running || wakeRequested; });
+    }
+}
@@ -0,0 +1,119 @@
+#include "trading/warm_state.h"
+#include "config.h"
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+constexpr int WARM_STATE_VERSION = 1;
+
+Json::Int64 toMillis(IClock::TimePoint time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+IClock::TimePoint fromMillis(const Json::Value& value) {
+    return IClock::TimePoint(std::chrono::milliseconds(value.asInt64()));
+}
+
+} // namespace
+
+WarmStateOptions WarmStateOptions::fromConfig() {
+    WarmStateOptions options;
+    const Config& config = Config::getInstance();
+    if (!config.hasWarmStateConfig()) {
+        return options;
+    }
+    options.path = config.getWarmStatePath();
+    if (config.getWarmStateMaxAgeMinutes() > 0) {
+        options.maxAge = std::chrono::minutes(config.getWarmStateMaxAgeMinutes());
+    }
+    return options;
+}
+
+Json::Value WarmState::toJson() const {
+    Json::Value root;
+    root["version"] = WARM_STATE_VERSION;
+    root["saved_at"] = toMillis(savedAt);
+    root["ranked_at"] = toMillis(rankedAt);
+    root["rankings"] = Json::Value(Json::arrayValue);
+    for (const auto& [symbol, score] : rankings) {
+        Json::Value entry(Json::arrayValue);
+        entry.append(symbol);
+        entry.append(score);
+        root["rankings"].append(entry);
+    }
+    root["spot_fee_rate"] = spotFeeRate;
+    root["contract_fee_rate"] = contractFeeRate;
+    if (positionsKnown) {
+        root["positions"] = Json::Value(Json::objectValue);
+        for (const auto& [symbol, sizes] : positions) {
+            Json::Value entry(Json::arrayValue);
+            entry.append(sizes.first);
+            entry.append(sizes.second);
+            root["positions"][symbol] = entry;
+        }
+    }
+    return root;
+}
+
+std::optional<WarmState> WarmState::fromJson(const Json::Value& root) {
+    if (!root.isObject() || root["version"].asInt() != WARM_STATE_VERSION) {
+        return std::nullopt;
+    }
+    WarmState state;
+    state.savedAt = fromMillis(root["saved_at"]);
+    state.rankedAt = fromMillis(root["ranked_at"]);
+    for (const auto& entry : root["rankings"]) {
+        if (entry.isArray() && entry.size() == 2) {
+            state.rankings.emplace_back(entry[0].asString(), entry[1].asDouble());
+        }
+    }
+    state.spotFeeRate = root.get("spot_fee_rate", -1.0).asDouble();
+    state.contractFeeRate = root.get("contract_fee_rate", -1.0).asDouble();
+    const Json::Value& positions = root["positions"];
+    if (positions.isObject()) {
+        state.positionsKnown = true;
+        for (const auto& symbol : positions.getMemberNames()) {
+            const Json::Value& entry = positions[symbol];
+            if (entry.isArray() && entry.size() == 2) {
+                state.positions[symbol] = {entry[0].asDouble(), entry[1].asDouble()};
+            }
+        }
+    }
+    return state;
+}
+
+bool WarmState::save(const std::string& path) const {
+    std::filesystem::path target(path);
+    std::error_code ec;
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), ec);
+    }
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        Json::FastWriter writer;
+        out << writer.write(toJson());
+        if (!out) {
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, target, ec);
+    return !ec;
+}
+
+std::optional<WarmState> WarmState::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return std::nullopt;
+    }
+    Json::Value root;
+    Json::Reader reader;
+    if (!reader.parse(in, root)) {
+        return std::nullopt;
+    }
+    return fromJson(root);
+}
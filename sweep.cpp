@@ -0,0 +1,148 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include "include/config.h"
+#include "backtest/market_history.h"
+#include "backtest/parameter_sweep.h"
+#include "scheduler/settlement_calendar.h"
+
+// 參數搜索工具: 以歷史數據並行評估資金費率評分及倉位縮放參數
+//   ./sweep <data_dir> <space.json> [--start YYYY-MM-DD] [--end YYYY-MM-DD]
+//           [--random N] [--seed S] [--threads N] [--capital USDT]
+//           [--drawdown-penalty X] [--top K] [--output results.csv]
+// 未在搜索空間中指定的參數取自 config/config.json
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "用法: " << program
+              << " <data_dir> <space.json> [--start YYYY-MM-DD] [--end YYYY-MM-DD]"
+              << " [--random N] [--seed S] [--threads N] [--capital USDT]"
+              << " [--drawdown-penalty X] [--top K] [--output results.csv]" << std::endl;
+}
+
+IClock::TimePoint parseDate(const std::string& text) {
+    std::tm tm = {};
+    std::istringstream ss(text);
+    ss >> std::get_time(&tm, "%Y-%m-%d");
+    if (ss.fail()) {
+        throw std::invalid_argument("日期格式錯誤: " + text);
+    }
+    return IClock::Clock::from_time_t(timegm(&tm));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        std::string dataDir = argv[1];
+        std::string spacePath = argv[2];
+        IClock::TimePoint start, end;
+        size_t randomCount = 0;
+        uint32_t seed = 42;
+        unsigned threads = 0;
+        double drawdownPenalty = 1.0;
+        size_t top = 20;
+        std::string outputPath;
+        SweepCosts costs;
+        costs.leverage = Config::getInstance().getDefaultLeverage();
+
+        for (int i = 3; i < argc; i++) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            std::string value = argv[++i];
+            if (arg == "--start") {
+                start = parseDate(value);
+            } else if (arg == "--end") {
+                end = parseDate(value);
+            } else if (arg == "--random") {
+                randomCount = std::stoul(value);
+            } else if (arg == "--seed") {
+                seed = static_cast<uint32_t>(std::stoul(value));
+            } else if (arg == "--threads") {
+                threads = static_cast<unsigned>(std::stoul(value));
+            } else if (arg == "--capital") {
+                costs.initialCapital = std::stod(value);
+            } else if (arg == "--drawdown-penalty") {
+                drawdownPenalty = std::stod(value);
+            } else if (arg == "--top") {
+                top = std::stoul(value);
+            } else if (arg == "--output") {
+                outputPath = value;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+
+        SweepParams base{ScoringParams::fromConfig(), PositionSizing::fromConfig()};
+        SweepSpace space = SweepSpace::loadFromFile(spacePath);
+        auto candidates = randomCount > 0 ? space.random(base, randomCount, seed) : space.grid(base);
+        if (candidates.empty()) {
+            std::cerr << "搜索空間沒有有效的參數組合" << std::endl;
+            return 1;
+        }
+
+        int lookback = 0;
+        for (const auto& candidate : candidates) {
+            lookback = std::max(lookback, candidate.scoring.maxLookback());
+        }
+
+        auto history = MarketHistory::loadFromDirectory(dataDir);
+        if (start == IClock::TimePoint()) {
+            start = IClock::TimePoint(std::chrono::milliseconds(history->firstTimestamp()));
+        }
+        if (end == IClock::TimePoint()) {
+            end = IClock::TimePoint(std::chrono::milliseconds(history->lastTimestamp()));
+        }
+        auto dataset = SweepDataset::build(*history, SettlementCalendar::fromConfig(), start, end, lookback);
+        std::cout << "決策時點: " << dataset->stepCount() << ", 幣對: " << dataset->symbolCount()
+                  << ", 參數組合: " << candidates.size() << std::endl;
+
+        ParameterSweep sweep(dataset, costs);
+        auto started = std::chrono::steady_clock::now();
+        auto results = sweep.run(candidates, threads, [](size_t done, size_t total) {
+            std::cerr << "\r評估進度: " << done << "/" << total << std::flush;
+        });
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started);
+        std::cerr << std::endl;
+        ParameterSweep::rank(results, drawdownPenalty);
+
+        std::cout << "耗時: " << std::fixed << std::setprecision(2) << elapsed.count() << " 秒 ("
+                  << (threads ? threads : std::thread::hardware_concurrency()) << " 線程)" << std::endl;
+        std::cout << "\n=== 參數排名 (報酬 - " << drawdownPenalty << " x 最大回撤) ===" << std::endl;
+        for (size_t i = 0; i < results.size() && i < top; i++) {
+            const SweepResult& r = results[i];
+            std::cout << std::setw(3) << i + 1 << ". "
+                      << "報酬 " << std::setw(7) << std::setprecision(2) << r.totalReturn * 100 << "% "
+                      << "回撤 " << std::setw(6) << r.maxDrawdown * 100 << "% "
+                      << (r.paretoOptimal ? "* " : "  ")
+                      << candidates[r.candidate].describe() << std::endl;
+        }
+
+        if (!outputPath.empty()) {
+            std::ofstream out(outputPath);
+            if (!out) {
+                std::cerr << "無法寫入結果: " << outputPath << std::endl;
+                return 1;
+            }
+            ParameterSweep::writeCsv(out, results, candidates);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "錯誤: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
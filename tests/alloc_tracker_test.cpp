@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "metrics/alloc_tracker.h"
+#include "trading/funding_scorer.h"
+#include "trading/order_book.h"
+#include "trading/rebalance_planner.h"
+#include <algorithm>
+#include <memory>
+
+class AllocTrackerTest : public ::testing::Test {
+protected:
+    void SetUp() override { AllocTracker::setEnabled(true); }
+    void TearDown() override { AllocTracker::setEnabled(false); }
+
+    static uint64_t siteCount(const std::string& label) {
+        auto sites = AllocTracker::topSites();
+        auto it = std::find_if(sites.begin(), sites.end(),
+                               [&label](const AllocSite& site) { return site.label == label; });
+        return it != sites.end() ? it->count : 0;
+    }
+
+    static Json::Value orderBook(int levels) {
+        Json::Value book;
+        book["retCode"] = 0;
+        for (int i = 0; i < levels; i++) {
+            Json::Value ask(Json::arrayValue);
+            ask.append(std::to_string(100.0 + i * 0.01));
+            ask.append("2.5");
+            book["result"]["a"].append(ask);
+            Json::Value bid(Json::arrayValue);
+            bid.append(std::to_string(99.99 - i * 0.01));
+            bid.append("1.5");
+            book["result"]["b"].append(bid);
+        }
+        return book;
+    }
+};
+
+TEST_F(AllocTrackerTest, CountsAllocationsPerThreadAndScope) {
+    AllocStats before = AllocTracker::threadStats();
+    {
+        AllocScope scope("test_counts");
+        auto value = std::make_unique<int64_t>(42);
+        EXPECT_EQ(scope.stats().count, 1u);
+        EXPECT_GE(scope.stats().bytes, sizeof(int64_t));
+    }
+    EXPECT_EQ(AllocTracker::threadStats().count - before.count, 1u);
+    EXPECT_EQ(siteCount("test_counts"), 1u);
+
+    // 關閉時不計數
+    AllocTracker::setEnabled(false);
+    {
+        AllocScope scope("test_counts");
+        auto value = std::make_unique<int64_t>(7);
+        EXPECT_EQ(scope.stats().count, 0u);
+    }
+    EXPECT_EQ(siteCount("test_counts"), 1u);
+}
+
+TEST_F(AllocTrackerTest, NestedScopesAttributeExclusively) {
+    {
+        AllocScope outer("test_outer");
+        auto a = std::make_unique<int>(1);
+        {
+            AllocScope inner("test_inner");
+            auto b = std::make_unique<int>(2);
+            auto c = std::make_unique<int>(3);
+        }
+        EXPECT_EQ(outer.stats().count, 3u);
+    }
+    EXPECT_EQ(siteCount("test_outer"), 1u);
+    EXPECT_EQ(siteCount("test_inner"), 2u);
+    EXPECT_GE(AllocTracker::topSites(1).front().count, 2u);
+}
+
+TEST_F(AllocTrackerTest, OrderBookParsingDoesNotAllocate) {
+    Json::Value book = orderBook(50);
+    AllocScope scope("test_orderbook");
+    TopOfBook top = parseTopOfBook(book);
+    BookLevel level;
+    double depth = 0.0;
+    for (const auto& entry : book["result"]["a"]) {
+        if (parseBookLevel(entry, level)) {
+            depth += level.quantity;
+        }
+    }
+    EXPECT_EQ(scope.stats().count, 0u);
+    EXPECT_DOUBLE_EQ(top.ask, 100.0);
+    EXPECT_DOUBLE_EQ(top.bid, 99.99);
+    EXPECT_DOUBLE_EQ(depth, 125.0);
+}
+
+TEST_F(AllocTrackerTest, ScoringStaysUnderAllocationCeiling) {
+    ScoringParams params;
+    params.periods = {3, 6, 9};
+    params.weights = {0.5, 0.3, 0.2};
+    params.topPairsCount = 10;
+    FundingScorer scorer(params);
+    std::vector<std::pair<std::string, std::vector<double>>> histories;
+    for (int i = 0; i < 200; i++) {
+        histories.emplace_back("SYM" + std::to_string(i) + "USDT", std::vector<double>(9, 0.0001 * (i + 1)));
+    }
+
+    AllocScope scope("test_scoring");
+    auto ranked = scorer.rank(histories);
+    // 結果向量一次, 排序暫存區一次
+    EXPECT_LE(scope.stats().count, 2u);
+    EXPECT_EQ(ranked.size(), 10u);
+}
+
+TEST_F(AllocTrackerTest, RebalancePlanStaysUnderAllocationCeiling) {
+    std::map<std::string, std::pair<double, double>> holdings;
+    std::map<std::string, std::pair<double, double>> prices;
+    std::vector<HedgeTarget> targets;
+    for (int i = 0; i < 40; i++) {
+        std::string symbol = "S" + std::to_string(i) + "USDT";
+        prices[symbol] = {10.0, 10.0};
+        if (i < 30) {
+            holdings[symbol] = {5.0, 5.0};
+        }
+        if (i >= 10) {
+            targets.push_back({symbol, 8.0, 8.0, i});
+        }
+    }
+    RebalancePlanner planner;
+
+    AllocScope scope("test_plan");
+    RebalancePlan plan = planner.plan(holdings, targets, prices);
+    // 動作向量一次, 穩定排序暫存區一次; 查找表在棧上的暫存區內
+    EXPECT_LE(scope.stats().count, 2u);
+    EXPECT_EQ(plan.actions.size(), 40u);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "trading/basis_tracker.h"
+#include <atomic>
+#include <thread>
+
+class BasisTrackerTest : public ::testing::Test {
+protected:
+    BasisTrackerTest() : clock(IClock::TimePoint(std::chrono::hours(1000))) {
+        options.enabled = true;
+        options.pollInterval = std::chrono::milliseconds(0);
+        options.window = 10;
+        options.minSamples = 5;
+        options.entryPercentile = 0.6;
+        options.exitPercentile = 0.4;
+    }
+
+    // 以固定買賣價差推送一組同步報價, perpMid 相對現貨中間價 100
+    void feed(BasisTracker& tracker, double perpMid) {
+        tracker.onSpotQuote("BTCUSDT", {99.99, 100.01});
+        tracker.onPerpQuote("BTCUSDT", {perpMid - 0.01, perpMid + 0.01});
+    }
+
+    VirtualClock clock;
+    BasisOptions options;
+};
+
+TEST(RollingHistogramTest, PercentilesOverRollingWindow) {
+    RollingHistogram histogram(4, 0.0001, 0.01);
+    EXPECT_DOUBLE_EQ(histogram.percentile(0.5), 0.0);
+    for (double value : {0.001, 0.002, 0.003, 0.004}) {
+        histogram.add(value);
+    }
+    EXPECT_EQ(histogram.size(), 4u);
+    EXPECT_NEAR(histogram.percentile(0.0), 0.001, 1e-9);
+    EXPECT_NEAR(histogram.percentile(0.5), 0.002, 1e-9);
+    EXPECT_NEAR(histogram.percentile(1.0), 0.004, 1e-9);
+
+    // 窗口滿後最舊的樣本被移出
+    histogram.add(0.005);
+    EXPECT_EQ(histogram.size(), 4u);
+    EXPECT_NEAR(histogram.percentile(0.0), 0.002, 1e-9);
+
+    // 超出範圍的樣本歸入兩端
+    histogram.add(-1.0);
+    EXPECT_NEAR(histogram.percentile(0.0), -0.01, 1e-9);
+}
+
+TEST_F(BasisTrackerTest, SynchronizedQuotesProduceSamples) {
+    BasisTracker tracker(clock, options);
+    EXPECT_FALSE(tracker.snapshot("BTCUSDT").has_value());
+    EXPECT_FALSE(tracker.onSpotQuote("BTCUSDT", {100.0, 100.02}));
+    EXPECT_TRUE(tracker.onPerpQuote("BTCUSDT", {100.10, 100.12}));
+
+    auto snap = tracker.snapshot("BTCUSDT");
+    ASSERT_TRUE(snap.has_value());
+    EXPECT_EQ(snap->samples, 1u);
+    EXPECT_NEAR(snap->mid, 0.1 / 100.01, 1e-12);
+    EXPECT_NEAR(snap->entry, (100.10 - 100.02) / 100.02, 1e-12);
+    EXPECT_NEAR(snap->exit, (100.12 - 100.0) / 100.0, 1e-12);
+    EXPECT_DOUBLE_EQ(snap->ewma, snap->mid);
+    EXPECT_TRUE(snap->fresh);
+
+    // 報價時間差超過 maxSkew 不計入樣本
+    clock.advance(std::chrono::seconds(1));
+    EXPECT_FALSE(tracker.onSpotQuote("BTCUSDT", {100.0, 100.02}));
+    EXPECT_EQ(tracker.snapshot("BTCUSDT")->samples, 1u);
+
+    // 無效報價被忽略
+    EXPECT_FALSE(tracker.onPerpQuote("BTCUSDT", {0.0, 100.0}));
+    EXPECT_FALSE(tracker.onPerpQuote("BTCUSDT", {101.0, 100.0}));
+
+    // 樣本過期
+    clock.advance(std::chrono::seconds(20));
+    EXPECT_FALSE(tracker.snapshot("BTCUSDT")->fresh);
+}
+
+TEST_F(BasisTrackerTest, EwmaTracksMidBasis) {
+    options.ewmaAlpha = 0.5;
+    BasisTracker tracker(clock, options);
+    feed(tracker, 100.10);
+    feed(tracker, 100.30);
+    auto snap = tracker.snapshot("BTCUSDT");
+    // 樣本依次為 0.001, 0.001 (現貨更新與上一筆合約報價配對), 0.003: 均值 0.002, 方差 0.5 * 0.5 * 0.002^2
+    EXPECT_NEAR(snap->ewma, 0.002, 1e-12);
+    EXPECT_NEAR(snap->ewmaStdDev, 0.001, 1e-12);
+}
+
+TEST_F(BasisTrackerTest, VerdictComparesAgainstRollingPercentiles) {
+    BasisTracker tracker(clock, options);
+    feed(tracker, 100.10);
+    EXPECT_EQ(tracker.verdict("BTCUSDT", BasisSide::Entry), BasisVerdict::Unknown);
+
+    for (double perpMid : {100.05, 100.10, 100.15, 100.20, 100.25}) {
+        feed(tracker, perpMid);
+    }
+    // 基差處於近期高位: 適合開倉, 不適合平倉
+    feed(tracker, 100.30);
+    EXPECT_EQ(tracker.verdict("BTCUSDT", BasisSide::Entry), BasisVerdict::Favourable);
+    EXPECT_EQ(tracker.verdict("BTCUSDT", BasisSide::Exit), BasisVerdict::Unfavourable);
+
+    // 基差收斂: 適合平倉, 不適合開倉
+    feed(tracker, 100.0);
+    EXPECT_EQ(tracker.verdict("BTCUSDT", BasisSide::Entry), BasisVerdict::Unfavourable);
+    EXPECT_EQ(tracker.verdict("BTCUSDT", BasisSide::Exit), BasisVerdict::Favourable);
+
+    // 過期後不做判斷
+    clock.advance(std::chrono::seconds(20));
+    EXPECT_EQ(tracker.verdict("BTCUSDT", BasisSide::Exit), BasisVerdict::Unknown);
+    EXPECT_STREQ(toString(BasisVerdict::Unknown), "unknown");
+}
+
+TEST_F(BasisTrackerTest, PollsWatchlist) {
+    options.pollInterval = std::chrono::milliseconds(1);
+    BasisTracker tracker(clock, options);
+    std::atomic<int> calls{0};
+    tracker.setWatchlist({"BTCUSDT"});
+    tracker.start([&calls](const std::string&, bool spot) {
+        calls++;
+        return spot ? TopOfBook{100.0, 100.02} : TopOfBook{100.10, 100.12};
+    });
+    ASSERT_TRUE(tracker.isRunning());
+    for (int i = 0; i < 500 && tracker.snapshot("BTCUSDT").value_or(BasisSnapshot{}).samples < 3; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    tracker.stop();
+    EXPECT_FALSE(tracker.isRunning());
+    EXPECT_GE(tracker.snapshot("BTCUSDT")->samples, 3u);
+    EXPECT_GE(calls.load(), 4);
+}
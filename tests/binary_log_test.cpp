@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "logger.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+std::vector<DecodedLogRecord> decodeFile(const std::filesystem::path& path, bool* corrupted = nullptr) {
+    std::ifstream in(path, std::ios::binary);
+    BinaryLogReader reader(in);
+    EXPECT_TRUE(reader.valid());
+    std::vector<DecodedLogRecord> records;
+    DecodedLogRecord record;
+    while (reader.next(record)) {
+        records.push_back(record);
+    }
+    if (corrupted) {
+        *corrupted = reader.corrupted();
+    }
+    return records;
+}
+
+} // namespace
+
+TEST(BinaryLogTest, EncodesAndRendersArguments) {
+    uint8_t buffer[LOG_PAYLOAD_BYTES];
+    BinaryEncoder encoder(buffer, sizeof(buffer));
+    encoder.put(logSymbol("BTCUSDT"));
+    encoder.put(0.125);
+    encoder.put(-42);
+    encoder.put(size_t(7));
+    encoder.put(true);
+    encoder.put("現貨");
+
+    EXPECT_EQ(renderLogMessage("{} 價格={}, 數量={}/{}, 成功={}, 類型={}", buffer, encoder.size()),
+              "BTCUSDT 價格=0.125, 數量=-42/7, 成功=true, 類型=現貨");
+    // 佔位符多於參數時保留原樣
+    EXPECT_EQ(renderLogMessage("{} {}", buffer, 0), "{} {}");
+}
+
+TEST(BinaryLogTest, TruncatesArgumentsThatDoNotFit) {
+    uint8_t buffer[32];
+    BinaryEncoder encoder(buffer, sizeof(buffer));
+    encoder.put(1.0);
+    encoder.put(2.0);
+    encoder.put(3.0);
+    encoder.put(4.0);   // 超出 32 位元組
+    ASSERT_LE(encoder.size(), sizeof(buffer));
+
+    EXPECT_EQ(renderLogMessage("{} {} {} {}", buffer, encoder.size()), "1 2 3 <截斷>");
+}
+
+TEST(BinaryLogTest, InternsSymbolsOnce) {
+    uint32_t first = internLogSymbol("ETHUSDT");
+    EXPECT_EQ(internLogSymbol("ETHUSDT"), first);
+    EXPECT_NE(internLogSymbol("SOLUSDT"), first);
+    EXPECT_EQ(logSymbolName(first), "ETHUSDT");
+}
+
+TEST(BinaryLogTest, BackendWritesDecodableFileSmallerThanText) {
+    auto dir = std::filesystem::temp_directory_path() / "binary_log_test";
+    std::filesystem::remove_all(dir);
+
+    LogOptions options;
+    options.console = false;
+    options.level = LogLevel::Debug;
+    options.filePath = (dir / "app.log").string();
+    options.binaryFilePath = (dir / "app.binlog").string();
+    options.overflow = OverflowPolicy::Block;
+
+    uint32_t formatId = registerLogFormat(LogLevel::Debug, "深度級別: 價格={}, 數量={}, 影響={}, {}",
+                                          __FILE__, __LINE__);
+    const int count = 500;
+    {
+        LogBackend backend(options);
+        backend.write(LogLevel::Info, "開始");
+        for (int i = 0; i < count; i++) {
+            backend.writeBinary(LogLevel::Debug, formatId, 100.0 + i, 0.5, 0.000125, logSymbol("BTCUSDT"));
+        }
+        backend.flush();
+    }
+
+    bool corrupted = true;
+    auto records = decodeFile(dir / "app.binlog", &corrupted);
+    EXPECT_FALSE(corrupted);
+    ASSERT_EQ(records.size(), static_cast<size_t>(count + 1));
+    EXPECT_EQ(records[0].message, "開始");
+    EXPECT_EQ(records[0].level, static_cast<int>(LogLevel::Info));
+    EXPECT_EQ(records[3].message, "深度級別: 價格=102, 數量=0.5, 影響=0.000125, BTCUSDT");
+    EXPECT_NE(records[3].location.find("binary_log_test.cpp"), std::string::npos);
+
+    // 同時寫出的文字文件內容一致, 二進位文件明顯較小
+    std::ifstream text(dir / "app.log");
+    std::string line;
+    std::getline(text, line);
+    std::getline(text, line);
+    EXPECT_NE(line.find("[DEBUG] 深度級別: 價格=100, 數量=0.5"), std::string::npos);
+    EXPECT_LT(std::filesystem::file_size(dir / "app.binlog") * 2, std::filesystem::file_size(dir / "app.log"));
+    std::filesystem::remove_all(dir);
+}
+
+TEST(BinaryLogTest, ReaderDetectsTruncatedFile) {
+    std::ostringstream out;
+    out.write(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+    out.put(static_cast<char>(BinaryRecordType::Event));
+    out.write("\x01\x02", 2);  // 事件記錄只寫了一半
+
+    std::istringstream in(out.str());
+    BinaryLogReader reader(in);
+    ASSERT_TRUE(reader.valid());
+    DecodedLogRecord record;
+    EXPECT_FALSE(reader.next(record));
+    EXPECT_TRUE(reader.corrupted());
+
+    std::istringstream notLog("plain text log");
+    EXPECT_FALSE(BinaryLogReader(notLog).valid());
+}
+
+TEST(BinaryLogTest, ReopenedFileKeepsTimestampsOfEachSession) {
+    auto path = std::filesystem::temp_directory_path() / "binary_log_reopen_test.binlog";
+    std::filesystem::remove(path);
+
+    uint32_t formatId = registerLogFormat(LogLevel::Info, "會話 {} 事件 {}", __FILE__, __LINE__);
+    auto first = std::chrono::system_clock::time_point(std::chrono::seconds(1760000000));
+    auto second = first + std::chrono::hours(5);
+    auto writeSession = [&](int session, std::chrono::system_clock::time_point start) {
+        BinaryLogWriter writer;
+        ASSERT_TRUE(writer.open(path.string()));
+        for (int i = 0; i < 2; i++) {
+            uint8_t buffer[LOG_PAYLOAD_BYTES];
+            BinaryEncoder encoder(buffer, sizeof(buffer));
+            encoder.put(session);
+            encoder.put(i);
+            writer.writeEvent(formatId, LogLevel::Info, start + std::chrono::milliseconds(i), buffer, encoder.size());
+        }
+        writer.close();
+    };
+    writeSession(1, first);
+    // 重啟後附加到同一文件
+    writeSession(2, second);
+
+    bool corrupted = true;
+    auto records = decodeFile(path, &corrupted);
+    EXPECT_FALSE(corrupted);
+    ASSERT_EQ(records.size(), 4u);
+    auto nanos = [](std::chrono::system_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    };
+    EXPECT_EQ(records[0].timestampNs, nanos(first));
+    EXPECT_EQ(records[1].timestampNs, nanos(first + std::chrono::milliseconds(1)));
+    EXPECT_EQ(records[2].timestampNs, nanos(second));
+    EXPECT_EQ(records[3].timestampNs, nanos(second + std::chrono::milliseconds(1)));
+    EXPECT_EQ(records[2].message, "會話 2 事件 0");
+    std::filesystem::remove(path);
+}
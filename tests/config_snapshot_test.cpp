@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "include/config.h"
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+Json::Value parseJson(const std::string& text) {
+    Json::Value root;
+    Json::Reader reader;
+    std::istringstream in(text);
+    EXPECT_TRUE(reader.parse(in, root));
+    return root;
+}
+
+const char* CONFIG_JSON = R"({
+    "preferred_exchange": "BYBIT",
+    "top_pairs_count": 3,
+    "exchanges": {"bybit": {"enabled": true, "default_leverage": 2, "spot_margin_trading": true}},
+    "trading": {
+        "min_position_value": 100,
+        "max_position_value": 200,
+        "funding_holding_days": 14,
+        "funding_rate_scoring": {
+            "periods": [3, 6, 9],
+            "weights": [3.0, 1.0, 2.0],
+            "settlement_times_utc": ["00:00", "08:00", "16:00"],
+            "history_days": 7
+        },
+        "execution": {"sliced_execution": true, "max_slices": 20, "slice_trigger": "replenish"}
+    },
+    "logging": {"level": "warning"}
+})";
+
+const char* PAIR_LIST_JSON = R"({
+    "pair_list": ["BTCUSDT", "ETHUSDT", "SOLUSDT"],
+    "unsupported_symbols": ["SOLUSDT"]
+})";
+
+// 單例會讀取 config/ 下的實際配置文件, 未部署配置時跳過
+bool hasConfigFiles() {
+    return std::filesystem::exists(Config::CONFIG_FILE) &&
+           std::filesystem::exists(Config::PAIR_LIST_FILE);
+}
+
+} // namespace
+
+TEST(ConfigSnapshotTest, BuildsTypedFields) {
+    auto snap = ConfigSnapshot::build(parseJson(CONFIG_JSON), parseJson(PAIR_LIST_JSON), 7);
+
+    EXPECT_EQ(snap->version, 7u);
+    EXPECT_EQ(snap->preferredExchange, "BYBIT");
+    EXPECT_EQ(snap->defaultLeverage, 2);
+    EXPECT_TRUE(snap->spotMarginTrading);
+    EXPECT_EQ(snap->topPairsCount, 3);
+    EXPECT_DOUBLE_EQ(snap->minPositionValue, 100.0);
+    EXPECT_DOUBLE_EQ(snap->maxPositionValue, 200.0);
+    EXPECT_EQ(snap->fundingPeriods, (std::vector<int>{3, 6, 9}));
+    EXPECT_EQ(snap->fundingWeights, (std::vector<double>{3.0, 1.0, 2.0}));
+    EXPECT_EQ(snap->settlementTimesUTC.size(), 3u);
+    EXPECT_EQ(snap->fundingHistoryDays, 7);
+    EXPECT_TRUE(snap->slicedExecution);
+    EXPECT_EQ(snap->sliceTrigger, "replenish");
+    EXPECT_EQ(snap->tradingPairs.size(), 3u);
+    EXPECT_TRUE(snap->isUnsupported("SOLUSDT"));
+    EXPECT_FALSE(snap->isUnsupported("BTCUSDT"));
+    EXPECT_EQ(snap->config["logging"]["level"].asString(), "warning");
+}
+
+TEST(ConfigSnapshotTest, AccountOverridesMergeIntoCopy) {
+    auto base = ConfigSnapshot::build(parseJson(CONFIG_JSON), parseJson(PAIR_LIST_JSON), 4);
+    auto account = base->withOverrides(parseJson(R"({
+        "exchanges": {"bybit": {"default_leverage": 3}},
+        "trading": {"max_position_value": 500, "execution": {"sliced_execution": false}}
+    })"));
+
+    EXPECT_EQ(account->version, 4u);
+    EXPECT_EQ(account->defaultLeverage, 3);
+    EXPECT_DOUBLE_EQ(account->maxPositionValue, 500.0);
+    EXPECT_FALSE(account->slicedExecution);
+    // 未覆蓋的欄位保留
+    EXPECT_DOUBLE_EQ(account->minPositionValue, 100.0);
+    EXPECT_TRUE(account->spotMarginTrading);
+    EXPECT_EQ(account->maxSlices, 20);
+    EXPECT_EQ(account->tradingPairs.size(), 3u);
+    // 原快照不受影響
+    EXPECT_EQ(base->defaultLeverage, 2);
+    EXPECT_TRUE(base->slicedExecution);
+
+    auto unchanged = base->withOverrides(Json::Value());
+    EXPECT_DOUBLE_EQ(unchanged->maxPositionValue, 200.0);
+}
+
+TEST(ConfigSnapshotTest, MissingKeysDefaultToZero) {
+    auto snap = ConfigSnapshot::build(Json::Value(Json::objectValue), Json::Value(Json::objectValue), 1);
+
+    EXPECT_TRUE(snap->tradingPairs.empty());
+    EXPECT_TRUE(snap->fundingPeriods.empty());
+    EXPECT_EQ(snap->maxSlices, 0);
+    EXPECT_FALSE(snap->isUnsupported("BTCUSDT"));
+}
+
+TEST(ConfigSnapshotTest, PublishKeepsOldSnapshotAliveForReaders) {
+    if (!hasConfigFiles()) {
+        GTEST_SKIP() << "缺少配置文件";
+    }
+    Config& config = Config::getInstance();
+    const auto original = config.snapshot();
+    const auto held = config.snapshot();
+
+    auto notified = std::make_shared<int>(0);
+    config.onReload([notified](const ConfigSnapshot& snap) {
+        if (snap.version == 1000) {
+            ++*notified;
+        }
+    });
+
+    config.publish(ConfigSnapshot::build(parseJson(CONFIG_JSON), parseJson(PAIR_LIST_JSON), 1000));
+
+    // 已取得的快照不受影響, 新的讀取看到新版本
+    EXPECT_EQ(held->version, original->version);
+    EXPECT_EQ(config.snapshot()->version, 1000u);
+    EXPECT_EQ(config.getTopPairsCount(), 3);
+    EXPECT_EQ(config.getUnsupportedSymbols(), (std::vector<std::string>{"SOLUSDT"}));
+    EXPECT_EQ(*notified, 1);
+
+    config.publish(original);
+    EXPECT_EQ(config.snapshot()->version, original->version);
+}
+
+TEST(ConfigSnapshotTest, ConcurrentReadersSeeCompleteSnapshots) {
+    if (!hasConfigFiles()) {
+        GTEST_SKIP() << "缺少配置文件";
+    }
+    Config& config = Config::getInstance();
+    const auto original = config.snapshot();
+    auto a = ConfigSnapshot::build(parseJson(CONFIG_JSON), parseJson(PAIR_LIST_JSON), 2000);
+    auto b = ConfigSnapshot::build(Json::Value(Json::objectValue), Json::Value(Json::objectValue), 2001);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> torn{0};
+    std::thread reader([&] {
+        while (!stop.load()) {
+            auto snap = config.snapshot();
+            // 每個快照的欄位必須來自同一版本
+            if ((snap->version == 2000 && snap->tradingPairs.size() != 3) ||
+                (snap->version == 2001 && !snap->tradingPairs.empty())) {
+                ++torn;
+            }
+        }
+    });
+    for (int i = 0; i < 2000; ++i) {
+        config.publish(i % 2 == 0 ? a : b);
+    }
+    stop = true;
+    reader.join();
+    config.publish(original);
+
+    EXPECT_EQ(torn.load(), 0);
+}
+
+TEST(ConfigSnapshotTest, ReloadPublishesNewVersion) {
+    if (!hasConfigFiles()) {
+        GTEST_SKIP() << "缺少配置文件";
+    }
+    Config& config = Config::getInstance();
+    const auto before = config.snapshot();
+
+    ASSERT_TRUE(config.reload());
+    const auto after = config.snapshot();
+
+    EXPECT_EQ(after->version, before->version + 1);
+    EXPECT_EQ(after->tradingPairs, before->tradingPairs);
+    EXPECT_NE(after.get(), before.get());
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "storage/funding_archive.h"
+#include "storage/sqlite_storage.h"
+#include "trading/funding_scorer.h"
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+constexpr int64_t HOUR_MS = 3600LL * 1000;
+constexpr int64_t T0 = 1700000000000LL;
+
+std::vector<FundingRecord> makeSeries(const std::string& symbol, int count, int64_t start = T0, double base = 0.0001) {
+    std::vector<FundingRecord> records;
+    for (int i = 0; i < count; i++) {
+        records.push_back({symbol, start + i * 8 * HOUR_MS, base * (i + 1)});
+    }
+    return records;
+}
+
+} // namespace
+
+class FundingArchiveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "funding_archive_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        path = (dir / "funding.frt").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::filesystem::path dir;
+    std::string path;
+};
+
+TEST_F(FundingArchiveTest, RoundTripSingleBlockIsMapped) {
+    auto records = makeSeries("BTCUSDT", 100);
+    auto eth = makeSeries("ETHUSDT", 30, T0, -0.0002);
+    records.insert(records.end(), eth.begin(), eth.end());
+    EXPECT_EQ(FundingArchive::append(path, records), 130u);
+
+    auto archive = FundingArchive::open(path);
+    EXPECT_EQ(archive->symbols(), (std::vector<std::string>{"BTCUSDT", "ETHUSDT"}));
+    EXPECT_EQ(archive->blockCount(), 2u);
+    ASSERT_EQ(archive->rates("BTCUSDT").size(), 100u);
+    EXPECT_TRUE(archive->isMapped("BTCUSDT"));
+    for (size_t i = 0; i < 100; i++) {
+        EXPECT_DOUBLE_EQ(archive->rates("BTCUSDT")[i], records[i].rate);
+        EXPECT_EQ(archive->timestamps("BTCUSDT")[i], records[i].ts);
+    }
+    EXPECT_EQ(archive->lastTimestamp("ETHUSDT"), eth.back().ts);
+    EXPECT_TRUE(archive->rates("XRPUSDT").empty());
+    EXPECT_EQ(archive->lastTimestamp("XRPUSDT"), std::numeric_limits<int64_t>::min());
+}
+
+TEST_F(FundingArchiveTest, AppendSkipsExistingAndMergesBlocks) {
+    FundingArchive::append(path, makeSeries("BTCUSDT", 10));
+    // 前 10 筆已存在, 只追加後 5 筆
+    EXPECT_EQ(FundingArchive::append(path, makeSeries("BTCUSDT", 15)), 5u);
+    EXPECT_EQ(FundingArchive::append(path, makeSeries("BTCUSDT", 15)), 0u);
+
+    auto archive = FundingArchive::open(path);
+    EXPECT_EQ(archive->blockCount(), 2u);
+    EXPECT_FALSE(archive->isMapped("BTCUSDT"));
+    auto rates = archive->rates("BTCUSDT");
+    ASSERT_EQ(rates.size(), 15u);
+    EXPECT_DOUBLE_EQ(rates[14], 0.0015);
+
+    archive.reset();
+    FundingArchive::compact(path);
+    archive = FundingArchive::open(path);
+    EXPECT_EQ(archive->blockCount(), 1u);
+    EXPECT_TRUE(archive->isMapped("BTCUSDT"));
+    EXPECT_EQ(archive->rates("BTCUSDT").size(), 15u);
+}
+
+TEST_F(FundingArchiveTest, WindowFeedsScorer) {
+    FundingArchive::append(path, makeSeries("BTCUSDT", 20));
+    auto archive = FundingArchive::open(path);
+
+    // asOf 為第 10 筆結算時間 (含), 取最近 3 筆
+    auto window = archive->window("BTCUSDT", T0 + 9 * 8 * HOUR_MS, 3);
+    ASSERT_EQ(window.size(), 3u);
+    EXPECT_DOUBLE_EQ(window[0], 0.0008);
+    EXPECT_DOUBLE_EQ(window[2], 0.0010);
+    EXPECT_TRUE(archive->window("BTCUSDT", T0 - 1, 3).empty());
+
+    ScoringParams params;
+    params.periods = {1, 3};
+    params.weights = {0.5, 0.5};
+    FundingScorer scorer(params);
+    std::vector<double> newestFirst(window.rbegin(), window.rend());
+    double expected = 0.0;
+    double actual = 0.0;
+    ASSERT_EQ(scorer.score(newestFirst, expected), FundingScorer::Result::Scored);
+    ASSERT_EQ(scorer.scoreOldestFirst(window, actual), FundingScorer::Result::Scored);
+    EXPECT_DOUBLE_EQ(actual, expected);
+}
+
+TEST_F(FundingArchiveTest, DetectsCorruption) {
+    FundingArchive::append(path, makeSeries("BTCUSDT", 50));
+    {
+        // 改動一筆費率的字節
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(64 + 24 + 8);
+        file.put('\x7f');
+    }
+    EXPECT_THROW(FundingArchive::open(path), std::runtime_error);
+
+    std::ofstream(path, std::ios::trunc) << "not an archive";
+    EXPECT_THROW(FundingArchive::open(path), std::runtime_error);
+    EXPECT_THROW(FundingArchive::open((dir / "missing.frt").string()), std::runtime_error);
+}
+
+TEST_F(FundingArchiveTest, ExportAndIncrementalAppendFromStorage) {
+    StorageOptions options;
+    options.path = (dir / "trading.db").string();
+    SQLiteStorage storage(options);
+    storage.storeFundingRates(makeSeries("BTCUSDT", 40));
+    storage.storeFundingRates(makeSeries("ETHUSDT", 20));
+
+    EXPECT_EQ(FundingArchive::exportFrom(storage, path), 60u);
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    // 新的結算同步後只追加新增記錄
+    storage.storeFundingRates({{"BTCUSDT", T0 + 40 * 8 * HOUR_MS, 0.005}});
+    EXPECT_EQ(FundingArchive::appendFromStorage(storage, path), 1u);
+    EXPECT_EQ(FundingArchive::appendFromStorage(storage, path), 0u);
+
+    auto archive = FundingArchive::open(path);
+    EXPECT_EQ(archive->rates("BTCUSDT").size(), 41u);
+    EXPECT_DOUBLE_EQ(archive->rates("BTCUSDT").back(), 0.005);
+    EXPECT_EQ(archive->rates("ETHUSDT").size(), 20u);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "logger.h"
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::filesystem::path tempLogDir(const std::string& name) {
+    auto dir = std::filesystem::temp_directory_path() / ("logger_test_" + name);
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+size_t countLines(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    size_t lines = 0;
+    std::string line;
+    while (std::getline(in, line)) lines++;
+    return lines;
+}
+
+} // namespace
+
+TEST(LogRingTest, PreservesOrderAndReportsFull) {
+    LogRing ring(3);  // 取整為 4
+    ASSERT_EQ(ring.capacity(), 4u);
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(ring.tryPush(LogRecord{LogLevel::Info, {}, std::to_string(i)}));
+    }
+    EXPECT_FALSE(ring.tryPush(LogRecord{LogLevel::Info, {}, "overflow"}));
+
+    LogRecord record;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(ring.tryPop(record));
+        EXPECT_EQ(record.message, std::to_string(i));
+    }
+    EXPECT_FALSE(ring.tryPop(record));
+}
+
+TEST(LogRingTest, ConcurrentProducersDeliverEveryRecordOnce) {
+    LogRing ring(1024);
+    const int producers = 4;
+    const int perProducer = 20000;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&ring, p]() {
+            for (int i = 0; i < perProducer; i++) {
+                std::string message = std::to_string(p) + ":" + std::to_string(i);
+                while (!ring.tryPush(LogRecord{LogLevel::Info, {}, message})) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::set<std::string> seen;
+    std::vector<int> lastIndex(producers, -1);
+    LogRecord record;
+    while (seen.size() < static_cast<size_t>(producers * perProducer)) {
+        if (!ring.tryPop(record)) {
+            std::this_thread::yield();
+            continue;
+        }
+        auto colon = record.message.find(':');
+        int producer = std::stoi(record.message.substr(0, colon));
+        int index = std::stoi(record.message.substr(colon + 1));
+        EXPECT_GT(index, lastIndex[producer]);  // 同一生產者內保持順序
+        lastIndex[producer] = index;
+        EXPECT_TRUE(seen.insert(record.message).second);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(ring.tryPop(record));
+}
+
+TEST(LogBackendTest, FiltersByLevelAndRotatesFiles) {
+    auto dir = tempLogDir("rotate");
+    LogOptions options;
+    options.console = false;
+    options.level = LogLevel::Info;
+    options.filePath = (dir / "app.log").string();
+    options.maxFileBytes = 2048;
+    options.maxFiles = 2;
+    options.overflow = OverflowPolicy::Block;
+
+    {
+        LogBackend backend(options);
+        backend.write(LogLevel::Debug, "filtered");
+        for (int i = 0; i < 200; i++) {
+            backend.write(LogLevel::Info, "message " + std::to_string(i) + std::string(40, 'x'));
+        }
+        backend.flush();
+        EXPECT_EQ(backend.writtenCount(), 200u);
+        EXPECT_EQ(backend.droppedCount(), 0u);
+    }
+
+    EXPECT_TRUE(std::filesystem::exists(dir / "app.log"));
+    EXPECT_TRUE(std::filesystem::exists(dir / "app.log.1"));
+    EXPECT_TRUE(std::filesystem::exists(dir / "app.log.2"));
+    EXPECT_FALSE(std::filesystem::exists(dir / "app.log.3"));
+    EXPECT_LE(std::filesystem::file_size(dir / "app.log.1"), options.maxFileBytes);
+
+    // 最新的記錄在當前文件的最後一行
+    std::ifstream in(dir / "app.log");
+    std::string line, last;
+    while (std::getline(in, line)) last = line;
+    EXPECT_NE(last.find("[INFO] message 199"), std::string::npos);
+    EXPECT_GT(countLines(dir / "app.log"), 0u);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(LogBackendTest, DisabledLevelsSkipTheQueue) {
+    LogOptions options;
+    options.console = false;
+    options.level = LogLevel::Off;
+    LogBackend backend(options);
+
+    backend.write(LogLevel::Error, "ignored");
+    backend.flush();
+    EXPECT_EQ(backend.writtenCount(), 0u);
+    EXPECT_FALSE(backend.enabled(LogLevel::Error));
+
+    backend.setLevel(LogLevel::Warning);
+    EXPECT_TRUE(backend.enabled(LogLevel::Error));
+    EXPECT_FALSE(backend.enabled(LogLevel::Info));
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "mock_exchange.h"
+#include "exchange/market_data_hub.h"
+#include <atomic>
+#include <future>
+#include <thread>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class MarketDataHubTest : public ::testing::Test {
+protected:
+    MarketDataHubTest() {
+        options.tickerTtl = std::chrono::milliseconds(60000);
+        options.bookTtl = std::chrono::milliseconds(60000);
+    }
+
+    MarketDataOptions options;
+    NiceMock<MockExchange> source;
+    NiceMock<MockExchange> accountA;
+    NiceMock<MockExchange> accountB;
+};
+
+TEST_F(MarketDataHubTest, AccountsSharePublicRequests) {
+    MarketDataHub hub(source, options);
+    AccountExchange a(accountA, hub);
+    AccountExchange b(accountB, hub);
+
+    EXPECT_CALL(source, getSpotPrice("BTCUSDT")).Times(1).WillOnce(Return(100.0));
+    EXPECT_CALL(source, getContractPrice("BTCUSDT")).Times(1).WillOnce(Return(100.5));
+    EXPECT_CALL(accountA, getSpotPrice(_)).Times(0);
+    EXPECT_CALL(accountB, getContractPrice(_)).Times(0);
+
+    EXPECT_DOUBLE_EQ(a.getSpotPrice("BTCUSDT"), 100.0);
+    EXPECT_DOUBLE_EQ(b.getSpotPrice("BTCUSDT"), 100.0);
+    EXPECT_DOUBLE_EQ(a.getContractPrice("BTCUSDT"), 100.5);
+    EXPECT_DOUBLE_EQ(b.getContractPrice("BTCUSDT"), 100.5);
+}
+
+TEST_F(MarketDataHubTest, PrivateRequestsUseOwnAccount) {
+    MarketDataHub hub(source, options);
+    AccountExchange a(accountA, hub);
+    AccountExchange b(accountB, hub);
+
+    EXPECT_CALL(source, getTotalEquity()).Times(0);
+    EXPECT_CALL(accountA, getTotalEquity()).WillOnce(Return(1000.0));
+    EXPECT_CALL(accountB, getTotalEquity()).WillOnce(Return(2000.0));
+    EXPECT_CALL(accountA, createSpotOrder("BTCUSDT", "Buy", 1.0, _)).WillOnce(Return(true));
+    EXPECT_CALL(accountB, createSpotOrder(_, _, _, _)).Times(0);
+    EXPECT_CALL(accountB, getContractFeeRate()).WillOnce(Return(0.0005));
+
+    EXPECT_DOUBLE_EQ(a.getTotalEquity(), 1000.0);
+    EXPECT_DOUBLE_EQ(b.getTotalEquity(), 2000.0);
+    EXPECT_TRUE(a.createSpotOrder("BTCUSDT", "Buy", 1.0));
+    EXPECT_DOUBLE_EQ(b.getContractFeeRate(), 0.0005);
+}
+
+TEST_F(MarketDataHubTest, FailedResponsesAreNotCached) {
+    MarketDataHub hub(source, options);
+    Json::Value error;
+    error["retCode"] = 10006;
+    Json::Value book;
+    book["retCode"] = 0;
+    EXPECT_CALL(source, getSpotPrice("ETHUSDT")).WillOnce(Return(0.0)).WillOnce(Return(10.0));
+    EXPECT_CALL(source, getSpotOrderBook("ETHUSDT")).WillOnce(Return(error)).WillOnce(Return(book));
+
+    EXPECT_DOUBLE_EQ(hub.getSpotPrice("ETHUSDT"), 0.0);
+    EXPECT_DOUBLE_EQ(hub.getSpotPrice("ETHUSDT"), 10.0);
+    EXPECT_DOUBLE_EQ(hub.getSpotPrice("ETHUSDT"), 10.0);
+    EXPECT_EQ(hub.getSpotOrderBook("ETHUSDT")["retCode"].asInt(), 10006);
+    EXPECT_EQ(hub.getSpotOrderBook("ETHUSDT")["retCode"].asInt(), 0);
+    EXPECT_EQ(hub.getSpotOrderBook("ETHUSDT")["retCode"].asInt(), 0);
+}
+
+TEST_F(MarketDataHubTest, ExpiredEntriesAreRefetched) {
+    options.tickerTtl = std::chrono::milliseconds(1);
+    MarketDataHub hub(source, options);
+    EXPECT_CALL(source, getCurrentFundingRate("BTCUSDT")).WillOnce(Return(-0.0001)).WillOnce(Return(0.0002));
+    EXPECT_DOUBLE_EQ(*hub.getCurrentFundingRate("BTCUSDT"), -0.0001);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_DOUBLE_EQ(*hub.getCurrentFundingRate("BTCUSDT"), 0.0002);
+}
+
+TEST_F(MarketDataHubTest, FailedFundingRateIsNotCached) {
+    MarketDataHub hub(source, options);
+    // 失敗以空值返回, 下一次請求重新讀取; 成功的 0 費率照常緩存
+    EXPECT_CALL(source, getCurrentFundingRate("BTCUSDT"))
+        .WillOnce(Return(std::nullopt)).WillOnce(Return(0.0));
+    EXPECT_FALSE(hub.getCurrentFundingRate("BTCUSDT").has_value());
+    EXPECT_EQ(hub.getCurrentFundingRate("BTCUSDT"), std::optional<double>(0.0));
+    EXPECT_EQ(hub.getCurrentFundingRate("BTCUSDT"), std::optional<double>(0.0));
+}
+
+TEST_F(MarketDataHubTest, DisplayRequestsReuseRecentResults) {
+    options.tickerTtl = std::chrono::milliseconds(1);
+    MarketDataHub hub(source, options);
+    EXPECT_CALL(source, getSpotPrice("BTCUSDT")).WillOnce(Return(100.0)).WillOnce(Return(101.0));
+    EXPECT_DOUBLE_EQ(hub.getSpotPrice("BTCUSDT"), 100.0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    {
+        // 顯示沿用策略取得的價格, 不另發請求
+        RequestPriorityScope scope(RequestPriority::Display);
+        EXPECT_DOUBLE_EQ(hub.getSpotPrice("BTCUSDT"), 100.0);
+    }
+    EXPECT_DOUBLE_EQ(hub.getSpotPrice("BTCUSDT"), 101.0);
+}
+
+TEST_F(MarketDataHubTest, FundingHistoryKeyIgnoresSymbolOrder) {
+    MarketDataHub hub(source, options);
+    std::vector<std::pair<std::string, std::vector<double>>> history{{"BTCUSDT", {0.0001}}, {"ETHUSDT", {0.0002}}};
+    EXPECT_CALL(source, getFundingHistory(_)).Times(1).WillOnce(Return(history));
+    EXPECT_EQ(hub.getFundingHistory({"BTCUSDT", "ETHUSDT"}).size(), 2u);
+    EXPECT_EQ(hub.getFundingHistory({"ETHUSDT", "BTCUSDT"}).size(), 2u);
+}
+
+TEST_F(MarketDataHubTest, ConcurrentRequestsAreCoalesced) {
+    MarketDataHub hub(source, options);
+    EXPECT_CALL(source, getContractOrderBook("BTCUSDT")).Times(1).WillOnce(Invoke([](const std::string&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        Json::Value book;
+        book["retCode"] = 0;
+        book["result"]["s"] = "BTCUSDT";
+        return book;
+    }));
+
+    std::atomic<int> received{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&] {
+            if (hub.getContractOrderBook("BTCUSDT")["result"]["s"].asString() == "BTCUSDT") {
+                received++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(received.load(), 4);
+}
+
+TEST_F(MarketDataHubTest, HigherPriorityCallersDoNotWaitForDisplayFetches) {
+    MarketDataHub hub(source, options);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<bool> displayStarted{false};
+    EXPECT_CALL(source, getSpotPrice("BTCUSDT"))
+        .WillOnce(Invoke([&](const std::string&) {
+            displayStarted = true;
+            released.wait();
+            return 100.0;
+        }))
+        .WillOnce(Return(101.0));
+
+    std::thread display([&] {
+        RequestPriorityScope scope(RequestPriority::Display);
+        EXPECT_DOUBLE_EQ(hub.getSpotPrice("BTCUSDT"), 100.0);
+    });
+    while (!displayStarted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    {
+        // 顯示的請求仍在途: 下單不合併到它, 另發請求並立即返回
+        RequestPriorityScope scope(RequestPriority::OrderEntry);
+        EXPECT_DOUBLE_EQ(hub.getSpotPrice("BTCUSDT"), 101.0);
+    }
+    release.set_value();
+    display.join();
+    // 較晚完成的顯示結果不覆蓋下單取得的較新價格
+    EXPECT_DOUBLE_EQ(hub.getSpotPrice("BTCUSDT"), 101.0);
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "metrics/metrics.h"
+#include "metrics/metrics_exporter.h"
+#include <arpa/inet.h>
+#include <filesystem>
+#include <fstream>
+#include <netinet/in.h>
+#include <random>
+#include <sstream>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// 連接到本地端口, 失敗時返回 -1
+int connectTo(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+std::string httpGet(int port, const std::string& path) {
+    int fd = connectTo(port);
+    if (fd < 0) {
+        return "";
+    }
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+    return response;
+}
+
+} // namespace
+
+TEST(LatencyHistogramTest, BucketsAreContiguousAndBounded) {
+    for (uint64_t v : {0ull, 1ull, 63ull, 64ull, 65ull, 127ull, 128ull, 1000ull, 123456789ull}) {
+        size_t index = LatencyHistogram::bucketIndex(v);
+        EXPECT_GE(LatencyHistogram::bucketUpperBound(index), v);
+        if (index > 0) {
+            EXPECT_LT(LatencyHistogram::bucketUpperBound(index - 1), v);
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucketIndex(uint64_t(1) << 50), LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinRelativeError) {
+    LatencyHistogram histogram;
+    std::vector<uint64_t> values;
+    std::mt19937 rng(7);
+    std::lognormal_distribution<double> latency(9.0, 1.0);   // 中位數約 8ms
+    for (int i = 0; i < 100000; i++) {
+        uint64_t v = static_cast<uint64_t>(latency(rng));
+        values.push_back(v);
+        histogram.record(v);
+    }
+    std::sort(values.begin(), values.end());
+
+    EXPECT_EQ(histogram.count(), values.size());
+    EXPECT_EQ(histogram.max(), values.back());
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        double exact = static_cast<double>(values[static_cast<size_t>(std::ceil(q * values.size())) - 1]);
+        double estimate = static_cast<double>(histogram.percentile(q));
+        EXPECT_NEAR(estimate, exact, exact * 0.04) << "q=" << q;
+    }
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.percentile(0.99), 0u);
+}
+
+TEST(MetricsRegistryTest, RendersPrometheusText) {
+    MetricsRegistry registry;
+    LatencyHistogram& total = registry.histogram("test_request_seconds", "請求耗時",
+                                                 {{"endpoint", "/v5/market/tickers"}, {"phase", "total"}});
+    EXPECT_EQ(&total, &registry.histogram("test_request_seconds", "請求耗時",
+                                          {{"endpoint", "/v5/market/tickers"}, {"phase", "total"}}));
+    total.record(std::chrono::milliseconds(25));
+    total.record(std::chrono::milliseconds(35));
+    registry.counter("test_errors_total", "錯誤", {{"ret_code", "10001"}, {"msg", "say \"hi\""}}).increment(3);
+    registry.gauge("test_queue_depth", "隊列深度", {{"queue", "orders"}}).set(7);
+
+    std::string text = registry.renderPrometheus();
+    EXPECT_NE(text.find("# TYPE test_request_seconds summary"), std::string::npos);
+    EXPECT_NE(text.find("test_request_seconds{endpoint=\"/v5/market/tickers\",phase=\"total\",quantile=\"0.99\"} 0.035"),
+              std::string::npos);
+    EXPECT_NE(text.find("test_request_seconds_count{endpoint=\"/v5/market/tickers\",phase=\"total\"} 2"),
+              std::string::npos);
+    EXPECT_NE(text.find("test_request_seconds_sum{endpoint=\"/v5/market/tickers\",phase=\"total\"} 0.060000"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_errors_total counter"), std::string::npos);
+    EXPECT_NE(text.find("test_errors_total{ret_code=\"10001\",msg=\"say \\\"hi\\\"\"} 3"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_queue_depth gauge"), std::string::npos);
+    EXPECT_NE(text.find("test_queue_depth{queue=\"orders\"} 7"), std::string::npos);
+}
+
+TEST(MetricsExporterTest, ServesHttpAndWritesFile) {
+    MetricsRegistry registry;
+    registry.counter("test_requests_total", "請求次數").increment();
+
+    auto dir = std::filesystem::temp_directory_path() / "metrics_test";
+    std::filesystem::remove_all(dir);
+    MetricsExportOptions options;
+    options.httpEnabled = true;
+    options.httpPort = 0;
+    options.filePath = (dir / "metrics.prom").string();
+
+    MetricsExporter exporter(registry, options);
+    ASSERT_TRUE(exporter.start());
+    ASSERT_GT(exporter.port(), 0);
+
+    std::string response = httpGet(exporter.port(), "/metrics");
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK", 0), 0u);
+    EXPECT_NE(response.find("test_requests_total 1"), std::string::npos);
+    EXPECT_EQ(httpGet(exporter.port(), "/other").rfind("HTTP/1.1 404", 0), 0u);
+
+    // 停止時寫出最後一份文件
+    registry.counter("test_requests_total", "請求次數").increment();
+    exporter.stop();
+    std::ifstream in(dir / "metrics.prom");
+    std::stringstream content;
+    content << in.rdbuf();
+    EXPECT_NE(content.str().find("test_requests_total 2"), std::string::npos);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(MetricsExporterTest, IdleClientDoesNotBlockScrape) {
+    MetricsRegistry registry;
+    registry.counter("test_requests_total", "請求次數").increment();
+    MetricsExportOptions options;
+    options.httpEnabled = true;
+    options.httpPort = 0;
+    options.requestTimeout = std::chrono::seconds(5);
+
+    MetricsExporter exporter(registry, options);
+    ASSERT_TRUE(exporter.start());
+
+    // 先連接但不送出請求, 之後的抓取不必等它逾時
+    int idle = connectTo(exporter.port());
+    ASSERT_GE(idle, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto started = std::chrono::steady_clock::now();
+    std::string response = httpGet(exporter.port(), "/metrics");
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK", 0), 0u);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+
+    close(idle);
+    exporter.stop();
+}
@@ -0,0 +1,47 @@
+#ifndef MOCK_EXCHANGE_H
+#define MOCK_EXCHANGE_H
+
+#include <gmock/gmock.h>
+#include "exchange/exchange_interface.h"
+
+// Mock Exchange 類
+class MockExchange : public IExchange {
+public:
+    MOCK_METHOD0(getFundingRates, std::vector<std::pair<std::string, double>>());
+    MOCK_METHOD1(getSpotPrice, double(const std::string&));
+    MOCK_METHOD0(getTotalEquity, double());
+    MOCK_METHOD1(getPositions, Json::Value(const std::string&));
+    MOCK_METHOD2(setLeverage, bool(const std::string&, int));
+    MOCK_METHOD6(createOrder, Json::Value(
+        const std::string&, 
+        const std::string&, 
+        double, 
+        const std::string&, 
+        const std::string&,
+        const std::string&
+    ));
+    MOCK_METHOD4(createSpotOrder, bool(const std::string&, const std::string&, double, const std::string&));
+    MOCK_METHOD2(getOrderByLinkId, Json::Value(const std::string&, const std::string&));
+    MOCK_METHOD1(closePosition, void(const std::string&));
+    MOCK_METHOD1(getInstruments, std::vector<std::string>(const std::string&));
+    MOCK_METHOD0(getLastError, std::string());
+    
+
+    // Mock 方法的具體實現
+    MOCK_METHOD0(displayPositions, void());
+    MOCK_METHOD0(getSpotBalances, Json::Value());
+    MOCK_METHOD1(getSpotBalance, double(const std::string&));
+    MOCK_METHOD1(getMarginRatio, double(const std::string&));
+    MOCK_METHOD1(getSpotOrderBook, Json::Value(const std::string&));
+    MOCK_METHOD1(getContractOrderBook, Json::Value(const std::string&));
+    MOCK_METHOD1(getContractPrice, double(const std::string&));
+    MOCK_METHOD1(getCurrentFundingRate, std::optional<double>(const std::string&));
+    MOCK_METHOD0(getSpotFeeRate, double());
+    MOCK_METHOD0(getContractFeeRate, double());
+    
+    MOCK_METHOD1(getFundingHistory, 
+        std::vector<std::pair<std::string, std::vector<double>>>(const std::vector<std::string>&));
+    MOCK_METHOD1(getFundingRecords, std::vector<FundingRecord>(const std::vector<std::string>&));
+};
+
+#endif // MOCK_EXCHANGE_H
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "exchange/order_retry.h"
+#include "storage/trade_group.h"
+#include <functional>
+#include <set>
+#include <vector>
+
+namespace {
+
+Json::Value response(int retCode) {
+    Json::Value value;
+    value["retCode"] = retCode;
+    value["result"]["orderId"] = retCode == 0 ? "ORDER1" : "";
+    return value;
+}
+
+const OrderIntent intent{"BTCUSDT", "Buy", 0.5};
+
+Json::Value order(const std::string& status, const std::string& cumExecQty = "0.5") {
+    Json::Value value;
+    value["orderId"] = "ORDER1";
+    value["orderStatus"] = status;
+    value["symbol"] = "BTCUSDT";
+    value["side"] = "Buy";
+    value["qty"] = "0.500";
+    value["cumExecQty"] = cumExecQty;
+    value["avgPrice"] = "100.5";
+    return value;
+}
+
+} // namespace
+
+TEST(OrderRetryTest, AnsweredRequestsAreNotRetried) {
+    int sends = 0;
+    int lookups = 0;
+    auto lookup = [&lookups] { lookups++; return Json::Value(); };
+
+    Json::Value placed = submitIdempotentOrder("id", intent, 3, [&sends] { sends++; return response(0); }, lookup);
+    EXPECT_EQ(placed["retCode"].asInt(), 0);
+    // 明確拒絕 (例如餘額不足) 不重試
+    Json::Value rejected = submitIdempotentOrder("id", intent, 3, [&sends] { sends++; return response(110007); }, lookup);
+    EXPECT_EQ(rejected["retCode"].asInt(), 110007);
+    EXPECT_EQ(sends, 2);
+    EXPECT_EQ(lookups, 0);
+}
+
+TEST(OrderRetryTest, LostResponseIsResolvedByLinkIdBeforeResending) {
+    // 第一次請求超時但訂單已成立: 查到訂單後不再重發
+    int sends = 0;
+    Json::Value result = submitIdempotentOrder("frt1-1-1c", intent, 3,
+        [&sends] { sends++; return Json::Value(); },
+        [] { return order("Filled"); });
+    EXPECT_EQ(sends, 1);
+    EXPECT_EQ(result["retCode"].asInt(), 0);
+    EXPECT_EQ(result["result"]["orderId"].asString(), "ORDER1");
+    EXPECT_EQ(result["result"]["orderLinkId"].asString(), "frt1-1-1c");
+
+    // 查不到時以相同訂單號重發
+    sends = 0;
+    result = submitIdempotentOrder("frt1-1-1c", intent, 3,
+        [&sends] { return ++sends < 2 ? Json::Value() : response(0); },
+        [] { return Json::Value(); });
+    EXPECT_EQ(sends, 2);
+    EXPECT_EQ(result["retCode"].asInt(), 0);
+
+    // 交易所拒絕的訂單
+    result = submitIdempotentOrder("frt1-1-1c", intent, 3, [] { return Json::Value(); },
+                                   [] { return order("Rejected"); });
+    EXPECT_NE(result["retCode"].asInt(), 0);
+}
+
+TEST(OrderRetryTest, DuplicateLinkIdCountsAsPlaced) {
+    int lookups = 0;
+    Json::Value result = submitIdempotentOrder("id", intent, 3,
+        [] { return response(ORDER_LINK_ID_DUPLICATE); },
+        [&lookups] { return ++lookups < 2 ? Json::Value() : order("Filled"); });
+    EXPECT_EQ(lookups, 2);
+    EXPECT_EQ(result["retCode"].asInt(), 0);
+    EXPECT_EQ(result["result"]["orderId"].asString(), "ORDER1");
+
+    // 一直查不到也不會當作失敗, 避免重複下單或撤回另一腿
+    result = submitIdempotentOrder("id", intent, 2, [] { return response(ORDER_LINK_ID_DUPLICATE); },
+                                   [] { return Json::Value(); });
+    EXPECT_EQ(result["retCode"].asInt(), 0);
+}
+
+TEST(OrderRetryTest, GivesUpWithUnknownStatusAfterMaxAttempts) {
+    int sends = 0;
+    Json::Value result = submitIdempotentOrder("id", intent, 3, [&sends] { sends++; return Json::Value(); },
+                                               [] { return Json::Value(); });
+    EXPECT_EQ(sends, 3);
+    EXPECT_EQ(result["retCode"].asInt(), ORDER_STATUS_UNKNOWN);
+}
+
+TEST(OrderRetryTest, OrderLinkIdsAreDeterministicAndDistinct) {
+    TradeGroup group;
+    group.id = 42;
+    group.openedAt = 1760000000000;
+    group.orderSeq = 3;
+
+    EXPECT_EQ(group.orderLinkId('c'), group.orderLinkId('c'));
+    std::set<std::string> ids{group.orderLinkId('s'), group.orderLinkId('c'), group.orderLinkId('u'),
+                              group.orderLinkId('s', 1), group.orderLinkId('s', 12)};
+    group.orderSeq++;
+    ids.insert(group.orderLinkId('s'));
+    TradeGroup other = group;
+    other.id = 43;
+    ids.insert(other.orderLinkId('s'));
+    EXPECT_EQ(ids.size(), 7u);
+
+    // Bybit 限制: 最長 36 字元, 只允許字母, 數字, - 及 _
+    group.id = 999999999;
+    group.orderSeq = 9999999;
+    std::string longest = group.orderLinkId('s', 999);
+    EXPECT_LE(longest.size(), 36u);
+    EXPECT_EQ(longest.find_first_not_of("abcdefghijklmnopqrstuvwxyz0123456789-_"), std::string::npos);
+
+    // 第二段為進程啟動標識: 同一進程內相同, 重啟後序號回退也不會重用訂單號
+    auto segment = [](const std::string& id) { return id.substr(id.find('-') + 1, 5); };
+    EXPECT_EQ(segment(longest), segment(other.orderLinkId('s')));
+    EXPECT_EQ(longest[longest.find('-') + 6], '-');
+}
+
+TEST(OrderRetryTest, FoundOrderMustMatchAndBeFilled) {
+    auto lost = [] { return Json::Value(); };
+    // 成交數量及均價來自訂單記錄
+    Json::Value result = submitIdempotentOrder("id", intent, 3, lost, [] { return order("Filled"); });
+    EXPECT_EQ(result["retCode"].asInt(), 0);
+    EXPECT_EQ(result["result"]["cumExecQty"].asString(), "0.5");
+    EXPECT_EQ(result["result"]["avgPrice"].asString(), "100.5");
+
+    // 訂單號對應的是另一筆訂單 (例如序號未落盤而重用): 不當作本次下單, 也不重發
+    int sends = 0;
+    for (auto mutate : std::vector<std::function<void(Json::Value&)>>{
+             [](Json::Value& o) { o["symbol"] = "ETHUSDT"; },
+             [](Json::Value& o) { o["side"] = "Sell"; },
+             [](Json::Value& o) { o["qty"] = "0.25"; }}) {
+        result = submitIdempotentOrder("id", intent, 3, [&sends] { sends++; return response(ORDER_LINK_ID_DUPLICATE); },
+                                       [&mutate] { Json::Value o = order("Filled"); mutate(o); return o; });
+        EXPECT_EQ(result["retCode"].asInt(), ORDER_LINK_ID_MISMATCH);
+    }
+    EXPECT_EQ(sends, 3);
+
+    // 已撤銷的訂單不算成立, 部分成交時返回已成交數量
+    result = submitIdempotentOrder("id", intent, 3, lost, [] { return order("Cancelled", "0"); });
+    EXPECT_EQ(result["retCode"].asInt(), ORDER_NOT_FILLED);
+    EXPECT_EQ(result["result"]["cumExecQty"].asString(), "0");
+    result = submitIdempotentOrder("id", intent, 3, lost, [] { return order("PartiallyFilledCanceled", "0.2"); });
+    EXPECT_EQ(result["retCode"].asInt(), ORDER_NOT_FILLED);
+    EXPECT_EQ(result["result"]["cumExecQty"].asString(), "0.2");
+    EXPECT_EQ(result["result"]["avgPrice"].asString(), "100.5");
+}
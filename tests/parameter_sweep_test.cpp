@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "backtest/parameter_sweep.h"
+#include "trading/funding_scorer.h"
+#include <cmath>
+
+namespace {
+
+constexpr int64_t HOUR_MS = 3600 * 1000;
+// 2024-01-01 00:00:00 UTC
+constexpr int64_t START_MS = 1704067200000;
+
+ScoringParams makeScoring() {
+    ScoringParams params;
+    params.periods = {1, 3};
+    params.weights = {1.0, 1.0};
+    params.topPairsCount = 2;
+    return params;
+}
+
+std::shared_ptr<MarketHistory> makeHistory() {
+    auto history = std::make_shared<MarketHistory>();
+    const double baseRates[] = {0.0003, 0.0001, -0.0002};
+    const char* names[] = {"AAAUSDT", "BBBUSDT", "CCCUSDT"};
+    for (int i = 0; i < 3; i++) {
+        SymbolHistory& symbol = history->symbol(names[i]);
+        for (int h = -24; h < 24 * 10; h++) {
+            double price = 100.0 * (i + 1) * (1 + 0.001 * std::sin(h / 5.0));
+            symbol.tickers.push_back({START_MS + h * HOUR_MS, price, price * 1.0005});
+        }
+        for (int k = -9; k < 3 * 10; k++) {
+            symbol.funding.push_back({START_MS + k * 8 * HOUR_MS, baseRates[i] * (1 + 0.1 * (k % 3))});
+        }
+    }
+    history->finalize();
+    return history;
+}
+
+std::shared_ptr<const SweepDataset> makeDataset() {
+    SettlementCalendar calendar({"00:00", "08:00", "16:00"}, 30, 1);
+    return SweepDataset::build(*makeHistory(), calendar,
+                               IClock::TimePoint(std::chrono::milliseconds(START_MS)),
+                               IClock::TimePoint(std::chrono::milliseconds(START_MS + 10 * 24 * HOUR_MS)),
+                               9);
+}
+
+} // namespace
+
+TEST(FundingScorerTest, WeightsPeriodAveragesAndSkipsContradictions) {
+    FundingScorer scorer(makeScoring());
+    double score = 0.0;
+
+    // (0.003 + (0.003 + 0.001 + 0.002) / 3) / 2
+    std::vector<double> rates = {0.003, 0.001, 0.002, 0.009};
+    ASSERT_EQ(scorer.score(rates, score), FundingScorer::Result::Scored);
+    EXPECT_NEAR(score, 0.0025, 1e-12);
+
+    std::vector<double> negative = {-0.001, -0.002};
+    EXPECT_EQ(scorer.score(negative, score), FundingScorer::Result::NegativeNotSupported);
+
+    std::vector<double> contradicting = {0.0001, -0.01, -0.01};
+    EXPECT_EQ(scorer.score(contradicting, score), FundingScorer::Result::ContradictsLatest);
+    EXPECT_EQ(scorer.score({}, score), FundingScorer::Result::NoData);
+}
+
+TEST(FundingScorerTest, RankKeepsTopByAbsoluteScore) {
+    ScoringParams params = makeScoring();
+    params.reverseContractFundingRate = true;
+    FundingScorer scorer(params);
+
+    auto ranked = scorer.rank({{"A", {0.001, 0.001}}, {"B", {-0.004, -0.004}}, {"C", {0.002}}});
+    ASSERT_EQ(ranked.size(), 2u);
+    EXPECT_EQ(ranked[0].first, "B");
+    EXPECT_EQ(ranked[1].first, "C");
+}
+
+TEST(FundingScorerTest, RankWindowMatchesRankHistories) {
+    ScoringParams params = makeScoring();
+    params.reverseContractFundingRate = true;
+    FundingScorer scorer(params);
+
+    FundingWindow window;
+    window.symbols = {"A", "B", "C"};
+    window.depth = 2;
+    window.counts = {2, 2, 1};
+    window.rates = {0.001, 0.001, -0.004, -0.004, 0.002, 0.0};
+    auto ranked = scorer.rank(window);
+    ASSERT_EQ(ranked.size(), 2u);
+    EXPECT_EQ(ranked[0].first, "B");
+    EXPECT_EQ(ranked[1].first, "C");
+}
+
+TEST(FundingScorerTest, PositionSizingClampsRateAndValue) {
+    PositionSizing sizing;
+    sizing.minPositionValue = 100;
+    sizing.maxPositionValue = 150;
+    sizing.scalingFactor = 100;
+
+    EXPECT_NEAR(sizing.targetValue(0.0), 100 * (1 + std::log1p(0.001 * 100)), 1e-9);
+    EXPECT_DOUBLE_EQ(sizing.targetValue(0.5), 150);
+    sizing.positionScaling = false;
+    EXPECT_DOUBLE_EQ(sizing.targetValue(0.5), 100);
+}
+
+TEST(SweepSpaceTest, GridExpandsRangesAndDropsInvalidCombinations) {
+    Json::Value root;
+    root["periods"].append(Json::Value(Json::arrayValue));
+    root["periods"][0].append(3);
+    root["periods"][0].append(9);
+    root["weights"].append(Json::Value(Json::arrayValue));
+    root["weights"][0].append(1.0);
+    root["weights"][0].append(2.0);
+    root["weights"].append(Json::Value(Json::arrayValue));
+    root["weights"][1].append(1.0);  // 長度不符, 應被略過
+    root["scaling_factor"]["min"] = 1.0;
+    root["scaling_factor"]["max"] = 2.0;
+    root["scaling_factor"]["step"] = 0.5;
+    root["top_pairs_count"].append(3);
+    root["top_pairs_count"].append(5);
+
+    SweepParams base{makeScoring(), PositionSizing()};
+    auto candidates = SweepSpace::fromJson(root).grid(base);
+    ASSERT_EQ(candidates.size(), 6u);
+    EXPECT_DOUBLE_EQ(candidates.back().sizing.scalingFactor, 2.0);
+    EXPECT_EQ(candidates.back().scoring.topPairsCount, 5);
+    EXPECT_DOUBLE_EQ(candidates.front().sizing.maxScalingRate, base.sizing.maxScalingRate);
+
+    auto first = SweepSpace::fromJson(root).random(base, 10, 7);
+    auto second = SweepSpace::fromJson(root).random(base, 10, 7);
+    ASSERT_EQ(first.size(), 10u);
+    for (size_t i = 0; i < first.size(); i++) {
+        EXPECT_EQ(first[i].describe(), second[i].describe());
+        EXPECT_GE(first[i].sizing.scalingFactor, 1.0);
+        EXPECT_LE(first[i].sizing.scalingFactor, 2.0);
+    }
+}
+
+TEST(ParameterSweepTest, DatasetWindowsOnlySeePastFunding) {
+    auto dataset = makeDataset();
+    ASSERT_EQ(dataset->stepCount(), 30u);
+    ASSERT_EQ(dataset->symbolCount(), 3u);
+
+    for (size_t step = 0; step < dataset->stepCount(); step++) {
+        auto window = dataset->fundingWindow(step, 0);
+        ASSERT_EQ(window.size(), 9u);
+        EXPECT_GT(dataset->spotPrice(step, 0), 0.0);
+    }
+    // 最後一次結算超出數據範圍, 沒有可用的結算費率
+    EXPECT_GT(dataset->settledRate(0, 0), 0.0);
+    EXPECT_DOUBLE_EQ(dataset->settledRate(dataset->stepCount() - 1, 0), 0.0);
+}
+
+TEST(ParameterSweepTest, ParallelRunMatchesSequentialAndRanks) {
+    ParameterSweep sweep(makeDataset(), SweepCosts());
+
+    std::vector<SweepParams> candidates;
+    for (int top = 1; top <= 3; top++) {
+        SweepParams params{makeScoring(), PositionSizing()};
+        params.scoring.topPairsCount = top;
+        candidates.push_back(params);
+    }
+
+    auto sequential = sweep.run(candidates, 1);
+    auto parallel = sweep.run(candidates, 3);
+    ASSERT_EQ(parallel.size(), candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++) {
+        EXPECT_EQ(parallel[i].candidate, i);
+        EXPECT_DOUBLE_EQ(parallel[i].finalEquity, sequential[i].finalEquity);
+    }
+    // 只有正費率的幣對可進場, 應收到資金費
+    EXPECT_GT(sequential[0].fundingIncome, 0.0);
+    EXPECT_GT(sequential[0].fees, 0.0);
+
+    ParameterSweep::rank(parallel, 1.0);
+    for (size_t i = 1; i < parallel.size(); i++) {
+        EXPECT_GE(parallel[i - 1].objective, parallel[i].objective);
+    }
+    EXPECT_TRUE(std::any_of(parallel.begin(), parallel.end(),
+        [](const SweepResult& r) { return r.paretoOptimal; }));
+}
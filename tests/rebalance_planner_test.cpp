@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "trading/rebalance_planner.h"
+
+class RebalancePlannerTest : public ::testing::Test {
+protected:
+    RebalancePlanner planner;
+    std::map<std::string, std::pair<double, double>> prices{
+        {"BTCUSDT", {50000.0, 50010.0}},
+        {"ETHUSDT", {3000.0, 3001.0}},
+        {"SOLUSDT", {100.0, 100.1}},
+    };
+};
+
+// 仍在排行中的倉位只調整差額, 不再全平重開
+TEST_F(RebalancePlannerTest, NetsExistingPositionInsteadOfRoundTrip) {
+    std::map<std::string, std::pair<double, double>> holdings{{"ETHUSDT", {0.05, 0.05}}};
+    std::vector<HedgeTarget> targets{{"ETHUSDT", 0.06, 0.06, 0}};
+
+    auto plan = planner.plan(holdings, targets, prices);
+
+    ASSERT_EQ(plan.actions.size(), 1u);
+    EXPECT_NEAR(plan.actions[0].spotDelta, 0.01, 1e-12);
+    EXPECT_NEAR(plan.actions[0].contractDelta, 0.01, 1e-12);
+    EXPECT_EQ(plan.orderCount(), 2);
+    EXPECT_LT(plan.tradedNotional * 5, plan.roundTripNotional);
+}
+
+TEST_F(RebalancePlannerTest, ClosesSymbolsOutsideTargets) {
+    std::map<std::string, std::pair<double, double>> holdings{{"SOLUSDT", {1.0, 1.0}}};
+
+    auto plan = planner.plan(holdings, {}, prices);
+
+    ASSERT_EQ(plan.actions.size(), 1u);
+    EXPECT_TRUE(plan.actions[0].isClosing());
+    EXPECT_TRUE(plan.actions[0].isReducing());
+    EXPECT_DOUBLE_EQ(plan.actions[0].spotDelta, -1.0);
+    EXPECT_DOUBLE_EQ(plan.actions[0].contractDelta, -1.0);
+}
+
+TEST_F(RebalancePlannerTest, SkipsDeltasWithinTolerance) {
+    std::map<std::string, std::pair<double, double>> holdings{{"BTCUSDT", {0.0100, 0.0100}}};
+    // 差額只有 0.1%, 且名義價值低於最小下單金額
+    std::vector<HedgeTarget> targets{{"BTCUSDT", 0.01001, 0.01001, 0}};
+
+    auto plan = planner.plan(holdings, targets, prices);
+
+    EXPECT_TRUE(plan.empty());
+}
+
+// 減倉先於加倉, 加倉按排名順序
+TEST_F(RebalancePlannerTest, OrdersReductionsBeforeIncreasesByPriority) {
+    std::map<std::string, std::pair<double, double>> holdings{
+        {"SOLUSDT", {2.0, 2.0}},
+        {"ETHUSDT", {0.1, 0.1}},
+    };
+    std::vector<HedgeTarget> targets{
+        {"BTCUSDT", 0.002, 0.002, 0},
+        {"ETHUSDT", 0.05, 0.05, 1},
+        {"SOLUSDT", 3.0, 3.0, 2},
+    };
+
+    auto plan = planner.plan(holdings, targets, prices);
+
+    ASSERT_EQ(plan.actions.size(), 3u);
+    EXPECT_EQ(plan.actions[0].symbol, "ETHUSDT");
+    EXPECT_TRUE(plan.actions[0].isReducing());
+    EXPECT_FALSE(plan.actions[0].isClosing());
+    EXPECT_EQ(plan.actions[1].symbol, "BTCUSDT");
+    EXPECT_EQ(plan.actions[2].symbol, "SOLUSDT");
+}
+
+// 只修正失衡的一側
+TEST_F(RebalancePlannerTest, RepairsSingleLegImbalance) {
+    std::map<std::string, std::pair<double, double>> holdings{{"SOLUSDT", {3.0, 2.0}}};
+    std::vector<HedgeTarget> targets{{"SOLUSDT", 3.0, 3.0, 0}};
+
+    auto plan = planner.plan(holdings, targets, prices);
+
+    ASSERT_EQ(plan.actions.size(), 1u);
+    EXPECT_DOUBLE_EQ(plan.actions[0].spotDelta, 0.0);
+    EXPECT_DOUBLE_EQ(plan.actions[0].contractDelta, 1.0);
+    EXPECT_EQ(plan.orderCount(), 1);
+}
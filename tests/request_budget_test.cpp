@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "exchange/request_budget.h"
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 在同一時間點連續取得額度, 返回成功次數
+int drain(RequestBudget& budget, RequestPriority priority, RequestBudget::TimePoint now) {
+    int granted = 0;
+    while (budget.tryAcquire(priority, now) == std::chrono::nanoseconds::zero()) {
+        granted++;
+    }
+    return granted;
+}
+
+} // namespace
+
+TEST(RequestBudgetTest, LowerPrioritiesLeaveReserveForHigherOnes) {
+    RequestBudgetOptions options;
+    RequestBudget budget("test", 10.0, options);
+    auto now = std::chrono::steady_clock::now();
+
+    // 額度 10: 顯示保留 50%, 行情保留 25%, 風險保留 10%, 下單可用盡
+    EXPECT_EQ(drain(budget, RequestPriority::Display, now), 5);
+    EXPECT_EQ(drain(budget, RequestPriority::MarketData, now), 2);
+    EXPECT_EQ(drain(budget, RequestPriority::Risk, now), 2);
+    EXPECT_EQ(drain(budget, RequestPriority::OrderEntry, now), 1);
+
+    // 下單只需等一個額度的補充時間
+    auto wait = budget.tryAcquire(RequestPriority::OrderEntry, now);
+    EXPECT_NEAR(std::chrono::duration<double>(wait).count(), 0.1, 0.01);
+    EXPECT_GT(budget.tryAcquire(RequestPriority::Display, now), wait);
+
+    // 一秒後補滿
+    EXPECT_EQ(drain(budget, RequestPriority::OrderEntry, now + std::chrono::seconds(1)), 10);
+
+    auto stats = budget.stats();
+    EXPECT_EQ(stats.granted[static_cast<size_t>(RequestPriority::Display)], 5u);
+    EXPECT_EQ(stats.granted[static_cast<size_t>(RequestPriority::OrderEntry)], 11u);
+}
+
+TEST(RequestBudgetTest, OrderEntryIsNotQueuedBehindDisplay) {
+    RequestBudgetOptions options;
+    RequestBudget budget("test", 20.0, options);
+    drain(budget, RequestPriority::OrderEntry, std::chrono::steady_clock::now());
+
+    std::mutex orderMutex;
+    std::vector<RequestPriority> order;
+    std::thread display([&] {
+        budget.acquire(RequestPriority::Display);
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(RequestPriority::Display);
+    });
+    // 顯示請求先開始等待
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    budget.acquire(RequestPriority::OrderEntry);
+    {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(RequestPriority::OrderEntry);
+    }
+    display.join();
+
+    EXPECT_EQ(order, (std::vector<RequestPriority>{RequestPriority::OrderEntry, RequestPriority::Display}));
+    auto stats = budget.stats();
+    EXPECT_EQ(stats.deferred[static_cast<size_t>(RequestPriority::Display)], 1u);
+}
+
+TEST(RequestBudgetTest, RateLimitResponseEmptiesBudget) {
+    RequestBudgetOptions options;
+    RequestBudget budget("test", 10.0, options);
+    auto now = std::chrono::steady_clock::now();
+    budget.exhaust(now);
+    EXPECT_DOUBLE_EQ(budget.available(now), 0.0);
+    EXPECT_GT(budget.tryAcquire(RequestPriority::OrderEntry, now), std::chrono::nanoseconds::zero());
+
+    options.enabled = false;
+    RequestBudget unlimited("test", 10.0, options);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(unlimited.tryAcquire(RequestPriority::Display, now), std::chrono::nanoseconds::zero());
+    }
+}
+
+TEST(RequestBudgetTest, ScopesOverrideEndpointDefaults) {
+    EXPECT_EQ(defaultRequestPriority("/v5/order/create"), RequestPriority::OrderEntry);
+    EXPECT_EQ(defaultRequestPriority("/v5/position/list"), RequestPriority::Risk);
+    EXPECT_EQ(defaultRequestPriority("/v5/market/tickers"), RequestPriority::MarketData);
+
+    EXPECT_EQ(currentRequestPriority(RequestPriority::MarketData), RequestPriority::MarketData);
+    {
+        RequestPriorityScope display(RequestPriority::Display);
+        EXPECT_EQ(currentRequestPriority(RequestPriority::OrderEntry), RequestPriority::Display);
+        {
+            RequestPriorityScope entry(RequestPriority::OrderEntry);
+            EXPECT_EQ(currentRequestPriority(RequestPriority::MarketData), RequestPriority::OrderEntry);
+        }
+        EXPECT_EQ(currentRequestPriority(RequestPriority::MarketData), RequestPriority::Display);
+    }
+    EXPECT_EQ(currentRequestPriority(RequestPriority::Risk), RequestPriority::Risk);
+}
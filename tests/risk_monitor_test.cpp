@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "trading/risk_monitor.h"
+#include <condition_variable>
+#include <mutex>
+
+class RiskMonitorTest : public ::testing::Test {
+protected:
+    RiskMonitorTest() : clock(IClock::TimePoint(std::chrono::hours(1000))) {
+        options.enabled = true;
+        options.pollInterval = std::chrono::milliseconds(0);
+        options.maintenanceMarginRate = 0.01;
+        options.warnRatio = 0.5;
+        options.deleverageRatio = 0.8;
+        options.deleverageFraction = 0.25;
+        options.deleverageCooldown = std::chrono::seconds(30);
+    }
+
+    // 等待處理函數收到 count 個警報
+    bool waitForAlerts(size_t count) {
+        std::unique_lock<std::mutex> lock(alertMutex);
+        return alertCv.wait_for(lock, std::chrono::seconds(5), [&] { return received.size() >= count; });
+    }
+
+    void recordAlerts(RiskMonitor& monitor) {
+        monitor.setDeleverageHandler([this](const RiskAlert& alert) {
+            std::lock_guard<std::mutex> lock(alertMutex);
+            received.push_back(alert);
+            alertCv.notify_all();
+        });
+    }
+
+    VirtualClock clock;
+    RiskOptions options;
+    std::mutex alertMutex;
+    std::condition_variable alertCv;
+    std::vector<RiskAlert> received;
+};
+
+TEST_F(RiskMonitorTest, IncrementalRatiosFollowPriceTicks) {
+    RiskMonitor monitor(clock, options);
+    monitor.sync({{"BTCUSDT", 1.0, 1.0, 100.0, 10}, {"ETHUSDT", 10.0, 10.0, 10.0, 10}}, 1000.0);
+
+    // 首筆行情確定基準價, 權益不變
+    monitor.onPrice("BTCUSDT", 100.0, 100.0);
+    monitor.onPrice("ETHUSDT", 10.0, 10.0);
+    EXPECT_DOUBLE_EQ(monitor.equity(), 1000.0);
+    // 維持保證金 (1*100 + 10*10) * 1% = 2
+    EXPECT_DOUBLE_EQ(monitor.accountMarginRatio(), 2.0 / 1000.0);
+    // 逐倉: 維持 1 / 初始 10
+    EXPECT_DOUBLE_EQ(monitor.positionMarginRatio("BTCUSDT"), 0.1);
+
+    // 合約上漲 5, 現貨同步上漲: 對沖後權益不變, 逐倉保證金減少
+    monitor.onPrice("BTCUSDT", 105.0, 105.0);
+    EXPECT_DOUBLE_EQ(monitor.equity(), 1000.0);
+    EXPECT_DOUBLE_EQ(monitor.positionMarginRatio("BTCUSDT"), 1.05 / 5.0);
+    EXPECT_DOUBLE_EQ(monitor.accountMarginRatio(), 2.05 / 1000.0);
+
+    // 只有合約行情時沿用上一筆現貨價
+    monitor.onPrice("BTCUSDT", 0.0, 110.0);
+    EXPECT_DOUBLE_EQ(monitor.equity(), 995.0);
+    monitor.onPrice("SOLUSDT", 1.0, 1.0);
+    EXPECT_EQ(monitor.symbols().size(), 2u);
+}
+
+TEST_F(RiskMonitorTest, CrossingThresholdDispatchesDeleverageOnWorkerThread) {
+    RiskMonitor monitor(clock, options);
+    recordAlerts(monitor);
+    monitor.start(nullptr);
+    monitor.sync({{"BTCUSDT", 1.0, 1.0, 100.0, 10}}, 1000.0);
+    monitor.onPrice("BTCUSDT", 100.0, 100.0);
+
+    // 維持 1.06 / (10 - 6) = 0.265: 只警告
+    monitor.onPrice("BTCUSDT", 106.0, 106.0);
+    // 維持 1.09 / (10 - 9) = 1.09: 超過減倉門檻
+    monitor.onPrice("BTCUSDT", 109.0, 109.0);
+    ASSERT_TRUE(waitForAlerts(1));
+    {
+        std::lock_guard<std::mutex> lock(alertMutex);
+        ASSERT_EQ(received.size(), 1u);
+        EXPECT_EQ(received[0].symbol, "BTCUSDT");
+        EXPECT_FALSE(received[0].accountTriggered);
+        EXPECT_DOUBLE_EQ(received[0].reduceFraction, 0.25);
+        EXPECT_GT(received[0].positionRatio, 1.0);
+    }
+
+    // 冷卻期內不重複觸發, 過期後再次觸發
+    monitor.onPrice("BTCUSDT", 109.5, 109.5);
+    clock.advance(std::chrono::seconds(31));
+    monitor.onPrice("BTCUSDT", 109.5, 109.5);
+    ASSERT_TRUE(waitForAlerts(2));
+    monitor.stop();
+    std::lock_guard<std::mutex> lock(alertMutex);
+    EXPECT_EQ(received.size(), 2u);
+}
+
+TEST_F(RiskMonitorTest, AccountThresholdPicksWorstPosition) {
+    options.deleverageRatio = 0.5;
+    RiskMonitor monitor(clock, options);
+    recordAlerts(monitor);
+    monitor.start(nullptr);
+    // 權益很小, 帳戶保證金率先於逐倉門檻觸發
+    monitor.sync({{"BTCUSDT", 1.0, 1.0, 100.0, 2}, {"ETHUSDT", 10.0, 10.0, 10.0, 5}}, 4.0);
+    monitor.onPrice("ETHUSDT", 10.0, 10.0);
+    monitor.onPrice("BTCUSDT", 100.0, 100.0);
+    ASSERT_TRUE(waitForAlerts(1));
+    monitor.stop();
+    std::lock_guard<std::mutex> lock(alertMutex);
+    EXPECT_TRUE(received[0].accountTriggered);
+    // ETH 槓桿較高, 逐倉保證金率較高
+    EXPECT_EQ(received[0].symbol, "ETHUSDT");
+}
+
+TEST_F(RiskMonitorTest, UpdatePositionRealizesPnl) {
+    RiskMonitor monitor(clock, options);
+    monitor.sync({{"BTCUSDT", 0.0, 1.0, 100.0, 10}}, 1000.0);
+    monitor.onPrice("BTCUSDT", 0.0, 100.0);
+    monitor.onPrice("BTCUSDT", 0.0, 104.0);
+    EXPECT_DOUBLE_EQ(monitor.equity(), 996.0);
+
+    // 減倉一半後, 已實現虧損保留在權益中, 之後只按剩餘數量計算
+    monitor.updatePosition({"BTCUSDT", 0.0, 0.5, 100.0, 10});
+    EXPECT_DOUBLE_EQ(monitor.equity(), 996.0);
+    monitor.onPrice("BTCUSDT", 0.0, 106.0);
+    EXPECT_DOUBLE_EQ(monitor.equity(), 995.0);
+
+    monitor.updatePosition({"BTCUSDT", 0.0, 0.0, 100.0, 10});
+    EXPECT_TRUE(monitor.symbols().empty());
+    EXPECT_DOUBLE_EQ(monitor.accountMarginRatio(), 0.0);
+}
+
+TEST_F(RiskMonitorTest, PollsPriceSourceForHeldSymbols) {
+    options.pollInterval = std::chrono::milliseconds(5);
+    RiskMonitor monitor(clock, options);
+    recordAlerts(monitor);
+    std::atomic<double> price{100.0};
+    monitor.sync({{"BTCUSDT", 1.0, 1.0, 100.0, 10}}, 1000.0);
+    monitor.start([&price](const std::string&) { return std::make_pair(price.load(), price.load()); });
+    price = 109.0;
+    ASSERT_TRUE(waitForAlerts(1));
+    monitor.stop();
+    EXPECT_FALSE(monitor.isRunning());
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "scheduler/settlement_calendar.h"
+#include "scheduler/task_scheduler.h"
+#include <chrono>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+// 2024-01-01 00:00:00 UTC 起算
+IClock::TimePoint utc(int day, int hour, int minute) {
+    return IClock::TimePoint(sys_days(year(2024) / January / 1)) +
+           days(day) + hours(hour) + minutes(minute);
+}
+
+} // namespace
+
+class SettlementCalendarTest : public ::testing::Test {
+protected:
+    SettlementCalendar calendar{{"00:00", "08:00", "16:00"}, 30, 1};
+};
+
+TEST_F(SettlementCalendarTest, NextSettlementWrapsAcrossDays) {
+    EXPECT_EQ(calendar.nextSettlement(utc(0, 7, 59)), utc(0, 8, 0));
+    EXPECT_EQ(calendar.nextSettlement(utc(0, 8, 0)), utc(0, 16, 0));
+    EXPECT_EQ(calendar.nextSettlement(utc(0, 23, 10)), utc(1, 0, 0));
+    EXPECT_EQ(calendar.previousSettlement(utc(0, 8, 0)), utc(0, 8, 0));
+    EXPECT_EQ(calendar.previousSettlement(utc(1, 0, 0) - seconds(1)), utc(0, 16, 0));
+}
+
+TEST_F(SettlementCalendarTest, PreAndPostSettlementDeadlines) {
+    EXPECT_EQ(calendar.nextPreSettlementEntry(utc(0, 7, 0)), utc(0, 7, 30));
+    // 已進入預留時間, 下一個進場點為下一個結算週期
+    EXPECT_EQ(calendar.nextPreSettlementEntry(utc(0, 7, 30)), utc(0, 15, 30));
+    EXPECT_EQ(calendar.nextPostSettlementRefresh(utc(0, 8, 0)), utc(0, 8, 1));
+    EXPECT_EQ(calendar.nextPostSettlementRefresh(utc(0, 8, 1)), utc(0, 16, 1));
+}
+
+TEST_F(SettlementCalendarTest, NearSettlementWindow) {
+    EXPECT_TRUE(calendar.isNearSettlement(utc(0, 23, 45)));
+    EXPECT_TRUE(calendar.isNearSettlement(utc(0, 7, 30)));
+    EXPECT_FALSE(calendar.isNearSettlement(utc(0, 7, 29)));
+    EXPECT_FALSE(calendar.isNearSettlement(utc(0, 8, 5)));
+}
+
+TEST_F(SettlementCalendarTest, InvalidTimesAreIgnored) {
+    SettlementCalendar partial({"bad", "25:00", "12:00"}, 10);
+    EXPECT_FALSE(partial.empty());
+    EXPECT_EQ(partial.nextSettlement(utc(0, 0, 0)), utc(0, 12, 0));
+
+    SettlementCalendar none({}, 10);
+    EXPECT_TRUE(none.empty());
+    EXPECT_FALSE(none.isNearSettlement(utc(0, 0, 0)));
+}
+
+TEST(TaskSchedulerTest, RunsJobsInDeadlineOrder) {
+    VirtualClock clock(utc(0, 7, 0));
+    SettlementCalendar calendar({"00:00", "08:00", "16:00"}, 30, 1);
+    TaskScheduler scheduler(clock);
+    std::vector<std::pair<JobType, IClock::TimePoint>> executed;
+
+    scheduler.addJob(JobType::PreSettlementEntry, "entry",
+        [&calendar](IClock::TimePoint after) { return calendar.nextPreSettlementEntry(after); },
+        [&]() { executed.emplace_back(JobType::PreSettlementEntry, clock.now()); });
+    scheduler.addJob(JobType::PostSettlementRefresh, "refresh",
+        [&calendar](IClock::TimePoint after) { return calendar.nextPostSettlementRefresh(after); },
+        [&]() { executed.emplace_back(JobType::PostSettlementRefresh, clock.now()); });
+    scheduler.addJob(JobType::PeriodicReconcile, "reconcile",
+        [](IClock::TimePoint after) { return after + hours(2); },
+        [&]() { executed.emplace_back(JobType::PeriodicReconcile, clock.now()); });
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(scheduler.runNext());
+    }
+
+    ASSERT_EQ(executed.size(), 4u);
+    EXPECT_EQ(executed[0], std::make_pair(JobType::PreSettlementEntry, utc(0, 7, 30)));
+    EXPECT_EQ(executed[1], std::make_pair(JobType::PostSettlementRefresh, utc(0, 8, 1)));
+    EXPECT_EQ(executed[2], std::make_pair(JobType::PeriodicReconcile, utc(0, 9, 0)));
+    EXPECT_EQ(executed[3], std::make_pair(JobType::PeriodicReconcile, utc(0, 11, 0)));
+}
+
+TEST(TaskSchedulerTest, OverrunDoesNotReplayMissedPeriods) {
+    VirtualClock clock(utc(0, 0, 0));
+    TaskScheduler scheduler(clock);
+    int runs = 0;
+
+    scheduler.addJob(JobType::PeriodicReconcile, "slow",
+        [](IClock::TimePoint after) { return after + minutes(5); },
+        [&]() {
+            runs++;
+            clock.advance(minutes(17));  // 執行時間超過間隔
+        });
+
+    ASSERT_TRUE(scheduler.runNext());
+    EXPECT_EQ(clock.now(), utc(0, 0, 22));
+    EXPECT_EQ(scheduler.nextDeadline(), utc(0, 0, 27));
+
+    scheduler.stop();
+    EXPECT_FALSE(scheduler.runNext());
+    EXPECT_EQ(runs, 1);
+}
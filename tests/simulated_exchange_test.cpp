@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "backtest/backtest_runner.h"
+#include "backtest/market_history.h"
+#include "backtest/simulated_exchange.h"
+#include "config.h"
+#include "storage/sqlite_storage.h"
+#include "trading/warm_state.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+constexpr int64_t HOUR_MS = 3600 * 1000;
+// 2024-01-01 00:00:00 UTC
+constexpr int64_t START_MS = 1704067200000;
+
+IClock::TimePoint at(int64_t ms) {
+    return IClock::TimePoint(std::chrono::milliseconds(ms));
+}
+
+// withUnbookedSymbol: 另加一個合約訂單簿為空的交易對, 合約下單會被拒絕 (Not supported symbols)
+std::shared_ptr<MarketHistory> makeHistory(bool withUnbookedSymbol = false) {
+    auto history = std::make_shared<MarketHistory>();
+    SymbolHistory& btc = history->symbol("BTCUSDT");
+    for (int h = 0; h < 48; h++) {
+        double price = 40000.0 + h * 10;
+        btc.tickers.push_back({START_MS + h * HOUR_MS, price, price + 5});
+    }
+    for (int k = 0; k < 6; k++) {
+        btc.funding.push_back({START_MS + k * 8 * HOUR_MS, 0.0001 * (k + 1)});
+    }
+    btc.spotBooks.push_back({START_MS + 2 * HOUR_MS,
+                             {{39990, 1.0}, {39980, 1.0}},
+                             {{40010, 0.5}, {40020, 1.0}}});
+    if (withUnbookedSymbol) {
+        SymbolHistory& eth = history->symbol("ETHUSDT");
+        for (int h = 0; h < 48; h++) {
+            eth.tickers.push_back({START_MS + h * HOUR_MS, 20.0, 20.01});
+        }
+        for (int k = 0; k < 6; k++) {
+            eth.funding.push_back({START_MS + k * 8 * HOUR_MS, 0.002});
+        }
+        // 合約訂單簿為空
+        eth.contractBooks.push_back({START_MS, {}, {}});
+    }
+    history->finalize();
+    return history;
+}
+
+// 文件內容, 不存在時返回 nullopt
+std::optional<std::string> fileContents(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+} // namespace
+
+TEST(MarketHistoryTest, LookupsNeverSeeTheFuture) {
+    auto history = makeHistory();
+
+    EXPECT_EQ(history->tickerAt("BTCUSDT", START_MS - 1), nullptr);
+    const TickerPoint* ticker = history->tickerAt("BTCUSDT", START_MS + HOUR_MS + 10);
+    ASSERT_NE(ticker, nullptr);
+    EXPECT_EQ(ticker->timestampMs, START_MS + HOUR_MS);
+
+    auto rates = history->fundingBefore("BTCUSDT", START_MS + 16 * HOUR_MS, 10);
+    ASSERT_EQ(rates.size(), 3u);
+    EXPECT_DOUBLE_EQ(rates[0], 0.0003);  // 最新在前
+    EXPECT_DOUBLE_EQ(rates[2], 0.0001);
+
+    EXPECT_EQ(history->bookAt("BTCUSDT", true, START_MS + HOUR_MS), nullptr);
+    EXPECT_NE(history->bookAt("BTCUSDT", true, START_MS + 3 * HOUR_MS), nullptr);
+}
+
+TEST(SimulatedExchangeTest, SpotOrdersWalkRecordedBookAndChargeFees) {
+    VirtualClock clock(at(START_MS + 2 * HOUR_MS));
+    SimulationOptions options;
+    options.initialCapital = 100000;
+    SimulatedExchange exchange(makeHistory(), clock, options);
+
+    // 0.5 @ 40010 + 0.5 @ 40020
+    ASSERT_TRUE(exchange.createSpotOrder("BTCUSDT", "Buy", 1.0));
+    EXPECT_NEAR(exchange.cashBalance(), 100000 - 40015.0, 1e-6);
+    EXPECT_NEAR(exchange.getSpotBalance("BTCUSDT"), 1.0 * (1 - options.spotFeeRate), 1e-12);
+    EXPECT_NEAR(exchange.stats().fees, 40015.0 * options.spotFeeRate, 1e-6);
+
+    EXPECT_FALSE(exchange.createSpotOrder("BTCUSDT", "Sell", 2.0));
+    EXPECT_EQ(exchange.getLastError(), "Insufficient balance");
+    EXPECT_EQ(exchange.stats().rejectedOrders, 1);
+}
+
+TEST(SimulatedExchangeTest, PerpPositionsRealizePnlAndSettleFunding) {
+    VirtualClock clock(at(START_MS));
+    SimulatedExchange exchange(makeHistory(), clock);
+
+    Json::Value response = exchange.createOrder("BTCUSDT", "Sell", 0.1);
+    ASSERT_EQ(response["retCode"].asInt(), 0);
+    Json::Value positions = exchange.getPositions();
+    ASSERT_EQ(positions["result"]["list"].size(), 1u);
+    EXPECT_EQ(positions["result"]["list"][0]["side"].asString(), "Sell");
+    EXPECT_DOUBLE_EQ(std::stod(positions["result"]["list"][0]["size"].asString()), 0.1);
+
+    // 費率 0.0001 為正, 空頭收取資金費
+    double cashBefore = exchange.cashBalance();
+    exchange.settleFunding();
+    EXPECT_GT(exchange.cashBalance(), cashBefore);
+    EXPECT_NEAR(exchange.stats().fundingIncome, 0.1 * 40005 * 0.0001, 1e-9);
+
+    clock.setTime(at(START_MS + 10 * HOUR_MS));
+    exchange.closePosition("BTCUSDT");
+    EXPECT_TRUE(exchange.getPositions()["result"]["list"].empty());
+    EXPECT_EQ(exchange.stats().orders, 2);
+
+    EXPECT_EQ(exchange.createOrder("ETHUSDT", "Buy", 1.0)["retCode"].asInt(), 10001);
+}
+
+TEST(SimulatedExchangeTest, RejectsReusedOrderLinkIds) {
+    VirtualClock clock(at(START_MS + 2 * HOUR_MS));
+    SimulatedExchange exchange(makeHistory(), clock);
+
+    EXPECT_EQ(exchange.createOrder("BTCUSDT", "Sell", 0.1, "linear", "MARKET", "g-1c")["retCode"].asInt(), 0);
+    EXPECT_EQ(exchange.createOrder("BTCUSDT", "Sell", 0.1, "linear", "MARKET", "g-1c")["retCode"].asInt(),
+              ORDER_LINK_ID_DUPLICATE);
+    EXPECT_TRUE(exchange.createSpotOrder("BTCUSDT", "Buy", 0.05, "g-1s"));
+    EXPECT_FALSE(exchange.createSpotOrder("BTCUSDT", "Buy", 0.05, "g-1s"));
+    // 不帶訂單號的訂單不去重
+    EXPECT_TRUE(exchange.createSpotOrder("BTCUSDT", "Buy", 0.05));
+    EXPECT_TRUE(exchange.createSpotOrder("BTCUSDT", "Buy", 0.05));
+    EXPECT_EQ(exchange.stats().orders, 4);
+}
+
+TEST(BacktestRunnerTest, RunsStrategyOverHistoryWithVirtualTime) {
+    BacktestOptions options;
+    options.reconcileInterval = std::chrono::minutes(240);
+    BacktestRunner runner(makeHistory());
+
+    auto started = std::chrono::steady_clock::now();
+    BacktestReport report = runner.run(options);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    // 48 小時的數據, 不應實際等待
+    EXPECT_LT(elapsed, std::chrono::seconds(10));
+    EXPECT_EQ(report.startMs, START_MS);
+    EXPECT_GE(report.settlements, 5);
+    EXPECT_FALSE(report.equityCurve.empty());
+    EXPECT_NEAR(report.pnl, report.finalEquity - report.initialEquity, 1e-9);
+}
+
+TEST(BacktestRunnerTest, LeavesLiveStateUntouched) {
+    const std::string database = StorageOptions().path;
+    const std::vector<std::string> paths{database, database + "-wal", Config::PAIR_LIST_FILE,
+                                         WarmStateOptions::fromConfig().path};
+    std::vector<std::optional<std::string>> before;
+    for (const auto& path : paths) {
+        before.push_back(path.empty() ? std::nullopt : fileContents(path));
+    }
+
+    BacktestOptions options;
+    options.reconcileInterval = std::chrono::minutes(240);
+    // 被拒絕的交易對會觸發封鎖, 成交會記錄對沖組
+    BacktestReport report = BacktestRunner(makeHistory(true)).run(options);
+    EXPECT_GT(report.orders, 0);
+    EXPECT_GT(report.rejectedOrders, 0);
+
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (!paths[i].empty()) {
+            EXPECT_EQ(fileContents(paths[i]), before[i]) << paths[i];
+        }
+    }
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "trading/order_book.h"
+#include "trading/sliced_executor.h"
+#include "mock_exchange.h"
+#include <cmath>
+
+using ::testing::_;
+using ::testing::Return;
+
+namespace {
+
+// 建立 Bybit 格式的訂單簿: 每層 (價格, 數量)
+Json::Value makeBook(const std::vector<std::pair<double, double>>& asks,
+                     const std::vector<std::pair<double, double>>& bids) {
+    Json::Value book;
+    book["retCode"] = 0;
+    book["result"]["a"] = Json::Value(Json::arrayValue);
+    book["result"]["b"] = Json::Value(Json::arrayValue);
+    for (const auto& [price, qty] : asks) {
+        Json::Value level(Json::arrayValue);
+        level.append(std::to_string(price));
+        level.append(std::to_string(qty));
+        book["result"]["a"].append(level);
+    }
+    for (const auto& [price, qty] : bids) {
+        Json::Value level(Json::arrayValue);
+        level.append(std::to_string(price));
+        level.append(std::to_string(qty));
+        book["result"]["b"].append(level);
+    }
+    return book;
+}
+
+Json::Value okResponse() {
+    Json::Value response;
+    response["retCode"] = 0;
+    return response;
+}
+
+} // namespace
+
+TEST(OrderBookTest, CostCurveRespectsImpactLimit) {
+    std::vector<BookLevel> asks{{100.0, 1.0}, {100.1, 1.0}, {101.0, 5.0}};
+
+    EXPECT_DOUBLE_EQ(averageImpact(asks, 1.0), 0.0);
+    EXPECT_NEAR(averageImpact(asks, 2.0), 0.0005, 1e-9);
+
+    // 0.05% 上限剛好容納前兩層
+    double capacity = maxQuantityWithinImpact(asks, 0.0005);
+    EXPECT_NEAR(capacity, 2.0, 1e-9);
+    EXPECT_LE(averageImpact(asks, capacity), 0.0005 + 1e-12);
+
+    // 第三層只能部分成交
+    double wider = maxQuantityWithinImpact(asks, 0.002);
+    EXPECT_GT(wider, 2.0);
+    EXPECT_LT(wider, 7.0);
+    EXPECT_NEAR(averageImpact(asks, wider), 0.002, 1e-9);
+}
+
+TEST(OrderBookTest, ParsesSidesAndSkipsInvalidLevels) {
+    Json::Value book = makeBook({{10.0, 2.0}}, {{9.9, 3.0}});
+    Json::Value bad(Json::arrayValue);
+    bad.append("x");
+    book["result"]["a"].append(bad);
+
+    auto asks = parseBookSide(book, "a");
+    auto bids = parseBookSide(book, "b");
+    ASSERT_EQ(asks.size(), 1u);
+    ASSERT_EQ(bids.size(), 1u);
+    EXPECT_DOUBLE_EQ(bids[0].price, 9.9);
+    EXPECT_TRUE(parseBookSide(Json::Value(), "a").empty());
+}
+
+class SlicedExecutorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // 每層 1 個單位, 0.05% 滑點上限下每個子單約 2 個單位
+        Json::Value thinBook = makeBook({{100.0, 1.0}, {100.1, 1.0}, {102.0, 50.0}},
+                                        {{99.9, 1.0}, {99.8, 1.0}, {98.0, 50.0}});
+        ON_CALL(exchange, getSpotOrderBook(_)).WillByDefault(Return(thinBook));
+        ON_CALL(exchange, getContractOrderBook(_)).WillByDefault(Return(thinBook));
+        ON_CALL(exchange, createSpotOrder(_, _, _, _)).WillByDefault(Return(true));
+        ON_CALL(exchange, createOrder(_, _, _, _, _, _)).WillByDefault(Return(okResponse()));
+        ON_CALL(exchange, getLastError()).WillByDefault(Return(std::string("rejected")));
+
+        options.maxSliceImpact = 0.0005;
+        options.maxSlices = 10;
+        options.sliceIntervalMs = 1000;
+    }
+
+    HedgeSliceRequest request(double quantity) {
+        HedgeSliceRequest r;
+        r.symbol = "ALTUSDT";
+        r.spotSide = "Buy";
+        r.contractSide = "Sell";
+        r.quantity = quantity;
+        r.minQuantity = 0.1;
+        r.roundSpot = [](double q) { return std::floor(q * 10) / 10.0; };
+        r.roundContract = [](double q) { return std::floor(q * 10) / 10.0; };
+        return r;
+    }
+
+    ::testing::NiceMock<MockExchange> exchange;
+    VirtualClock clock;
+    SlicedExecutor::Options options;
+};
+
+TEST_F(SlicedExecutorTest, SplitsLargeHedgeIntoLockstepChildren) {
+    SlicedExecutor executor(exchange, clock, options);
+    ASSERT_TRUE(executor.needsSlicing("ALTUSDT", "Buy", "Sell", 7.0));
+
+    std::vector<double> contractChildren;
+    std::vector<std::string> linkIds;
+    EXPECT_CALL(exchange, createOrder("ALTUSDT", "Sell", _, "linear", "MARKET", _))
+        .WillRepeatedly([&contractChildren, &linkIds](const std::string&, const std::string&, double qty,
+                                                      const std::string&, const std::string&,
+                                                      const std::string& orderLinkId) {
+            contractChildren.push_back(qty);
+            linkIds.push_back(orderLinkId);
+            return okResponse();
+        });
+
+    int reports = 0;
+    HedgeSliceRequest hedge = request(7.0);
+    hedge.orderLinkId = [](char leg, int slice) { return std::string("g-") + leg + std::to_string(slice); };
+    auto result = executor.execute(hedge, [&reports](const SliceProgress&) { reports++; });
+
+    EXPECT_FALSE(result.failed);
+    EXPECT_FALSE(result.running);
+    EXPECT_NEAR(result.spotFilled, 7.0, 1e-9);
+    EXPECT_NEAR(result.contractFilled, 7.0, 1e-9);
+    EXPECT_EQ(result.slicesDone, 4);
+    ASSERT_EQ(contractChildren.size(), 4u);
+    for (double child : contractChildren) {
+        EXPECT_LE(child, 2.0 + 1e-9);
+    }
+    // 每個子單有各自的客戶端訂單號
+    EXPECT_EQ(linkIds, (std::vector<std::string>{"g-c1", "g-c2", "g-c3", "g-c4"}));
+    EXPECT_GT(reports, 4);
+    EXPECT_NEAR(executor.progress().completion(), 1.0, 1e-9);
+}
+
+TEST_F(SlicedExecutorTest, RevertsSpotChildWhenContractChildFails) {
+    SlicedExecutor executor(exchange, clock, options);
+    Json::Value rejected;
+    rejected["retCode"] = 10001;
+    EXPECT_CALL(exchange, createOrder(_, _, _, _, _, _))
+        .WillOnce(Return(okResponse()))
+        .WillOnce(Return(rejected));
+    EXPECT_CALL(exchange, createSpotOrder("ALTUSDT", "Buy", _, _)).Times(2).WillRepeatedly(Return(true));
+    EXPECT_CALL(exchange, createSpotOrder("ALTUSDT", "Sell", _, _)).Times(1).WillOnce(Return(true));
+
+    auto result = executor.execute(request(7.0));
+
+    EXPECT_TRUE(result.failed);
+    EXPECT_NEAR(result.spotFilled, result.contractFilled, 1e-9);
+    EXPECT_EQ(result.slicesDone, 1);
+}
+
+TEST_F(SlicedExecutorTest, CancelStopsBeforeNextChild) {
+    SlicedExecutor executor(exchange, clock, options);
+    EXPECT_CALL(exchange, createOrder(_, _, _, _, _, _))
+        .WillOnce([&executor](const std::string&, const std::string&, double,
+                              const std::string&, const std::string&, const std::string&) {
+            executor.cancel();
+            return okResponse();
+        });
+
+    auto result = executor.execute(request(7.0));
+
+    EXPECT_TRUE(result.cancelled);
+    EXPECT_FALSE(result.failed);
+    EXPECT_EQ(result.slicesDone, 1);
+}
+
+TEST_F(SlicedExecutorTest, CancelBeforeExecuteIsNotLost) {
+    SlicedExecutor executor(exchange, clock, options);
+    EXPECT_CALL(exchange, createSpotOrder(_, _, _, _)).Times(0);
+    EXPECT_CALL(exchange, createOrder(_, _, _, _, _, _)).Times(0);
+
+    // 調用方決定切片之後, execute() 開始之前到達的取消
+    executor.cancel();
+    auto result = executor.execute(request(7.0));
+    EXPECT_TRUE(result.cancelled);
+    EXPECT_EQ(result.slicesDone, 0);
+
+    // 取消只作用於一次執行
+    ::testing::Mock::VerifyAndClearExpectations(&exchange);
+    result = executor.execute(request(7.0));
+    EXPECT_FALSE(result.cancelled);
+    EXPECT_NEAR(result.contractFilled, 7.0, 1e-9);
+}
+
+TEST_F(SlicedExecutorTest, PreemptionStopsDuringSliceInterval) {
+    options.sliceIntervalMs = 60000;
+    SlicedExecutor executor(exchange, clock, options);
+    bool pending = false;
+    EXPECT_CALL(exchange, createOrder(_, _, _, _, _, _))
+        .WillOnce([&pending](const std::string&, const std::string&, double,
+                             const std::string&, const std::string&, const std::string&) {
+            pending = true;
+            return okResponse();
+        });
+
+    HedgeSliceRequest hedge = request(7.0);
+    hedge.preempted = [&pending] { return pending; };
+    auto started = clock.now();
+    auto result = executor.execute(hedge);
+
+    // 不等滿子單間隔
+    EXPECT_TRUE(result.cancelled);
+    EXPECT_EQ(result.slicesDone, 1);
+    EXPECT_LT(clock.now() - started, std::chrono::seconds(1));
+}
+
+TEST_F(SlicedExecutorTest, FailsWhenDepthNeverReplenishes) {
+    options.trigger = SliceTrigger::Replenish;
+    options.replenishTimeoutMs = 1000;
+    Json::Value empty = makeBook({}, {});
+    ON_CALL(exchange, getContractOrderBook(_)).WillByDefault(Return(empty));
+    SlicedExecutor executor(exchange, clock, options);
+    EXPECT_CALL(exchange, createOrder(_, _, _, _, _, _)).Times(0);
+
+    auto result = executor.execute(request(3.0));
+
+    EXPECT_TRUE(result.failed);
+    EXPECT_EQ(result.slicesDone, 0);
+}
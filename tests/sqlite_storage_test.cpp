@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "storage/sqlite_storage.h"
 #include <filesystem>
+#include <thread>
 
 class SQLiteStorageTest : public ::testing::Test {
 protected:
@@ -48,4 +49,241 @@ TEST_F(SQLiteStorageTest, DatabaseConnection) {
     storage->storeTradeData("BTCUSDT", 0.001);
     auto trades = storage->getActiveTradeGroups();
     EXPECT_FALSE(trades.empty());
-} 
\ No newline at end of file
+} 
+class SQLiteStorageBatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "sqlite_storage_batch_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        options.path = (dir / "trading.db").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    int countRows(const char* table) {
+        sqlite3* db = nullptr;
+        sqlite3_open(options.path.c_str(), &db);
+        sqlite3_stmt* stmt = nullptr;
+        std::string sql = std::string("SELECT COUNT(*) FROM ") + table + ";";
+        sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+        int count = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : -1;
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        return count;
+    }
+
+    std::filesystem::path dir;
+    StorageOptions options;
+};
+
+TEST_F(SQLiteStorageBatchTest, UsesWalJournal) {
+    SQLiteStorage storage(options);
+    ASSERT_TRUE(storage.isConnectionValid());
+    storage.storeTradeData("BTCUSDT", 0.001);
+    ASSERT_TRUE(storage.flush());
+    EXPECT_TRUE(std::filesystem::exists(options.path + "-wal"));
+}
+
+TEST_F(SQLiteStorageBatchTest, FlushMakesQueuedWritesVisible) {
+    options.batchInterval = std::chrono::seconds(10);   // 只靠筆數或 flush 觸發提交
+    options.batchSize = 1000;
+    SQLiteStorage storage(options);
+    for (int i = 0; i < 500; i++) {
+        storage.storeTradeData("BTCUSDT", 0.001 * i);
+    }
+    storage.storeTradeGroup("BYBIT", "ETHUSDT", "SPOT1", "FUT1", 2);
+    // 批次未滿且未到時間, 寫入仍在隊列中, flush 會等待提交
+    ASSERT_TRUE(storage.flush(std::chrono::seconds(30)));
+    EXPECT_EQ(countRows("trades"), 500);
+
+    auto groups = storage.getActiveTradeGroups();
+    ASSERT_EQ(groups.size(), 1u);
+    EXPECT_EQ(groups[0], "BYBIT:ETHUSDT:SPOT1_FUT1_2");
+}
+
+TEST_F(SQLiteStorageBatchTest, ConcurrentWritersWithSmallQueue) {
+    options.queueCapacity = 8;
+    options.batchSize = 4;
+    options.batchInterval = std::chrono::milliseconds(1);
+    {
+        SQLiteStorage storage(options);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; t++) {
+            writers.emplace_back([&storage, t] {
+                for (int i = 0; i < 100; i++) {
+                    storage.storeTradeData("SYM" + std::to_string(t), i);
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+    }
+    // 析構時寫完隊列中的剩餘數據
+    EXPECT_EQ(countRows("trades"), 400);
+}
+
+TEST_F(SQLiteStorageBatchTest, TradeGroupWritesDoNotWaitForFullQueue) {
+    options.queueCapacity = 1;
+    options.batchSize = 1000;
+    options.batchInterval = std::chrono::seconds(10);
+    SQLiteStorage storage(options);
+    storage.storeTradeData("BTCUSDT", 0.001);   // 隊列已滿, 背景線程仍在等待批次
+
+    // 下單路徑的對沖組寫入不等待隊列空位
+    auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < 3; i++) {
+        TradeGroup group;
+        group.exchangeId = "BYBIT";
+        group.symbol = "SYM" + std::to_string(i);
+        group.orderSeq = 1;
+        storage.openTradeGroup(group);
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(1));
+
+    ASSERT_TRUE(storage.flushDurable());
+    EXPECT_EQ(countRows("trade_groups"), 3);
+    EXPECT_EQ(countRows("trades"), 1);
+}
+
+TEST_F(SQLiteStorageBatchTest, FundingRatesUpsertAndRangeRead) {
+    SQLiteStorage storage(options);
+    const int64_t hour = 3600 * 1000;
+    std::vector<FundingRecord> records;
+    for (int i = 0; i < 10; i++) {
+        records.push_back({"BTCUSDT", i * 8 * hour, 0.0001 * i});
+    }
+    storage.storeFundingRates(records);
+    // 同一結算時間重複寫入以新值為準
+    storage.storeFundingRates({{"BTCUSDT", 0, 0.5}});
+
+    auto range = storage.getFundingRates("BTCUSDT", 0, 16 * hour);
+    ASSERT_EQ(range.size(), 3u);
+    EXPECT_DOUBLE_EQ(range[0].rate, 0.5);
+    EXPECT_EQ(range[2].ts, 16 * hour);
+    EXPECT_TRUE(storage.getFundingRates("ETHUSDT", 0, 100 * hour).empty());
+}
+
+TEST_F(SQLiteStorageBatchTest, LatestFundingWindowForManySymbols) {
+    SQLiteStorage storage(options);
+    std::vector<FundingRecord> records;
+    for (int i = 0; i < 20; i++) {
+        records.push_back({"BTCUSDT", i, 0.001 * i});
+    }
+    records.push_back({"ETHUSDT", 5, 0.01});
+    records.push_back({"ETHUSDT", 6, 0.02});
+    storage.storeFundingRates(records);
+
+    auto window = storage.getLatestFundingRates({"ETHUSDT", "SOLUSDT", "BTCUSDT"}, 4);
+    ASSERT_EQ(window.size(), 3u);
+    EXPECT_EQ(window.symbols[2], "BTCUSDT");
+    // 最新在前, 每行最多 depth 筆
+    EXPECT_EQ(std::vector<double>(window.row(0).begin(), window.row(0).end()),
+              (std::vector<double>{0.02, 0.01}));
+    EXPECT_TRUE(window.row(1).empty());
+    ASSERT_EQ(window.row(2).size(), 4u);
+    EXPECT_DOUBLE_EQ(window.row(2)[0], 0.019);
+    EXPECT_DOUBLE_EQ(window.row(2)[3], 0.016);
+
+    // 指定時間點之前的視窗 (回測用)
+    auto asOf = storage.getLatestFundingRates({"BTCUSDT"}, 3, 10);
+    ASSERT_EQ(asOf.row(0).size(), 3u);
+    EXPECT_DOUBLE_EQ(asOf.row(0)[0], 0.010);
+    EXPECT_DOUBLE_EQ(asOf.row(0)[2], 0.008);
+}
+
+TEST_F(SQLiteStorageBatchTest, TradeGroupLifecycleAndMirror) {
+    int64_t id = 0;
+    {
+        SQLiteStorage storage(options);
+        TradeGroup group;
+        group.exchangeId = "BYBIT";
+        group.symbol = "ETHUSDT";
+        group.leverage = 2;
+        id = storage.openTradeGroup(group);
+
+        auto found = storage.findActiveTradeGroup("BYBIT", "ETHUSDT");
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(found->id, id);
+        EXPECT_EQ(found->state, TradeGroupState::Opening);
+
+        found->applySpotFill(1.0, 2000.0, 0.001);
+        found->applyContractFill(1.0, 2001.0, 0.0005);
+        found->state = TradeGroupState::Open;
+        found->orderSeq = 2;
+        storage.updateTradeGroup(*found);
+
+        TradeGroup other;
+        other.exchangeId = "BYBIT";
+        other.symbol = "BTCUSDT";
+        other.state = TradeGroupState::Open;
+        other.spotQty = other.contractQty = 0.01;
+        int64_t otherId = storage.openTradeGroup(other);
+        EXPECT_GT(otherId, id);
+        auto closed = *storage.findActiveTradeGroup(otherId);
+        closed.state = TradeGroupState::Closed;
+        storage.updateTradeGroup(closed);
+        EXPECT_FALSE(storage.findActiveTradeGroup(otherId).has_value());
+        ASSERT_EQ(storage.activeTradeGroups().size(), 1u);
+
+        auto history = storage.getTradeGroupHistory("BTCUSDT");
+        ASSERT_EQ(history.size(), 1u);
+        EXPECT_EQ(history[0].state, TradeGroupState::Closed);
+    }
+
+    // 重新打開時只載入未平倉組, 新 id 接續遞增
+    SQLiteStorage storage(options);
+    auto groups = storage.activeTradeGroups();
+    ASSERT_EQ(groups.size(), 1u);
+    EXPECT_EQ(groups[0].id, id);
+    EXPECT_EQ(groups[0].state, TradeGroupState::Open);
+    EXPECT_DOUBLE_EQ(groups[0].spotQty, 1.0);
+    EXPECT_DOUBLE_EQ(groups[0].contractAvgPrice, 2001.0);
+    EXPECT_NEAR(groups[0].fees, 2.0 + 1.0005, 1e-9);
+    EXPECT_EQ(groups[0].orderSeq, 2);
+    EXPECT_GT(storage.openTradeGroup(TradeGroup{}), id + 1);
+}
+
+TEST_F(SQLiteStorageBatchTest, MigratesLegacyTradeGroups) {
+    {
+        sqlite3* db = nullptr;
+        sqlite3_open(options.path.c_str(), &db);
+        sqlite3_exec(db,
+            "CREATE TABLE trade_groups (id INTEGER PRIMARY KEY AUTOINCREMENT, exchange_id TEXT NOT NULL, "
+            "symbol TEXT NOT NULL, spot_order_id TEXT NOT NULL, futures_order_id TEXT NOT NULL, "
+            "leverage INTEGER NOT NULL, active INTEGER DEFAULT 1, created_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+            "INSERT INTO trade_groups (exchange_id, symbol, spot_order_id, futures_order_id, leverage, active) "
+            "VALUES ('BYBIT', 'SOLUSDT', 'S1', 'F1', 3, 1), ('BYBIT', 'XRPUSDT', 'S2', 'F2', 3, 0);",
+            nullptr, nullptr, nullptr);
+        sqlite3_close(db);
+    }
+
+    SQLiteStorage storage(options);
+    ASSERT_TRUE(storage.isConnectionValid());
+    EXPECT_EQ(storage.getActiveTradeGroups(), (std::vector<std::string>{"BYBIT:SOLUSDT:S1_F1_3"}));
+    auto history = storage.getTradeGroupHistory("XRPUSDT");
+    ASSERT_EQ(history.size(), 1u);
+    EXPECT_EQ(history[0].state, TradeGroupState::Closed);
+}
+
+TEST(TradeGroupTest, FillsUpdateAveragePriceAndFees) {
+    TradeGroup group;
+    group.applySpotFill(1.0, 100.0, 0.001);
+    group.applySpotFill(1.0, 110.0, 0.001);
+    EXPECT_DOUBLE_EQ(group.spotQty, 2.0);
+    EXPECT_DOUBLE_EQ(group.spotAvgPrice, 105.0);
+    // 減倉不改變均價
+    group.applySpotFill(-0.5, 120.0, 0.001);
+    EXPECT_DOUBLE_EQ(group.spotQty, 1.5);
+    EXPECT_DOUBLE_EQ(group.spotAvgPrice, 105.0);
+    group.applySpotFill(-2.0, 120.0, 0.0);
+    EXPECT_DOUBLE_EQ(group.spotQty, 0.0);
+    EXPECT_DOUBLE_EQ(group.spotAvgPrice, 0.0);
+    EXPECT_NEAR(group.fees, 0.1 + 0.11 + 0.06, 1e-12);
+
+    EXPECT_EQ(parseTradeGroupState(toString(TradeGroupState::Closing)), TradeGroupState::Closing);
+    EXPECT_FALSE(parseTradeGroupState("bogus").has_value());
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "trading/symbol_registry.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+Json::Value readJson(const std::string& path) {
+    Json::Value root;
+    Json::Reader reader;
+    std::ifstream in(path);
+    EXPECT_TRUE(reader.parse(in, root));
+    return root;
+}
+
+class SymbolRegistryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "symbol_registry_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        path = (dir / "pair_list.json").string();
+        std::ofstream(path) << R"({"pair_list": ["BTCUSDT", "ETHUSDT"], "unsupported_symbols": ["USDCUSDT"]})";
+        options.filePath = path;
+        options.ttl = std::chrono::hours(24);
+        options.flushInterval = std::chrono::milliseconds(10);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::shared_ptr<const ConfigSnapshot> snapshotFromFile(uint64_t version) {
+        return ConfigSnapshot::build(Json::Value(Json::objectValue), readJson(path), version);
+    }
+
+    std::filesystem::path dir;
+    std::string path;
+    SymbolBlockOptions options;
+    VirtualClock clock{IClock::TimePoint(std::chrono::hours(1000))};
+};
+
+} // namespace
+
+TEST_F(SymbolRegistryTest, LoadsConfigListAsPermanent) {
+    SymbolRegistry registry(clock, options);
+    registry.sync(*snapshotFromFile(1));
+
+    EXPECT_TRUE(registry.isBlocked("USDCUSDT"));
+    EXPECT_FALSE(registry.isBlocked("BTCUSDT"));
+    clock.advance(std::chrono::hours(24 * 365));
+    EXPECT_TRUE(registry.isBlocked("USDCUSDT"));
+}
+
+TEST_F(SymbolRegistryTest, BlockedSymbolsExpireAfterTtl) {
+    SymbolRegistry registry(clock, options);
+    EXPECT_TRUE(registry.block("FOOUSDT", "Not supported symbols"));
+    EXPECT_FALSE(registry.block("FOOUSDT", "Not supported symbols"));
+
+    auto entry = registry.find("FOOUSDT");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->reason, "Not supported symbols");
+    EXPECT_EQ(entry->firstSeen, clock.now());
+    EXPECT_FALSE(entry->permanent());
+
+    clock.advance(std::chrono::hours(23));
+    EXPECT_TRUE(registry.isBlocked("FOOUSDT"));
+    clock.advance(std::chrono::hours(1));
+    EXPECT_FALSE(registry.isBlocked("FOOUSDT"));
+    EXPECT_EQ(registry.purgeExpired(), 1u);
+    // 過期後可再次封鎖
+    EXPECT_TRUE(registry.block("FOOUSDT", "again"));
+}
+
+TEST_F(SymbolRegistryTest, ZeroTtlBlocksPermanently) {
+    options.ttl = std::chrono::hours(0);
+    SymbolRegistry registry(clock, options);
+    registry.sync(*snapshotFromFile(1));
+    registry.block("FOOUSDT", "manual");
+
+    clock.advance(std::chrono::hours(24 * 365));
+    EXPECT_TRUE(registry.isBlocked("FOOUSDT"));
+    ASSERT_TRUE(registry.flush());
+    auto root = readJson(path);
+    ASSERT_EQ(root["unsupported_symbols"].size(), 2u);
+    EXPECT_EQ(root["unsupported_symbols"][0].asString(), "FOOUSDT");
+}
+
+TEST_F(SymbolRegistryTest, FlushPreservesPairListAndRoundTrips) {
+    SymbolRegistry registry(clock, options);
+    registry.sync(*snapshotFromFile(1));
+    registry.block("FOOUSDT", "Not supported symbols");
+    ASSERT_TRUE(registry.flush());
+    // 只留下 pair_list.json, 臨時文件已改名
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator()), 1);
+
+    auto root = readJson(path);
+    EXPECT_EQ(root["pair_list"].size(), 2u);
+    EXPECT_EQ(root["unsupported_symbols"][0].asString(), "USDCUSDT");
+    EXPECT_EQ(root["blocked_symbols"]["FOOUSDT"]["reason"].asString(), "Not supported symbols");
+
+    SymbolRegistry reloaded(clock, options);
+    reloaded.sync(*snapshotFromFile(2));
+    EXPECT_TRUE(reloaded.isBlocked("FOOUSDT"));
+    EXPECT_TRUE(reloaded.isBlocked("USDCUSDT"));
+    EXPECT_EQ(reloaded.find("FOOUSDT")->expiresAt, clock.now() + std::chrono::hours(24));
+}
+
+TEST_F(SymbolRegistryTest, SyncKeepsUnflushedChanges) {
+    SymbolRegistry registry(clock, options);
+    registry.sync(*snapshotFromFile(1));
+    registry.block("FOOUSDT", "Not supported symbols");
+    registry.unblock("USDCUSDT");
+
+    // 文件尚未更新, 重新載入不應覆蓋本地變更
+    registry.sync(*snapshotFromFile(2));
+    EXPECT_TRUE(registry.isBlocked("FOOUSDT"));
+    EXPECT_FALSE(registry.isBlocked("USDCUSDT"));
+}
+
+TEST_F(SymbolRegistryTest, BackgroundWriterBatchesChanges) {
+    SymbolRegistry registry(clock, options);
+    registry.start();
+    registry.block("FOOUSDT", "a");
+    registry.block("BARUSDT", "b");
+
+    for (int i = 0; i < 200; i++) {
+        if (readJson(path)["blocked_symbols"].size() == 2) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(readJson(path)["blocked_symbols"].size(), 2u);
+
+    registry.block("BAZUSDT", "c");
+    registry.stop();
+    EXPECT_EQ(readJson(path)["blocked_symbols"].size(), 3u);
+}
+
+TEST_F(SymbolRegistryTest, AccountsShareOneRegistryPerFile) {
+    auto first = SymbolRegistry::shared(clock, options);
+    auto second = SymbolRegistry::shared(clock, options);
+    EXPECT_EQ(first, second);
+    SymbolBlockOptions otherFile = options;
+    otherFile.filePath = (dir / "other.json").string();
+    EXPECT_NE(SymbolRegistry::shared(clock, otherFile), first);
+
+    // 兩個帳戶的封鎖都寫入同一文件, 不會互相覆蓋
+    first->sync(*snapshotFromFile(1));
+    second->sync(*snapshotFromFile(1));
+    first->block("FOOUSDT", "a");
+    second->block("BARUSDT", "b");
+    ASSERT_TRUE(first->flush());
+    EXPECT_EQ(readJson(path)["blocked_symbols"].size(), 2u);
+
+    // 全部持有者釋放後重新建立
+    first.reset();
+    second.reset();
+    auto recreated = SymbolRegistry::shared(clock, options);
+    recreated->sync(*snapshotFromFile(2));
+    EXPECT_TRUE(recreated->isBlocked("BARUSDT"));
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "metrics/trace.h"
+#include <json/json.h>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <thread>
+
+namespace {
+
+Json::Value readJson(const std::string& path) {
+    std::ifstream in(path);
+    Json::Value root;
+    Json::Reader reader;
+    EXPECT_TRUE(reader.parse(in, root));
+    return root;
+}
+
+} // namespace
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "trace_test";
+        std::filesystem::remove_all(dir);
+        TraceOptions options;
+        options.enabled = true;
+        options.outputDir = dir.string();
+        Tracer::getInstance().configure(options);
+    }
+
+    void TearDown() override {
+        Tracer::getInstance().configure(TraceOptions());
+        std::filesystem::remove_all(dir);
+    }
+
+    std::filesystem::path dir;
+};
+
+TEST_F(TraceTest, SpansOutsideCycleAreNotRecorded) {
+    { TraceSpan span("ignored", "test"); }
+    EXPECT_TRUE(Tracer::getInstance().drain().empty());
+}
+
+TEST_F(TraceTest, WritesChromeTraceForCycleAcrossThreads) {
+    Tracer& tracer = Tracer::getInstance();
+    tracer.beginCycle("unit");
+    {
+        TraceSpan outer("getTopFundingRates", "strategy");
+        std::thread worker([]() {
+            TraceSpan span("makeRequest", "rest", "/v5/market/\"tickers\"");
+        });
+        worker.join();
+        // 嵌套週期不會提前輸出
+        tracer.beginCycle("nested");
+        EXPECT_EQ(tracer.endCycle(), "");
+    }
+    std::string path = tracer.endCycle();
+    ASSERT_FALSE(path.empty());
+    EXPECT_NE(path.find("unit"), std::string::npos);
+
+    Json::Value root = readJson(path);
+    EXPECT_EQ(root["otherData"]["cycle"].asString(), "unit");
+    const Json::Value& events = root["traceEvents"];
+    std::set<std::string> names;
+    std::set<int> threads;
+    for (const auto& event : events) {
+        if (event["ph"].asString() == "X") {
+            names.insert(event["name"].asString());
+            threads.insert(event["tid"].asInt());
+            EXPECT_GE(event["dur"].asInt64(), 0);
+        }
+        if (event["name"].asString() == "makeRequest") {
+            EXPECT_EQ(event["args"]["detail"].asString(), "/v5/market/\"tickers\"");
+            EXPECT_EQ(event["cat"].asString(), "rest");
+        }
+    }
+    EXPECT_EQ(names, (std::set<std::string>{"cycle", "getTopFundingRates", "makeRequest"}));
+    EXPECT_EQ(threads.size(), 2u);
+    EXPECT_TRUE(tracer.drain().empty());
+}
+
+TEST_F(TraceTest, DropsEventsBeyondCycleLimit) {
+    TraceOptions options;
+    options.enabled = true;
+    options.outputDir = dir.string();
+    options.maxEventsPerCycle = 3;
+    Tracer& tracer = Tracer::getInstance();
+    tracer.configure(options);
+
+    uint64_t droppedBefore = tracer.droppedCount();
+    tracer.beginCycle("limit");
+    for (int i = 0; i < 5; i++) {
+        TraceSpan span("span", "test");
+    }
+    std::string path = tracer.endCycle();
+    EXPECT_EQ(tracer.droppedCount() - droppedBefore, 2u);
+    EXPECT_EQ(readJson(path)["traceEvents"].size(), 3u + 1u + 1u);   // 3 個區段、週期及線程名稱
+}
@@ -2,52 +2,28 @@
 #include <gmock/gmock.h>
 #include "include/trading/trading_module.h"
 #include "include/exchange/exchange_interface.h"
-
-// Mock Exchange 類
-class MockExchange : public IExchange {
-public:
-    MOCK_METHOD0(getFundingRates, std::vector<std::pair<std::string, double>>());
-    MOCK_METHOD1(getSpotPrice, double(const std::string&));
-    MOCK_METHOD0(getTotalEquity, double());
-    MOCK_METHOD1(getPositions, Json::Value(const std::string&));
-    MOCK_METHOD2(setLeverage, bool(const std::string&, int));
-    MOCK_METHOD5(createOrder, Json::Value(
-        const std::string&, 
-        const std::string&, 
-        double, 
-        const std::string&, 
-        const std::string&
-    ));
-    MOCK_METHOD3(createSpotOrder, bool(const std::string&, const std::string&, double));
-    MOCK_METHOD1(closePosition, void(const std::string&));
-    MOCK_METHOD1(getInstruments, std::vector<std::string>(const std::string&));
-    MOCK_METHOD0(getLastError, std::string());
-    
-
-    // Mock 方法的具體實現
-    MOCK_METHOD0(displayPositions, void());
-    MOCK_METHOD0(getSpotBalances, Json::Value());
-    MOCK_METHOD1(getSpotBalance, double(const std::string&));
-    MOCK_METHOD1(getMarginRatio, double(const std::string&));
-    MOCK_METHOD1(getSpotOrderBook, Json::Value(const std::string&));
-    MOCK_METHOD1(getContractOrderBook, Json::Value(const std::string&));
-    MOCK_METHOD1(getContractPrice, double(const std::string&));
-    MOCK_METHOD1(getCurrentFundingRate, double(const std::string&));
-    MOCK_METHOD0(getSpotFeeRate, double());
-    MOCK_METHOD0(getContractFeeRate, double());
-    
-    MOCK_METHOD1(getFundingHistory, 
-        std::vector<std::pair<std::string, std::vector<double>>>(const std::vector<std::string>&));
-};
+#include "mock_exchange.h"
+#include "metrics/alloc_tracker.h"
+#include "scheduler/strategy_jobs.h"
+#include <filesystem>
+#include <unistd.h>
 
 class TradingModuleTest : public ::testing::Test {
 protected:
     void SetUp() override {
         ::testing::FLAGS_gtest_death_test_style = "threadsafe";
         ::testing::GTEST_FLAG(print_time) = true;
-        
-        TradingModule::resetInstance();
-        
+
+        // 對沖組及資金費率寫入臨時數據庫, 不使用工作目錄下正式的 trading.db
+        dir = std::filesystem::temp_directory_path() /
+              ("trading_module_test_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        StorageOptions options;
+        options.path = (dir / "trading.db").string();
+        options.batchInterval = std::chrono::milliseconds(5);
+        testStorage = std::make_unique<SQLiteStorage>(options);
+
         mockExchange = new MockExchange();
         ON_CALL(*mockExchange, getFundingRates())
             .WillByDefault(::testing::Return(std::vector<std::pair<std::string, double>>()));
@@ -59,12 +35,31 @@ protected:
     }
 
     void TearDown() override {
+        traders.clear();
         delete mockExchange;
-        TradingModule::resetInstance();
+        testStorage.reset();
+        std::filesystem::remove_all(dir);
         std::remove("config.json");
     }
 
+    // 寫入臨時目錄的 sinks; 重啟快照默認關閉, 避免覆蓋配置中的正式快照
+    TradingSinks sinks(bool warmState = false) const {
+        TradingSinks result;
+        result.storage = testStorage.get();
+        result.pairListPath = (dir / "pair_list.json").string();
+        result.warmState = warmState;
+        return result;
+    }
+
+    TradingModule& makeTrader(IExchange& exchange, IClock& clock = SystemClock::getInstance()) {
+        traders.push_back(TradingModule::createForAccount(exchange, clock, AccountConfig{}, sinks()));
+        return *traders.back();
+    }
+
     MockExchange* mockExchange;
+    std::filesystem::path dir;
+    std::unique_ptr<SQLiteStorage> testStorage;
+    std::vector<std::unique_ptr<TradingModule>> traders;
 };
 
 TEST_F(TradingModuleTest, GetTopFundingRates) {
@@ -76,9 +71,414 @@ TEST_F(TradingModuleTest, GetTopFundingRates) {
         {"BTCUSDT", {0.001, 0.002, 0.001}}
     };
     
-    auto& trader = TradingModule::getInstance(*mockExchange);
+    auto& trader = makeTrader(*mockExchange);
     auto rates = trader.getTopFundingRates();
     
     ASSERT_EQ(rates.size(), 2);
 }
-  
\ No newline at end of file
+  
+TEST_F(TradingModuleTest, ScoresFundingRatesFromLocalSeries) {
+    // 帶結算時間的記錄寫入本地時間序列後再評分, 不再以無時間的歷史評分
+    const int64_t base = 1760000000000;
+    const int64_t interval = 8 * 3600 * 1000;
+    std::vector<FundingRecord> records;
+    for (int i = 0; i < 9; i++) {
+        records.push_back({"LOCALAUSDT", base - i * interval, 0.001});
+    }
+    for (int i = 0; i < 9; i++) {
+        records.push_back({"LOCALBUSDT", base - i * interval, 0.0004});
+    }
+    EXPECT_CALL(*mockExchange, getFundingRecords(::testing::_)).WillOnce(::testing::Return(records));
+    EXPECT_CALL(*mockExchange, getFundingHistory(::testing::_)).Times(0);
+
+    auto& trader = makeTrader(*mockExchange);
+    trader.setSymbolUniverse({"LOCALAUSDT", "LOCALBUSDT"});
+    auto rates = trader.getTopFundingRates();
+
+    ASSERT_EQ(rates.size(), 2u);
+    EXPECT_EQ(rates[0].first, "LOCALAUSDT");
+    EXPECT_NEAR(rates[0].second, 0.001, 1e-12);
+    auto stored = testStorage->getFundingRates("LOCALAUSDT", base - 8 * interval, base);
+    EXPECT_EQ(stored.size(), 9u);
+}
+
+TEST_F(TradingModuleTest, JournalsHedgeAtExecutionPrices) {
+    using ::testing::_;
+    using ::testing::Return;
+    const std::string symbol = "JOURNALUSDT";
+    SQLiteStorage& storage = *testStorage;
+    VirtualClock clock;
+    auto& trader = makeTrader(*mockExchange, clock);
+    const std::string exchangeId = Config::getInstance().getPreferredExchange();
+    // 行情價格 100, 實際成交: 現貨 101 (按訂單號查詢), 合約 99.5 / 98 (下單響應)
+    ON_CALL(*mockExchange, getSpotPrice(symbol)).WillByDefault(Return(100.0));
+    ON_CALL(*mockExchange, getContractPrice(symbol)).WillByDefault(Return(100.0));
+    ON_CALL(*mockExchange, getSpotFeeRate()).WillByDefault(Return(0.0));
+    ON_CALL(*mockExchange, getContractFeeRate()).WillByDefault(Return(0.0005));
+    ON_CALL(*mockExchange, createSpotOrder(symbol, _, 2.0, _)).WillByDefault(Return(true));
+    EXPECT_CALL(*mockExchange, getOrderByLinkId(_, _))
+        .WillRepeatedly([](const std::string& category, const std::string&) {
+            Json::Value order;
+            if (category == "spot") {
+                order["avgPrice"] = "101";
+            }
+            return order;
+        });
+    auto filled = [](const std::string& avgPrice) {
+        Json::Value response;
+        response["retCode"] = 0;
+        response["result"]["orderId"] = "F1";
+        response["result"]["avgPrice"] = avgPrice;
+        return response;
+    };
+    EXPECT_CALL(*mockExchange, createOrder(symbol, "Sell", 2.0, "linear", "MARKET", _))
+        .WillOnce(Return(filled("99.5")));
+    EXPECT_CALL(*mockExchange, createOrder(symbol, "Buy", 2.0, "linear", "MARKET", _))
+        .WillOnce(Return(filled("98")));
+
+    RebalancePlan plan;
+    plan.actions.push_back({symbol, 0.0, 0.0, 2.0, 2.0, 0, 200.0});
+    std::map<std::string, std::pair<double, double>> positions;
+    trader.executeRebalancePlan(plan, positions);
+
+    auto group = storage.findActiveTradeGroup(exchangeId, symbol);
+    ASSERT_TRUE(group.has_value());
+    EXPECT_EQ(group->state, TradeGroupState::Open);
+    EXPECT_DOUBLE_EQ(group->spotQty, 2.0);
+    EXPECT_DOUBLE_EQ(group->contractQty, 2.0);
+    EXPECT_DOUBLE_EQ(group->spotAvgPrice, 101.0);
+    EXPECT_DOUBLE_EQ(group->contractAvgPrice, 99.5);
+    EXPECT_EQ(group->futuresOrderId, "F1");
+
+    // 按組記錄的數量平倉, 手續費按平倉成交價累計
+    EXPECT_TRUE(trader.closeTradeGroup(group->id));
+    EXPECT_FALSE(storage.findActiveTradeGroup(group->id).has_value());
+    EXPECT_FALSE(trader.closeTradeGroup(group->id));
+    auto history = storage.getTradeGroupHistory(symbol);
+    ASSERT_FALSE(history.empty());
+    EXPECT_EQ(history.back().id, group->id);
+    EXPECT_EQ(history.back().state, TradeGroupState::Closed);
+    EXPECT_DOUBLE_EQ(history.back().spotQty, 0.0);
+    EXPECT_NEAR(history.back().fees, 2 * 99.5 * 0.0005 + 2 * 98 * 0.0005, 1e-9);
+}
+
+TEST_F(TradingModuleTest, OrderLinkIdsReachTheExchange) {
+    using ::testing::_;
+    using ::testing::Return;
+    const std::string symbol = "LINKIDUSDT";
+    SQLiteStorage& storage = *testStorage;
+    VirtualClock clock;
+    auto& trader = makeTrader(*mockExchange, clock);
+    const std::string exchangeId = Config::getInstance().getPreferredExchange();
+    ON_CALL(*mockExchange, getSpotPrice(symbol)).WillByDefault(Return(100.0));
+    ON_CALL(*mockExchange, getContractPrice(symbol)).WillByDefault(Return(100.0));
+    std::vector<std::string> spotIds;
+    std::vector<std::string> contractIds;
+    EXPECT_CALL(*mockExchange, createSpotOrder(symbol, _, 2.0, _))
+        .WillRepeatedly([&spotIds](const std::string&, const std::string&, double, const std::string& linkId) {
+            spotIds.push_back(linkId);
+            return true;
+        });
+    EXPECT_CALL(*mockExchange, createOrder(symbol, _, 2.0, "linear", "MARKET", _))
+        .WillRepeatedly([&contractIds](const std::string&, const std::string&, double, const std::string&,
+                                       const std::string&, const std::string& linkId) {
+            contractIds.push_back(linkId);
+            Json::Value response;
+            response["retCode"] = 0;
+            response["result"]["orderId"] = "L1";
+            return response;
+        });
+
+    RebalancePlan plan;
+    plan.actions.push_back({symbol, 0.0, 0.0, 2.0, 2.0, 0, 200.0});
+    std::map<std::string, std::pair<double, double>> positions;
+    trader.executeRebalancePlan(plan, positions);
+    auto group = storage.findActiveTradeGroup(exchangeId, symbol);
+    ASSERT_TRUE(group.has_value());
+    ASSERT_EQ(spotIds.size(), 1u);
+    ASSERT_EQ(contractIds.size(), 1u);
+    EXPECT_EQ(spotIds[0], group->orderLinkId('s'));
+    EXPECT_EQ(contractIds[0], group->orderLinkId('c'));
+
+    // 平倉是新的下單批次, 訂單號不與開倉重複
+    TradeGroup opened = *group;
+    ASSERT_TRUE(trader.closeTradeGroup(group->id));
+    ASSERT_EQ(spotIds.size(), 2u);
+    ASSERT_EQ(contractIds.size(), 2u);
+    opened.orderSeq++;
+    EXPECT_EQ(spotIds[1], opened.orderLinkId('s'));
+    EXPECT_EQ(contractIds[1], opened.orderLinkId('c'));
+    EXPECT_NE(spotIds[1], spotIds[0]);
+    EXPECT_NE(contractIds[1], contractIds[0]);
+}
+
+TEST_F(TradingModuleTest, AccountsUseTheirOwnConfigAndJournalSeparately) {
+    using ::testing::_;
+    using ::testing::Return;
+    const std::string symbol = "ACCOUNTUSDT";
+    const auto warmDir = dir / "warm";
+    std::filesystem::create_directories(warmDir);
+
+    // 全局配置沒有重啟快照, 只有 alpha 帳戶的覆蓋配置啟用
+    Config& config = Config::getInstance();
+    const Config::Snapshot original = config.snapshot();
+    Json::Value root = original->config;
+    root["storage"].removeMember("warm_state");
+    config.publish(ConfigSnapshot::build(root, original->pairList, original->version + 1));
+    AccountConfig alpha{"alpha"};
+    alpha.overrides["storage"]["warm_state"]["path"] = (warmDir / "warm.json").string();
+    AccountConfig beta{"beta"};
+
+    auto setUp = [&](::testing::NiceMock<MockExchange>& exchange, double qty) {
+        ON_CALL(exchange, getSpotPrice(symbol)).WillByDefault(Return(100.0));
+        ON_CALL(exchange, getContractPrice(symbol)).WillByDefault(Return(100.0));
+        ON_CALL(exchange, getSpotFeeRate()).WillByDefault(Return(0.0));
+        ON_CALL(exchange, getContractFeeRate()).WillByDefault(Return(0.0));
+        ON_CALL(exchange, createSpotOrder(_, _, _, _)).WillByDefault(Return(true));
+        Json::Value filled;
+        filled["retCode"] = 0;
+        filled["result"]["orderId"] = "F" + std::to_string(qty);
+        filled["result"]["avgPrice"] = "100";
+        EXPECT_CALL(exchange, createOrder(symbol, _, qty, "linear", "MARKET", _))
+            .Times(2).WillRepeatedly(Return(filled));
+    };
+    ::testing::NiceMock<MockExchange> alphaExchange;
+    ::testing::NiceMock<MockExchange> betaExchange;
+    setUp(alphaExchange, 2.0);
+    setUp(betaExchange, 3.0);
+    VirtualClock clock;
+    auto alphaTrader = TradingModule::createForAccount(alphaExchange, clock, alpha, sinks(true));
+    auto betaTrader = TradingModule::createForAccount(betaExchange, clock, beta, sinks(true));
+    EXPECT_EQ(alphaTrader->getAccountName(), "alpha");
+
+    // 覆蓋配置在建構時生效: 只有 alpha 保存快照, 文件名附加帳戶名稱
+    EXPECT_TRUE(alphaTrader->saveWarmState());
+    EXPECT_TRUE(betaTrader->saveWarmState());
+    EXPECT_TRUE(std::filesystem::exists(warmDir / "warm.json.alpha"));
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(warmDir), std::filesystem::directory_iterator()), 1);
+
+    // 同一幣種的對沖組按帳戶分開記錄
+    SQLiteStorage& storage = *testStorage;
+    const std::string preferred = original->preferredExchange;
+    std::map<std::string, std::pair<double, double>> positions;
+    RebalancePlan alphaPlan;
+    alphaPlan.actions.push_back({symbol, 0.0, 0.0, 2.0, 2.0, 0, 200.0});
+    alphaTrader->executeRebalancePlan(alphaPlan, positions);
+    RebalancePlan betaPlan;
+    betaPlan.actions.push_back({symbol, 0.0, 0.0, 3.0, 3.0, 0, 300.0});
+    betaTrader->executeRebalancePlan(betaPlan, positions);
+
+    auto alphaGroup = storage.findActiveTradeGroup(preferred + ":alpha", symbol);
+    auto betaGroup = storage.findActiveTradeGroup(preferred + ":beta", symbol);
+    ASSERT_TRUE(alphaGroup.has_value());
+    ASSERT_TRUE(betaGroup.has_value());
+    EXPECT_NE(alphaGroup->id, betaGroup->id);
+    EXPECT_DOUBLE_EQ(alphaGroup->contractQty, 2.0);
+    EXPECT_DOUBLE_EQ(betaGroup->contractQty, 3.0);
+    EXPECT_FALSE(storage.findActiveTradeGroup(preferred, symbol).has_value());
+
+    EXPECT_TRUE(alphaTrader->closeTradeGroup(alphaGroup->id));
+    EXPECT_TRUE(betaTrader->closeTradeGroup(betaGroup->id));
+    alphaTrader.reset();
+    betaTrader.reset();
+    config.publish(original);
+}
+
+TEST_F(TradingModuleTest, PipelineRunsDisplayAndArchiveStepsAfterTheirStage) {
+    using ::testing::_;
+    using ::testing::Return;
+    Config& config = Config::getInstance();
+    const Config::Snapshot original = config.snapshot();
+    Json::Value root = original->config;
+    root["pipeline"]["enabled"] = true;
+    root["pipeline"]["idle_wait_us"] = 100;
+    config.publish(ConfigSnapshot::build(root, original->pairList, original->version + 1));
+
+    // 所有交易所調用記錄線程: 流水線模式下不應在調用方線程上執行
+    const auto caller = std::this_thread::get_id();
+    std::atomic<int> callerCalls{0};
+    std::atomic<int> recordFetches{0};
+    auto onCaller = [&] {
+        if (std::this_thread::get_id() == caller) {
+            callerCalls++;
+        }
+    };
+    const int64_t base = 1760000000000;
+    std::vector<FundingRecord> records;
+    for (int i = 0; i < 9; i++) {
+        records.push_back({"PIPEAUSDT", base - i * 8 * 3600 * 1000LL, 0.001});
+        records.push_back({"PIPEBUSDT", base - i * 8 * 3600 * 1000LL, 0.0005});
+    }
+    ON_CALL(*mockExchange, getFundingRecords(_)).WillByDefault([&](const std::vector<std::string>&) {
+        onCaller();
+        recordFetches++;
+        return records;
+    });
+    Json::Value balances;
+    balances["result"]["list"][0]["coin"] = Json::Value(Json::arrayValue);
+    ON_CALL(*mockExchange, getSpotBalances()).WillByDefault([&] { onCaller(); return balances; });
+    Json::Value positions;
+    positions["result"]["list"] = Json::Value(Json::arrayValue);
+    ON_CALL(*mockExchange, getPositions(_)).WillByDefault([&](const std::string&) { onCaller(); return positions; });
+    EXPECT_CALL(*mockExchange, getFundingRecords(_)).Times(2);
+
+    // 與結算時間相隔數小時, 排名緩存不會因接近結算而失效
+    VirtualClock clock{IClock::TimePoint(std::chrono::hours(1000 + 4))};
+    auto& trader = makeTrader(*mockExchange, clock);
+    trader.setSymbolUniverse({"PIPEAUSDT", "PIPEBUSDT"});
+    trader.startPipeline();
+    ASSERT_TRUE(trader.pipelineRunning());
+
+    // 執行後的步驟在流水線線程上, 本週期執行完成後調用
+    std::atomic<bool> cycleDone{false};
+    std::atomic<uint64_t> executedBeforeCallback{0};
+    trader.executeHedgeStrategy([&] {
+        executedBeforeCallback = trader.getPipelineStats()->executed;
+        cycleDone = std::this_thread::get_id() != caller;
+    });
+    for (int i = 0; i < 500 && !cycleDone; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(cycleDone);
+    EXPECT_EQ(executedBeforeCallback, 1u);
+
+    // 對帳只投遞週期, 執行後輸出持倉沿用本週期的排名, 不會重複刷新
+    runReconcile(trader, true);
+    EXPECT_EQ(callerCalls, 0);
+    // 回調按請求順序調用: 下一個週期的回調調用時持倉已輸出完畢
+    std::atomic<bool> displayed{false};
+    trader.executeHedgeStrategy([&] { displayed = true; });
+    for (int i = 0; i < 500 && !displayed; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(displayed);
+    EXPECT_GE(trader.getPipelineStats()->executed, 2u);
+    EXPECT_EQ(recordFetches, 1);
+
+    // 結算後刷新: 後續步驟 (歸檔追加) 在新的記錄寫入之後才調用
+    std::atomic<int> fetchesBeforeArchive{-1};
+    trader.refreshFundingRates([&] { fetchesBeforeArchive = recordFetches.load(); });
+    for (int i = 0; i < 500 && fetchesBeforeArchive < 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(fetchesBeforeArchive, 2);
+
+    trader.stopPipeline();
+    EXPECT_EQ(callerCalls, 0);
+    config.publish(original);
+}
+
+// TradingModule 將 BenchmarkAccess 宣告為 friend; 測試程序不鏈接 benchmarks/, 在此提供測試用的定義
+struct BenchmarkAccess {
+    static void checkPositionBalance(TradingModule& module, const std::string& symbol) {
+        module.checkPositionBalance(symbol, 1.0, 1.0);
+    }
+    static double rebalanceCost(TradingModule& module, const std::string& symbol, const Json::Value& book) {
+        return module.calculateRebalanceCost(symbol, 3.0, true, book);
+    }
+    static void setPosition(TradingModule& module, const std::string& symbol, double spot, double contract) {
+        std::lock_guard<std::mutex> lock(module.positionBookMutex);
+        module.positionBook[symbol] = {spot, contract};
+        module.positionBookKnown = true;
+    }
+    static bool hasPosition(TradingModule& module, const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(module.positionBookMutex);
+        return module.positionBook.count(symbol) > 0;
+    }
+    static void deleverage(TradingModule& module, const std::string& symbol) {
+        RiskAlert alert;
+        alert.symbol = symbol;
+        alert.level = RiskLevel::Deleverage;
+        alert.reduceFraction = 0.5;
+        alert.tickAt = std::chrono::steady_clock::now();
+        module.deleverage(alert);
+    }
+};
+
+TEST_F(TradingModuleTest, CostEstimateStaysUnderAllocationCeiling) {
+    using ::testing::_;
+    using ::testing::Return;
+    const std::string symbol = "COSTUSDT";
+    Json::Value book;
+    book["retCode"] = 0;
+    for (int i = 0; i < 50; i++) {
+        Json::Value ask(Json::arrayValue);
+        ask.append(std::to_string(100.0 + i * 0.01));
+        ask.append("2.5");
+        book["result"]["a"].append(ask);
+        Json::Value bid(Json::arrayValue);
+        bid.append(std::to_string(99.99 - i * 0.01));
+        bid.append("1.5");
+        book["result"]["b"].append(bid);
+    }
+    ON_CALL(*mockExchange, getSpotPrice(symbol)).WillByDefault(Return(100.0));
+    ON_CALL(*mockExchange, getContractPrice(symbol)).WillByDefault(Return(100.0));
+    ON_CALL(*mockExchange, getSpotOrderBook(symbol)).WillByDefault(Return(book));
+    ON_CALL(*mockExchange, getContractOrderBook(symbol)).WillByDefault(Return(book));
+    ON_CALL(*mockExchange, getCurrentFundingRate(symbol)).WillByDefault(Return(0.0001));
+    ON_CALL(*mockExchange, getSpotFeeRate()).WillByDefault(Return(0.001));
+    ON_CALL(*mockExchange, getContractFeeRate()).WillByDefault(Return(0.0005));
+    auto& trader = makeTrader(*mockExchange);
+    // 第一次調用取得手續費率並建立基差追蹤的條目
+    BenchmarkAccess::checkPositionBalance(trader, symbol);
+
+    AllocTracker::setEnabled(true);
+    uint64_t costAllocations;
+    {
+        AllocScope scope("test_rebalance_cost");
+        BenchmarkAccess::rebalanceCost(trader, symbol, book);
+        costAllocations = scope.stats().count;
+    }
+    // 交易所調用本身 (返回 Json 副本) 的分配次數作為基準, 不計入成本估算
+    uint64_t fetchAllocations;
+    {
+        AllocScope scope("test_cost_fetch");
+        mockExchange->getSpotPrice(symbol);
+        mockExchange->getContractPrice(symbol);
+        mockExchange->getSpotOrderBook(symbol);
+        mockExchange->getContractOrderBook(symbol);
+        mockExchange->getCurrentFundingRate(symbol);
+        fetchAllocations = scope.stats().count;
+    }
+    uint64_t checkAllocations;
+    {
+        AllocScope scope("test_balance_check");
+        BenchmarkAccess::checkPositionBalance(trader, symbol);
+        checkAllocations = scope.stats().count;
+    }
+    AllocTracker::setEnabled(false);
+
+    EXPECT_EQ(costAllocations, 0u);
+    EXPECT_LE(checkAllocations, fetchAllocations);
+}
+
+TEST_F(TradingModuleTest, ClosedGroupIsRemovedFromPositionBook) {
+    using ::testing::_;
+    using ::testing::Return;
+    const std::string symbol = "CLOSEBOOKUSDT";
+    SQLiteStorage& storage = *testStorage;
+    VirtualClock clock;
+    auto& trader = makeTrader(*mockExchange, clock);
+    const std::string exchangeId = Config::getInstance().getPreferredExchange();
+    ON_CALL(*mockExchange, getSpotPrice(symbol)).WillByDefault(Return(100.0));
+    ON_CALL(*mockExchange, getContractPrice(symbol)).WillByDefault(Return(100.0));
+    ON_CALL(*mockExchange, createSpotOrder(symbol, _, 2.0, _)).WillByDefault(Return(true));
+    Json::Value filled;
+    filled["retCode"] = 0;
+    filled["result"]["orderId"] = "B1";
+    EXPECT_CALL(*mockExchange, createOrder(symbol, "Sell", 2.0, "linear", "MARKET", _)).WillOnce(Return(filled));
+    // 只有平倉買回合約; 之後的減倉不應再買入 (會變成多單)
+    EXPECT_CALL(*mockExchange, createOrder(symbol, "Buy", _, "linear", "MARKET", _)).WillOnce(Return(filled));
+
+    RebalancePlan plan;
+    plan.actions.push_back({symbol, 0.0, 0.0, 2.0, 2.0, 0, 200.0});
+    std::map<std::string, std::pair<double, double>> positions;
+    trader.executeRebalancePlan(plan, positions);
+    BenchmarkAccess::setPosition(trader, symbol, 2.0, 2.0);
+    auto group = storage.findActiveTradeGroup(exchangeId, symbol);
+    ASSERT_TRUE(group.has_value());
+
+    ASSERT_TRUE(trader.closeTradeGroup(group->id));
+    EXPECT_FALSE(BenchmarkAccess::hasPosition(trader, symbol));
+    BenchmarkAccess::deleverage(trader, symbol);
+}
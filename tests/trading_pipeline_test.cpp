@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include "metrics/metrics.h"
+#include "scheduler/lockfree_queue.h"
+#include "scheduler/trading_pipeline.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 輪詢等待條件成立, 最多 5 秒
+template <typename Predicate>
+bool waitFor(Predicate predicate) {
+    for (int i = 0; i < 5000; i++) {
+        if (predicate()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return predicate();
+}
+
+RebalancePlan nonEmptyPlan() {
+    RebalancePlan plan;
+    plan.actions.push_back(SymbolRebalance{"BTCUSDT", 0.0, 0.0, 1.0, 1.0, 0, 100.0});
+    return plan;
+}
+
+} // namespace
+
+TEST(LockfreeQueueTest, SpscRespectsCapacityAndOrder) {
+    SpscQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(queue.size(), 4u);
+    for (int i = 0; i < 4; i++) {
+        auto value = queue.tryPop();
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(*value, i);
+    }
+    EXPECT_FALSE(queue.tryPop().has_value());
+}
+
+TEST(LockfreeQueueTest, SpscTransfersAcrossThreads) {
+    SpscQueue<int> queue(16);
+    constexpr int COUNT = 100000;
+    std::thread producer([&] {
+        for (int i = 0; i < COUNT; i++) {
+            while (!queue.tryPush(i)) {
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+            }
+        }
+    });
+    int expected = 0;
+    while (expected < COUNT) {
+        if (auto value = queue.tryPop()) {
+            ASSERT_EQ(*value, expected);
+            expected++;
+        }
+    }
+    producer.join();
+}
+
+TEST(LockfreeQueueTest, MpscDeliversEveryItemOnce) {
+    MpscQueue<int> queue(64);
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                while (!queue.tryPush(p * PER_PRODUCER + i)) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(10));
+                }
+            }
+        });
+    }
+    std::vector<int> seen(PRODUCERS * PER_PRODUCER, 0);
+    std::vector<int> lastPerProducer(PRODUCERS, -1);
+    for (int received = 0; received < PRODUCERS * PER_PRODUCER;) {
+        if (auto value = queue.tryPop()) {
+            seen[*value]++;
+            // 同一生產者的項目保持順序
+            int producer = *value / PER_PRODUCER;
+            ASSERT_GT(*value, lastPerProducer[producer]);
+            lastPerProducer[producer] = *value;
+            received++;
+        }
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    for (int count : seen) {
+        ASSERT_EQ(count, 1);
+    }
+    EXPECT_FALSE(queue.tryPop().has_value());
+}
+
+TEST(TradingPipelineTest, RunsStagesOnDedicatedThreads) {
+    std::atomic<int> refreshes{0};
+    std::atomic<int> executed{0};
+    std::atomic<bool> sameThread{false};
+    std::thread::id captureThread;
+    PipelineStages stages;
+    stages.refresh = [&] { refreshes++; };
+    stages.capture = [&](MarketSnapshot& snapshot) {
+        captureThread = std::this_thread::get_id();
+        snapshot.topRates = {{"BTCUSDT", 0.0001}};
+        snapshot.positions["BTCUSDT"] = {1.0, 1.0};
+        return true;
+    };
+    stages.decide = [&](const MarketSnapshot& snapshot) {
+        EXPECT_EQ(snapshot.topRates.size(), 1u);
+        sameThread = sameThread || std::this_thread::get_id() == captureThread;
+        return RebalancePlan{};
+    };
+    stages.execute = [&](StrategyDecision& decision) {
+        EXPECT_EQ(decision.positions.at("BTCUSDT").first, 1.0);
+        EXPECT_LE(decision.capturedAt, decision.decidedAt);
+        executed++;
+    };
+
+    PipelineOptions options;
+    options.idleWait = std::chrono::microseconds(100);
+    TradingPipeline pipeline(std::move(stages), options, "pipeline_test");
+    pipeline.start();
+    EXPECT_TRUE(pipeline.isRunning());
+    EXPECT_TRUE(pipeline.requestRefresh());
+    EXPECT_TRUE(pipeline.requestCycle());
+    ASSERT_TRUE(waitFor([&] { return executed.load() >= 1; }));
+    pipeline.stop();
+    EXPECT_FALSE(pipeline.isRunning());
+
+    EXPECT_EQ(refreshes.load(), 1);
+    EXPECT_FALSE(sameThread.load());
+    EXPECT_EQ(pipeline.stats().stale, 0u);
+    EXPECT_GE(MetricsRegistry::getInstance().histogram(
+        "frt_pipeline_hop_seconds", "", {{"account", "pipeline_test"}, {"hop", "execution"}}).count(), 1u);
+}
+
+TEST(TradingPipelineTest, DropsDecisionsMadeBeforeExecutionChangedPositions) {
+    std::atomic<int> captures{0};
+    std::atomic<bool> release{false};
+    std::vector<uint64_t> executedSequences;
+    PipelineStages stages;
+    stages.capture = [&](MarketSnapshot&) {
+        captures++;
+        return true;
+    };
+    stages.decide = [](const MarketSnapshot&) { return nonEmptyPlan(); };
+    stages.execute = [&](StrategyDecision& decision) {
+        // 第一個決策執行期間, 第二個快照以舊持倉完成決策
+        while (decision.sequence == 1 && !release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        executedSequences.push_back(decision.sequence);
+    };
+
+    PipelineOptions options;
+    options.idleWait = std::chrono::microseconds(100);
+    TradingPipeline pipeline(std::move(stages), options);
+    pipeline.start();
+    ASSERT_TRUE(pipeline.requestCycle());
+    ASSERT_TRUE(waitFor([&] { return pipeline.stats().decisions >= 1; }));
+    ASSERT_TRUE(pipeline.requestCycle());
+    ASSERT_TRUE(waitFor([&] { return pipeline.stats().decisions >= 2; }));
+    release = true;
+
+    // 過時的第二個決策被丟棄, 自動重新取得的第三個快照照常執行
+    ASSERT_TRUE(waitFor([&] { return pipeline.stats().executed >= 2; }));
+    pipeline.stop();
+    EXPECT_EQ(pipeline.stats().stale, 1u);
+    EXPECT_EQ(captures.load(), 3);
+    EXPECT_EQ(executedSequences, (std::vector<uint64_t>{1, 3}));
+}
+
+TEST(TradingPipelineTest, CompletionCallbacksRunAfterTheirStage) {
+    std::mutex eventsMutex;
+    std::vector<std::string> events;
+    auto record = [&](const std::string& event) {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        events.push_back(event);
+    };
+    std::atomic<bool> failCapture{false};
+    PipelineStages stages;
+    stages.refresh = [&] { record("refresh"); };
+    stages.capture = [&](MarketSnapshot&) { return !failCapture.load(); };
+    stages.decide = [](const MarketSnapshot&) { return nonEmptyPlan(); };
+    stages.execute = [&](StrategyDecision&) { record("execute"); };
+
+    PipelineOptions options;
+    options.idleWait = std::chrono::microseconds(100);
+    TradingPipeline pipeline(std::move(stages), options);
+    // 啟動前投遞: 兩個週期請求合併為一次執行, 兩個回調都在執行後調用
+    ASSERT_TRUE(pipeline.requestRefresh([&] { record("after refresh"); }));
+    ASSERT_TRUE(pipeline.requestCycle([&] { record("after cycle 1"); }));
+    ASSERT_TRUE(pipeline.requestCycle([&] { record("after cycle 2"); }));
+    pipeline.start();
+    ASSERT_TRUE(waitFor([&] {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        return events.size() >= 5;
+    }));
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        EXPECT_EQ(events, (std::vector<std::string>{"refresh", "after refresh", "execute",
+                                                    "after cycle 1", "after cycle 2"}));
+        events.clear();
+    }
+
+    // 快照失敗時週期沒有執行, 回調照常調用
+    failCapture = true;
+    ASSERT_TRUE(pipeline.requestCycle([&] { record("after failed cycle"); }));
+    ASSERT_TRUE(waitFor([&] {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        return !events.empty();
+    }));
+    pipeline.stop();
+    EXPECT_EQ(events, (std::vector<std::string>{"after failed cycle"}));
+    EXPECT_EQ(pipeline.stats().executed, 1u);
+}
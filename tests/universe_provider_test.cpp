@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include "trading/universe_provider.h"
+#include "exchange/coin_market_cap.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <filesystem>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+class FakeUniverseSource : public IUniverseSource {
+public:
+    bool fetch(int topCount, const std::string&, std::vector<std::string>& symbols,
+               std::string& error) override {
+        calls++;
+        if (fail) {
+            error = "CMC API 錯誤 1008: You've exceeded your API Key's HTTP request rate limit";
+            return false;
+        }
+        symbols = next;
+        if (symbols.size() > static_cast<size_t>(topCount)) {
+            symbols.resize(topCount);
+        }
+        return true;
+    }
+
+    std::vector<std::string> next{"BTCUSDT", "ETHUSDT"};
+    std::atomic<bool> fail{false};
+    std::atomic<int> calls{0};
+};
+
+// 本地 CMC 替身: 每個連線返回固定的狀態碼及內容
+class StandInServer {
+public:
+    StandInServer(int status, std::string body) : status(status), body(std::move(body)) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = 0;
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(fd, 4);
+        socklen_t len = sizeof(addr);
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        port = ntohs(addr.sin_port);
+        worker = std::thread([this] { serve(); });
+    }
+
+    ~StandInServer() {
+        shutdown(fd, SHUT_RDWR);
+        close(fd);
+        worker.join();
+    }
+
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port); }
+
+    std::string lastRequest;
+
+private:
+    void serve() {
+        int client = accept(fd, nullptr, nullptr);
+        if (client < 0) {
+            return;
+        }
+        char buffer[4096];
+        ssize_t n = recv(client, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            lastRequest.assign(buffer, static_cast<size_t>(n));
+        }
+        std::string response = "HTTP/1.1 " + std::to_string(status) + " X\r\n"
+                               "Content-Type: application/json\r\n"
+                               "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                               "Connection: close\r\n\r\n" + body;
+        send(client, response.data(), response.size(), MSG_NOSIGNAL);
+        close(client);
+    }
+
+    int status;
+    std::string body;
+    int fd = -1;
+    int port = 0;
+    std::thread worker;
+};
+
+const char* LISTINGS = R"({
+    "status": {"error_code": 0, "error_message": null},
+    "data": [{"symbol": "BTC"}, {"symbol": "ETH"}, {"symbol": "SOL"}]
+})";
+
+class UniverseProviderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "universe_provider_test";
+        std::filesystem::remove_all(dir);
+        options.cachePath = (dir / "cmc_universe.json").string();
+        options.topCount = 2;
+        options.ttl = std::chrono::hours(6);
+        options.retryInterval = std::chrono::minutes(5);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::filesystem::path dir;
+    UniverseOptions options;
+    FakeUniverseSource source;
+    VirtualClock clock{IClock::TimePoint(std::chrono::hours(1000))};
+};
+
+} // namespace
+
+TEST(CoinMarketCapSourceTest, ParsesListings) {
+    std::vector<std::string> symbols;
+    std::string error;
+    ASSERT_TRUE(CoinMarketCapSource::parseListings(LISTINGS, 2, symbols, error));
+    EXPECT_EQ(symbols, (std::vector<std::string>{"BTCUSDT", "ETHUSDT"}));
+}
+
+TEST(CoinMarketCapSourceTest, StatusErrorIsFailure) {
+    std::vector<std::string> symbols;
+    std::string error;
+    const char* outOfCredits = R"({"status": {"error_code": 1010, "error_message": "monthly credit limit reached"}})";
+    EXPECT_FALSE(CoinMarketCapSource::parseListings(outOfCredits, 10, symbols, error));
+    EXPECT_NE(error.find("1010"), std::string::npos);
+    EXPECT_FALSE(CoinMarketCapSource::parseListings("not json", 10, symbols, error));
+}
+
+TEST(CoinMarketCapSourceTest, FetchesFromStandInEndpoint) {
+    StandInServer server(200, LISTINGS);
+    CoinMarketCapSource source(server.url(), "test-key", 5);
+    std::vector<std::string> symbols;
+    std::string error;
+
+    ASSERT_TRUE(source.fetch(3, "volume_7d", symbols, error)) << error;
+    EXPECT_EQ(symbols.size(), 3u);
+    EXPECT_NE(server.lastRequest.find("/v1/cryptocurrency/listings/latest?sort=volume_7d&limit=3"),
+              std::string::npos);
+    EXPECT_NE(server.lastRequest.find("X-CMC_PRO_API_KEY: test-key"), std::string::npos);
+}
+
+TEST(CoinMarketCapSourceTest, StandInErrorStatusIsFailure) {
+    StandInServer server(402, R"({"status": {"error_code": 1008, "error_message": "rate limit"}})");
+    CoinMarketCapSource source(server.url(), "test-key", 5);
+    std::vector<std::string> symbols;
+    std::string error;
+
+    EXPECT_FALSE(source.fetch(3, "volume_7d", symbols, error));
+    EXPECT_NE(error.find("1008"), std::string::npos);
+}
+
+TEST_F(UniverseProviderTest, ServesStaleListWithoutWaiting) {
+    UniverseProvider provider(source, clock, options);
+    ASSERT_TRUE(provider.refresh());
+    EXPECT_EQ(provider.symbols(), (std::vector<std::string>{"BTCUSDT", "ETHUSDT"}));
+
+    clock.advance(std::chrono::hours(7));
+    source.next = {"SOLUSDT", "XRPUSDT"};
+    EXPECT_TRUE(provider.isStale());
+    // 後台線程未啟動, 讀取仍立即返回舊列表
+    EXPECT_EQ(provider.symbols(), (std::vector<std::string>{"BTCUSDT", "ETHUSDT"}));
+    EXPECT_EQ(source.calls.load(), 1);
+}
+
+TEST_F(UniverseProviderTest, KeepsLastGoodListOnFailure) {
+    UniverseProvider provider(source, clock, options);
+    ASSERT_TRUE(provider.refresh());
+    const auto fetchedAt = provider.fetchedAt();
+
+    source.fail = true;
+    clock.advance(std::chrono::hours(7));
+    EXPECT_FALSE(provider.refresh());
+    EXPECT_EQ(provider.symbols(), (std::vector<std::string>{"BTCUSDT", "ETHUSDT"}));
+    EXPECT_EQ(provider.fetchedAt(), fetchedAt);
+}
+
+TEST_F(UniverseProviderTest, PersistsCacheAcrossRestarts) {
+    {
+        UniverseProvider provider(source, clock, options);
+        ASSERT_TRUE(provider.refresh());
+    }
+    UniverseProvider restarted(source, clock, options);
+    ASSERT_TRUE(restarted.loadCache());
+    EXPECT_EQ(restarted.symbols(), (std::vector<std::string>{"BTCUSDT", "ETHUSDT"}));
+    EXPECT_EQ(restarted.fetchedAt(), clock.now());
+    EXPECT_FALSE(restarted.isStale());
+
+    // 參數變更後不使用舊緩存
+    options.sortBy = "market_cap";
+    UniverseProvider changed(source, clock, options);
+    EXPECT_FALSE(changed.loadCache());
+}
+
+TEST_F(UniverseProviderTest, BackgroundRefreshReplacesStaleList) {
+    UniverseProvider provider(source, clock, options);
+    ASSERT_TRUE(provider.refresh());
+    provider.start();
+
+    clock.advance(std::chrono::hours(7));
+    source.next = {"SOLUSDT", "XRPUSDT"};
+    provider.symbols();   // 喚醒背景線程
+    for (int i = 0; i < 200 && provider.isStale(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    provider.stop();
+
+    EXPECT_EQ(provider.symbols(), (std::vector<std::string>{"SOLUSDT", "XRPUSDT"}));
+    EXPECT_EQ(source.calls.load(), 2);
+}
+
+TEST_F(UniverseProviderTest, FailedRefreshWaitsForRetryInterval) {
+    source.fail = true;
+    UniverseProvider provider(source, clock, options);
+    provider.start();
+    for (int i = 0; i < 200 && source.calls.load() == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    // 連續讀取不會觸發新的請求
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(provider.symbols().empty());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    provider.stop();
+    EXPECT_EQ(source.calls.load(), 1);
+}
+
+TEST_F(UniverseProviderTest, StartAfterSynchronousRefreshDoesNotFetchAgain) {
+    UniverseProvider provider(source, clock, options);
+    ASSERT_FALSE(provider.loadCache());
+    ASSERT_TRUE(provider.refresh());
+    provider.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    provider.stop();
+    EXPECT_EQ(source.calls.load(), 1);
+
+    // 同步刷新失敗後, 背景線程同樣等到重試間隔才再次請求
+    FakeUniverseSource failing;
+    failing.fail = true;
+    UniverseProvider cold(failing, clock, options);
+    EXPECT_FALSE(cold.refresh());
+    cold.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    cold.stop();
+    EXPECT_EQ(failing.calls.load(), 1);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "trading/warm_state.h"
+#include <filesystem>
+#include <fstream>
+
+class WarmStateTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "warm_state_test";
+        std::filesystem::remove_all(dir);
+        path = (dir / "state" / "warm_state.json").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::filesystem::path dir;
+    std::string path;
+};
+
+TEST_F(WarmStateTest, SaveAndLoadRoundTrip) {
+    WarmState state;
+    state.savedAt = IClock::TimePoint(std::chrono::milliseconds(1700000000123LL));
+    state.rankedAt = IClock::TimePoint(std::chrono::milliseconds(1700000000000LL));
+    state.rankings = {{"ETHUSDT", 0.0021}, {"BTCUSDT", -0.0008}};
+    state.spotFeeRate = 0.001;
+    state.contractFeeRate = 0.00055;
+    state.positions = {{"ETHUSDT", {1.5, 1.49}}};
+    state.positionsKnown = true;
+
+    ASSERT_TRUE(state.save(path));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    auto loaded = WarmState::load(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->savedAt, state.savedAt);
+    EXPECT_EQ(loaded->rankedAt, state.rankedAt);
+    EXPECT_EQ(loaded->rankings, state.rankings);
+    EXPECT_DOUBLE_EQ(loaded->spotFeeRate, 0.001);
+    EXPECT_DOUBLE_EQ(loaded->contractFeeRate, 0.00055);
+    EXPECT_TRUE(loaded->positionsKnown);
+    EXPECT_EQ(loaded->positions, state.positions);
+}
+
+TEST_F(WarmStateTest, UnknownPositionsAndFeesStayUnknown) {
+    WarmState state;
+    ASSERT_TRUE(state.save(path));
+
+    auto loaded = WarmState::load(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_FALSE(loaded->positionsKnown);
+    EXPECT_LT(loaded->spotFeeRate, 0);
+    EXPECT_TRUE(loaded->rankings.empty());
+}
+
+TEST_F(WarmStateTest, RejectsMissingOrIncompatibleFiles) {
+    EXPECT_FALSE(WarmState::load(path).has_value());
+
+    std::filesystem::create_directories(dir / "state");
+    std::ofstream(path) << "{\"version\": 99, \"rankings\": []}";
+    EXPECT_FALSE(WarmState::load(path).has_value());
+
+    std::ofstream(path, std::ios::trunc) << "not json";
+    EXPECT_FALSE(WarmState::load(path).has_value());
+}